@@ -13,7 +13,7 @@ namespace Apricot {
 	template<typename T>
 	APRICOT_API uint64 FormatType(const T& Value, TChar* Buffer, uint64 BufferSize)
 	{
-		AE_STATIC_ASSERT(false, "Specialize FormatType<T> in order to format this type!");
+		AE_STATIC_ASSERT(sizeof(T) == 0, "Specialize FormatType<T> in order to format this type!");
 		return 0;
 	}
 
@@ -44,7 +44,7 @@ namespace Apricot {
 			if (String[StringOffset] == '}')
 			{
 				BufferOffset += FormatType(Value, Buffer + BufferOffset, BufferSize - BufferOffset);
-				InternalFormat(String + StringOffset + 1, StringSize - StringOffset, Buffer + BufferOffset, BufferSize - BufferOffset, std::forward<Args>(args)...);
+				InternalFormat(String + StringOffset + 1, StringSize - StringOffset - 1, Buffer + BufferOffset, BufferSize - BufferOffset, std::forward<Args>(args)...);
 				break;
 			}
 			else if (!bIsInsideCurlies)
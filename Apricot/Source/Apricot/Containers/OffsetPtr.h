@@ -0,0 +1,125 @@
+// Part of Apricot Engine. 2022-2022.
+// Submodule: Containers
+
+#pragma once
+
+#include "Apricot/Core/Base.h"
+#include "Apricot/Core/Assert.h"
+
+namespace Apricot {
+
+	/*
+	* Apricot Engine
+	*
+	* C++ Core engine architecture. Offset Pointer implementation.
+	* Stores the distance from itself to the object, instead of the object's address, so a block of memory that only points
+	*	inside itself stays valid wherever it is mapped. Used by the data stored in arena snapshots.
+	* It doesn't own the object.
+	*
+	* @tparam T The type of the object.
+	*/
+	template<typename T>
+	class TOffsetPtr
+	{
+	/* Constructors & Deconstructor */
+	public:
+		TOffsetPtr()
+			: m_Offset(0)
+		{
+		}
+
+		TOffsetPtr(T* Pointer)
+		{
+			Set(Pointer);
+		}
+
+		/*
+		* The offset is relative to the pointer's own address, so it must be recomputed by every copy.
+		*/
+		TOffsetPtr(const TOffsetPtr<T>& Other)
+		{
+			Set(Other.Get());
+		}
+
+	/* Overloaded operators */
+	public:
+		TOffsetPtr<T>& operator=(const TOffsetPtr<T>& Other)
+		{
+			Set(Other.Get());
+			return *this;
+		}
+
+		TOffsetPtr<T>& operator=(T* Pointer)
+		{
+			Set(Pointer);
+			return *this;
+		}
+
+		T* operator->() const
+		{
+			AE_CORE_ASSERT(m_Offset != 0); /* Pointer is null */
+			return Get();
+		}
+
+		T& operator*() const
+		{
+			AE_CORE_ASSERT(m_Offset != 0); /* Pointer is null */
+			return *Get();
+		}
+
+		T& operator[](uint64 Index) const
+		{
+			AE_CORE_ASSERT(m_Offset != 0); /* Pointer is null */
+			return Get()[Index];
+		}
+
+		operator bool8() const
+		{
+			return m_Offset != 0;
+		}
+
+		bool8 operator==(const TOffsetPtr<T>& Other) const
+		{
+			return Get() == Other.Get();
+		}
+
+		bool8 operator!=(const TOffsetPtr<T>& Other) const
+		{
+			return Get() != Other.Get();
+		}
+
+	/* API functions */
+	public:
+		/*
+		* Return the raw pointer.
+		*/
+		FORCEINLINE T* Get() const
+		{
+			return m_Offset != 0 ? (T*)((uint8*)this + m_Offset) : nullptr;
+		}
+
+		/*
+		* Checks if the pointer is valid (not nullptr).
+		*/
+		FORCEINLINE bool8 IsValid() const
+		{
+			return m_Offset != 0;
+		}
+
+		/*
+		* The offset 0 means nullptr, so an offset pointer can't point to itself.
+		*/
+		FORCEINLINE void Set(T* Pointer)
+		{
+			AE_CORE_ASSERT((void*)Pointer != (void*)this, TEXT("An offset pointer can't point to itself!"));
+			m_Offset = Pointer ? (int64)((uint8*)Pointer - (uint8*)this) : 0;
+		}
+
+	private:
+		/*
+		* Distance, in bytes, from this pointer to the object. 0 if the pointer is null.
+		*/
+		int64 m_Offset;
+	};
+
+}
@@ -382,18 +382,16 @@ namespace Apricot {
 		TString& Append(const TStringView<CharType>& substring)
 		{
 			CharType* data = m_SSO;
+			uint64 newSize = m_Size + substring.Size() - 1;
 
-			if (m_Size + substring.Size() - 1 > SSOBufferSize)
+			if (newSize > SSOBufferSize)
 			{
-				if (m_Size > m_Capacity)
-				{
-					ReAllocateCopy(m_Size);
-				}
+				GrowHeapData(newSize);
 				data = m_Data;
 			}
 
 			MemCpy(data + m_Size - 1, substring.Data(), substring.Size() * sizeof(CharType));
-			m_Size = m_Size + substring.Size() - 1;
+			m_Size = newSize;
 
 			return *this;
 		}
@@ -405,16 +403,14 @@ namespace Apricot {
 			
 			if (newSize > SSOBufferSize)
 			{
-				if (newSize > m_Capacity)
-				{
-					ReAllocateCopy(newSize);
-				}
+				GrowHeapData(newSize);
 				data = m_Data;
 			}
 
-			for (uint64 index = where; index < m_Size; index++)
+			// Backwards, so that the characters aren't overwritten before they are moved.
+			for (uint64 index = m_Size; index > where; index--)
 			{
-				data[index + substring.Size() - 1] = data[index];
+				data[index - 1 + substring.Size() - 1] = data[index - 1];
 			}
 
 			MemCpy(data + where, substring.Data(), (substring.Size() - 1) * sizeof(CharType));
@@ -703,11 +699,37 @@ namespace Apricot {
 			}
 			else
 			{
-				m_Data = (CharType*)m_Allocator->Realloc(m_Data, (uint64)newCapacity * sizeof(CharType), EAllocatorHint::String);
+				CharType* newBlock = (CharType*)m_Allocator->Realloc(m_Data, m_Capacity * sizeof(CharType), (uint64)newCapacity * sizeof(CharType), EAllocatorHint::String);
+				if (!newBlock)
+				{
+					// The old block is still valid, so the string keeps it.
+					return;
+				}
+				m_Data = newBlock;
 			}
 			m_Capacity = newCapacity;
 		}
 
+		/**
+		* Makes sure that the heap block can hold 'newSize' characters. The capacity grows geometrically, so that appending is amortized O(1).
+		* If the string is leaving the SSO buffer, its characters are copied to the heap block.
+		*/
+		void GrowHeapData(uint64 newSize)
+		{
+			bool bWasUsingSSO = IsUsingSSO();
+
+			if (newSize > m_Capacity)
+			{
+				uint64 newCapacity = m_Capacity + m_Capacity / 2;
+				ReAllocateCopy(newCapacity > newSize ? newCapacity : newSize);
+			}
+
+			if (bWasUsingSSO)
+			{
+				MemCpy(m_Data, m_SSO, m_Size * sizeof(CharType));
+			}
+		}
+
 		void ReAllocateCopy(uint64 newCapacity)
 		{
 			if (!m_Data)
@@ -716,12 +738,16 @@ namespace Apricot {
 			}
 			else
 			{
-				CharType* newBlock = (CharType*)m_Allocator->ExpandBlock(m_Data, (uint64)newCapacity * sizeof(CharType), EAllocatorHint::String);
+				CharType* newBlock = (CharType*)m_Allocator->ExpandBlock(m_Data, m_Capacity * sizeof(CharType), (uint64)newCapacity * sizeof(CharType), EAllocatorHint::String);
 				if (!newBlock)
 				{
-					newBlock = (CharType*)m_Allocator->Alloc((uint64)newCapacity * sizeof(CharType), EAllocatorHint::String);
-					MemCpy(newBlock, m_Data, m_Size * sizeof(CharType));
-					DeleteData();
+					// The characters are trivially copyable, so the allocator can move them (big blocks are remapped, not copied).
+					newBlock = (CharType*)m_Allocator->Realloc(m_Data, m_Capacity * sizeof(CharType), (uint64)newCapacity * sizeof(CharType), EAllocatorHint::String);
+				}
+				if (!newBlock)
+				{
+					// The old block is still valid, so the string keeps it.
+					return;
 				}
 				m_Data = newBlock;
 			}
@@ -30,7 +30,16 @@ namespace Apricot {
 
 	APRICOT_API uint64 StrLength(const char16* String)
 	{
+	#ifdef AE_COMPILER_MSVC
 		return wcslen(String);
+	#else
+		const char16* End = String;
+		while (*End)
+		{
+			End++;
+		}
+		return End - String;
+	#endif
 	}
 
 }
\ No newline at end of file
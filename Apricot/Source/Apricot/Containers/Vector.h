@@ -6,6 +6,7 @@
 #include "Apricot/Core/Base.h"
 #include "Apricot/Core/Assert.h"
 #include "Apricot/Core/Memory/ApricotMemory.h"
+#include "Apricot/Core/Memory/HeapAllocator.h"
 
 #include "Iterators/VectorIterator.h"
 
@@ -17,9 +18,10 @@ namespace Apricot {
 	* Apricot Engine Vector implementation.
 	* 
 	* @tparam T The type that the vector stores.
-	* @tparam Alloc The allocator class used for managing the internal memory. Default value = it allocates directly from the global heap.
+	* @tparam AllocatorType The allocator class used for managing the internal memory. Default value = it allocates from the global heap.
+	*			Arenas can be used through the adapters from ArenaAllocator.h.
 	*/
-	template<typename T>
+	template<typename T, typename AllocatorType = HeapAllocator>
 	class TVector
 	{
 	/* Typedefs */
@@ -33,18 +35,30 @@ namespace Apricot {
 
 	public:
 		TVector()
-			: m_Data(nullptr), m_Capacity(0), m_Size(0)
+			: m_Data(nullptr), m_Allocator(AllocatorType::GetDefault()), m_Capacity(0), m_Size(0)
 		{
 		}
 
 		TVector(uint64 Capacity)
-			: m_Data(nullptr), m_Capacity(0), m_Size(0)
+			: m_Data(nullptr), m_Allocator(AllocatorType::GetDefault()), m_Capacity(0), m_Size(0)
 		{
 			ReAllocate(Capacity);
 		}
 
+		explicit TVector(AllocatorType* Allocator, uint64 Capacity = 0)
+			: m_Data(nullptr), m_Allocator(Allocator), m_Capacity(0), m_Size(0)
+		{
+			if (Capacity > 0)
+			{
+				ReAllocate(Capacity);
+			}
+		}
+
+		/*
+		* The copy uses the same allocator as the original.
+		*/
 		TVector(const TVector& Other)
-			: m_Data(nullptr), m_Capacity(0), m_Size(0)
+			: m_Data(nullptr), m_Allocator(Other.m_Allocator), m_Capacity(0), m_Size(0)
 		{
 			ReAllocate(Other.m_Size);
 			m_Size = Other.m_Size;
@@ -56,7 +70,7 @@ namespace Apricot {
 		}
 
 		TVector(TVector&& other) noexcept
-			: m_Data(nullptr), m_Capacity(0), m_Size(0)
+			: m_Data(nullptr), m_Allocator(other.m_Allocator), m_Capacity(0), m_Size(0)
 		{
 			m_Data = other.m_Data;
 			m_Capacity = other.m_Capacity;
@@ -68,7 +82,7 @@ namespace Apricot {
 		}
 
 		TVector(std::initializer_list<T> IntializerList)
-			: m_Data(nullptr), m_Capacity(0), m_Size(0)
+			: m_Data(nullptr), m_Allocator(AllocatorType::GetDefault()), m_Capacity(0), m_Size(0)
 		{
 			ReAllocate(IntializerList.size());
 
@@ -92,6 +106,8 @@ namespace Apricot {
 
 		FORCEINLINE bool8 IsEmpty() const { return (m_Size == 0); }
 
+		FORCEINLINE AllocatorType* GetAllocator() const { return m_Allocator; }
+
 		/*
 		* 
 		*/
@@ -316,14 +332,17 @@ namespace Apricot {
 		void Swap(TVector&& Vector)
 		{
 			T* TempData = m_Data;
+			AllocatorType* TempAllocator = m_Allocator;
 			uint64 TempCapacity = m_Capacity;
 			uint64 TempSize = m_Size;
 
 			m_Data = Vector.m_Data;
+			m_Allocator = Vector.m_Allocator;
 			m_Capacity = Vector.m_Capacity;
 			m_Size = Vector.m_Size;
 
 			Vector.m_Data = TempData;
+			Vector.m_Allocator = TempAllocator;
 			Vector.m_Capacity = TempCapacity;
 			Vector.m_Size = TempSize;
 		}
@@ -372,6 +391,7 @@ namespace Apricot {
 			DeleteMemory();
 
 			m_Data = Other.m_Data;
+			m_Allocator = Other.m_Allocator;
 			m_Capacity = Other.m_Capacity;
 			m_Size = Other.m_Size;
 
@@ -443,7 +463,7 @@ namespace Apricot {
 		void ReAllocate(uint64 NewCapacity)
 		{
 			DeleteMemory();
-			m_Data = (T*)GMalloc->Alloc(NewCapacity * sizeof(T));
+			m_Data = (T*)m_Allocator->Alloc(NewCapacity * sizeof(T), EAllocatorHint::Vector);
 			m_Capacity = NewCapacity;
 		}
 
@@ -452,7 +472,29 @@ namespace Apricot {
 		*/
 		void ReAllocateCopy(uint64 NewCapacity)
 		{
-			T* NewBlock = (T*)GMalloc->Alloc(NewCapacity * sizeof(T));
+			// Growing the block in place doesn't touch the elements at all.
+			if (m_Data && m_Allocator->ExpandBlock(m_Data, m_Capacity * sizeof(T), NewCapacity * sizeof(T), EAllocatorHint::Vector))
+			{
+				m_Capacity = NewCapacity;
+				return;
+			}
+
+			if constexpr (IsTriviallyCopyable<T>())
+			{
+				// The elements can be moved by the allocator, which remaps big blocks instead of copying them.
+				T* NewBlock = (T*)m_Allocator->Realloc(m_Data, m_Capacity * sizeof(T), NewCapacity * sizeof(T), EAllocatorHint::Vector);
+				if (NewBlock == nullptr)
+				{
+					// The old block is still valid, so the vector keeps its elements and capacity.
+					return;
+				}
+
+				m_Data = NewBlock;
+				m_Capacity = NewCapacity;
+				return;
+			}
+
+			T* NewBlock = (T*)m_Allocator->Alloc(NewCapacity * sizeof(T), EAllocatorHint::Vector);
 
 			for (uint64 Index = 0; Index < m_Size; Index++)
 			{
@@ -470,7 +512,7 @@ namespace Apricot {
 		*/
 		void DeleteMemory()
 		{
-			GMalloc->Free(m_Data, m_Capacity * sizeof(T));
+			m_Allocator->Free(m_Data, m_Capacity * sizeof(T), EAllocatorHint::Vector);
 		}
 
 	private:
@@ -479,6 +521,11 @@ namespace Apricot {
 		*/
 		T* m_Data;
 
+		/*
+		* 
+		*/
+		AllocatorType* m_Allocator;
+
 		/*
 		* 
 		*/
@@ -11,7 +11,7 @@
 	#define AE_CORE_ASSERT(Expression, ...)                                                                                                               \
 		if (!(Expression))                                                                                                                                \
 		{                                                                                                                                                 \
-			bool formatted = Format(GCrashReporter->AssertionBuffer, GCrashReporter->AssertionBufferSize, TEXT("")##__VA_ARGS__);                         \
+			bool formatted = Format(GCrashReporter->AssertionBuffer, GCrashReporter->AssertionBufferSize, TEXT("") __VA_ARGS__);                          \
 			GCrashReporter->PreCheckFailed(AE_FILE, AE_FUNCTION_SIG, AE_LINE, TEXT(#Expression), formatted ? GCrashReporter->AssertionBuffer : nullptr);  \
 			AE_DEBUGBREAK();                                                                                                                              \
 			GCrashReporter->PostCheckFailed(AE_FILE, AE_FUNCTION_SIG, AE_LINE, TEXT(#Expression), formatted ? GCrashReporter->AssertionBuffer : nullptr); \
@@ -47,7 +47,7 @@
 	#define AE_CORE_RASSERT(Expression, ...) \
 		if (!(Expression))                                                                                                                                \
 		{                                                                                                                                                 \
-			bool formatted = Format(GCrashReporter->AssertionBuffer, GCrashReporter->AssertionBufferSize, TEXT("")##__VA_ARGS__);                         \
+			bool formatted = Format(GCrashReporter->AssertionBuffer, GCrashReporter->AssertionBufferSize, TEXT("") __VA_ARGS__);                          \
 			GCrashReporter->PreCheckFailed(AE_FILE, AE_FUNCTION_SIG, AE_LINE, TEXT(#Expression), formatted ? GCrashReporter->AssertionBuffer : nullptr);  \
 			AE_DEBUGBREAK();                                                                                                                              \
 			GCrashReporter->PostCheckFailed(AE_FILE, AE_FUNCTION_SIG, AE_LINE, TEXT(#Expression), formatted ? GCrashReporter->AssertionBuffer : nullptr); \
@@ -83,7 +83,7 @@
 	#define AE_CORE_VERIFY(Expression, ...)                                                                                                                \
 		if (!(Expression))                                                                                                                                 \
 		{                                                                                                                                                  \
-			bool formatted = Format(GCrashReporter->AssertionBuffer, GCrashReporter->AssertionBufferSize, TEXT("")##__VA_ARGS__);                          \
+			bool formatted = Format(GCrashReporter->AssertionBuffer, GCrashReporter->AssertionBufferSize, TEXT("") __VA_ARGS__);                           \
 			GCrashReporter->PreVerifyFailed(AE_FILE, AE_FUNCTION_SIG, AE_LINE, TEXT(#Expression), formatted ? GCrashReporter->AssertionBuffer : nullptr);  \
 			AE_DEBUGBREAK();                                                                                                                               \
 			GCrashReporter->PostVerifyFailed(AE_FILE, AE_FUNCTION_SIG, AE_LINE, TEXT(#Expression), formatted ? GCrashReporter->AssertionBuffer : nullptr); \
@@ -91,7 +91,7 @@
 
 #else
 
-	#define AE_CORE_VERIFY(Expression)        { Expression; }
+	#define AE_CORE_VERIFY(Expression, ...)   { Expression; }
 
 #endif
 
@@ -101,14 +101,14 @@
 	#define AE_ENSURE(Expression, ...)                                                                                                                 \
 		if (!(Expression))                                                                                                                             \
 		{                                                                                                                                              \
-			bool formatted = Format(GCrashReporter->AssertionBuffer, GCrashReporter->AssertionBufferSize, TEXT("")##__VA_ARGS__);                      \
+			bool formatted = Format(GCrashReporter->AssertionBuffer, GCrashReporter->AssertionBufferSize, TEXT("") __VA_ARGS__);                       \
 			GCrashReporter->EnsureFailed(AE_FILE, AE_FUNCTION_SIG, AE_LINE, TEXT(#Expression), formatted ? GCrashReporter->AssertionBuffer : nullptr); \
 		}
 
 	#define AE_ENSURE_ALWAYS(Expression, ...)                                                                                                                \
 		if (!(Expression))                                                                                                                                   \
 		{                                                                                                                                                    \
-			bool formatted = Format(GCrashReporter->AssertionBuffer, GCrashReporter->AssertionBufferSize,  TEXT("")##__VA_ARGS__);                           \
+			bool formatted = Format(GCrashReporter->AssertionBuffer, GCrashReporter->AssertionBufferSize,  TEXT("") __VA_ARGS__);                            \
 			GCrashReporter->EnsureAlwaysFailed(AE_FILE, AE_FUNCTION_SIG, AE_LINE, TEXT(#Expression), formatted ? GCrashReporter->AssertionBuffer : nullptr); \
 		}
 
@@ -0,0 +1,187 @@
+// Part of Apricot Engine. 2022-2022.
+// Module: Core
+
+#pragma once
+
+#include "Base.h"
+
+#include <atomic>
+
+#ifdef AE_COMPILER_MSVC
+	#include <intrin.h>
+#endif
+
+namespace Apricot {
+
+	enum class EMemoryOrder : uint8
+	{
+		Relaxed,
+		Acquire,
+		Release,
+		AcquireRelease,
+		SequentiallyConsistent
+	};
+
+	namespace Utils {
+
+		FORCEINLINE constexpr std::memory_order ToStdMemoryOrder(EMemoryOrder Order)
+		{
+			switch (Order)
+			{
+				case EMemoryOrder::Relaxed:                return std::memory_order_relaxed;
+				case EMemoryOrder::Acquire:                return std::memory_order_acquire;
+				case EMemoryOrder::Release:                return std::memory_order_release;
+				case EMemoryOrder::AcquireRelease:         return std::memory_order_acq_rel;
+				case EMemoryOrder::SequentiallyConsistent: return std::memory_order_seq_cst;
+			}
+			return std::memory_order_seq_cst;
+		}
+
+	}
+
+	/**
+	* Value that can be safely read and modified by multiple threads at the same time.
+	* 'T' must be an integral or a pointer type. The operations default to sequential consistency.
+	*/
+	template<typename T>
+	class TAtomic
+	{
+	public:
+		constexpr TAtomic()
+			: m_Value(T()) {}
+
+		constexpr TAtomic(T Value)
+			: m_Value(Value) {}
+
+		TAtomic(const TAtomic&) = delete;
+		TAtomic& operator=(const TAtomic&) = delete;
+
+	public:
+		FORCEINLINE T Load(EMemoryOrder Order = EMemoryOrder::SequentiallyConsistent) const
+		{
+			return m_Value.load(Utils::ToStdMemoryOrder(Order));
+		}
+
+		FORCEINLINE void Store(T Value, EMemoryOrder Order = EMemoryOrder::SequentiallyConsistent)
+		{
+			m_Value.store(Value, Utils::ToStdMemoryOrder(Order));
+		}
+
+		FORCEINLINE T Exchange(T Value, EMemoryOrder Order = EMemoryOrder::SequentiallyConsistent)
+		{
+			return m_Value.exchange(Value, Utils::ToStdMemoryOrder(Order));
+		}
+
+		/**
+		* Replaces the value with 'Desired' if it is equal to 'Expected'. Otherwise, 'Expected' is updated with the current value.
+		* Might fail spuriously, so it is meant to be called in a loop.
+		*
+		* @returns True if the value was replaced.
+		*/
+		FORCEINLINE bool8 CompareExchange(T& Expected, T Desired, EMemoryOrder Order = EMemoryOrder::SequentiallyConsistent)
+		{
+			return m_Value.compare_exchange_weak(Expected, Desired, Utils::ToStdMemoryOrder(Order));
+		}
+
+		FORCEINLINE T FetchAdd(T Value, EMemoryOrder Order = EMemoryOrder::SequentiallyConsistent)
+		{
+			return m_Value.fetch_add(Value, Utils::ToStdMemoryOrder(Order));
+		}
+
+		FORCEINLINE T FetchSub(T Value, EMemoryOrder Order = EMemoryOrder::SequentiallyConsistent)
+		{
+			return m_Value.fetch_sub(Value, Utils::ToStdMemoryOrder(Order));
+		}
+
+		FORCEINLINE T FetchOr(T Value, EMemoryOrder Order = EMemoryOrder::SequentiallyConsistent)
+		{
+			return m_Value.fetch_or(Value, Utils::ToStdMemoryOrder(Order));
+		}
+
+		FORCEINLINE T FetchAnd(T Value, EMemoryOrder Order = EMemoryOrder::SequentiallyConsistent)
+		{
+			return m_Value.fetch_and(Value, Utils::ToStdMemoryOrder(Order));
+		}
+
+	private:
+		std::atomic<T> m_Value;
+	};
+
+	/**
+	* Hints the processor that the thread is busy-waiting.
+	*/
+	FORCEINLINE void CpuPause()
+	{
+	#if defined(AE_COMPILER_MSVC)
+		_mm_pause();
+	#elif defined(__x86_64__) || defined(__i386__)
+		__builtin_ia32_pause();
+	#elif defined(__aarch64__)
+		__asm__ __volatile__("yield");
+	#endif
+	}
+
+	/**
+	* Minimal lock for very short critical sections. The waiting threads spin, so it must never be held for long.
+	*/
+	class ASpinLock
+	{
+	public:
+		constexpr ASpinLock() = default;
+
+		ASpinLock(const ASpinLock&) = delete;
+		ASpinLock& operator=(const ASpinLock&) = delete;
+
+	public:
+		FORCEINLINE void Lock()
+		{
+			while (m_bIsLocked.Exchange(true, EMemoryOrder::Acquire))
+			{
+				// Spin on a plain load, so the cache line isn't bounced between the waiting threads.
+				while (m_bIsLocked.Load(EMemoryOrder::Relaxed))
+				{
+					CpuPause();
+				}
+			}
+		}
+
+		FORCEINLINE bool8 TryLock()
+		{
+			return !m_bIsLocked.Load(EMemoryOrder::Relaxed) && !m_bIsLocked.Exchange(true, EMemoryOrder::Acquire);
+		}
+
+		FORCEINLINE void Unlock()
+		{
+			m_bIsLocked.Store(false, EMemoryOrder::Release);
+		}
+
+	private:
+		TAtomic<bool8> m_bIsLocked = false;
+	};
+
+	/**
+	* Holds a lock for the lifetime of the scope.
+	*/
+	template<typename LockType>
+	class TScopedLock
+	{
+	public:
+		TScopedLock(LockType& Lock)
+			: m_Lock(Lock)
+		{
+			m_Lock.Lock();
+		}
+
+		~TScopedLock()
+		{
+			m_Lock.Unlock();
+		}
+
+		TScopedLock(const TScopedLock&) = delete;
+		TScopedLock& operator=(const TScopedLock&) = delete;
+
+	private:
+		LockType& m_Lock;
+	};
+
+}
@@ -7,8 +7,9 @@
 * Platform detection
 */
 #ifdef AE_PLATFORM_WINDOWS
+#elif defined(AE_PLATFORM_LINUX)
 #else
-	#error "Apricot only supports Windows!"
+	#error "Apricot only supports Windows and Linux!"
 #endif // AE_PLATFORM_WINDOWS
 
 
@@ -24,6 +25,12 @@
 	#else
 		#define APRICOT_API 
 	#endif
+#elif defined(AE_PLATFORM_LINUX)
+	#ifdef AE_EXPORT_DLL
+		#define APRICOT_API __attribute__((visibility("default")))
+	#else
+		#define APRICOT_API 
+	#endif
 #endif // AE_PLATFORM_WINDOWS
 
 
@@ -36,6 +43,9 @@
 	#define AE_D3D12
 	#define AE_D3D11
 	#define AE_OPENGL
+#elif defined(AE_PLATFORM_LINUX)
+	#define AE_VULKAN
+	#define AE_OPENGL
 #endif // AE_PLATFORM_WINDOWS
 
 
@@ -104,6 +114,24 @@
 	/* Enables error checking before allocating from an arena */
 	#define AE_ENABLE_MEMORY_CHECK
 
+	/* Enables the allocation statistics of the memory profiler */
+	#define AE_ENABLE_MEMORY_STATS
+
+	/* Enables the sampled allocation call stacks of the memory profiler */
+	#define AE_ENABLE_MEMORY_SAMPLING
+
+	/* Enables the registry of the live heap blocks, which reports the leaked ones at shutdown */
+	#define AE_ENABLE_MEMORY_LEAK_CHECK
+
+	/* Enables the memory budgets of the hints, arenas and process. Requires AE_ENABLE_MEMORY_STATS */
+	#define AE_ENABLE_MEMORY_BUDGETS
+
+	/* Enables the allocation recorder, which writes the heap and arena allocations to a trace file. Requires AE_ENABLE_MEMORY_STATS */
+	#define AE_ENABLE_MEMORY_RECORDING
+
+	/* Enables the counting of the heap allocations made inside AE_NO_ALLOC_SCOPE */
+	#define AE_ENABLE_NO_ALLOC_SCOPES
+
 	/*  */
 	#define AE_ENABLE_PERFORMANCE_PROFILING
 
@@ -119,7 +147,14 @@
 	#define AE_ENABLE_CORE_VERIFIES
 	#define AE_ENABLE_ENSURES
 	#define AE_ENABLE_MEMORY_CHECK
+	#define AE_ENABLE_MEMORY_STATS
+	#define AE_ENABLE_MEMORY_BUDGETS
 	#define AE_ENABLE_FILESYSTEM_ERROR_CHECK
+
+	#ifdef AE_EDITOR
+		#define AE_ENABLE_MEMORY_SAMPLING
+		#define AE_ENABLE_MEMORY_RECORDING
+	#endif
 #endif
 
 
@@ -129,6 +164,10 @@
 */
 #ifdef _MSC_BUILD
 	#define AE_COMPILER_MSVC
+#elif defined(__clang__)
+	#define AE_COMPILER_CLANG
+#elif defined(__GNUC__)
+	#define AE_COMPILER_GCC
 #else
 	#error "Unknown compiler!"
 #endif // _MSC_BUILD
@@ -142,15 +181,15 @@
 
 	#define NODISCARD [[nodiscard]]
 	#define FORCEINLINE __forceinline
-#else
-	#define AE_STATIC_ASSERT(...)
-	#define AE_DEBUGBREAK()
-	#define AE_LINE
-	#define AE_FILE
-	#define AE_FUNCTION
-	#define AE_FUNCTION_SIG
-	#define NODISCARD
-	#define FORCEINLINE
+	#define NOINLINE __declspec(noinline)
+#elif defined(AE_COMPILER_CLANG) || defined(AE_COMPILER_GCC)
+	#define AE_STATIC_ASSERT(...) static_assert(__VA_ARGS__)
+	#define AE_DEBUGBREAK() __builtin_trap()
+	#define AE_LINE __LINE__
+
+	#define NODISCARD [[nodiscard]]
+	#define FORCEINLINE inline __attribute__((always_inline))
+	#define NOINLINE __attribute__((noinline))
 #endif // AE_COMPILER_MSVC
 
 #define AE_EXIT_UNKNOWN        -1
@@ -221,7 +260,7 @@
 	using bool32 = int;
 
 	using char8 = char;
-	using char16 = wchar_t;
+	using char16 = char16_t;
 
 #endif
 
@@ -246,20 +285,36 @@ AE_STATIC_ASSERT(sizeof(char16)  == 2, "sizeof(char16)  expected to be 16 bits!"
 
 AE_STATIC_ASSERT(sizeof(uintptr) == sizeof(void*), "sizeof(uintptr) expected to be sizeof(void*)!");
 
-#define AE_INT8_MIN   (-127i8 - 1)
-#define AE_INT16_MIN  (-32767i16 - 1)
-#define AE_INT32_MIN  (-2147483647i32 - 1)
-#define AE_INT64_MIN  (-9223372036854775807i64 - 1)
-#define AE_INT8_MAX   127i8
-#define AE_INT16_MAX  32767i16
-#define AE_INT32_MAX  2147483647i32
-#define AE_INT64_MAX  9223372036854775807i64
-#define AE_UINT8_MAX  0xffui8
-#define AE_UINT16_MAX 0xffffui16
-#define AE_UINT32_MAX 0xffffffffui32
-#define AE_UINT64_MAX 0xffffffffffffffffui64
+#ifdef AE_COMPILER_MSVC
+	#define AE_INT8_MIN   (-127i8 - 1)
+	#define AE_INT16_MIN  (-32767i16 - 1)
+	#define AE_INT32_MIN  (-2147483647i32 - 1)
+	#define AE_INT64_MIN  (-9223372036854775807i64 - 1)
+	#define AE_INT8_MAX   127i8
+	#define AE_INT16_MAX  32767i16
+	#define AE_INT32_MAX  2147483647i32
+	#define AE_INT64_MAX  9223372036854775807i64
+	#define AE_UINT8_MAX  0xffui8
+	#define AE_UINT16_MAX 0xffffui16
+	#define AE_UINT32_MAX 0xffffffffui32
+	#define AE_UINT64_MAX 0xffffffffffffffffui64
+#else
+	#define AE_INT8_MIN   ((int8)(-127 - 1))
+	#define AE_INT16_MIN  ((int16)(-32767 - 1))
+	#define AE_INT32_MIN  ((int32)(-2147483647 - 1))
+	#define AE_INT64_MIN  ((int64)(-9223372036854775807ll - 1))
+	#define AE_INT8_MAX   ((int8)127)
+	#define AE_INT16_MAX  ((int16)32767)
+	#define AE_INT32_MAX  ((int32)2147483647)
+	#define AE_INT64_MAX  ((int64)9223372036854775807ll)
+	#define AE_UINT8_MAX  ((uint8)0xffu)
+	#define AE_UINT16_MAX ((uint16)0xffffu)
+	#define AE_UINT32_MAX ((uint32)0xffffffffu)
+	#define AE_UINT64_MAX ((uint64)0xffffffffffffffffull)
+#endif // AE_COMPILER_MSVC
 
 #include <type_traits>
+#include <utility>
 
 namespace Apricot {
 
@@ -323,6 +378,12 @@ namespace Apricot {
 		return std::is_same<A, B>::value;
 	}
 
+	template<typename T>
+	NODISCARD FORCEINLINE constexpr bool8 IsTriviallyCopyable() noexcept
+	{
+		return std::is_trivially_copyable<T>::value;
+	}
+
 }
 
 #include "Char.h"
@@ -330,6 +391,8 @@ namespace Apricot {
 
 #ifdef AE_PLATFORM_WINDOWS
 	#define AE_PLATFORM TEXT("Windows")
+#elif defined(AE_PLATFORM_LINUX)
+	#define AE_PLATFORM TEXT("Linux")
 #endif
 
 #ifdef AE_CONFIG_DEBUG_GAME
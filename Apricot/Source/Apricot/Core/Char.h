@@ -18,6 +18,10 @@
 		#define AE_FILE         __FILE__
 		#define AE_FUNCTION     __FUNCTION__
 		#define AE_FUNCTION_SIG __FUNCSIG__
+	#else
+		#define AE_FILE         __FILE__
+		#define AE_FUNCTION     __FUNCTION__
+		#define AE_FUNCTION_SIG __PRETTY_FUNCTION__
 	#endif
 
 #elif AE_UNICODE
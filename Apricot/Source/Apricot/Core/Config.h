@@ -3,4 +3,109 @@
 
 #pragma once
 
-#define AEC_FLOAT_LOG_PRECISION 4
\ No newline at end of file
+#define AEC_FLOAT_LOG_PRECISION 4
+
+/**
+* Size of the address range reserved by each of the engine's frame arenas. It is the maximum size of a frame's transient allocations.
+*/
+#define AEC_FRAME_ARENA_RESERVE_SIZE (256ull * 1024 * 1024)
+
+/**
+* Memory committed by each frame arena when it is created.
+*/
+#define AEC_FRAME_ARENA_INITIAL_SIZE (2ull * 1024 * 1024)
+
+/**
+* Size of the address range reserved by each thread's scratch arena. It is the maximum size of a thread's live scratch allocations.
+*/
+#define AEC_SCRATCH_ARENA_RESERVE_SIZE (64ull * 1024 * 1024)
+
+/**
+* Memory committed by a thread's scratch arena when it is created, on the thread's first use of it.
+*/
+#define AEC_SCRATCH_ARENA_INITIAL_SIZE (64ull * 1024)
+
+/**
+* Maximum number of arenas whose allocation statistics are tracked by the memory profiler. Arenas created after the limit is reached aren't tracked.
+*/
+#define AEC_MEMORY_STATS_MAX_ARENAS 64
+
+/**
+* Mean number of bytes allocated through GMalloc between two sampled allocations. Can be changed at runtime with AMemoryProfiler::SetSamplingRate.
+*/
+#define AEC_MEMORY_SAMPLING_RATE (512ull * 1024)
+
+/**
+* Maximum depth of a sampled call stack. Deeper stacks are truncated.
+*/
+#define AEC_MEMORY_SAMPLING_MAX_FRAMES 32
+
+/**
+* Maximum number of distinct call stacks the sampler can record. Samples from new call stacks are dropped once it is reached.
+*/
+#define AEC_MEMORY_SAMPLING_MAX_STACKS 4096
+
+/**
+* Maximum number of sampled allocations that can be alive at once. Must be a power of two.
+*/
+#define AEC_MEMORY_SAMPLING_MAX_LIVE_SAMPLES 16384
+
+/**
+* Number of return addresses stored as the call site of every block registered by the leak check. 0 disables the capture of the call sites.
+*/
+#define AEC_MEMORY_LEAK_CHECK_CALL_SITE_FRAMES 6
+
+/**
+* Maximum number of leaked blocks that are logged individually at shutdown. The others only appear in the census.
+*/
+#define AEC_MEMORY_LEAK_REPORT_MAX_BLOCKS 32
+
+/**
+* Maximum number of arena debug names that can be given a memory budget.
+*/
+#define AEC_MEMORY_BUDGETS_MAX_ARENAS 32
+
+/**
+* Number of 'AMemoryBudgets::Update' calls (frames) between two polls of the process' memory usage. Reading it is a system call.
+*/
+#define AEC_MEMORY_BUDGETS_PROCESS_POLL_FRAMES 30
+
+/**
+* Maximum number of threads that can record allocations during a recording. The events of the threads started after it is reached are dropped.
+*/
+#define AEC_MEMORY_RECORDING_MAX_THREADS 256
+
+/**
+* Number of events each thread buffers before they are written to the trace file.
+*/
+#define AEC_MEMORY_RECORDING_BUFFER_EVENTS 512
+
+/**
+* Maximum number of pages that an AArenaFragmentationReport describes individually. The others are only counted in its totals.
+*/
+#define AEC_ARENA_REPORT_MAX_PAGES 64
+
+/**
+* Largest allocation served by the size-class slabs of HeapAllocator's hint heaps. Bigger allocations go to GMalloc. Must be a power of two, at least 128.
+*/
+#define AEC_HINT_HEAP_MAX_BLOCK_SIZE 1024
+
+/**
+* Size of a hint heap's slab. Every slab holds blocks of a single size class. Must be a power of two.
+*/
+#define AEC_HINT_HEAP_SLAB_SIZE (64ull * 1024)
+
+/**
+* Size of the address range reserved by each hint heap. The allocations of a hint that don't fit in it go to GMalloc.
+*/
+#define AEC_HINT_HEAP_RESERVE_SIZE (1024ull * 1024 * 1024)
+
+/**
+* Number of empty slabs that a hint heap keeps committed for reuse. The physical memory of the others is returned to the system.
+*/
+#define AEC_HINT_HEAP_MAX_EMPTY_SLABS 8
+
+/**
+* If 1, a no-allocation scope (AE_NO_ALLOC_SCOPE) that allocated from the heap asserts when it ends. Otherwise, it only logs an error.
+*/
+#define AEC_NO_ALLOC_SCOPE_ASSERT 1
@@ -150,6 +150,26 @@ namespace Apricot {
 						AE_CORE_WARN(TEXT("CrashReporter: Allocate operation triggered OutOfMemoryUnableToGrow! Couldn't allocate a new page because 'bShouldGrow' is false... RequestedSize: {}, FreeSize: {}"), MemoryState.Size, MemoryState.FreeSize);
 						break;
 					}
+					case EMemoryError::InvalidArena:
+					{
+						AE_CORE_WARN(TEXT("CrashReporter: Allocate operation triggered InvalidArena! The arena doesn't have any pages..."));
+						break;
+					}
+					case EMemoryError::InvalidSize:
+					{
+						AE_CORE_WARN(TEXT("CrashReporter: Allocate operation triggered InvalidSize! RequestedSize: {}"), MemoryState.Size);
+						break;
+					}
+					case EMemoryError::InvalidAlignment:
+					{
+						AE_CORE_WARN(TEXT("CrashReporter: Allocate operation triggered InvalidAlignment! RequestedAlignment: {}"), MemoryState.Alignment);
+						break;
+					}
+					case EMemoryError::BudgetExceeded:
+					{
+						AE_CORE_WARN(TEXT("CrashReporter: Allocate operation triggered BudgetExceeded! '{}' uses {} bytes, but its budget is {} bytes..."), MemoryState.BudgetName, MemoryState.Size, MemoryState.BudgetSize);
+						break;
+					}
 					default:
 					{
 						AE_CORE_RASSERT_NO_ENTRY();
@@ -160,6 +180,39 @@ namespace Apricot {
 			}
 			case EMemoryOperation::Free:
 			{
+				switch (ErrorFlag)
+				{
+					case EMemoryError::AlreadyFreed:
+					{
+						AE_CORE_WARN(TEXT("CrashReporter: Free operation triggered AlreadyFreed! The memory block was freed twice... Size: {}"), MemoryState.Size);
+						break;
+					}
+					case EMemoryError::PointerOutOfRange:
+					{
+						AE_CORE_WARN(TEXT("CrashReporter: Free operation triggered PointerOutOfRange! The memory block wasn't allocated by this arena... Size: {}"), MemoryState.Size);
+						break;
+					}
+					case EMemoryError::InvalidMemoryPtr:
+					{
+						AE_CORE_WARN(TEXT("CrashReporter: Free operation triggered InvalidMemoryPtr!"));
+						break;
+					}
+					case EMemoryError::InvalidSize:
+					{
+						AE_CORE_WARN(TEXT("CrashReporter: Free operation triggered InvalidSize! Size: {}"), MemoryState.Size);
+						break;
+					}
+					case EMemoryError::InvalidCall:
+					{
+						AE_CORE_WARN(TEXT("CrashReporter: Free operation triggered InvalidCall! The arena doesn't support this operation..."));
+						break;
+					}
+					default:
+					{
+						AE_CORE_RASSERT_NO_ENTRY();
+						break;
+					}
+				}
 				break;
 			}
 			case EMemoryOperation::NewPage:
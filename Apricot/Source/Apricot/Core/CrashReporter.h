@@ -32,6 +32,12 @@ namespace Apricot {
 			void* MemoryBlock = nullptr;
 
 			uint64 FreeSize = 0;
+
+			/**
+			* Set by the memory budgets. The name of the hint, arena or process whose budget was exceeded, and the budget's limit.
+			*/
+			const TChar* BudgetName = nullptr;
+			uint64 BudgetSize = 0;
 		};
 
 	public:
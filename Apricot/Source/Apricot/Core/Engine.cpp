@@ -14,6 +14,8 @@
 
 #include "Apricot/Containers/Hash.h"
 
+#include "Apricot/Profiling/MemoryBudgets.h"
+
 #include "Memory/PoolArena.h"
 #include "Memory/LinearArena.h"
 #include "Memory/StackArena.h"
@@ -52,6 +54,11 @@ namespace Apricot {
 			Timestep ts = nowTime.Seconds() - lastTime.Seconds();
 			lastTime = nowTime;
 
+			m_FrameIndex ^= 1;
+			m_FrameArenas[m_FrameIndex]->FreeAll();
+
+			AMemoryBudgets::Update();
+
 			m_LayerStack.OnUpdate(ts);
 		}
 
@@ -109,6 +116,18 @@ namespace Apricot {
 
 		ALogger::Init();
 
+		uint64 FrameArenaSize = AEC_FRAME_ARENA_INITIAL_SIZE;
+		ALinearArenaSpecification FrameArenaSpecification;
+		FrameArenaSpecification.PagesCount = 1;
+		FrameArenaSpecification.PageSizes = &FrameArenaSize;
+		FrameArenaSpecification.bUseVirtualMemory = true;
+		FrameArenaSpecification.VirtualReserveSize = AEC_FRAME_ARENA_RESERVE_SIZE;
+
+		for (uint64 Index = 0; Index < AE_ARRAY_LENGTH(m_FrameArenas); Index++)
+		{
+			m_FrameArenas[Index] = ALinearArena::Create(FrameArenaSpecification);
+		}
+
 		AE_CORE_INFO(TEXT("Engine initialization succeded!"));
 		AE_CORE_INFO(TEXT("Instance Info:"));
 		AE_CORE_INFO(TEXT("    Platform:      {}"), AE_PLATFORM);
@@ -120,6 +139,11 @@ namespace Apricot {
 
 	bool8 AEngine::OnEngineDestroy()
 	{
+		for (uint64 Index = 0; Index < AE_ARRAY_LENGTH(m_FrameArenas); Index++)
+		{
+			m_FrameArenas[Index] = NULL_SHARED;
+		}
+
 		ALogger::Destroy();
 
 		return true;
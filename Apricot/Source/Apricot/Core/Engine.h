@@ -7,6 +7,8 @@
 
 #include "LayerStack.h"
 
+#include "Memory/LinearArena.h"
+
 #include "Apricot/Events/Event.h"
 
 namespace Apricot {
@@ -38,6 +40,17 @@ namespace Apricot {
 			m_LayerStack.PushOverlay(overlay);
 		}
 
+		/**
+		* Returns the arena for the current frame's transient allocations. Allocating from it is a pointer bump and nothing has to be freed.
+		* Allocations live until the end of the next frame, so a frame can still read the data produced by the previous one.
+		*/
+		FORCEINLINE ALinearArena* GetFrameArena() { return m_FrameArenas[m_FrameIndex].Get(); }
+
+		/**
+		* Returns the arena used by the previous frame. Its allocations are released at the beginning of the next frame.
+		*/
+		FORCEINLINE ALinearArena* GetPreviousFrameArena() { return m_FrameArenas[m_FrameIndex ^ 1].Get(); }
+
 	private:
 		bool8 OnEngineInitialize(const char8* CommandLine);
 		bool8 OnEngineDestroy();
@@ -58,6 +71,13 @@ namespace Apricot {
 		LayerStack m_LayerStack;
 
 		AEventDispatchMap m_DispatchMap;
+
+		/**
+		* The double-buffered frame arenas. They are swapped, and the new current one is reset, at the beginning of every frame.
+		*/
+		TSharedPtr<ALinearArena> m_FrameArenas[2];
+
+		uint64 m_FrameIndex = 0;
 	};
 
 	extern AEngine* CreateEngine();
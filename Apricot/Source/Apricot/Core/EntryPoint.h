@@ -62,4 +62,30 @@ int WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _In_ LPS
 	return (int)ReturnCode;
 }
 
+#elif defined(AE_PLATFORM_LINUX)
+
+int main(int ArgumentsCount, char** Arguments)
+{
+	// Init foundational systems.
+	Apricot::APlatform::Init();
+	Apricot::ApricotMemoryInit();
+	Apricot::ACrashReporter::Init();
+
+	// Instantiate the engine.
+	Apricot::AEngine* Engine = Apricot::CreateEngine();
+
+	// Run the engine.
+	int32 ReturnCode = Engine->Run(ArgumentsCount > 1 ? Arguments[1] : "");
+
+	// Delete the engine.
+	Apricot::DeleteEngine(Engine);
+
+	// Destroy foundational systems.
+	Apricot::ACrashReporter::Destroy();
+	Apricot::ApricotMemoryDestroy();
+	Apricot::APlatform::Destroy();
+
+	return (int)ReturnCode;
+}
+
 #endif
\ No newline at end of file
@@ -13,6 +13,12 @@ namespace Apricot {
 
 		Heap,
 
+		LinearArena,
+		StackArena,
+		PoolArena,
+		FreelistArena,
+		BuddyArena,
+
 		MaxEnumValue
 	};
 
@@ -5,9 +5,13 @@
 #include "ApricotMemory.h"
 
 #include "HeapAllocator.h"
+#include "ScratchArena.h"
 
 #include "Apricot/Core/Platform.h"
 
+#include "Apricot/Profiling/AllocationRecorder.h"
+#include "Apricot/Profiling/AllocationRegistry.h"
+#include "Apricot/Profiling/MemoryBudgets.h"
 #include "Apricot/Profiling/MemoryProfiler.h"
 
 namespace Apricot {
@@ -34,10 +38,18 @@ namespace Apricot {
 
 	APRICOT_API void ApricotMemoryDestroy()
 	{
+		// The other threads destroy their scratch arenas when they exit.
+		DestroyScratchArena();
+
 	#ifdef AE_ENABLE_MEMORY_TRACE
 		AMemoryProfiler::Destroy();
 	#endif
 
+	#ifdef AE_ENABLE_MEMORY_RECORDING
+		// The events that are still buffered would be lost otherwise.
+		AAllocationRecorder::Stop();
+	#endif
+
 		if (GHeapAllocator)
 		{
 			MemDelete<HeapAllocator>(GHeapAllocator);
@@ -51,6 +63,12 @@ namespace Apricot {
 			GMalloc = nullptr;
 		}
 
+	#ifdef AE_ENABLE_MEMORY_LEAK_CHECK
+		// Everything the engine allocated should be freed by now, including GMalloc itself.
+		AAllocationRegistry::ReportOutstandingBlocks();
+		AAllocationRegistry::Destroy();
+	#endif
+
 		APlatform::Destroy();
 	}
 
@@ -120,6 +138,246 @@ namespace Apricot {
 		APlatform::Free(Allocation, Size);
 	}
 
+	void* AMalloc::Realloc(void* Allocation, uint64 OldSize, uint64 NewSize, uint64 Alignment /*= sizeof(void*)*/)
+	{
+		return APlatform::Realloc(Allocation, OldSize, NewSize, Alignment);
+	}
+
+	bool8 AMalloc::Expand(void* Allocation, uint64 OldSize, uint64 NewSize)
+	{
+		return APlatform::Expand(Allocation, OldSize, NewSize);
+	}
+
+	AMemoryArena::AMemoryArena(bool8 bIsThreadSafe /*= false*/)
+		: m_bIsThreadSafe(bIsThreadSafe)
+	{
+	#ifdef AE_ENABLE_MEMORY_RECORDING
+		m_RecordingId = AAllocationRecorder::GenerateArenaId();
+	#endif
+	}
+
+	AMemoryArena::~AMemoryArena()
+	{
+	#ifdef AE_ENABLE_MEMORY_STATS
+		if (m_bIsStatsRegistered.Load(EMemoryOrder::Relaxed))
+		{
+			AMemoryProfiler::UnregisterArena(this);
+		}
+	#endif
+	}
+
+	AArenaPosition AMemoryArena::GetPosition() const
+	{
+		switch (m_FailureMode)
+		{
+			case AMemoryArena::EFailureMode::Assert:
+				AE_CORE_RASSERT_NO_ENTRY();
+				break;
+			case AMemoryArena::EFailureMode::Error:
+				AE_CORE_WARN(TEXT("The '{}' arena doesn't support positions!"), GetDebugName());
+				break;
+			case AMemoryArena::EFailureMode::Ignore:
+				// The default position is returned, so rewinding to it does nothing.
+				break;
+			default:
+				break;
+		}
+		return AArenaPosition();
+	}
+
+	void AMemoryArena::RewindTo(const AArenaPosition& Position)
+	{
+		switch (m_FailureMode)
+		{
+			case AMemoryArena::EFailureMode::Assert:
+				AE_CORE_RASSERT_NO_ENTRY();
+				break;
+			case AMemoryArena::EFailureMode::Error:
+				AE_CORE_WARN(TEXT("The '{}' arena can't be rewound!"), GetDebugName());
+				break;
+			case AMemoryArena::EFailureMode::Ignore:
+				// The arena is left as it is.
+				break;
+			default:
+				break;
+		}
+	}
+
+	void AMemoryArena::ClaimOwnership()
+	{
+		m_OwnerThreadId.Store(APlatform::GetCurrentThreadId(), EMemoryOrder::Relaxed);
+	}
+
+	bool8 AMemoryArena::IsRemoteThread() const
+	{
+		const uint64 OwnerThreadId = m_OwnerThreadId.Load(EMemoryOrder::Relaxed);
+		return OwnerThreadId != 0 && OwnerThreadId != APlatform::GetCurrentThreadId();
+	}
+
+	void AMemoryArena::BeginOwnerAllocation()
+	{
+		const uint64 ThreadId = APlatform::GetCurrentThreadId();
+		const uint64 OwnerThreadId = m_OwnerThreadId.Load(EMemoryOrder::Relaxed);
+
+		if (OwnerThreadId == 0)
+		{
+			m_OwnerThreadId.Store(ThreadId, EMemoryOrder::Relaxed);
+		}
+		else if (OwnerThreadId != ThreadId)
+		{
+			// Draining here would only push the frees back on the stack, as they are freed from a remote thread.
+			AE_CORE_ASSERT(OwnerThreadId == ThreadId, TEXT("Only the owner thread can allocate from the '{}' arena! Call 'ClaimOwnership' after handing it to another thread."), GetDebugName());
+			return;
+		}
+
+		if (HasRemoteFrees())
+		{
+			DrainRemoteFrees();
+		}
+	}
+
+	void AMemoryArena::PushRemoteFree(void* Allocation, uint64 Size)
+	{
+		ARemoteFreeNode* Node = (ARemoteFreeNode*)Allocation;
+		Node->Size = Size;
+
+		// The release publishes the node's content to the owner, which takes the stack with an acquire.
+		ARemoteFreeNode* Head = m_RemoteFrees.Load(EMemoryOrder::Relaxed);
+		do
+		{
+			Node->Next = Head;
+		} while (!m_RemoteFrees.CompareExchange(Head, Node, EMemoryOrder::Release));
+	}
+
+	void AMemoryArena::TakeFragmentationReport(AArenaFragmentationReport& OutReport) const
+	{
+		OutReport = {};
+		OutReport.TotalBytes = GetTotalSize();
+	}
+
+#ifdef AE_ENABLE_MEMORY_STATS
+	void AMemoryArena::RegisterStats()
+	{
+		// Only the thread that flips the flag registers the arena, in case multiple threads allocate for the first time at once.
+		if (!m_bIsStatsRegistered.Exchange(true, EMemoryOrder::Relaxed))
+		{
+			AMemoryProfiler::RegisterArena(this, GetDebugName(), &m_Stats);
+
+		#ifdef AE_ENABLE_MEMORY_BUDGETS
+			if (!m_BudgetState.IsSet())
+			{
+				AMemoryBudgets::ApplyArenaBudget(this, m_BudgetState);
+			}
+		#endif
+		}
+	}
+#endif
+
+	void AMemoryArena::SetBudget(uint64 LimitBytes, uint64 WarningBytes /*= 0*/)
+	{
+	#ifdef AE_ENABLE_MEMORY_BUDGETS
+		m_bHasOwnBudget.Store(true, EMemoryOrder::Relaxed);
+		m_BudgetState.Set(LimitBytes, WarningBytes);
+	#endif
+	}
+
+#ifdef AE_ENABLE_MEMORY_BUDGETS
+	void AMemoryArena::SetNamedBudget(uint64 LimitBytes, uint64 WarningBytes)
+	{
+		if (!m_bHasOwnBudget.Load(EMemoryOrder::Relaxed))
+		{
+			m_BudgetState.Set(LimitBytes, WarningBytes);
+		}
+	}
+#endif
+
+#ifdef AE_ENABLE_MEMORY_BUDGETS
+	void AMemoryArena::SubmitBudgetUsage(uint64 UsedBytes)
+	{
+		AMemoryBudgets::SubmitArenaUsage(this, m_BudgetState, UsedBytes);
+	}
+#endif
+
+	namespace Utils {
+
+		FORCEINLINE static uint64 GetArenaMemoryGranularity(const AArenaMemoryOptions& Options)
+		{
+			return Options.bUseHugePages ? APlatform::GetHugePageSize() : APlatform::GetPageSize();
+		}
+
+	}
+
+	APRICOT_API void* AllocateArenaMemory(uint64 Size, const AArenaMemoryOptions& Options)
+	{
+		if (Options.IsDefault())
+		{
+			return GMalloc->Alloc(Size);
+		}
+
+		uint64 Granularity = Utils::GetArenaMemoryGranularity(Options);
+		Size += GetAlignmentOffset(Size, Granularity);
+
+		void* MemoryBlock = nullptr;
+		if (Options.bUseHugePages)
+		{
+			MemoryBlock = APlatform::AllocateHugePages(Size);
+		}
+		else
+		{
+			MemoryBlock = APlatform::Reserve(Size);
+			if (MemoryBlock && !APlatform::Commit(MemoryBlock, Size))
+			{
+				APlatform::Release(MemoryBlock, Size);
+				MemoryBlock = nullptr;
+			}
+		}
+
+		if (MemoryBlock)
+		{
+			PrepareArenaMemory(MemoryBlock, Size, Options);
+		}
+		return MemoryBlock;
+	}
+
+	APRICOT_API void FreeArenaMemory(void* MemoryBlock, uint64 Size, const AArenaMemoryOptions& Options)
+	{
+		if (Options.IsDefault())
+		{
+			GMalloc->Free(MemoryBlock, Size);
+			return;
+		}
+
+		if (!MemoryBlock)
+		{
+			return;
+		}
+
+		Size += GetAlignmentOffset(Size, Utils::GetArenaMemoryGranularity(Options));
+		if (Options.bLockMemory)
+		{
+			APlatform::Unlock(MemoryBlock, Size);
+		}
+		APlatform::Release(MemoryBlock, Size);
+	}
+
+	APRICOT_API void PrepareArenaMemory(void* MemoryBlock, uint64 Size, const AArenaMemoryOptions& Options)
+	{
+		if (Options.bLockMemory)
+		{
+			// Locking also faults the range in.
+			if (APlatform::Lock(MemoryBlock, Size))
+			{
+				return;
+			}
+			AE_CORE_WARN(TEXT("Failed to lock {} bytes of arena memory! The locked memory limit of the process might be too low."), Size);
+		}
+
+		if (Options.bPrefault || Options.bLockMemory)
+		{
+			APlatform::Prefault(MemoryBlock, Size);
+		}
+	}
+
 	APRICOT_API void MemCpy(void* Destination, const void* Source, uint64 SizeBytes)
 	{
 		APlatform::MemCpy(Destination, Source, SizeBytes);
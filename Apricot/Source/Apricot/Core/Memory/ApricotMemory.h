@@ -5,8 +5,16 @@
 
 #include "Apricot/Core/Base.h"
 
+#include "Apricot/Profiling/AllocationRecorder.h"
+#include "Apricot/Profiling/MemoryProfiler.h"
+#include "Apricot/Profiling/NoAllocScope.h"
+
 #include <new>
 
+#ifdef AE_COMPILER_MSVC
+	#include <intrin.h>
+#endif
+
 #define AE_MEMZERO_STRUCT(Struct) { ::Apricot::MemZero( &Struct, sizeof(  Struct )); }
 #define AE_MEMZERO_ARRAY(Array)   { ::Apricot::MemZero(  Array,  sizeof(  Array  )); }
 #define AE_MEMZERO_PTR(Ptr)       { ::Apricot::MemZero(  Ptr,    sizeof( *Ptr    )); }
@@ -47,6 +55,7 @@ namespace Apricot {
 		InvalidMemoryPtr        = InvalidAlignment        - 1,
 		InvalidOuterPointer     = InvalidMemoryPtr        - 1,
 		InvalidCall             = InvalidOuterPointer     - 1,
+		BudgetExceeded          = InvalidCall             - 1,
 	};
 
 	/**
@@ -71,6 +80,20 @@ namespace Apricot {
 		void Free(void* Allocation, uint64 Size);
 		int32 TryFree(void* Allocation, uint64 Size);
 		void FreeUnsafe(void* Allocation, uint64 Size);
+
+		/**
+		* Resizes the allocation, preserving its content. Grows it in place when possible.
+		* 
+		* @returns The resized allocation, or nullptr on failure (the old allocation stays valid).
+		*/
+		NODISCARD void* Realloc(void* Allocation, uint64 OldSize, uint64 NewSize, uint64 Alignment = sizeof(void*));
+
+		/**
+		* Grows the allocation in place.
+		* 
+		* @returns True on success. On failure, the allocation is left untouched.
+		*/
+		NODISCARD bool8 Expand(void* Allocation, uint64 OldSize, uint64 NewSize);
 	};
 
 	APRICOT_API extern AMalloc* GMalloc;
@@ -79,6 +102,77 @@ namespace Apricot {
 	APRICOT_API void MemSet(void* Destination, int32 Value, uint64 SizeBytes);
 	APRICOT_API void MemZero(void* Destination, uint64 SizeBytes);
 
+	/**
+	* Returns the index of the least significant set bit. 'Value' must not be 0.
+	*/
+	FORCEINLINE uint32 FindFirstSetBit(uint64 Value)
+	{
+	#ifdef AE_COMPILER_MSVC
+		unsigned long Index;
+		_BitScanForward64(&Index, Value);
+		return (uint32)Index;
+	#else
+		return (uint32)__builtin_ctzll(Value);
+	#endif
+	}
+
+	/**
+	* Returns the index of the most significant set bit. 'Value' must not be 0.
+	*/
+	FORCEINLINE uint32 FindLastSetBit(uint64 Value)
+	{
+	#ifdef AE_COMPILER_MSVC
+		unsigned long Index;
+		_BitScanReverse64(&Index, Value);
+		return (uint32)Index;
+	#else
+		return 63u - (uint32)__builtin_clzll(Value);
+	#endif
+	}
+
+	FORCEINLINE constexpr bool8 IsPowerOfTwo(uint64 Value)
+	{
+		return Value != 0 && (Value & (Value - 1)) == 0;
+	}
+
+	/**
+	* Describes how the backing memory of an arena's pages is obtained from the system.
+	* With the default options, the pages are allocated from GMalloc.
+	*/
+	struct AArenaMemoryOptions
+	{
+		/**
+		* If true, the pages are backed by huge pages (2 MiB on most platforms), which reduces the TLB pressure of big arenas.
+		* Falls back to transparent huge pages, or to regular pages, if the system can't provide them.
+		*/
+		bool bUseHugePages = false;
+
+		/**
+		* If true, the pages are backed by physical memory when they are allocated (or committed), instead of on first touch.
+		*/
+		bool bPrefault = false;
+
+		/**
+		* If true, the pages are locked in physical memory, so they are never paged out. Implies 'bPrefault'.
+		*/
+		bool bLockMemory = false;
+
+		FORCEINLINE bool8 IsDefault() const { return !bUseHugePages && !bPrefault && !bLockMemory; }
+	};
+
+	/**
+	* Allocates the backing memory of an arena page. With non-default options, the memory is obtained directly from the system.
+	* The memory must be freed with 'FreeArenaMemory', using the same size and options.
+	*/
+	APRICOT_API NODISCARD void* AllocateArenaMemory(uint64 Size, const AArenaMemoryOptions& Options);
+
+	APRICOT_API void FreeArenaMemory(void* MemoryBlock, uint64 Size, const AArenaMemoryOptions& Options);
+
+	/**
+	* Prefaults and locks an already committed range, as the options require. Used by the virtual memory arenas.
+	*/
+	APRICOT_API void PrepareArenaMemory(void* MemoryBlock, uint64 Size, const AArenaMemoryOptions& Options);
+
 	template<typename T, typename... Args>
 	constexpr T* MemConstruct(void* Destination, Args&&... args)
 	{
@@ -99,6 +193,77 @@ namespace Apricot {
 		GMalloc->Free(object, size == 0 ? sizeof(T) : size);
 	}
 
+	/**
+	* A point in the allocation history of a linear or stack arena. The arena can be rewound to it, which frees everything
+	*	that was allocated afterwards. Obtained from 'AMemoryArena::GetPosition'.
+	*/
+	struct AArenaPosition
+	{
+		uint64 PageIndex = 0;
+		uint64 AllocatedBytes = 0;
+
+	#ifdef AE_ENABLE_MEMORY_STATS
+		uint64 StatsLiveBytes = 0;
+		uint64 StatsLiveAllocationsCount = 0;
+	#endif
+	};
+
+	/**
+	* Occupancy of a single arena page.
+	*/
+	struct AArenaPageReport
+	{
+		uint64 SizeBytes = 0;
+
+		/**
+		* The bytes given to the allocations, padding included.
+		*/
+		uint64 AllocatedBytes = 0;
+
+		/**
+		* The unused end of a page that a linear or stack arena left behind when it moved to the next page.
+		* It can't be used again until the arena is rewound or freed.
+		*/
+		uint64 TailWasteBytes = 0;
+	};
+
+	/**
+	* Structured report of an arena's memory usage, filled by 'AMemoryArena::TakeFragmentationReport'.
+	* It is plain data with a fixed size, so it can be kept around and sent to a telemetry backend as it is.
+	* Only the first AEC_ARENA_REPORT_MAX_PAGES pages are described individually, but all of them are counted in the totals.
+	*/
+	struct AArenaFragmentationReport
+	{
+		static constexpr uint64 MaxPagesCount = AEC_ARENA_REPORT_MAX_PAGES;
+
+		uint64 TotalBytes = 0;
+		uint64 AllocatedBytes = 0;
+
+		/**
+		* The bytes that can still be allocated without growing, even if they aren't contiguous.
+		*/
+		uint64 FreeBytes = 0;
+
+		/**
+		* The bytes allocated beyond the requested sizes: alignment padding, allocation headers and the unused ends of pool chunks.
+		* Computed from the arena's statistics, so it is always 0 when AE_ENABLE_MEMORY_STATS isn't defined.
+		*/
+		uint64 PaddingBytes = 0;
+
+		/**
+		* Sum of the pages' tail waste.
+		*/
+		uint64 TailWasteBytes = 0;
+
+		/**
+		* Number of the arena's pages. Might be bigger than MaxPagesCount.
+		*/
+		uint64 PagesCount = 0;
+		AArenaPageReport Pages[MaxPagesCount];
+
+		FORCEINLINE float32 GetOccupancy() const { return TotalBytes > 0 ? (float32)AllocatedBytes / (float32)TotalBytes : 0.0f; }
+	};
+
 	/**
 	* 
 	*/
@@ -113,17 +278,342 @@ namespace Apricot {
 		};
 
 	public:
-		virtual ~AMemoryArena() = default;
+		AMemoryArena(bool8 bIsThreadSafe = false);
+		virtual ~AMemoryArena();
 
 		virtual void GarbageCollect() = 0;
 
 		virtual const TChar* GetDebugName() const = 0;
 
+		/**
+		* Returns the size of all the arena's pages, which is the memory it holds from the system.
+		*/
+		virtual uint64 GetTotalSize() const = 0;
+
+		/**
+		* Returns the current position of the arena. Only the linear and stack arenas support positions, the others
+		*	issue an error based on the EFailureMode and return an empty position.
+		*/
+		virtual AArenaPosition GetPosition() const;
+
+		/**
+		* Frees everything allocated after 'Position', even from the pages that were added since. The pages are kept.
+		* Rewinding a stack arena that already freed past the position corrupts it.
+		*/
+		virtual void RewindTo(const AArenaPosition& Position);
+
+		/**
+		* Fills the report with the arena's cached sizes and the occupancy of each page. It walks the pages, but never the allocations,
+		*	so it is cheap enough to be taken every frame. The arenas that don't override it only report their total size.
+		*/
+		virtual void TakeFragmentationReport(AArenaFragmentationReport& OutReport) const;
+
 		FORCEINLINE EFailureMode GetFailureMode() const { return m_FailureMode; }
 		FORCEINLINE void SetFailureMode(EFailureMode FailureMode) { m_FailureMode = FailureMode; }
 
+		/**
+		* Returns true if multiple threads can allocate from the arena at the same time.
+		*/
+		FORCEINLINE bool8 IsThreadSafe() const { return m_bIsThreadSafe; }
+
+		/**
+		* Makes the calling thread the owner of the arena. Until then, the arena is owned by the first thread that allocates from it,
+		*	so an arena that is created on one thread and only used by another doesn't need to be claimed.
+		* The arenas that aren't thread-safe but can free (pool, freelist and buddy) accept frees from the other threads: they are pushed
+		*	on a lock-free stack and applied by the owner in a batch, on its next allocation.
+		* Only the owner may allocate, so an arena that is handed to another thread must be claimed by it. Must not be called while
+		*	other threads use the arena.
+		*/
+		void ClaimOwnership();
+
+		/**
+		* Applies the frees that the other threads deferred to the owner. Does nothing when called by a thread other than the owner.
+		* The allocations already do it, so it is only needed before the arena is inspected or garbage collected.
+		* The arenas that don't accept remote frees do nothing.
+		*/
+		virtual void DrainRemoteFrees() {}
+
+	#ifdef AE_ENABLE_MEMORY_STATS
+		FORCEINLINE const AAllocationStats& GetStats() const { return m_Stats; }
+	#endif
+
+		/**
+		* Sets the budget of the arena's used bytes, replacing the one registered for its debug name (see AMemoryBudgets).
+		* An exceeded limit is reported through the crash reporter and then handled based on the EFailureMode. 0 disables a threshold.
+		* Does nothing if AE_ENABLE_MEMORY_BUDGETS isn't defined.
+		*/
+		void SetBudget(uint64 LimitBytes, uint64 WarningBytes = 0);
+
+	#ifdef AE_ENABLE_MEMORY_BUDGETS
+		FORCEINLINE const AMemoryBudgetState& GetBudgetState() const { return m_BudgetState; }
+
+		/**
+		* Applies the budget registered for the arena's debug name. Ignored if the arena was given its own budget through 'SetBudget'.
+		* Called by AMemoryBudgets, when the budget of the debug name is set.
+		*/
+		void SetNamedBudget(uint64 LimitBytes, uint64 WarningBytes);
+	#endif
+
+	protected:
+		/**
+		* Updates the allocation statistics of the arena and records the allocation, if a recording is running.
+		* Compiled out when neither AE_ENABLE_MEMORY_STATS nor AE_ENABLE_MEMORY_RECORDING is defined.
+		* The arena is registered to the memory profiler on its first allocation, when it is surely fully constructed.
+		*/
+		FORCEINLINE void SubmitAllocationStats(void* Allocation, uint64 Size, uint64 Alignment)
+		{
+		#ifdef AE_ENABLE_MEMORY_RECORDING
+			AAllocationRecorder::RecordAllocation(m_RecordingId, Allocation, Size, Alignment);
+		#endif
+
+		#ifdef AE_ENABLE_MEMORY_STATS
+			if (!m_bIsStatsRegistered.Load(EMemoryOrder::Relaxed))
+			{
+				RegisterStats();
+			}
+
+			if (m_bIsThreadSafe)
+			{
+				m_Stats.SubmitAllocation(Size);
+			}
+			else
+			{
+				m_Stats.SubmitAllocationExclusive(Size);
+				m_LiveAllocationsCount++;
+			}
+		#endif
+
+			CheckBudget();
+		}
+
+		FORCEINLINE void SubmitDeallocationStats(void* Allocation, uint64 Size)
+		{
+		#ifdef AE_ENABLE_MEMORY_RECORDING
+			AAllocationRecorder::RecordDeallocation(m_RecordingId, Allocation, Size);
+		#endif
+
+		#ifdef AE_ENABLE_MEMORY_STATS
+			if (m_bIsThreadSafe)
+			{
+				m_Stats.SubmitDeallocation(Size);
+			}
+			else
+			{
+				m_Stats.SubmitDeallocationExclusive(Size);
+				m_LiveAllocationsCount--;
+			}
+		#endif
+
+			CheckBudget();
+		}
+
+		FORCEINLINE void SubmitDeallocationOfAllStats()
+		{
+		#ifdef AE_ENABLE_MEMORY_RECORDING
+			AAllocationRecorder::RecordDeallocationOfAll(m_RecordingId);
+		#endif
+
+		#ifdef AE_ENABLE_MEMORY_STATS
+			m_Stats.SubmitDeallocationOfAll();
+			m_LiveAllocationsCount = 0;
+		#endif
+
+			CheckBudget();
+		}
+
+		/**
+		* Records the statistics in the position, so that a rewind can restore them. Only used by arenas that aren't thread-safe.
+		*/
+		FORCEINLINE void CapturePositionStats(AArenaPosition& Position) const
+		{
+		#ifdef AE_ENABLE_MEMORY_STATS
+			Position.StatsLiveBytes = m_Stats.GetLiveBytes();
+			Position.StatsLiveAllocationsCount = m_LiveAllocationsCount;
+		#endif
+		}
+
+		FORCEINLINE void SubmitRewindStats(const AArenaPosition& Position)
+		{
+		#if defined(AE_ENABLE_MEMORY_RECORDING) && defined(AE_ENABLE_MEMORY_STATS)
+			// The position only knows the live bytes it was taken at when the statistics are enabled.
+			AAllocationRecorder::RecordRewind(m_RecordingId, Position.StatsLiveBytes);
+		#endif
+
+		#ifdef AE_ENABLE_MEMORY_STATS
+			// The allocations freed inside the marked range were already counted by their deallocation.
+			m_Stats.SubmitRewindExclusive(Position.StatsLiveBytes, m_LiveAllocationsCount - Position.StatsLiveAllocationsCount);
+			m_LiveAllocationsCount = Position.StatsLiveAllocationsCount;
+		#endif
+
+			CheckBudget();
+		}
+
+		/**
+		* Records an allocation that was moved by a compaction, as a free followed by an allocation. The statistics don't change.
+		*/
+		FORCEINLINE void SubmitRelocation(void* OldAllocation, void* NewAllocation, uint64 Size, uint64 Alignment)
+		{
+		#ifdef AE_ENABLE_MEMORY_RECORDING
+			AAllocationRecorder::RecordDeallocation(m_RecordingId, OldAllocation, Size);
+			AAllocationRecorder::RecordAllocation(m_RecordingId, NewAllocation, Size, Alignment);
+		#endif
+		}
+
+		/**
+		* Returns the difference between the bytes the arena gave to the allocations and the bytes they requested.
+		*/
+		FORCEINLINE uint64 GetPaddingBytes(uint64 AllocatedBytes) const
+		{
+		#ifdef AE_ENABLE_MEMORY_STATS
+			uint64 LiveBytes = m_Stats.GetLiveBytes();
+			return AllocatedBytes > LiveBytes ? AllocatedBytes - LiveBytes : 0;
+		#else
+			return 0;
+		#endif
+		}
+
+		/**
+		* A block freed by a thread that doesn't own the arena. The node is stored in the block itself.
+		*/
+		struct ARemoteFreeNode
+		{
+			ARemoteFreeNode* Next;
+			uint64 Size;
+		};
+
+		/**
+		* Returns true if the calling thread isn't the owner of the arena, so its frees must be deferred.
+		* Always false while the arena has no owner.
+		*/
+		bool8 IsRemoteThread() const;
+
+		/**
+		* Called at the beginning of the allocations of the arenas that accept remote frees. The calling thread claims the arena if it
+		*	has no owner yet, then applies the pending remote frees.
+		* An allocation from another thread asserts and doesn't drain, because its own frees would then be deferred to an owner
+		*	that might never allocate again.
+		*/
+		void BeginOwnerAllocation();
+
+		/**
+		* Pushes a block on the remote-free stack. Lock-free, so the freeing thread never waits for the owner.
+		* The block must be at least sizeof(ARemoteFreeNode) bytes.
+		*/
+		void PushRemoteFree(void* Allocation, uint64 Size);
+
+		FORCEINLINE bool8 HasRemoteFrees() const { return m_RemoteFrees.Load(EMemoryOrder::Relaxed) != nullptr; }
+
+		/**
+		* Takes the whole remote-free stack at once. The owner is the only thread that pops, so the stack can't suffer from ABA.
+		*/
+		FORCEINLINE ARemoteFreeNode* TakeRemoteFrees() { return m_RemoteFrees.Exchange(nullptr, EMemoryOrder::Acquire); }
+
+		/**
+		* Checks the used bytes against the budget's cached bounds. Compiled out when AE_ENABLE_MEMORY_BUDGETS isn't defined.
+		*/
+		FORCEINLINE void CheckBudget()
+		{
+		#ifdef AE_ENABLE_MEMORY_BUDGETS
+			uint64 UsedBytes = m_Stats.GetLiveBytes();
+			if (m_BudgetState.NeedsUpdate(UsedBytes))
+			{
+				SubmitBudgetUsage(UsedBytes);
+			}
+		#endif
+		}
+
+	private:
+	#ifdef AE_ENABLE_MEMORY_STATS
+		void RegisterStats();
+	#endif
+
+	#ifdef AE_ENABLE_MEMORY_BUDGETS
+		void SubmitBudgetUsage(uint64 UsedBytes);
+	#endif
+
 	protected:
 		EFailureMode m_FailureMode = EFailureMode::Ignore;
+
+		const bool8 m_bIsThreadSafe;
+
+	private:
+		/**
+		* The thread that applies the remote frees, or 0 until the arena is claimed. See 'ClaimOwnership'.
+		*/
+		TAtomic<uint64> m_OwnerThreadId = 0;
+
+		TAtomic<ARemoteFreeNode*> m_RemoteFrees = nullptr;
+
+	private:
+	#ifdef AE_ENABLE_MEMORY_STATS
+		AAllocationStats m_Stats;
+		TAtomic<bool8> m_bIsStatsRegistered = false;
+
+		/**
+		* Only counted by the arenas that aren't thread-safe, which are the only ones that can be rewound.
+		*/
+		uint64 m_LiveAllocationsCount = 0;
+	#endif
+
+	#ifdef AE_ENABLE_MEMORY_BUDGETS
+		AMemoryBudgetState m_BudgetState;
+
+		/**
+		* Set by 'SetBudget', so that the budget of the debug name doesn't replace the arena's own.
+		*/
+		TAtomic<bool8> m_bHasOwnBudget = false;
+	#endif
+
+	#ifdef AE_ENABLE_MEMORY_RECORDING
+		/**
+		* Identifies the arena's events in the allocation traces.
+		*/
+		uint16 m_RecordingId;
+	#endif
+	};
+
+	/**
+	* Records the position of a linear or stack arena and rewinds the arena to it when it goes out of scope.
+	* Everything allocated from the arena during the mark's lifetime is freed at once, no matter how many pages it spans.
+	*
+	*	{
+	*		AArenaMark Mark(GetScratchArena());
+	*		void* Temporary = GetScratchArena()->Alloc(Size);
+	*		...
+	*	} // 'Temporary' is freed here.
+	*/
+	class AArenaMark
+	{
+	public:
+		AArenaMark(AMemoryArena* Arena)
+			: m_Arena(Arena), m_Position(Arena->GetPosition()) {}
+
+		~AArenaMark()
+		{
+			if (m_Arena)
+			{
+				m_Arena->RewindTo(m_Position);
+			}
+		}
+
+		AArenaMark(const AArenaMark&) = delete;
+		AArenaMark& operator=(const AArenaMark&) = delete;
+
+		/**
+		* Frees everything allocated since the mark was created. The mark stays active.
+		*/
+		FORCEINLINE void Rewind() { m_Arena->RewindTo(m_Position); }
+
+		/**
+		* Keeps the allocations made since the mark was created. The mark doesn't rewind the arena anymore.
+		*/
+		FORCEINLINE void Release() { m_Arena = nullptr; }
+
+		FORCEINLINE const AArenaPosition& GetPosition() const { return m_Position; }
+
+	private:
+		AMemoryArena* m_Arena;
+		AArenaPosition m_Position;
 	};
 
 	enum class EAllocStrategy : uint8
@@ -0,0 +1,115 @@
+// Part of Apricot Engine. 2022-2022.
+// Module: Memory
+
+#pragma once
+
+#include "ApricotAllocator.h"
+#include "LinearArena.h"
+#include "StackArena.h"
+#include "PoolArena.h"
+#include "FreelistArena.h"
+#include "BuddyArena.h"
+
+#include "Apricot/Core/UUID.h"
+
+namespace Apricot {
+
+	/**
+	* C++ Core Engine Architecture
+	*
+	* Adapter that lets a memory arena be the 'AllocatorType' of the containers (TVector, THashMap, TString), with the same interface
+	*	as HeapAllocator. The containers store a pointer to the adapter, so it must outlive them. The hints are ignored, because the
+	*	arena's statistics already track its allocations.
+	*
+	* Linear and stack arenas can't free arbitrary blocks, so their adapters never free anything. The containers' memory is
+	*	reclaimed all at once, by 'FreeAll' or by rewinding an AArenaMark. This is meant for frame-scoped containers:
+	*
+	*	AArenaMark Mark(FrameArena.Get());
+	*	ALinearArenaAllocator FrameAllocator(FrameArena.Get());
+	*	TVector<ADrawCommand, ALinearArenaAllocator> Commands(&FrameAllocator, 256);
+	*
+	* Pool, freelist and buddy arenas free the blocks as the heap does. A pool arena can only hold blocks as big as its chunks.
+	*
+	* There is no default arena, so 'GetDefault' returns nullptr and the containers must always be given the adapter explicitly.
+	*/
+	template<typename ArenaType, EAllocatorType AllocatorType>
+	class TArenaAllocator
+	{
+	public:
+		static constexpr bool8 bCanFreeBlocks = AllocatorType == EAllocatorType::PoolArena || AllocatorType == EAllocatorType::FreelistArena ||
+			AllocatorType == EAllocatorType::BuddyArena;
+
+	public:
+		static TArenaAllocator* GetDefault() { return nullptr; }
+
+	public:
+		explicit TArenaAllocator(ArenaType* Arena)
+			: m_Arena(Arena)
+		{
+		}
+
+		TArenaAllocator(const TArenaAllocator&) = delete;
+		TArenaAllocator& operator=(const TArenaAllocator&) = delete;
+
+	public:
+		UUID GetUUID() const { return m_UUID; }
+		static EAllocatorType GetStaticType() { return AllocatorType; }
+
+		FORCEINLINE ArenaType* GetArena() const { return m_Arena; }
+
+	public:
+		void* Alloc(uint64 size, EAllocatorHint hint)
+		{
+			if (size == 0)
+			{
+				return nullptr;
+			}
+			return m_Arena->Alloc(size);
+		}
+
+		/**
+		* Resizes the block, preserving its content. Returns nullptr on failure, leaving the old block valid.
+		* The arenas can't resize blocks, so the content is always copied to a new block.
+		*/
+		void* Realloc(void* oldBlock, uint64 oldSize, uint64 size, EAllocatorHint hint)
+		{
+			void* block = Alloc(size, hint);
+			if (block && oldBlock)
+			{
+				MemCpy(block, oldBlock, oldSize < size ? oldSize : size);
+				Free(oldBlock, oldSize, hint);
+			}
+			return block;
+		}
+
+		/**
+		* The arenas can't grow blocks in place, so it always returns nullptr.
+		*/
+		void* ExpandBlock(void* block, uint64 oldSize, uint64 newSize, EAllocatorHint hint)
+		{
+			return nullptr;
+		}
+
+		void Free(void* block, uint64 size, EAllocatorHint hint)
+		{
+			if constexpr (bCanFreeBlocks)
+			{
+				if (block)
+				{
+					m_Arena->Free(block, size);
+				}
+			}
+		}
+
+	private:
+		ArenaType* m_Arena = nullptr;
+		UUID m_UUID;
+	};
+
+	using ALinearArenaAllocator   = TArenaAllocator<ALinearArena, EAllocatorType::LinearArena>;
+	using AStackArenaAllocator    = TArenaAllocator<AStackArena, EAllocatorType::StackArena>;
+	using APoolArenaAllocator     = TArenaAllocator<APoolArena, EAllocatorType::PoolArena>;
+	using AFreelistArenaAllocator = TArenaAllocator<AFreelistArena, EAllocatorType::FreelistArena>;
+	using ABuddyArenaAllocator    = TArenaAllocator<ABuddyArena, EAllocatorType::BuddyArena>;
+
+}
@@ -0,0 +1,178 @@
+// Part of Apricot Engine. 2022-2022.
+// Module: Memory
+
+#include "aepch.h"
+#include "ArenaSnapshot.h"
+
+namespace Apricot {
+
+	/**
+	* The beginning of a snapshot file. The arena's page follows it.
+	*/
+	struct AArenaSnapshotHeader
+	{
+		uint64 Magic;
+		uint32 Version;
+
+		/**
+		* The layout the snapshot was built with. The data is read as it is, so it can't be read by a build with another layout.
+		*/
+		uint16 PointerSize;
+		uint16 PageHeaderSize;
+
+		uint64 CapacityBytes;
+
+		/**
+		* Offset of the root allocation from the beginning of the file. 0 if there is no root.
+		*/
+		uint64 RootOffset;
+	};
+
+	namespace Utils {
+
+		/**
+		* "AESNAPSH", in little endian.
+		*/
+		static constexpr uint64 SnapshotMagic = 0x485350414E534541ull;
+		static constexpr uint32 SnapshotVersion = 1;
+
+		/**
+		* Offset of the arena's memory in the file.
+		*/
+		static constexpr uint64 SnapshotArenaOffset = sizeof(AArenaSnapshotHeader);
+		AE_STATIC_ASSERT(SnapshotArenaOffset % 16 == 0, "The arena's memory should be 16 bytes aligned in the file!");
+
+		FORCEINLINE static AArenaSnapshotHeader* GetHeader(const APlatform::AMappedFile& File)
+		{
+			return (AArenaSnapshotHeader*)File.Address;
+		}
+
+		FORCEINLINE static uint64 GetSnapshotFileSize(uint64 CapacityBytes)
+		{
+			return SnapshotArenaOffset + ALinearArena::GetPageMemoryRequirement(CapacityBytes);
+		}
+
+		static bool8 IsHeaderCompatible(const APlatform::AMappedFile& File)
+		{
+			if (File.Size < SnapshotArenaOffset)
+			{
+				return false;
+			}
+
+			const AArenaSnapshotHeader* Header = GetHeader(File);
+			if (Header->Magic != SnapshotMagic || Header->Version != SnapshotVersion)
+			{
+				return false;
+			}
+			if (Header->PointerSize != sizeof(void*) || Header->PageHeaderSize != sizeof(ALinearArena::APage))
+			{
+				return false;
+			}
+			if (File.Size < GetSnapshotFileSize(Header->CapacityBytes) || Header->RootOffset >= File.Size)
+			{
+				return false;
+			}
+
+			// The page's header is the first thing in the arena's memory.
+			const ALinearArena::APage* Page = (const ALinearArena::APage*)((const uint8*)File.Address + SnapshotArenaOffset);
+			return Page->AllocatedBytes <= Header->CapacityBytes;
+		}
+
+	}
+
+	AArenaSnapshot::~AArenaSnapshot()
+	{
+		Close();
+	}
+
+	bool8 AArenaSnapshot::Create(const char8* FilePath, uint64 CapacityBytes)
+	{
+		Close();
+
+		if (!APlatform::MapFile(FilePath, APlatform::EFileMapMode::Create, Utils::GetSnapshotFileSize(CapacityBytes), m_File))
+		{
+			AE_CORE_ERROR(TEXT("ArenaSnapshot - Failed to create the snapshot file!"));
+			return false;
+		}
+
+		AArenaSnapshotHeader* Header = Utils::GetHeader(m_File);
+		Header->Magic = Utils::SnapshotMagic;
+		Header->Version = Utils::SnapshotVersion;
+		Header->PointerSize = (uint16)sizeof(void*);
+		Header->PageHeaderSize = (uint16)sizeof(ALinearArena::APage);
+		Header->CapacityBytes = CapacityBytes;
+		Header->RootOffset = 0;
+
+		CreateArena(CapacityBytes, false);
+		return true;
+	}
+
+	bool8 AArenaSnapshot::Open(const char8* FilePath, bool8 bWritable /*= false*/)
+	{
+		Close();
+
+		APlatform::EFileMapMode Mode = bWritable ? APlatform::EFileMapMode::ReadWrite : APlatform::EFileMapMode::CopyOnWrite;
+		if (!APlatform::MapFile(FilePath, Mode, 0, m_File))
+		{
+			AE_CORE_ERROR(TEXT("ArenaSnapshot - Failed to map the snapshot file!"));
+			return false;
+		}
+
+		if (!Utils::IsHeaderCompatible(m_File))
+		{
+			AE_CORE_ERROR(TEXT("ArenaSnapshot - The file isn't a snapshot, or it was built with another memory layout!"));
+			APlatform::UnmapFile(m_File);
+			return false;
+		}
+
+		CreateArena(Utils::GetHeader(m_File)->CapacityBytes, true);
+		return true;
+	}
+
+	bool8 AArenaSnapshot::Save()
+	{
+		return APlatform::FlushMappedFile(m_File);
+	}
+
+	void AArenaSnapshot::Close()
+	{
+		// The arena doesn't own its memory, so it only has to be destroyed before the file is unmapped.
+		m_Arena = NULL_SHARED;
+		APlatform::UnmapFile(m_File);
+	}
+
+	void AArenaSnapshot::SetRoot(void* Root)
+	{
+		AE_CORE_ASSERT(IsOpen());
+
+		uint8* FileBegin = (uint8*)m_File.Address;
+		AE_CORE_ASSERT(Root == nullptr || ((uint8*)Root >= FileBegin + Utils::SnapshotArenaOffset && (uint8*)Root < FileBegin + m_File.Size),
+			TEXT("The root of a snapshot must be allocated from the snapshot's arena!"));
+
+		Utils::GetHeader(m_File)->RootOffset = Root ? (uint64)((uint8*)Root - FileBegin) : 0;
+	}
+
+	void* AArenaSnapshot::GetRoot() const
+	{
+		if (!IsOpen())
+		{
+			return nullptr;
+		}
+
+		uint64 RootOffset = Utils::GetHeader(m_File)->RootOffset;
+		return RootOffset ? (uint8*)m_File.Address + RootOffset : nullptr;
+	}
+
+	void AArenaSnapshot::CreateArena(uint64 CapacityBytes, bool8 bRestore)
+	{
+		ALinearArenaSpecification Specification;
+		Specification.PagesCount = 1;
+		Specification.PageSizes = &CapacityBytes;
+		Specification.ArenaMemory = (uint8*)m_File.Address + Utils::SnapshotArenaOffset;
+		Specification.bShouldGrow = false;
+		Specification.bRestoreArenaMemory = bRestore;
+
+		m_Arena = ALinearArena::Create(Specification);
+	}
+
+}
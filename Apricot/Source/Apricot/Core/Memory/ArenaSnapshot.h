@@ -0,0 +1,93 @@
+// Part of Apricot Engine. 2022-2022.
+// Module: Memory
+
+#pragma once
+
+#include "LinearArena.h"
+
+#include "Apricot/Core/Platform.h"
+#include "Apricot/Containers/OffsetPtr.h"
+
+namespace Apricot {
+
+	/**
+	* C++ Core Engine Architecture
+	*
+	* A linear arena that lives in a memory-mapped file, so data structures that are expensive to build can be saved once
+	*	and mapped back in at the next startup, with no parsing.
+	* The file is mapped at a different address every time, so the data must only point inside the arena through TOffsetPtr.
+	*	The root allocation is the entry point to the data.
+	* A snapshot can only be opened by a build with the same pointer size and arena page layout.
+	*/
+	class APRICOT_API AArenaSnapshot
+	{
+	/* Constructors & Deconstructor */
+	public:
+		AArenaSnapshot() = default;
+		~AArenaSnapshot();
+
+		AArenaSnapshot(const AArenaSnapshot&) = delete;
+		AArenaSnapshot& operator=(const AArenaSnapshot&) = delete;
+
+	/* API interface */
+	public:
+		/**
+		* Creates the snapshot file, or overwrites it, with room for 'CapacityBytes' bytes of allocations.
+		* The arena allocates straight into the file and never grows.
+		*
+		* @returns False if the file couldn't be created or mapped.
+		*/
+		NODISCARD bool8 Create(const char8* FilePath, uint64 CapacityBytes);
+
+		/**
+		* Maps a snapshot file. The arena keeps the allocations that were saved, and can still allocate in the remaining capacity.
+		*
+		* @param bWritable If false, the file is mapped copy-on-write: it is shared with the other processes that read it, and
+		*			nothing that is modified reaches it. 'Save' fails in this case.
+		*
+		* @returns False if the file couldn't be mapped, or if it isn't a snapshot this build can read.
+		*/
+		NODISCARD bool8 Open(const char8* FilePath, bool8 bWritable = false);
+
+		/**
+		* Writes the modified pages to the file, and waits for them to be stored.
+		*
+		* @returns False if the snapshot isn't writable, or if the writes failed.
+		*/
+		bool8 Save();
+
+		/**
+		* Destroys the arena and unmaps the file. Everything allocated in the arena becomes invalid.
+		*/
+		void Close();
+
+		/**
+		* Sets the allocation that is the entry point to the snapshot's data. Must be allocated from the snapshot's arena.
+		*/
+		void SetRoot(void* Root);
+
+		NODISCARD void* GetRoot() const;
+
+		template<typename T>
+		NODISCARD FORCEINLINE T* GetRoot() const { return (T*)GetRoot(); }
+
+	/* Getters & Setters */
+	public:
+		FORCEINLINE ALinearArena* GetArena() { return m_Arena.Get(); }
+
+		FORCEINLINE bool8 IsOpen() const { return m_File.IsValid(); }
+
+	private:
+		void CreateArena(uint64 CapacityBytes, bool8 bRestore);
+
+	/* Member variables */
+	private:
+		APlatform::AMappedFile m_File;
+
+		/**
+		* Allocates inside the mapped file, right after the snapshot's header.
+		*/
+		TSharedPtr<ALinearArena> m_Arena;
+	};
+
+}
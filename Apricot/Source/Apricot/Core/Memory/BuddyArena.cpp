@@ -0,0 +1,669 @@
+// Part of Apricot Engine. 2022-2022.
+// Module: Memory
+
+#include "aepch.h"
+#include "BuddyArena.h"
+
+namespace Apricot {
+
+	namespace Utils {
+
+		/**
+		* Returns log2 of the smallest power of two that is bigger or equal to 'Value'.
+		*/
+		FORCEINLINE static uint64 GetCeilLog2(uint64 Value)
+		{
+			return Value > 1 ? FindLastSetBit(Value - 1) + 1 : 0;
+		}
+
+		FORCEINLINE static uint64 GetMinimumBlockSizeLog2(uint64 MinimumBlockSize)
+		{
+			uint64 SizeLog2 = GetCeilLog2(MinimumBlockSize);
+			uint64 LimitLog2 = GetCeilLog2(ABuddyArena::MinimumBlockSizeLimit);
+			return SizeLog2 > LimitLog2 ? SizeLog2 : LimitLog2;
+		}
+
+		FORCEINLINE static uint64 GetPageSizeLog2(uint64 PageSize, uint64 MinimumBlockSizeLog2)
+		{
+			uint64 SizeLog2 = GetCeilLog2(PageSize);
+			return SizeLog2 > MinimumBlockSizeLog2 ? SizeLog2 : MinimumBlockSizeLog2;
+		}
+
+		FORCEINLINE static uint64 GetPageAlignment(uint64 PageSizeLog2)
+		{
+			uint64 PageSize = 1ull << PageSizeLog2;
+			return PageSize < ABuddyArena::MaximumAlignment ? PageSize : ABuddyArena::MaximumAlignment;
+		}
+
+		/**
+		* A tree with 'LevelsCount' levels below its root has (2 << LevelsCount) - 1 nodes, numbered from 1.
+		*/
+		FORCEINLINE static uint64 GetBitmapWordsCount(uint64 LevelsCount)
+		{
+			return ((2ull << LevelsCount) + 63) / 64;
+		}
+
+		FORCEINLINE static bool8 TestBit(const uint64* Bitmap, uint64 Node)
+		{
+			return (Bitmap[Node / 64] & (1ull << (Node % 64))) != 0;
+		}
+
+		FORCEINLINE static void SetBit(uint64* Bitmap, uint64 Node)
+		{
+			Bitmap[Node / 64] |= (1ull << (Node % 64));
+		}
+
+		FORCEINLINE static void ClearBit(uint64* Bitmap, uint64 Node)
+		{
+			Bitmap[Node / 64] &= ~(1ull << (Node % 64));
+		}
+
+		FORCEINLINE static uint8* GetNodeBlock(const ABuddyArena::APage* Page, uint64 Node, uint64 BlockSizeLog2)
+		{
+			uint64 FirstLevelNode = 1ull << (Page->SizeLog2 - BlockSizeLog2);
+			return Page->MemoryBlock + ((Node - FirstLevelNode) << BlockSizeLog2);
+		}
+
+		FORCEINLINE static uint64 GetBlockNode(const ABuddyArena::APage* Page, const void* Block, uint64 BlockSizeLog2)
+		{
+			uint64 FirstLevelNode = 1ull << (Page->SizeLog2 - BlockSizeLog2);
+			return FirstLevelNode + (((const uint8*)Block - Page->MemoryBlock) >> BlockSizeLog2);
+		}
+
+		static ABuddyArena::APage* ConstructNewPage(uint8* ArenaMemory, uint64& Offset, uint64 PageSizeLog2, uint64 MinimumBlockSizeLog2)
+		{
+			Offset += GetAlignmentOffset(ArenaMemory + Offset, sizeof(void*));
+
+			ABuddyArena::APage* NewPage = (ABuddyArena::APage*)(ArenaMemory + Offset);
+			MemConstruct<ABuddyArena::APage>(NewPage);
+			Offset += sizeof(ABuddyArena::APage);
+
+			NewPage->SizeLog2 = PageSizeLog2;
+			NewPage->LevelsCount = PageSizeLog2 - MinimumBlockSizeLog2;
+
+			uint64 BitmapBytes = GetBitmapWordsCount(NewPage->LevelsCount) * sizeof(uint64);
+			NewPage->FreeBits = (uint64*)(ArenaMemory + Offset);
+			Offset += BitmapBytes;
+			NewPage->SplitBits = (uint64*)(ArenaMemory + Offset);
+			Offset += BitmapBytes;
+
+			Offset += GetAlignmentOffset(ArenaMemory + Offset, GetPageAlignment(PageSizeLog2));
+			NewPage->MemoryBlock = ArenaMemory + Offset;
+			Offset += 1ull << PageSizeLog2;
+
+			return NewPage;
+		}
+
+	}
+
+	NODISCARD TSharedPtr<ABuddyArena> ABuddyArena::Create(const ABuddyArenaSpecification& Specification)
+	{
+		return MakeShared<ABuddyArena>(Specification);
+	}
+
+	NODISCARD uint64 ABuddyArena::GetPageMemoryRequirement(uint64 PageSizeBytes, uint64 MinimumBlockSize)
+	{
+		uint64 MinimumBlockSizeLog2 = Utils::GetMinimumBlockSizeLog2(MinimumBlockSize);
+		uint64 PageSizeLog2 = Utils::GetPageSizeLog2(PageSizeBytes, MinimumBlockSizeLog2);
+
+		uint64 MemoryRequirement = 0;
+
+		MemoryRequirement += sizeof(APage);
+		MemoryRequirement += 2 * Utils::GetBitmapWordsCount(PageSizeLog2 - MinimumBlockSizeLog2) * sizeof(uint64);
+
+		// The worst case padding of the blocks.
+		MemoryRequirement += Utils::GetPageAlignment(PageSizeLog2) - 1;
+		MemoryRequirement += 1ull << PageSizeLog2;
+
+		return MemoryRequirement;
+	}
+
+	NODISCARD uint64 ABuddyArena::GetMemoryRequirement(const ABuddyArenaSpecification& Specification)
+	{
+		// The pages' sizes are multiples of the pointer's size, so they don't need padding between them.
+		return Specification.PagesCount * GetPageMemoryRequirement(Specification.PageSize, Specification.MinimumBlockSize);
+	}
+
+	ABuddyArena::ABuddyArena(const ABuddyArenaSpecification& Specification)
+		: m_Specification(Specification)
+	{
+		m_MinimumBlockSizeLog2 = Utils::GetMinimumBlockSizeLog2(m_Specification.MinimumBlockSize);
+		m_PageSizeLog2 = Utils::GetPageSizeLog2(m_Specification.PageSize, m_MinimumBlockSizeLog2);
+		AE_CORE_ASSERT(m_PageSizeLog2 < MaximumBlockSizeLog2, TEXT("The buddy arena's pages are too big!"));
+
+		m_Pages.SetCapacity(m_Specification.PagesCount);
+
+		if (m_Specification.PagesCount > 0)
+		{
+			uint8* ArenaMemory = (uint8*)m_Specification.ArenaMemory;
+			if (!ArenaMemory)
+			{
+				m_BulkMemoryBytes = GetMemoryRequirement(m_Specification);
+				m_BulkMemory = AllocateArenaMemory(m_BulkMemoryBytes, m_Specification.MemoryOptions);
+				ArenaMemory = (uint8*)m_BulkMemory;
+			}
+			uint64 MemoryOffset = 0;
+
+			for (uint64 Index = 0; Index < m_Specification.PagesCount; Index++)
+			{
+				uint64 PageOffset = MemoryOffset;
+				APage* Page = Utils::ConstructNewPage(ArenaMemory, MemoryOffset, m_PageSizeLog2, m_MinimumBlockSizeLog2);
+				Page->MemoryRequirement = MemoryOffset - PageOffset;
+				Page->bIsSpecPage = true;
+				RegisterPage(Page);
+			}
+
+			if (m_Specification.ArenaMemory)
+			{
+				m_Specification.ArenaMemoryOffset = MemoryOffset;
+			}
+		}
+	}
+
+	ABuddyArena::~ABuddyArena()
+	{
+		for (uint64 Index = 0; Index < m_Pages.Size(); Index++)
+		{
+			if (!m_Pages[Index]->bIsSpecPage && !m_Specification.bUseArenaMemoryAlways)
+			{
+				FreeArenaMemory(m_Pages[Index], m_Pages[Index]->MemoryRequirement, m_Specification.MemoryOptions);
+			}
+		}
+		if (m_BulkMemory)
+		{
+			FreeArenaMemory(m_BulkMemory, m_BulkMemoryBytes, m_Specification.MemoryOptions);
+		}
+	}
+
+	uint64 ABuddyArena::GetTotalSize() const
+	{
+		return m_TotalBytes;
+	}
+
+	uint64 ABuddyArena::GetAllocatedSize() const
+	{
+		return m_AllocatedBytes;
+	}
+
+	uint64 ABuddyArena::GetFreeSize() const
+	{
+		return m_TotalBytes - m_AllocatedBytes;
+	}
+
+	uint64 ABuddyArena::GetLargestFreeBlockSize() const
+	{
+		return m_AvailableSizes ? 1ull << FindLastSetBit(m_AvailableSizes) : 0;
+	}
+
+	const TChar* ABuddyArena::GetDebugName() const
+	{
+		return TEXT("BUDDY_ARENA");
+	}
+
+	void ABuddyArena::TakeFragmentationReport(AArenaFragmentationReport& OutReport) const
+	{
+		OutReport = {};
+		OutReport.TotalBytes = m_TotalBytes;
+		OutReport.AllocatedBytes = m_AllocatedBytes;
+		OutReport.FreeBytes = m_TotalBytes - m_AllocatedBytes;
+		OutReport.PaddingBytes = GetPaddingBytes(OutReport.AllocatedBytes);
+		OutReport.PagesCount = m_Pages.Size();
+
+		for (uint64 Index = 0; Index < m_Pages.Size() && Index < AArenaFragmentationReport::MaxPagesCount; Index++)
+		{
+			const APage* Page = m_Pages[Index];
+			AArenaPageReport& PageReport = OutReport.Pages[Index];
+			PageReport.SizeBytes = 1ull << Page->SizeLog2;
+			PageReport.AllocatedBytes = Page->AllocatedBytes;
+		}
+	}
+
+	NODISCARD void* ABuddyArena::Alloc(uint64 Size, uint64 Alignment /*= sizeof(void*)*/)
+	{
+	#ifdef AE_ENABLE_MEMORY_CHECK
+		if (Size == 0 || Size > MaximumBlockSize)
+		{
+			GCrashReporter->MemoryState.Arena = this;
+			GCrashReporter->MemoryState.Size = Size;
+			GCrashReporter->SubmitArenaFailure(ACrashReporter::EMemoryOperation::Allocate, EMemoryError::InvalidSize);
+			return nullptr;
+		}
+		if (!IsPowerOfTwo(Alignment))
+		{
+			GCrashReporter->MemoryState.Arena = this;
+			GCrashReporter->MemoryState.Alignment = Alignment;
+			GCrashReporter->SubmitArenaFailure(ACrashReporter::EMemoryOperation::Allocate, EMemoryError::InvalidAlignment);
+			return nullptr;
+		}
+		if (Alignment > MaximumAlignment)
+		{
+			GCrashReporter->MemoryState.Arena = this;
+			GCrashReporter->MemoryState.Alignment = Alignment;
+			GCrashReporter->SubmitArenaFailure(ACrashReporter::EMemoryOperation::Allocate, EMemoryError::AlignmentIsForbidden);
+			return nullptr;
+		}
+	#endif
+
+		BeginOwnerAllocation();
+
+		void* Memory = AllocateBlock(Size, Alignment);
+		if (!Memory)
+		{
+			GCrashReporter->MemoryState.Arena = this;
+			GCrashReporter->MemoryState.Size = Size;
+			GCrashReporter->MemoryState.Alignment = Alignment;
+			GCrashReporter->MemoryState.FreeSize = GetFreeSize();
+			GCrashReporter->SubmitArenaFailure(ACrashReporter::EMemoryOperation::Allocate, EMemoryError::OutOfMemoryUnableToGrow);
+		}
+		return Memory;
+	}
+
+	NODISCARD int32 ABuddyArena::TryAlloc(uint64 Size, void** OutPointer, uint64 Alignment /*= sizeof(void*)*/)
+	{
+		if (OutPointer == nullptr)
+		{
+			return (int32)EMemoryError::InvalidOuterPointer;
+		}
+		if (Size == 0 || Size > MaximumBlockSize)
+		{
+			*OutPointer = nullptr;
+			return (int32)EMemoryError::InvalidSize;
+		}
+		if (!IsPowerOfTwo(Alignment))
+		{
+			*OutPointer = nullptr;
+			return (int32)EMemoryError::InvalidAlignment;
+		}
+		if (Alignment > MaximumAlignment)
+		{
+			*OutPointer = nullptr;
+			return (int32)EMemoryError::AlignmentIsForbidden;
+		}
+
+		BeginOwnerAllocation();
+
+		*OutPointer = AllocateBlock(Size, Alignment);
+		if (*OutPointer == nullptr)
+		{
+			return (int32)EMemoryError::OutOfMemoryUnableToGrow;
+		}
+		return (int32)EMemoryError::Success;
+	}
+
+	NODISCARD void* ABuddyArena::AllocUnsafe(uint64 Size, uint64 Alignment /*= sizeof(void*)*/)
+	{
+		BeginOwnerAllocation();
+
+		return AllocateBlock(Size, Alignment);
+	}
+
+	void ABuddyArena::Free(void* Allocation, uint64 Size)
+	{
+		if (Allocation == nullptr)
+		{
+			return;
+		}
+
+		if (IsRemoteThread())
+		{
+			// The blocks are at least 'MinimumBlockSizeLimit' bytes, so they can always hold the node.
+			PushRemoteFree(Allocation, Size);
+			return;
+		}
+
+		APage* Page = FindPage(Allocation);
+		uint64 BlockSizeLog2 = 0;
+		uint64 Node = Page ? FindAllocatedNode(Page, Allocation, BlockSizeLog2) : 0;
+
+	#ifdef AE_ENABLE_MEMORY_CHECK
+		if (Node == 0 || Utils::TestBit(Page->FreeBits, Node))
+		{
+			GCrashReporter->MemoryState.Arena = this;
+			GCrashReporter->MemoryState.MemoryBlock = Allocation;
+			GCrashReporter->MemoryState.Size = Size;
+			GCrashReporter->SubmitArenaFailure(ACrashReporter::EMemoryOperation::Free,
+				Page == nullptr ? EMemoryError::PointerOutOfRange : (Node == 0 ? EMemoryError::InvalidMemoryPtr : EMemoryError::AlreadyFreed));
+			return;
+		}
+	#endif
+
+		FreeBlock(Page, Node, BlockSizeLog2);
+		SubmitDeallocationStats(Allocation, Size);
+	}
+
+	int32 ABuddyArena::TryFree(void* Allocation, uint64 Size)
+	{
+		if (Allocation == nullptr)
+		{
+			return (int32)EMemoryError::InvalidMemoryPtr;
+		}
+
+		if (IsRemoteThread())
+		{
+			// The owner's pages can't be read from this thread, so the allocation isn't validated.
+			// The blocks are at least 'MinimumBlockSizeLimit' bytes, so they can always hold the node.
+			PushRemoteFree(Allocation, Size);
+			return (int32)EMemoryError::Success;
+		}
+
+		APage* Page = FindPage(Allocation);
+		if (Page == nullptr)
+		{
+			return (int32)EMemoryError::PointerOutOfRange;
+		}
+
+		uint64 BlockSizeLog2 = 0;
+		uint64 Node = FindAllocatedNode(Page, Allocation, BlockSizeLog2);
+		if (Node == 0)
+		{
+			return (int32)EMemoryError::InvalidMemoryPtr;
+		}
+		if (Utils::TestBit(Page->FreeBits, Node))
+		{
+			return (int32)EMemoryError::AlreadyFreed;
+		}
+
+		FreeBlock(Page, Node, BlockSizeLog2);
+		SubmitDeallocationStats(Allocation, Size);
+		return (int32)EMemoryError::Success;
+	}
+
+	void ABuddyArena::FreeUnsafe(void* Allocation, uint64 Size)
+	{
+		if (IsRemoteThread())
+		{
+			// The blocks are at least 'MinimumBlockSizeLimit' bytes, so they can always hold the node.
+			PushRemoteFree(Allocation, Size);
+			return;
+		}
+
+		APage* Page = FindPage(Allocation);
+		uint64 BlockSizeLog2 = 0;
+		uint64 Node = FindAllocatedNode(Page, Allocation, BlockSizeLog2);
+
+		FreeBlock(Page, Node, BlockSizeLog2);
+		SubmitDeallocationStats(Allocation, Size);
+	}
+
+	void ABuddyArena::FreeAll()
+	{
+		FreeAllUnsafe();
+	}
+
+	int32 ABuddyArena::TryFreeAll()
+	{
+		FreeAllUnsafe();
+		return (int32)EMemoryError::Success;
+	}
+
+	void ABuddyArena::FreeAllUnsafe()
+	{
+		// The blocks freed by the other threads are freed with everything else.
+		TakeRemoteFrees();
+
+		m_AvailableSizes = 0;
+		AE_MEMZERO_ARRAY(m_FreeLists);
+
+		m_AllocatedBytes = 0;
+
+		for (uint64 Index = 0; Index < m_Pages.Size(); Index++)
+		{
+			ResetPage(m_Pages[Index]);
+		}
+
+		SubmitDeallocationOfAllStats();
+	}
+
+	void ABuddyArena::DrainRemoteFrees()
+	{
+		// The frees of another thread would be pushed straight back on the stack.
+		if (IsRemoteThread())
+		{
+			return;
+		}
+
+		ARemoteFreeNode* Node = TakeRemoteFrees();
+		while (Node)
+		{
+			// The node is stored in the allocation, so it must be read before the allocation is freed.
+			ARemoteFreeNode* Next = Node->Next;
+			Free(Node, Node->Size);
+			Node = Next;
+		}
+	}
+
+	void ABuddyArena::GarbageCollect()
+	{
+		DrainRemoteFrees();
+
+		for (int64 Index = (int64)m_Pages.Size() - 1; Index >= 0; Index--)
+		{
+			APage* Page = m_Pages[Index];
+
+			// A page without allocations is a single free block: its root.
+			if (!Page->bIsSpecPage && Utils::TestBit(Page->FreeBits, 1))
+			{
+				RemoveFreeBlock(Page, 1, Page->SizeLog2);
+				m_TotalBytes -= 1ull << Page->SizeLog2;
+
+				if (!m_Specification.bUseArenaMemoryAlways)
+				{
+					FreeArenaMemory(Page, Page->MemoryRequirement, m_Specification.MemoryOptions);
+				}
+
+				m_Pages.Erase(Index);
+			}
+		}
+	}
+
+	uint64 ABuddyArena::GetBlockSizeLog2(uint64 Size, uint64 Alignment) const
+	{
+		// A block is aligned to its own size, as long as it isn't bigger than its page's alignment.
+		uint64 SizeLog2 = Utils::GetCeilLog2(Size > Alignment ? Size : Alignment);
+		return SizeLog2 > m_MinimumBlockSizeLog2 ? SizeLog2 : m_MinimumBlockSizeLog2;
+	}
+
+	void* ABuddyArena::AllocateBlock(uint64 Size, uint64 Alignment)
+	{
+		uint64 BlockSizeLog2 = GetBlockSizeLog2(Size, Alignment);
+		if (BlockSizeLog2 >= MaximumBlockSizeLog2)
+		{
+			return nullptr;
+		}
+
+		uint64 AvailableSizes = m_AvailableSizes & (~0ull << BlockSizeLog2);
+		if (!AvailableSizes)
+		{
+			if (!m_Specification.bShouldGrow)
+			{
+				return nullptr;
+			}
+
+			AllocateNewPage(BlockSizeLog2 > m_PageSizeLog2 ? BlockSizeLog2 : m_PageSizeLog2);
+			AvailableSizes = m_AvailableSizes & (~0ull << BlockSizeLog2);
+		}
+
+		// The smallest free block that fits is split in halves, until it is as small as the allocation allows.
+		uint64 SizeLog2 = FindFirstSetBit(AvailableSizes);
+		AFreeBlock* Block = m_FreeLists[SizeLog2];
+		APage* Page = Block->Page;
+
+		uint64 Node = Utils::GetBlockNode(Page, Block, SizeLog2);
+		RemoveFreeBlock(Page, Node, SizeLog2);
+
+		while (SizeLog2 > BlockSizeLog2)
+		{
+			Utils::SetBit(Page->SplitBits, Node);
+			SizeLog2--;
+			Node *= 2;
+
+			// The first half keeps the block's address. The second one is its free buddy.
+			InsertFreeBlock(Page, Node + 1, SizeLog2);
+		}
+
+		Page->AllocatedBytes += 1ull << BlockSizeLog2;
+		m_AllocatedBytes += 1ull << BlockSizeLog2;
+		SubmitAllocationStats(Block, Size, Alignment);
+		return Block;
+	}
+
+	void ABuddyArena::FreeBlock(APage* Page, uint64 Node, uint64 BlockSizeLog2)
+	{
+		Page->AllocatedBytes -= 1ull << BlockSizeLog2;
+		m_AllocatedBytes -= 1ull << BlockSizeLog2;
+
+		// Merge with the buddy while it is free. The parent of two free buddies isn't split anymore.
+		while (Node > 1)
+		{
+			uint64 Buddy = Node ^ 1;
+			if (!Utils::TestBit(Page->FreeBits, Buddy))
+			{
+				break;
+			}
+
+			RemoveFreeBlock(Page, Buddy, BlockSizeLog2);
+			Node /= 2;
+			BlockSizeLog2++;
+			Utils::ClearBit(Page->SplitBits, Node);
+		}
+
+		InsertFreeBlock(Page, Node, BlockSizeLog2);
+	}
+
+	ABuddyArena::APage* ABuddyArena::FindPage(const void* Address) const
+	{
+		// Find the last page that starts before the address.
+		uint64 Begin = 0;
+		uint64 End = m_Pages.Size();
+		while (Begin < End)
+		{
+			uint64 Middle = Begin + (End - Begin) / 2;
+			if ((const uint8*)Address < m_Pages[Middle]->MemoryBlock)
+			{
+				End = Middle;
+			}
+			else
+			{
+				Begin = Middle + 1;
+			}
+		}
+
+		if (Begin == 0)
+		{
+			return nullptr;
+		}
+
+		APage* Page = m_Pages[Begin - 1];
+		return (const uint8*)Address < Page->MemoryBlock + (1ull << Page->SizeLog2) ? Page : nullptr;
+	}
+
+	uint64 ABuddyArena::FindAllocatedNode(const APage* Page, const void* Allocation, uint64& OutBlockSizeLog2) const
+	{
+		uint64 Offset = (uint64)((const uint8*)Allocation - Page->MemoryBlock);
+
+		// The allocated block is the first block on the way down that isn't split.
+		uint64 Node = 1;
+		uint64 SizeLog2 = Page->SizeLog2;
+		while (Utils::TestBit(Page->SplitBits, Node))
+		{
+			SizeLog2--;
+			Node = 2 * Node + ((Offset >> SizeLog2) & 1);
+		}
+
+		if (Offset & ((1ull << SizeLog2) - 1))
+		{
+			return 0;
+		}
+
+		OutBlockSizeLog2 = SizeLog2;
+		return Node;
+	}
+
+	void ABuddyArena::InsertFreeBlock(APage* Page, uint64 Node, uint64 BlockSizeLog2)
+	{
+		AFreeBlock* Block = (AFreeBlock*)Utils::GetNodeBlock(Page, Node, BlockSizeLog2);
+		AFreeBlock* Head = m_FreeLists[BlockSizeLog2];
+
+		Block->Next = Head;
+		Block->Previous = nullptr;
+		Block->Page = Page;
+		if (Head)
+		{
+			Head->Previous = Block;
+		}
+
+		m_FreeLists[BlockSizeLog2] = Block;
+		m_AvailableSizes |= (1ull << BlockSizeLog2);
+		Utils::SetBit(Page->FreeBits, Node);
+	}
+
+	void ABuddyArena::RemoveFreeBlock(APage* Page, uint64 Node, uint64 BlockSizeLog2)
+	{
+		AFreeBlock* Block = (AFreeBlock*)Utils::GetNodeBlock(Page, Node, BlockSizeLog2);
+
+		if (Block->Next)
+		{
+			Block->Next->Previous = Block->Previous;
+		}
+		if (Block->Previous)
+		{
+			Block->Previous->Next = Block->Next;
+		}
+		else
+		{
+			m_FreeLists[BlockSizeLog2] = Block->Next;
+			if (!Block->Next)
+			{
+				m_AvailableSizes &= ~(1ull << BlockSizeLog2);
+			}
+		}
+
+		Utils::ClearBit(Page->FreeBits, Node);
+	}
+
+	void ABuddyArena::ResetPage(APage* Page)
+	{
+		uint64 BitmapBytes = Utils::GetBitmapWordsCount(Page->LevelsCount) * sizeof(uint64);
+		MemZero(Page->FreeBits, BitmapBytes);
+		MemZero(Page->SplitBits, BitmapBytes);
+
+		Page->AllocatedBytes = 0;
+		InsertFreeBlock(Page, 1, Page->SizeLog2);
+	}
+
+	ABuddyArena::APage* ABuddyArena::AllocateNewPage(uint64 PageSizeLog2)
+	{
+		uint64 MemoryRequirement = GetPageMemoryRequirement(1ull << PageSizeLog2, 1ull << m_MinimumBlockSizeLog2);
+
+		APage* NewPage = nullptr;
+		if (m_Specification.bUseArenaMemoryAlways)
+		{
+			uint64 PageOffset = m_Specification.ArenaMemoryOffset;
+			NewPage = Utils::ConstructNewPage((uint8*)m_Specification.ArenaMemory, m_Specification.ArenaMemoryOffset, PageSizeLog2, m_MinimumBlockSizeLog2);
+			MemoryRequirement = m_Specification.ArenaMemoryOffset - PageOffset;
+		}
+		else
+		{
+			uint64 Offset = 0;
+			NewPage = Utils::ConstructNewPage((uint8*)AllocateArenaMemory(MemoryRequirement, m_Specification.MemoryOptions), Offset, PageSizeLog2, m_MinimumBlockSizeLog2);
+		}
+
+		NewPage->MemoryRequirement = MemoryRequirement;
+		RegisterPage(NewPage);
+		return NewPage;
+	}
+
+	void ABuddyArena::RegisterPage(APage* Page)
+	{
+		m_Pages.PushBack(Page);
+		for (uint64 Index = m_Pages.Size() - 1; Index > 0 && m_Pages[Index - 1]->MemoryBlock > Page->MemoryBlock; Index--)
+		{
+			m_Pages[Index] = m_Pages[Index - 1];
+			m_Pages[Index - 1] = Page;
+		}
+
+		m_TotalBytes += 1ull << Page->SizeLog2;
+		ResetPage(Page);
+	}
+
+}
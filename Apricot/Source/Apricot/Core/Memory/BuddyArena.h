@@ -0,0 +1,399 @@
+// Part of Apricot Engine. 2022-2022.
+// Module: Memory
+
+#pragma once
+
+#include "ApricotMemory.h"
+#include "Apricot/Core/AClass.h"
+
+namespace Apricot {
+
+	/**
+	* ABuddyArena Specification
+	*
+	* These are the initial arena's specifications. Might not be up-to-date.
+	*/
+	struct ABuddyArenaSpecification
+	{
+		/**
+		* Count of initial pages. These are allocated at the same time as the arena itself.
+		*/
+		uint64 PagesCount = 0;
+
+		/**
+		* The size of the pages. Rounded up to a power of two. It is also the biggest allocation a page can hold, so a
+		*	bigger allocation makes the arena grow with a page of its own size.
+		*/
+		uint64 PageSize = 16 * 1024 * 1024;
+
+		/**
+		* The size of the smallest block. Rounded up to a power of two, and to at least 'MinimumBlockSizeLimit'.
+		* Every allocation takes at least a block this big, but the pages' bitmaps double with every halving of it.
+		*/
+		uint64 MinimumBlockSize = 256;
+
+		/**
+		* Pointer to a memory block that will be used to allocate memory for the arena. Pointer should
+		*	be valid on the entire arena's lifetime. If this is nullptr, the memory will be allocated from the global heap.
+		*/
+		void* ArenaMemory = nullptr;
+
+		/**
+		* Offset in 'ArenaMemory' where the next page will be constructed.
+		*/
+		uint64 ArenaMemoryOffset = 0;
+
+		/**
+		* Tells the arena if it can allocate new pages when it gets out of memory.
+		* If this is false, and the arena runs out of memory, an 'error' will be issued.
+		*/
+		bool bShouldGrow = true;
+
+		/**
+		* If true, the new pages will also be constructed in 'ArenaMemory'.
+		*/
+		bool bUseArenaMemoryAlways = false;
+
+		/**
+		* Controls how the pages' memory is obtained from the system (huge pages, prefaulting, locking).
+		* Doesn't apply to the memory provided through 'ArenaMemory'.
+		*/
+		AArenaMemoryOptions MemoryOptions;
+	};
+
+	/**
+	* C++ Core Engine Architecture
+	*
+	* Buddy Arena implementation.
+	* Power-of-two sub-allocator for big blocks of varying sizes, such as the upload heaps and the texture atlases of the
+	*	renderer. Every page is a binary tree of blocks: a free block is split in two halves (buddies) until it fits the
+	*	allocation, and a freed block is merged back with its buddy for as long as the buddy is free too.
+	* The tree's split and free states are tracked by two bitmaps per page, so the blocks have no headers and a block is
+	*	always aligned to its own size. Both allocation and freeing run in O(log n), n being the count of blocks of a page.
+	*/
+	class APRICOT_API ABuddyArena : public AMemoryArena
+	{
+		ACLASS_CORE()
+
+	public:
+		NODISCARD static TSharedPtr<ABuddyArena> Create(const ABuddyArenaSpecification& Specification);
+
+		NODISCARD static uint64 GetPageMemoryRequirement(uint64 PageSizeBytes, uint64 MinimumBlockSize);
+
+		NODISCARD static uint64 GetMemoryRequirement(const ABuddyArenaSpecification& Specification);
+
+	/* Constructors & Deconstructor */
+	private:
+		ABuddyArena(const ABuddyArenaSpecification& Specification);
+		virtual ~ABuddyArena() override;
+
+		ABuddyArena(const ABuddyArena&) = delete;
+		ABuddyArena& operator=(const ABuddyArena&) = delete;
+		ABuddyArena(ABuddyArena&&) = delete;
+		ABuddyArena& operator=(ABuddyArena&&) = delete;
+
+	/* Typedefs */
+	public:
+		struct APage
+		{
+			/**
+			* Pointer to the page's blocks. Aligned to 'MaximumAlignment', or to the page's size if it is smaller.
+			*/
+			uint8* MemoryBlock = nullptr;
+
+			/**
+			* log2 of the page's size, which is the size of the tree's root block.
+			*/
+			uint64 SizeLog2 = 0;
+
+			/**
+			* Count of levels of the tree, below the root.
+			*/
+			uint64 LevelsCount = 0;
+
+			/**
+			* Bit 'Node' is set if the block is free. The nodes are numbered as in a binary heap: the root is 1, and the
+			*	children of 'Node' are '2 * Node' and '2 * Node + 1'.
+			*/
+			uint64* FreeBits = nullptr;
+
+			/**
+			* Bit 'Node' is set if the block is split in its two children.
+			*/
+			uint64* SplitBits = nullptr;
+
+			/**
+			* The bytes of the page's allocated blocks.
+			*/
+			uint64 AllocatedBytes = 0;
+
+			/**
+			* The size of the memory the page was allocated in, including its header and bitmaps.
+			*/
+			uint64 MemoryRequirement = 0;
+
+			/**
+			* True if the page is part of the memory block of the specification's pages, so it can't be freed on its own.
+			*/
+			bool8 bIsSpecPage = false;
+		};
+
+		/**
+		* A free block. It is stored in the block itself, so it costs nothing.
+		*/
+		struct AFreeBlock
+		{
+			AFreeBlock* Next = nullptr;
+			AFreeBlock* Previous = nullptr;
+			APage* Page = nullptr;
+		};
+
+		/**
+		* The smallest block must be able to hold the free list links.
+		*/
+		static constexpr uint64 MinimumBlockSizeLimit = 32;
+		AE_STATIC_ASSERT(sizeof(AFreeBlock) <= MinimumBlockSizeLimit, "The smallest block can't hold the free list links!");
+
+		/**
+		* The biggest alignment the arena can give. Bigger alignments would make every page waste as much memory.
+		*/
+		static constexpr uint64 MaximumAlignment = 4096;
+
+		/**
+		* Blocks must be smaller than (1 << MaximumBlockSizeLog2) bytes.
+		*/
+		static constexpr uint64 MaximumBlockSizeLog2 = 48;
+
+		static constexpr uint64 MaximumBlockSize = 1ull << (MaximumBlockSizeLog2 - 1);
+
+	/* API interface */
+	public:
+		/**
+		* Allocates a block of memory, in O(log n).
+		* The size is rounded up to a power of two, so the block is aligned to its own size, up to 'MaximumAlignment'.
+		* Issues errors based on the value of EFailureMode.
+		*
+		* @param Size The size of the allocation.
+		*
+		* @param Alignment The alignment of the memory block. Must be a power of two, no bigger than 'MaximumAlignment'.
+		*			Default value is sizeof(void*), which, in case of allocating structs bigger than sizeof(void) bytes, is optimal for most platforms.
+		*
+		* @returns Pointer to the aligned memory block. In case of failure, it will return nullptr.
+		*/
+		NODISCARD void* Alloc(uint64 Size, uint64 Alignment = sizeof(void*));
+
+		/**
+		* Allocates a block of memory, in O(log n).
+		* Same as 'Alloc', but it returns a flag indicating failure or success.
+		*
+		* @param Size The size of the allocation.
+		*
+		* @param OutPointer Out parameter, holds the 'returned' pointer. Must NOT be nullptr.
+		*
+		* @param Alignment The alignment of the memory block. Must be a power of two, no bigger than 'MaximumAlignment'.
+		*
+		* @returns A flag specifying if any errors were encountered. A simple 'if' statement will check for any error flags.
+		*/
+		NODISCARD int32 TryAlloc(uint64 Size, void** OutPointer, uint64 Alignment = sizeof(void*));
+
+		/**
+		* Allocates a block of memory, in O(log n).
+		* Does NOT issue ANY errors.
+		*
+		* @param Size The size of the allocation.
+		*
+		* @param Alignment The alignment of the memory block. Must be a power of two, no bigger than 'MaximumAlignment'.
+		*
+		* @returns Pointer to the aligned memory block. It will return nullptr ONLY when the arena is out of memory and 'bShouldGrow' is false.
+		*/
+		NODISCARD void* AllocUnsafe(uint64 Size, uint64 Alignment = sizeof(void*));
+
+		/**
+		* Frees the block where Allocation is placed, and merges it with its free buddies. Runs in O(log n).
+		* The block's size is found from the page's bitmaps.
+		* Generates errors based on EFailureMode enum value.
+		*
+		* @param Allocation Pointer to the memory to be freed.
+		*
+		* @param Size Size of the allocation. Currently, used only for debugging.
+		*/
+		void Free(void* Allocation, uint64 Size);
+
+		/**
+		* Frees the block where Allocation is placed.
+		* Same behavior as 'Free', but it validates the pointer and returns a flag specifying if any errors were encountered.
+		*
+		* @param Allocation Pointer to the memory to be freed.
+		*
+		* @param Size Size of the allocation. Currently, used only for debugging.
+		*
+		* @returns A flag specifying if any errors were encountered. A simple 'if' statement will check for any error flags.
+		*/
+		int32 TryFree(void* Allocation, uint64 Size);
+
+		/**
+		* Frees the block where Allocation is placed.
+		* It doesn't perform ANY error checking and will most likely unreportedly crash the engine if ANY errors occur.
+		*
+		* @param Allocation Pointer to the memory to be freed.
+		*
+		* @param Size Size of the allocation. Currently, used only for debugging.
+		*/
+		void FreeUnsafe(void* Allocation, uint64 Size);
+
+		/**
+		* Frees all allocations, turning every page back into a single free block. No page is deleted.
+		* It will always succeed.
+		*/
+		void FreeAll();
+
+		/**
+		* Frees all allocations, turning every page back into a single free block. No page is deleted.
+		*
+		* @returns A flag specifying if any errors were encountered. A simple 'if' statement will check for any error flags.
+		*/
+		int32 TryFreeAll();
+
+		/**
+		* Frees all allocations, turning every page back into a single free block. No page is deleted.
+		* It will always succeed.
+		*/
+		void FreeAllUnsafe();
+
+		/**
+		* Deletes all the pages that don't hold any allocation. It cannot delete the specification pages, because they aren't allocated individually.
+		*/
+		virtual void GarbageCollect() override;
+
+		/**
+		* Frees the allocations that the other threads freed since the last allocation. Does nothing when called by a thread other than the owner.
+		*/
+		virtual void DrainRemoteFrees() override;
+
+	/* Getters & Setters */
+	public:
+		/**
+		* Returns the total size of all pages.
+		*/
+		virtual uint64 GetTotalSize() const override;
+
+		/**
+		* Returns the total size of the allocated blocks, which are the allocations' sizes rounded up to powers of two.
+		*/
+		uint64 GetAllocatedSize() const;
+
+		/**
+		* Returns the total size of the free blocks. Remember that this memory might not be contiguous, so this is not
+		*	the biggest size that can be allocated without having to allocate a new page.
+		*/
+		uint64 GetFreeSize() const;
+
+		/**
+		* Returns the size of the biggest block that can be allocated without growing.
+		*/
+		uint64 GetLargestFreeBlockSize() const;
+
+		/**
+		* Returns the debug tag of the arena.
+		*/
+		virtual const TChar* GetDebugName() const override;
+
+		virtual void TakeFragmentationReport(AArenaFragmentationReport& OutReport) const override;
+
+		/**
+		* Returns the arena's specification.
+		*/
+		FORCEINLINE const ABuddyArenaSpecification& GetSpecification() const { return m_Specification; }
+
+	private:
+		/**
+		* Returns log2 of the block size an allocation takes.
+		*/
+		uint64 GetBlockSizeLog2(uint64 Size, uint64 Alignment) const;
+
+		/**
+		* Allocates a block, growing the arena if needed. Doesn't report any errors.
+		*/
+		void* AllocateBlock(uint64 Size, uint64 Alignment);
+
+		/**
+		* Returns an allocated block to the free lists, merging it with its free buddies.
+		*/
+		void FreeBlock(APage* Page, uint64 Node, uint64 BlockSizeLog2);
+
+		/**
+		* Finds the page that holds the address, with a binary search of the pages.
+		*
+		* @returns The page, or nullptr if the address isn't in any of the arena's pages.
+		*/
+		APage* FindPage(const void* Address) const;
+
+		/**
+		* Finds the allocated block that starts at 'Allocation', by walking down the page's tree.
+		*
+		* @returns The block's node, or 0 if 'Allocation' isn't the beginning of an allocated block.
+		*/
+		uint64 FindAllocatedNode(const APage* Page, const void* Allocation, uint64& OutBlockSizeLog2) const;
+
+		void InsertFreeBlock(APage* Page, uint64 Node, uint64 BlockSizeLog2);
+
+		void RemoveFreeBlock(APage* Page, uint64 Node, uint64 BlockSizeLog2);
+
+		/**
+		* Turns the page in a single free block and inserts it in the free lists.
+		*/
+		void ResetPage(APage* Page);
+
+		/**
+		* Allocates enough memory for a page, its bitmaps and its blocks.
+		* Also, it inserts the page pointer in the arena's vector.
+		*/
+		APage* AllocateNewPage(uint64 PageSizeLog2);
+
+		/**
+		* Inserts the page in the arena's vector, which is sorted by the pages' addresses.
+		*/
+		void RegisterPage(APage* Page);
+
+	/* Member variables */
+	private:
+		/**
+		* Vector of all available arena's pages (pointers to them), sorted by their blocks' addresses.
+		*/
+		TVector<APage*> m_Pages;
+
+		/**
+		* Bit 'SizeLog2' is set if the list 'm_FreeLists[SizeLog2]' is not empty.
+		*/
+		uint64 m_AvailableSizes = 0;
+
+		/**
+		* Heads of the free lists, one for every block size, shared by all the pages.
+		*/
+		AFreeBlock* m_FreeLists[MaximumBlockSizeLog2] = {};
+
+		uint64 m_MinimumBlockSizeLog2 = 0;
+		uint64 m_PageSizeLog2 = 0;
+
+		uint64 m_TotalBytes = 0;
+		uint64 m_AllocatedBytes = 0;
+
+		/**
+		* Arena's specification. Can't be modified after the creation.
+		*/
+		ABuddyArenaSpecification m_Specification;
+
+		/**
+		* Size of the memory block that holds the specification's pages. The specification is only read during the creation.
+		*/
+		uint64 m_BulkMemoryBytes = 0;
+
+		void* m_BulkMemory = nullptr;
+
+	/* Friends */
+	private:
+		template<typename T, typename... Args>
+		friend constexpr T* MemConstruct(void*, Args&&...);
+	};
+
+}
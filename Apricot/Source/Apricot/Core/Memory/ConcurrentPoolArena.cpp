@@ -0,0 +1,628 @@
+// Part of Apricot Engine. 2022-2022.
+// Module: Memory
+
+#include "aepch.h"
+#include "ConcurrentPoolArena.h"
+
+namespace Apricot {
+
+	namespace Utils {
+
+		FORCEINLINE static uint64 GetConcurrentAllocatedChunksBitmapSize(uint64 ChunksCount)
+		{
+			return ((ChunksCount + 63) / 64) * sizeof(TAtomic<uint64>);
+		}
+
+		FORCEINLINE static uint64 GetConcurrentChunkSize(uint64 ChunkSize)
+		{
+			// The link to the next free chunk must be aligned.
+			ChunkSize = ChunkSize > AConcurrentPoolArena::MinimumChunkSize ? ChunkSize : AConcurrentPoolArena::MinimumChunkSize;
+			return ChunkSize + GetAlignmentOffset(ChunkSize, sizeof(uint32));
+		}
+
+		FORCEINLINE static uint64 GetChunkIndex(const AConcurrentPoolArena::APage* Page, const void* Allocation)
+		{
+			return ((uintptr)Allocation - (uintptr)Page->MemoryBlock) / Page->ChunkSize;
+		}
+
+		FORCEINLINE static TAtomic<uint32>* GetChunkLink(const AConcurrentPoolArena::APage* Page, uint64 ChunkIndex)
+		{
+			return (TAtomic<uint32>*)((uint8*)Page->MemoryBlock + ChunkIndex * Page->ChunkSize);
+		}
+
+		/**
+		* Builds the value of a free list head. The tag is incremented on every change, so a stale head never matches a new one.
+		*/
+		FORCEINLINE static uint64 MakeFreeListHead(uint64 PreviousHead, uint64 FirstChunkIndexPlusOne)
+		{
+			return ((PreviousHead & 0xFFFFFFFF00000000ull) + (1ull << 32)) | FirstChunkIndexPlusOne;
+		}
+
+		/**
+		* Rebuilds the page's free list, marking all its chunks as free.
+		*/
+		static void ResetPageChunks(AConcurrentPoolArena::APage* Page)
+		{
+			for (uint64 Index = 0; Index < Page->ChunksCount; Index++)
+			{
+				// Chunk 'Index' links to chunk 'Index + 1', stored as 'Index + 2'. The last one links to nothing (0).
+				uint32 NextChunkIndexPlusOne = Index + 1 < Page->ChunksCount ? (uint32)(Index + 2) : 0;
+				MemConstruct<TAtomic<uint32>>(GetChunkLink(Page, Index), NextChunkIndexPlusOne);
+			}
+
+		#ifdef AE_ENABLE_MEMORY_CHECK
+			for (uint64 Index = 0; Index < (Page->ChunksCount + 63) / 64; Index++)
+			{
+				Page->AllocatedChunks[Index].Store(0, EMemoryOrder::Relaxed);
+			}
+		#endif
+
+			Page->FreeChunksCount.Store(Page->ChunksCount, EMemoryOrder::Relaxed);
+			Page->FreeListHead.Store(MakeFreeListHead(Page->FreeListHead.Load(EMemoryOrder::Relaxed), Page->ChunksCount > 0 ? 1 : 0), EMemoryOrder::Release);
+		}
+
+		static AConcurrentPoolArena::APage* ConstructNewPage(uint8* ArenaMemory, uint64& Offset, uint64 ChunksCount, uint64 ChunkSize)
+		{
+			uint8* PageMemory = ArenaMemory + Offset;
+			Offset += GetAlignmentOffset(ArenaMemory + Offset, alignof(AConcurrentPoolArena::APage));
+
+			AConcurrentPoolArena::APage* NewPage = (AConcurrentPoolArena::APage*)(ArenaMemory + Offset);
+			MemConstruct<AConcurrentPoolArena::APage>(NewPage);
+			NewPage->PageMemory = PageMemory;
+			Offset += sizeof(AConcurrentPoolArena::APage);
+
+		#ifdef AE_ENABLE_MEMORY_CHECK
+			NewPage->AllocatedChunks = (TAtomic<uint64>*)(ArenaMemory + Offset);
+			for (uint64 Index = 0; Index < (ChunksCount + 63) / 64; Index++)
+			{
+				MemConstruct<TAtomic<uint64>>(NewPage->AllocatedChunks + Index);
+			}
+			Offset += GetConcurrentAllocatedChunksBitmapSize(ChunksCount);
+		#endif
+
+			Offset += GetAlignmentOffset(ArenaMemory + Offset, APoolArena::ChunksAlignment);
+
+			NewPage->MemoryBlock = ArenaMemory + Offset;
+			NewPage->ChunksCount = ChunksCount;
+			NewPage->ChunkSize = GetConcurrentChunkSize(ChunkSize);
+
+			Offset += NewPage->ChunksCount * NewPage->ChunkSize;
+
+			ResetPageChunks(NewPage);
+
+			return NewPage;
+		}
+
+	}
+
+	TSharedPtr<AConcurrentPoolArena> AConcurrentPoolArena::Create(const APoolArenaSpecification& Specification)
+	{
+		return MakeShared<AConcurrentPoolArena>(Specification);
+	}
+
+	NODISCARD uint64 AConcurrentPoolArena::GetMemoryRequirement(const APoolArenaSpecification& Specification)
+	{
+		uint64 MemoryRequirement = 0;
+
+		for (uint64 Index = 0; Index < Specification.PagesCount; Index++)
+		{
+			MemoryRequirement += GetPageMemoryRequirement(Specification.PageChunkCounts[Index], Specification.PageChunkSizes[Index]);
+		}
+
+		return MemoryRequirement;
+	}
+
+	NODISCARD uint64 AConcurrentPoolArena::GetPageMemoryRequirement(uint64 ChunksCount, uint64 ChunkSize)
+	{
+		uint64 MemoryRequirement = 0;
+
+		MemoryRequirement += alignof(APage) - 1;
+		MemoryRequirement += sizeof(APage);
+	#ifdef AE_ENABLE_MEMORY_CHECK
+		MemoryRequirement += Utils::GetConcurrentAllocatedChunksBitmapSize(ChunksCount);
+	#endif
+		MemoryRequirement += APoolArena::ChunksAlignment - 1;
+		MemoryRequirement += ChunksCount * Utils::GetConcurrentChunkSize(ChunkSize);
+
+		return MemoryRequirement;
+	}
+
+	AConcurrentPoolArena::AConcurrentPoolArena(const APoolArenaSpecification& Specification)
+		: AMemoryArena(true), m_Specification(Specification)
+	{
+		AE_CORE_ASSERT(m_Specification.PagesCount <= MaxPagesCount, TEXT("Too many pages in the concurrent pool arena's specification!"));
+
+		uint8* ArenaMemory = (uint8*)m_Specification.ArenaMemory;
+
+		if (m_Specification.bBulkAllocateSpecPages || ArenaMemory)
+		{
+			if (!ArenaMemory)
+			{
+				m_BulkMemoryBytes = GetMemoryRequirement(m_Specification);
+				ArenaMemory = (uint8*)AllocateArenaMemory(m_BulkMemoryBytes, m_Specification.MemoryOptions);
+			}
+			uint64 MemoryOffset = 0;
+
+			for (uint64 Index = 0; Index < m_Specification.PagesCount; Index++)
+			{
+				RegisterPage(Utils::ConstructNewPage(ArenaMemory, MemoryOffset, m_Specification.PageChunkCounts[Index], m_Specification.PageChunkSizes[Index]));
+			}
+
+			if (m_Specification.ArenaMemory)
+			{
+				m_Specification.ArenaMemoryOffset = MemoryOffset;
+			}
+		}
+		else
+		{
+			for (uint64 Index = 0; Index < m_Specification.PagesCount; Index++)
+			{
+				uint64 MemoryOffset = 0;
+				uint64 PageChunksCount = m_Specification.PageChunkCounts[Index];
+				uint64 PageChunkSize = m_Specification.PageChunkSizes[Index];
+
+				ArenaMemory = (uint8*)AllocateArenaMemory(GetPageMemoryRequirement(PageChunksCount, PageChunkSize), m_Specification.MemoryOptions);
+				RegisterPage(Utils::ConstructNewPage(ArenaMemory, MemoryOffset, PageChunksCount, PageChunkSize));
+			}
+		}
+	}
+
+	AConcurrentPoolArena::~AConcurrentPoolArena()
+	{
+		bool8 bSpecPagesAreBulk = m_Specification.bBulkAllocateSpecPages || m_Specification.ArenaMemory;
+		uint64 PagesCount = m_PagesCount.Load(EMemoryOrder::Acquire);
+
+		for (uint64 Index = 0; Index < PagesCount; Index++)
+		{
+			APage* Page = m_Pages[Index];
+			bool8 bIsSpecPage = Index < m_Specification.PagesCount;
+			if ((bIsSpecPage && !bSpecPagesAreBulk) || (!bIsSpecPage && !m_Specification.bUseArenaMemoryAlways))
+			{
+				FreeArenaMemory(Page->PageMemory, GetPageMemoryRequirement(Page->ChunksCount, Page->ChunkSize), m_Specification.MemoryOptions);
+			}
+		}
+		if (bSpecPagesAreBulk && !m_Specification.ArenaMemory && m_Specification.PagesCount > 0)
+		{
+			FreeArenaMemory(m_Pages[0]->PageMemory, m_BulkMemoryBytes, m_Specification.MemoryOptions);
+		}
+	}
+
+	uint64 AConcurrentPoolArena::GetAllocatedSize() const
+	{
+		return GetTotalSize() - GetFreeSize();
+	}
+
+	uint64 AConcurrentPoolArena::GetFreeSize() const
+	{
+		uint64 FreeBytes = 0;
+		uint64 PagesCount = m_PagesCount.Load(EMemoryOrder::Acquire);
+		for (uint64 Index = 0; Index < PagesCount; Index++)
+		{
+			FreeBytes += m_Pages[Index]->FreeChunksCount.Load(EMemoryOrder::Relaxed) * m_Pages[Index]->ChunkSize;
+		}
+		return FreeBytes;
+	}
+
+	uint64 AConcurrentPoolArena::GetTotalSize() const
+	{
+		return m_TotalBytes.Load(EMemoryOrder::Relaxed);
+	}
+
+	const TChar* AConcurrentPoolArena::GetDebugName() const
+	{
+		return TEXT("CONCURRENT_POOL_ARENA");
+	}
+
+	NODISCARD void* AConcurrentPoolArena::Alloc(uint64 Size, uint64 Alignment /*= sizeof(void*)*/, EAllocStrategy Mode /*= EAllocStrategy::BestFit*/)
+	{
+		if (Size == 0)
+		{
+			GCrashReporter->MemoryState.Arena = this;
+			GCrashReporter->MemoryState.Size = Size;
+			GCrashReporter->SubmitArenaFailure(ACrashReporter::EMemoryOperation::Allocate, EMemoryError::InvalidSize);
+			return nullptr;
+		}
+		if (Alignment == 0)
+		{
+			GCrashReporter->MemoryState.Arena = this;
+			GCrashReporter->MemoryState.Alignment = Alignment;
+			GCrashReporter->SubmitArenaFailure(ACrashReporter::EMemoryOperation::Allocate, EMemoryError::InvalidAlignment);
+			return nullptr;
+		}
+
+		uint64 RequiredSize = Size + Alignment - 1;
+
+		uint8* Chunk = (uint8*)AllocateChunk(RequiredSize, Mode);
+		if (Chunk == nullptr)
+		{
+			if (m_Specification.bShouldGrow)
+			{
+				Chunk = (uint8*)GrowAndAllocate(RequiredSize, Mode);
+			}
+
+			if (Chunk == nullptr)
+			{
+				GCrashReporter->MemoryState.Arena = this;
+				GCrashReporter->MemoryState.Size = Size;
+				GCrashReporter->MemoryState.Alignment = Alignment;
+				GCrashReporter->MemoryState.FreeSize = GetFreeSize();
+				GCrashReporter->SubmitArenaFailure(ACrashReporter::EMemoryOperation::Allocate, EMemoryError::OutOfMemoryUnableToGrow);
+				return nullptr;
+			}
+		}
+
+		void* Allocation = Chunk + GetAlignmentOffset(Chunk, Alignment);
+		SubmitAllocationStats(Allocation, Size, Alignment);
+		return Allocation;
+	}
+
+	NODISCARD int32 AConcurrentPoolArena::TryAlloc(uint64 Size, void** OutPointer, uint64 Alignment /*= sizeof(void*)*/, EAllocStrategy Mode /*= EAllocStrategy::BestFit*/)
+	{
+		if (OutPointer == nullptr)
+		{
+			return (int32)EMemoryError::InvalidOuterPointer;
+		}
+		*OutPointer = nullptr;
+
+		if (Size == 0)
+		{
+			return (int32)EMemoryError::InvalidSize;
+		}
+		if (Alignment == 0)
+		{
+			return (int32)EMemoryError::InvalidAlignment;
+		}
+
+		uint64 RequiredSize = Size + Alignment - 1;
+
+		uint8* Chunk = (uint8*)AllocateChunk(RequiredSize, Mode);
+		if (Chunk == nullptr)
+		{
+			if (m_Specification.bShouldGrow)
+			{
+				Chunk = (uint8*)GrowAndAllocate(RequiredSize, Mode);
+			}
+
+			if (Chunk == nullptr)
+			{
+				return (int32)EMemoryError::OutOfMemoryUnableToGrow;
+			}
+		}
+
+		*OutPointer = Chunk + GetAlignmentOffset(Chunk, Alignment);
+		SubmitAllocationStats(*OutPointer, Size, Alignment);
+		return (int32)EMemoryError::Success;
+	}
+
+	NODISCARD void* AConcurrentPoolArena::AllocUnsafe(uint64 Size, uint64 Alignment /*= sizeof(void*)*/, EAllocStrategy Mode /*= EAllocStrategy::BestFit*/)
+	{
+		uint64 RequiredSize = Size + Alignment - 1;
+
+		uint8* Chunk = (uint8*)AllocateChunk(RequiredSize, Mode);
+		if (Chunk == nullptr)
+		{
+			if (!m_Specification.bShouldGrow)
+			{
+				return nullptr;
+			}
+
+			Chunk = (uint8*)GrowAndAllocate(RequiredSize, Mode);
+			if (Chunk == nullptr)
+			{
+				return nullptr;
+			}
+		}
+
+		void* Allocation = Chunk + GetAlignmentOffset(Chunk, Alignment);
+		SubmitAllocationStats(Allocation, Size, Alignment);
+		return Allocation;
+	}
+
+	void AConcurrentPoolArena::Free(void* Allocation, uint64 Size)
+	{
+		if (Allocation == nullptr)
+		{
+			GCrashReporter->MemoryState.Arena = this;
+			GCrashReporter->SubmitArenaFailure(ACrashReporter::EMemoryOperation::Free, EMemoryError::InvalidMemoryPtr);
+			return;
+		}
+
+		APage* Page = FindOwningPage(Allocation);
+		if (Page == nullptr)
+		{
+			GCrashReporter->MemoryState.Arena = this;
+			GCrashReporter->MemoryState.MemoryBlock = Allocation;
+			GCrashReporter->MemoryState.Size = Size;
+			GCrashReporter->SubmitArenaFailure(ACrashReporter::EMemoryOperation::Free, EMemoryError::PointerOutOfRange);
+			return;
+		}
+
+	#ifdef AE_ENABLE_MEMORY_CHECK
+		// Clearing the bit atomically also catches two threads freeing the same chunk at the same time.
+		uint64 ChunkIndex = Utils::GetChunkIndex(Page, Allocation);
+		uint64 ChunkBit = 1ull << (ChunkIndex % 64);
+		if ((Page->AllocatedChunks[ChunkIndex / 64].FetchAnd(~ChunkBit, EMemoryOrder::Relaxed) & ChunkBit) == 0)
+		{
+			GCrashReporter->MemoryState.Arena = this;
+			GCrashReporter->MemoryState.MemoryBlock = Allocation;
+			GCrashReporter->MemoryState.Size = Size;
+			GCrashReporter->SubmitArenaFailure(ACrashReporter::EMemoryOperation::Free, EMemoryError::AlreadyFreed);
+			return;
+		}
+	#endif
+
+		PushChunk(Page, Allocation);
+		SubmitDeallocationStats(Allocation, Size);
+	}
+
+	int32 AConcurrentPoolArena::TryFree(void* Allocation, uint64 Size)
+	{
+		if (Allocation == nullptr)
+		{
+			return (int32)EMemoryError::InvalidMemoryPtr;
+		}
+
+		APage* Page = FindOwningPage(Allocation);
+		if (Page == nullptr)
+		{
+			return (int32)EMemoryError::PointerOutOfRange;
+		}
+
+	#ifdef AE_ENABLE_MEMORY_CHECK
+		uint64 ChunkIndex = Utils::GetChunkIndex(Page, Allocation);
+		uint64 ChunkBit = 1ull << (ChunkIndex % 64);
+		if ((Page->AllocatedChunks[ChunkIndex / 64].FetchAnd(~ChunkBit, EMemoryOrder::Relaxed) & ChunkBit) == 0)
+		{
+			return (int32)EMemoryError::AlreadyFreed;
+		}
+	#endif
+
+		PushChunk(Page, Allocation);
+		SubmitDeallocationStats(Allocation, Size);
+		return (int32)EMemoryError::Success;
+	}
+
+	void AConcurrentPoolArena::FreeUnsafe(void* Allocation, uint64 Size)
+	{
+		APage* Page = FindOwningPage(Allocation);
+
+	#ifdef AE_ENABLE_MEMORY_CHECK
+		uint64 ChunkIndex = Utils::GetChunkIndex(Page, Allocation);
+		Page->AllocatedChunks[ChunkIndex / 64].FetchAnd(~(1ull << (ChunkIndex % 64)), EMemoryOrder::Relaxed);
+	#endif
+
+		PushChunk(Page, Allocation);
+		SubmitDeallocationStats(Allocation, Size);
+	}
+
+	void AConcurrentPoolArena::FreeAll()
+	{
+		FreeAllUnsafe();
+	}
+
+	int32 AConcurrentPoolArena::TryFreeAll()
+	{
+		FreeAllUnsafe();
+		return (int32)EMemoryError::Success;
+	}
+
+	void AConcurrentPoolArena::FreeAllUnsafe()
+	{
+		uint64 PagesCount = m_PagesCount.Load(EMemoryOrder::Acquire);
+		for (uint64 Index = 0; Index < PagesCount; Index++)
+		{
+			Utils::ResetPageChunks(m_Pages[Index]);
+		}
+
+		SubmitDeallocationOfAllStats();
+	}
+
+	void AConcurrentPoolArena::GarbageCollect()
+	{
+	}
+
+	void* AConcurrentPoolArena::AllocateChunk(uint64 RequiredSize, EAllocStrategy Mode)
+	{
+		uint64 PagesCount = m_PagesCount.Load(EMemoryOrder::Acquire);
+
+		while (true)
+		{
+			APage* FoundPage = nullptr;
+			for (uint64 Index = 0; Index < PagesCount; Index++)
+			{
+				APage* Page = m_Pages[Index];
+				if (Page->ChunkSize < RequiredSize || (Page->FreeListHead.Load(EMemoryOrder::Relaxed) & 0xFFFFFFFFull) == 0)
+				{
+					continue;
+				}
+
+				if (Mode == EAllocStrategy::FirstFit)
+				{
+					FoundPage = Page;
+					break;
+				}
+				if (!FoundPage || Page->ChunkSize < FoundPage->ChunkSize)
+				{
+					FoundPage = Page;
+				}
+			}
+
+			if (FoundPage == nullptr)
+			{
+				return nullptr;
+			}
+
+			// Other threads might have emptied the page since it was checked. If so, look for another one.
+			void* Chunk = PopChunk(FoundPage);
+			if (Chunk)
+			{
+				return Chunk;
+			}
+		}
+	}
+
+	void* AConcurrentPoolArena::PopChunk(APage* Page)
+	{
+		uint64 Head = Page->FreeListHead.Load(EMemoryOrder::Acquire);
+
+		while (true)
+		{
+			uint64 ChunkIndexPlusOne = Head & 0xFFFFFFFFull;
+			if (ChunkIndexPlusOne == 0)
+			{
+				return nullptr;
+			}
+
+			// The chunk might be popped and written by another thread before the exchange below. Then the read link is garbage,
+			//	but the exchange fails, because the tag has changed.
+			TAtomic<uint32>* Link = Utils::GetChunkLink(Page, ChunkIndexPlusOne - 1);
+			uint64 NewHead = Utils::MakeFreeListHead(Head, Link->Load(EMemoryOrder::Relaxed));
+
+			if (Page->FreeListHead.CompareExchange(Head, NewHead, EMemoryOrder::Acquire))
+			{
+				Page->FreeChunksCount.FetchSub(1, EMemoryOrder::Relaxed);
+
+			#ifdef AE_ENABLE_MEMORY_CHECK
+				Page->AllocatedChunks[(ChunkIndexPlusOne - 1) / 64].FetchOr(1ull << ((ChunkIndexPlusOne - 1) % 64), EMemoryOrder::Relaxed);
+			#endif
+
+				return Link;
+			}
+		}
+	}
+
+	void AConcurrentPoolArena::PushChunk(APage* Page, void* Allocation)
+	{
+		// The allocation might be offset inside its chunk, because of alignment.
+		uint64 ChunkIndex = Utils::GetChunkIndex(Page, Allocation);
+		TAtomic<uint32>* Link = Utils::GetChunkLink(Page, ChunkIndex);
+
+		uint64 Head = Page->FreeListHead.Load(EMemoryOrder::Relaxed);
+		do
+		{
+			Link->Store((uint32)(Head & 0xFFFFFFFFull), EMemoryOrder::Relaxed);
+		}
+		while (!Page->FreeListHead.CompareExchange(Head, Utils::MakeFreeListHead(Head, ChunkIndex + 1), EMemoryOrder::Release));
+
+		Page->FreeChunksCount.FetchAdd(1, EMemoryOrder::Relaxed);
+	}
+
+	AConcurrentPoolArena::APage* AConcurrentPoolArena::FindOwningPage(const void* Allocation) const
+	{
+		while (true)
+		{
+			uint64 Version = m_SortedPagesVersion.Load(EMemoryOrder::Acquire);
+			if (Version & 1)
+			{
+				CpuPause();
+				continue;
+			}
+
+			// Find the last page whose chunks start before the allocation.
+			uint64 Begin = 0;
+			uint64 End = m_PagesCount.Load(EMemoryOrder::Acquire);
+			while (Begin < End)
+			{
+				uint64 Middle = Begin + (End - Begin) / 2;
+				if ((const uint8*)Allocation < (const uint8*)m_SortedPages[Middle].Load(EMemoryOrder::Acquire)->MemoryBlock)
+				{
+					End = Middle;
+				}
+				else
+				{
+					Begin = Middle + 1;
+				}
+			}
+			APage* Page = Begin > 0 ? m_SortedPages[Begin - 1].Load(EMemoryOrder::Acquire) : nullptr;
+
+			// The entries are loaded with acquire, so the version is read again only after them.
+			if (m_SortedPagesVersion.Load(EMemoryOrder::Relaxed) != Version)
+			{
+				continue;
+			}
+
+			if (Page && (const uint8*)Allocation < (const uint8*)Page->MemoryBlock + Page->ChunksCount * Page->ChunkSize)
+			{
+				return Page;
+			}
+			return nullptr;
+		}
+	}
+
+	void* AConcurrentPoolArena::GrowAndAllocate(uint64 RequiredSize, EAllocStrategy Mode)
+	{
+		TScopedLock<ASpinLock> Lock(m_GrowLock);
+
+		// Another thread might have grown the arena (or freed chunks) while this one was waiting for the lock.
+		void* Chunk = AllocateChunk(RequiredSize, Mode);
+		if (Chunk)
+		{
+			return Chunk;
+		}
+
+		uint64 PagesCount = m_PagesCount.Load(EMemoryOrder::Relaxed);
+		if (PagesCount >= MaxPagesCount)
+		{
+			return nullptr;
+		}
+
+		// Same sizing policy as APoolArena.
+		uint64 NewPageChunksCount = 32;
+		uint64 NewPageChunkSize = RequiredSize;
+		if (PagesCount > 0)
+		{
+			NewPageChunksCount = m_ChunksCountSum / PagesCount;
+			if (NewPageChunkSize < m_ChunkSizeSum / PagesCount)
+			{
+				NewPageChunkSize = m_ChunkSizeSum / PagesCount;
+			}
+		}
+
+		APage* NewPage = nullptr;
+		if (m_Specification.bUseArenaMemoryAlways)
+		{
+			NewPage = Utils::ConstructNewPage((uint8*)m_Specification.ArenaMemory, m_Specification.ArenaMemoryOffset, NewPageChunksCount, NewPageChunkSize);
+		}
+		else
+		{
+			uint64 Offset = 0;
+			uint8* Memory = (uint8*)AllocateArenaMemory(GetPageMemoryRequirement(NewPageChunksCount, NewPageChunkSize), m_Specification.MemoryOptions);
+			NewPage = Utils::ConstructNewPage(Memory, Offset, NewPageChunksCount, NewPageChunkSize);
+		}
+
+		// The chunk is taken before the page is published, so the other threads can't empty the page first.
+		void* NewChunk = PopChunk(NewPage);
+		RegisterPage(NewPage);
+		return NewChunk;
+	}
+
+	void AConcurrentPoolArena::RegisterPage(APage* Page)
+	{
+		AE_CORE_ASSERT(Page->ChunksCount < 0xFFFFFFFFull, TEXT("The chunks of a concurrent pool arena page must be indexable with 32 bits!"));
+
+		m_TotalBytes.FetchAdd(Page->ChunksCount * Page->ChunkSize, EMemoryOrder::Relaxed);
+		m_ChunksCountSum += Page->ChunksCount;
+		m_ChunkSizeSum += Page->ChunkSize;
+
+		uint64 PagesCount = m_PagesCount.Load(EMemoryOrder::Relaxed);
+		uint64 Version = m_SortedPagesVersion.Load(EMemoryOrder::Relaxed);
+		m_SortedPagesVersion.Store(Version + 1, EMemoryOrder::Relaxed);
+
+		// The entries are stored with release, so a reader that sees one of them also sees the odd version.
+		uint64 Index = PagesCount;
+		for (; Index > 0; Index--)
+		{
+			APage* PreviousPage = m_SortedPages[Index - 1].Load(EMemoryOrder::Relaxed);
+			if (PreviousPage->MemoryBlock < Page->MemoryBlock)
+			{
+				break;
+			}
+			m_SortedPages[Index].Store(PreviousPage, EMemoryOrder::Release);
+		}
+		m_SortedPages[Index].Store(Page, EMemoryOrder::Release);
+
+		m_Pages[PagesCount] = Page;
+		m_PagesCount.Store(PagesCount + 1, EMemoryOrder::Release);
+		m_SortedPagesVersion.Store(Version + 2, EMemoryOrder::Release);
+	}
+}
@@ -0,0 +1,262 @@
+// Part of Apricot Engine. 2022-2022.
+// Module: Memory
+
+#pragma once
+
+#include "ApricotMemory.h"
+#include "PoolArena.h"
+
+#include "Apricot/Core/AClass.h"
+#include "Apricot/Core/Atomic.h"
+
+#include "Apricot/Containers/SharedPtr.h"
+
+namespace Apricot {
+
+	/**
+	* C++ Core Engine Architecture
+	*
+	* Thread-safe variant of the Pool Arena. It is created from the same specification as APoolArena.
+	*
+	* Every page has its own lock-free free list (a Treiber stack), so any thread can allocate and free chunks without taking a lock.
+	* The list head packs the index of the first free chunk with a tag that changes on every operation, which makes it safe from
+	*	the ABA problem with a single 64-bit compare-and-swap. Only growing the arena takes a (spin) lock.
+	*
+	* The pages are never deleted while the arena is alive, because other threads might still read the links of their chunks.
+	*/
+	class APRICOT_API AConcurrentPoolArena : public AMemoryArena
+	{
+		ACLASS_CORE()
+
+	public:
+		NODISCARD static TSharedPtr<AConcurrentPoolArena> Create(const APoolArenaSpecification& Specification);
+
+		NODISCARD static uint64 GetMemoryRequirement(const APoolArenaSpecification& Specification);
+
+		NODISCARD static uint64 GetPageMemoryRequirement(uint64 ChunksCount, uint64 ChunkSize);
+
+	/* Constructors & Deconstructor */
+	private:
+		AConcurrentPoolArena(const APoolArenaSpecification& Specification);
+		virtual ~AConcurrentPoolArena() override;
+
+		AConcurrentPoolArena(const AConcurrentPoolArena&) = delete;
+		AConcurrentPoolArena(AConcurrentPoolArena&&) = delete;
+		AConcurrentPoolArena& operator=(const AConcurrentPoolArena&) = delete;
+		AConcurrentPoolArena& operator=(AConcurrentPoolArena&&) = delete;
+
+	/* Typedefs */
+	public:
+		struct APage
+		{
+			/**
+			* Head of the free list. The low 32 bits hold the index of the first free chunk plus one (0 means that the list is empty),
+			*	while the high 32 bits hold the tag.
+			* It lives on its own cache line, because it is the only member that is written after the page's creation.
+			*/
+			alignas(64) TAtomic<uint64> FreeListHead;
+
+			TAtomic<uint64> FreeChunksCount;
+
+			alignas(64) void* MemoryBlock = nullptr;
+
+			/**
+			* The memory block that the page was constructed in. The page header is aligned, so it might not start at its beginning.
+			*/
+			void* PageMemory = nullptr;
+
+			uint64 ChunksCount = 0;
+
+			uint64 ChunkSize = 0;
+
+			/**
+			* One bit for every chunk, set while the chunk is allocated. Used to detect double frees.
+			* Only allocated when AE_ENABLE_MEMORY_CHECK is defined, otherwise it is nullptr.
+			*/
+			TAtomic<uint64>* AllocatedChunks = nullptr;
+		};
+
+		/**
+		* The link to the next free chunk is stored in the chunk itself, so the chunks are at least this big.
+		*/
+		static constexpr uint64 MinimumChunkSize = sizeof(uint32);
+
+		/**
+		* The pages live in a fixed array, so that they can be read without a lock while the arena grows.
+		*/
+		static constexpr uint64 MaxPagesCount = 256;
+
+	/* API interface */
+	public:
+		/**
+		* Allocates from a single chunk of memory. Can be called from any thread.
+		* Generates errors based on the EFailureMode enum value. Always return nullptr on error.
+		*
+		* @param Size The size of the allocation. It is recommended to request maximum of ChunkSize - Alignment.
+		*
+		* @param Alignment The value that the returned pointer is aligned to. This is made possible by padding from the beginning of the chunk.
+		*
+		* @returns A pointer that is guaranteed to have the specified Size and aligned to the specified Alignment.
+		*/
+		NODISCARD void* Alloc(uint64 Size, uint64 Alignment = sizeof(void*), EAllocStrategy Mode = EAllocStrategy::BestFit);
+
+		/**
+		* Allocates from a single chunk of memory. Can be called from any thread.
+		* Main difference from 'Alloc' is that it returns a flag specifying the encountered error. The outer pointer is set to nullptr on error.
+		*
+		* @returns A flag specifying if any errors were encountered. A simple 'if' statement will check for any error flags.
+		*/
+		NODISCARD int32 TryAlloc(uint64 Size, void** OutPointer, uint64 Alignment = sizeof(void*), EAllocStrategy Mode = EAllocStrategy::BestFit);
+
+		/**
+		* Allocates from a single chunk of memory. Can be called from any thread.
+		* It doesn't perform ANY error checking and will most likely unreportedly crash the engine if ANY errors occur.
+		*/
+		NODISCARD void* AllocUnsafe(uint64 Size, uint64 Alignment = sizeof(void*), EAllocStrategy Mode = EAllocStrategy::BestFit);
+
+		/**
+		* Frees the chunk where Allocation is placed. Can be called from any thread, not only from the one that allocated the chunk.
+		* Generates errors based on EFailureMode enum value. Double frees are detected only when AE_ENABLE_MEMORY_CHECK is defined.
+		*/
+		void Free(void* Allocation, uint64 Size);
+
+		/**
+		* Frees the chunk where Allocation is placed. Can be called from any thread.
+		*
+		* @returns A flag specifying if any errors were encountered. A simple 'if' statement will check for any error flags.
+		*/
+		int32 TryFree(void* Allocation, uint64 Size);
+
+		/**
+		* Frees the chunk where Allocation is placed. Can be called from any thread.
+		* It doesn't perform ANY error checking and will most likely unreportedly crash the engine if ANY errors occur.
+		*/
+		void FreeUnsafe(void* Allocation, uint64 Size);
+
+		/**
+		* Frees all the chunks of all pages. No page is deleted.
+		* NOT thread-safe: no other thread may use the arena during the call.
+		*/
+		void FreeAll();
+
+		/**
+		* Same as 'FreeAll'.
+		*/
+		int32 TryFreeAll();
+
+		/**
+		* Same as 'FreeAll'.
+		*/
+		void FreeAllUnsafe();
+
+		/**
+		* Does nothing. The pages are kept for the arena's lifetime.
+		*/
+		virtual void GarbageCollect() override;
+
+	/* Getters & Setters */
+	public:
+		/**
+		* Returns the total size of the used chunks. It is only a snapshot, if other threads are using the arena.
+		*/
+		uint64 GetAllocatedSize() const;
+
+		/**
+		* Returns the total size of the free chunks. It is only a snapshot, if other threads are using the arena.
+		*/
+		uint64 GetFreeSize() const;
+
+		/**
+		* Returns the total size of all chunks (free or not).
+		*/
+		virtual uint64 GetTotalSize() const override;
+
+		/**
+		* Returns the debug tag of the arena.
+		*/
+		virtual const TChar* GetDebugName() const override;
+
+		FORCEINLINE const APoolArenaSpecification& GetSpecification() const { return m_Specification; }
+
+	private:
+		/**
+		* Tries to pop a chunk from one of the pages that can hold 'RequiredSize' bytes. Lock-free.
+		*
+		* @returns The chunk or nullptr if no page has free chunks that can hold the allocation.
+		*/
+		void* AllocateChunk(uint64 RequiredSize, EAllocStrategy Mode);
+
+		/**
+		* Pops a free chunk from the page's free list. Lock-free.
+		*
+		* @returns The chunk or nullptr if the page has no free chunks.
+		*/
+		void* PopChunk(APage* Page);
+
+		/**
+		* Pushes the chunk that contains 'Allocation' back to the page's free list. Lock-free.
+		*/
+		void PushChunk(APage* Page, void* Allocation);
+
+		/**
+		* Returns the page whose chunks contain 'Allocation', with a binary search of the pages. nullptr if the arena doesn't own the pointer.
+		* Doesn't take the grow lock, but the search is repeated if a page was published while it ran.
+		*/
+		APage* FindOwningPage(const void* Allocation) const;
+
+		/**
+		* Creates a new page that can hold 'RequiredSize' bytes and allocates a chunk from it. Takes the grow lock.
+		*
+		* @returns The chunk or nullptr if the arena reached 'MaxPagesCount' pages.
+		*/
+		void* GrowAndAllocate(uint64 RequiredSize, EAllocStrategy Mode);
+
+		/**
+		* Publishes the page, so that the other threads can allocate from it. Must be called with the grow lock held.
+		*/
+		void RegisterPage(APage* Page);
+
+	private:
+		APoolArenaSpecification m_Specification;
+
+		/**
+		* Size of the memory block that holds the specification's pages, if they are bulk allocated. The specification's page
+		*	arrays are only valid during the creation, so the block can't be measured again when the arena is destroyed.
+		*/
+		uint64 m_BulkMemoryBytes = 0;
+
+		/**
+		* The first 'm_PagesCount' entries are valid. An entry is written before the count is incremented, so readers never see it uninitialized.
+		*/
+		APage* m_Pages[MaxPagesCount] = {};
+		TAtomic<uint64> m_PagesCount;
+
+		/**
+		* Serializes the creation of new pages.
+		*/
+		ASpinLock m_GrowLock;
+
+		/**
+		* Only modified with the grow lock held.
+		*/
+		TAtomic<uint64> m_TotalBytes;
+		uint64 m_ChunksCountSum = 0;
+		uint64 m_ChunkSizeSum = 0;
+
+		/**
+		* The first 'm_PagesCount' entries are the pages, sorted by their chunks' addresses. Publishing a page shifts the entries,
+		*	so the version is odd while they are written and the readers search again if it changed under them.
+		*/
+		TAtomic<APage*> m_SortedPages[MaxPagesCount];
+		TAtomic<uint64> m_SortedPagesVersion;
+
+	/* Friends */
+	private:
+		template<typename T, typename... Args>
+		friend constexpr T* MemConstruct(void*, Args&&...);
+
+		template<typename T>
+		friend class TSharedPtr;
+	};
+
+}
@@ -6,22 +6,209 @@
 
 namespace Apricot {
 
-	NODISCARD TSharedPtr<AFreelistArena> AFreelistArena::Create()
+	namespace Utils {
+
+		static constexpr uint64 BlockFreeFlag = 1ull << 0;
+		static constexpr uint64 BlockLastFlag = 1ull << 1;
+		static constexpr uint64 BlockFlagsMask = AFreelistArena::Granularity - 1;
+
+		FORCEINLINE static uint64 GetBlockSize(const AFreelistArena::ABlock* Block)
+		{
+			return Block->SizeAndFlags & ~BlockFlagsMask;
+		}
+
+		FORCEINLINE static void SetBlockSize(AFreelistArena::ABlock* Block, uint64 Size)
+		{
+			Block->SizeAndFlags = Size | (Block->SizeAndFlags & BlockFlagsMask);
+		}
+
+		FORCEINLINE static bool8 IsBlockFree(const AFreelistArena::ABlock* Block)
+		{
+			return (Block->SizeAndFlags & BlockFreeFlag) != 0;
+		}
+
+		FORCEINLINE static bool8 IsBlockLast(const AFreelistArena::ABlock* Block)
+		{
+			return (Block->SizeAndFlags & BlockLastFlag) != 0;
+		}
+
+		FORCEINLINE static void SetBlockFlag(AFreelistArena::ABlock* Block, uint64 Flag, bool8 bValue)
+		{
+			Block->SizeAndFlags = bValue ? (Block->SizeAndFlags | Flag) : (Block->SizeAndFlags & ~Flag);
+		}
+
+		FORCEINLINE static void* GetBlockPayload(AFreelistArena::ABlock* Block)
+		{
+			return (uint8*)Block + AFreelistArena::BlockHeaderSize;
+		}
+
+		FORCEINLINE static AFreelistArena::ABlock* GetPayloadBlock(void* Payload)
+		{
+			return (AFreelistArena::ABlock*)((uint8*)Payload - AFreelistArena::BlockHeaderSize);
+		}
+
+		FORCEINLINE static AFreelistArena::ABlock* GetNextPhysicalBlock(AFreelistArena::ABlock* Block)
+		{
+			return (AFreelistArena::ABlock*)((uint8*)GetBlockPayload(Block) + GetBlockSize(Block));
+		}
+
+		FORCEINLINE static uint64 AlignSizeUp(uint64 Size, uint64 Alignment)
+		{
+			return (Size + Alignment - 1) & ~(Alignment - 1);
+		}
+
+		/**
+		* Maps a block size to the list that holds blocks of that size class.
+		*/
+		FORCEINLINE static void MappingInsert(uint64 Size, uint64& OutFirstLevel, uint64& OutSecondLevel)
+		{
+			if (Size < AFreelistArena::SmallBlockSize)
+			{
+				OutFirstLevel = 0;
+				OutSecondLevel = Size / (AFreelistArena::SmallBlockSize / AFreelistArena::SecondLevelCount);
+			}
+			else
+			{
+				uint64 LastSetBit = FindLastSetBit(Size);
+				OutSecondLevel = (Size >> (LastSetBit - AFreelistArena::SecondLevelCountLog2)) ^ (1ull << AFreelistArena::SecondLevelCountLog2);
+				OutFirstLevel = LastSetBit - (AFreelistArena::FirstLevelShift - 1);
+			}
+		}
+
+		/**
+		* Same as 'MappingInsert', but rounds the size up to the next size class, so that any block of the found list fits.
+		*/
+		FORCEINLINE static void MappingSearch(uint64 Size, uint64& OutFirstLevel, uint64& OutSecondLevel)
+		{
+			if (Size >= AFreelistArena::SmallBlockSize)
+			{
+				Size += (1ull << (FindLastSetBit(Size) - AFreelistArena::SecondLevelCountLog2)) - 1;
+			}
+			MappingInsert(Size, OutFirstLevel, OutSecondLevel);
+		}
+
+		static AFreelistArena::APage* ConstructNewPage(uint8* ArenaMemory, uint64& Offset, uint64 PageSize)
+		{
+			Offset += GetAlignmentOffset(Offset, sizeof(void*));
+
+			AFreelistArena::APage* NewPage = (AFreelistArena::APage*)(ArenaMemory + Offset);
+			MemConstruct<AFreelistArena::APage>(NewPage);
+			Offset += sizeof(AFreelistArena::APage);
+
+			NewPage->MemoryBlock = ArenaMemory + Offset;
+			NewPage->SizeBytes = PageSize;
+
+			Offset += NewPage->SizeBytes;
+
+			return NewPage;
+		}
+
+	}
+
+	NODISCARD TSharedPtr<AFreelistArena> AFreelistArena::Create(const AFreelistArenaSpecification& Specification)
+	{
+		return MakeShared<AFreelistArena>(Specification);
+	}
+
+	NODISCARD uint64 AFreelistArena::GetPageMemoryRequirement(uint64 PageSizeBytes)
 	{
-		return MakeShared<AFreelistArena>();
+		uint64 MemoryRequirement = 0;
+
+		MemoryRequirement += sizeof(APage);
+		MemoryRequirement += PageSizeBytes;
+
+		return MemoryRequirement;
 	}
 
-	AFreelistArena::AFreelistArena()
+	NODISCARD uint64 AFreelistArena::GetMemoryRequirement(const AFreelistArenaSpecification& Specification)
 	{
+		uint64 MemoryRequirement = 0;
+
+		for (uint64 Index = 0; Index < Specification.PagesCount; Index++)
+		{
+			MemoryRequirement += GetAlignmentOffset(MemoryRequirement, sizeof(void*));
+			MemoryRequirement += GetPageMemoryRequirement(Specification.PageSizes[Index]);
+		}
+
+		return MemoryRequirement;
+	}
+
+	AFreelistArena::AFreelistArena(const AFreelistArenaSpecification& Specification)
+		: m_Specification(Specification)
+	{
+		m_Pages.SetCapacity(m_Specification.PagesCount);
+
+		uint8* ArenaMemory = (uint8*)m_Specification.ArenaMemory;
+
+		if (m_Specification.bBulkAllocateSpecPages || ArenaMemory)
+		{
+			if (!ArenaMemory && m_Specification.PagesCount > 0)
+			{
+				m_BulkMemoryBytes = GetMemoryRequirement(m_Specification);
+				ArenaMemory = (uint8*)AllocateArenaMemory(m_BulkMemoryBytes, m_Specification.MemoryOptions);
+			}
+			uint64 MemoryOffset = 0;
+
+			for (uint64 Index = 0; Index < m_Specification.PagesCount; Index++)
+			{
+				m_Pages.PushBack(Utils::ConstructNewPage(ArenaMemory, MemoryOffset, m_Specification.PageSizes[Index]));
+			}
+
+			if (m_Specification.ArenaMemory)
+			{
+				m_Specification.ArenaMemoryOffset = MemoryOffset;
+			}
+		}
+		else
+		{
+			for (uint64 Index = 0; Index < m_Specification.PagesCount; Index++)
+			{
+				uint64 MemoryOffset = 0;
+				uint64 PageSizeBytes = m_Specification.PageSizes[Index];
+
+				ArenaMemory = (uint8*)AllocateArenaMemory(GetPageMemoryRequirement(PageSizeBytes), m_Specification.MemoryOptions);
+				m_Pages.PushBack(Utils::ConstructNewPage(ArenaMemory, MemoryOffset, PageSizeBytes));
+			}
+		}
+
+		for (uint64 Index = 0; Index < m_Pages.Size(); Index++)
+		{
+			m_TotalBytes += m_Pages[Index]->SizeBytes;
+			ResetPage(m_Pages[Index]);
+		}
 	}
 
 	AFreelistArena::~AFreelistArena()
 	{
+		bool8 bSpecPagesAreBulk = m_Specification.bBulkAllocateSpecPages || m_Specification.ArenaMemory;
+
+		for (uint64 Index = 0; Index < m_Pages.Size(); Index++)
+		{
+			bool8 bIsSpecPage = Index < m_Specification.PagesCount;
+			if ((bIsSpecPage && !bSpecPagesAreBulk) || (!bIsSpecPage && !m_Specification.bUseArenaMemoryAlways))
+			{
+				FreeArenaMemory(m_Pages[Index], GetPageMemoryRequirement(m_Pages[Index]->SizeBytes), m_Specification.MemoryOptions);
+			}
+		}
+		if (bSpecPagesAreBulk && !m_Specification.ArenaMemory && m_Specification.PagesCount > 0)
+		{
+			FreeArenaMemory(m_Pages[0], m_BulkMemoryBytes, m_Specification.MemoryOptions);
+		}
+	}
+
+	uint64 AFreelistArena::GetTotalSize() const
+	{
+		return m_TotalBytes;
 	}
 
-	void AFreelistArena::GarbageCollect()
+	uint64 AFreelistArena::GetAllocatedSize() const
 	{
-		
+		return m_AllocatedBytes;
+	}
+
+	uint64 AFreelistArena::GetFreeSize() const
+	{
+		return m_FreeBytes;
 	}
 
 	const TChar* AFreelistArena::GetDebugName() const
@@ -29,4 +216,499 @@ namespace Apricot {
 		return TEXT("FREELIST_ARENA");
 	}
 
-}
\ No newline at end of file
+	NODISCARD void* AFreelistArena::Alloc(uint64 Size, uint64 Alignment /*= sizeof(void*)*/)
+	{
+	#ifdef AE_ENABLE_MEMORY_CHECK
+		if (Size == 0 || Size > MaximumBlockSize)
+		{
+			GCrashReporter->MemoryState.Arena = this;
+			GCrashReporter->MemoryState.Size = Size;
+			GCrashReporter->SubmitArenaFailure(ACrashReporter::EMemoryOperation::Allocate, EMemoryError::InvalidSize);
+			return nullptr;
+		}
+		if (!IsPowerOfTwo(Alignment))
+		{
+			GCrashReporter->MemoryState.Arena = this;
+			GCrashReporter->MemoryState.Alignment = Alignment;
+			GCrashReporter->SubmitArenaFailure(ACrashReporter::EMemoryOperation::Allocate, EMemoryError::InvalidAlignment);
+			return nullptr;
+		}
+	#endif
+
+		BeginOwnerAllocation();
+
+		void* Memory = AllocateBlock(Size, Alignment);
+		if (!Memory)
+		{
+			GCrashReporter->MemoryState.Arena = this;
+			GCrashReporter->MemoryState.Size = Size;
+			GCrashReporter->MemoryState.Alignment = Alignment;
+			GCrashReporter->MemoryState.FreeSize = m_FreeBytes;
+			GCrashReporter->SubmitArenaFailure(ACrashReporter::EMemoryOperation::Allocate, EMemoryError::OutOfMemoryUnableToGrow);
+		}
+		return Memory;
+	}
+
+	NODISCARD int32 AFreelistArena::TryAlloc(uint64 Size, void** OutPointer, uint64 Alignment /*= sizeof(void*)*/)
+	{
+		if (OutPointer == nullptr)
+		{
+			return (int32)EMemoryError::InvalidOuterPointer;
+		}
+		if (Size == 0 || Size > MaximumBlockSize)
+		{
+			*OutPointer = nullptr;
+			return (int32)EMemoryError::InvalidSize;
+		}
+		if (!IsPowerOfTwo(Alignment))
+		{
+			*OutPointer = nullptr;
+			return (int32)EMemoryError::InvalidAlignment;
+		}
+
+		BeginOwnerAllocation();
+
+		*OutPointer = AllocateBlock(Size, Alignment);
+		if (*OutPointer == nullptr)
+		{
+			return (int32)EMemoryError::OutOfMemoryUnableToGrow;
+		}
+		return (int32)EMemoryError::Success;
+	}
+
+	NODISCARD void* AFreelistArena::AllocUnsafe(uint64 Size, uint64 Alignment /*= sizeof(void*)*/)
+	{
+		BeginOwnerAllocation();
+
+		return AllocateBlock(Size, Alignment);
+	}
+
+	void AFreelistArena::Free(void* Allocation, uint64 Size)
+	{
+		if (Allocation == nullptr)
+		{
+			return;
+		}
+
+		if (IsRemoteThread())
+		{
+			// The payloads are at least 'MinimumBlockSize' bytes, so they can always hold the node.
+			PushRemoteFree(Allocation, Size);
+			return;
+		}
+
+		ABlock* Block = Utils::GetPayloadBlock(Allocation);
+
+	#ifdef AE_ENABLE_MEMORY_CHECK
+		if (Utils::IsBlockFree(Block))
+		{
+			GCrashReporter->MemoryState.Arena = this;
+			GCrashReporter->MemoryState.MemoryBlock = Allocation;
+			GCrashReporter->MemoryState.Size = Size;
+			GCrashReporter->SubmitArenaFailure(ACrashReporter::EMemoryOperation::Free, EMemoryError::AlreadyFreed);
+			return;
+		}
+	#endif
+
+		FreeBlock(Block);
+		SubmitDeallocationStats(Allocation, Size);
+	}
+
+	int32 AFreelistArena::TryFree(void* Allocation, uint64 Size)
+	{
+		if (Allocation == nullptr)
+		{
+			return (int32)EMemoryError::InvalidMemoryPtr;
+		}
+
+		if (IsRemoteThread())
+		{
+			// The owner's pages can't be read from this thread, so the allocation isn't validated.
+			// The payloads are at least 'MinimumBlockSize' bytes, so they can always hold the node.
+			PushRemoteFree(Allocation, Size);
+			return (int32)EMemoryError::Success;
+		}
+
+		if (!OwnsAllocation(Allocation))
+		{
+			return (int32)EMemoryError::PointerOutOfRange;
+		}
+
+		ABlock* Block = Utils::GetPayloadBlock(Allocation);
+		if (Utils::IsBlockFree(Block))
+		{
+			return (int32)EMemoryError::AlreadyFreed;
+		}
+
+		FreeBlock(Block);
+		SubmitDeallocationStats(Allocation, Size);
+		return (int32)EMemoryError::Success;
+	}
+
+	void AFreelistArena::FreeUnsafe(void* Allocation, uint64 Size)
+	{
+		if (IsRemoteThread())
+		{
+			// The payloads are at least 'MinimumBlockSize' bytes, so they can always hold the node.
+			PushRemoteFree(Allocation, Size);
+			return;
+		}
+
+		FreeBlock(Utils::GetPayloadBlock(Allocation));
+		SubmitDeallocationStats(Allocation, Size);
+	}
+
+	void AFreelistArena::FreeAll()
+	{
+		FreeAllUnsafe();
+	}
+
+	int32 AFreelistArena::TryFreeAll()
+	{
+		FreeAllUnsafe();
+		return (int32)EMemoryError::Success;
+	}
+
+	void AFreelistArena::FreeAllUnsafe()
+	{
+		// The blocks freed by the other threads are freed with everything else.
+		TakeRemoteFrees();
+
+		m_FirstLevelBitmap = 0;
+		AE_MEMZERO_ARRAY(m_SecondLevelBitmaps);
+		AE_MEMZERO_ARRAY(m_FreeLists);
+
+		m_AllocatedBytes = 0;
+		m_FreeBytes = 0;
+
+		for (uint64 Index = 0; Index < m_Pages.Size(); Index++)
+		{
+			ResetPage(m_Pages[Index]);
+		}
+
+		SubmitDeallocationOfAllStats();
+	}
+
+	void AFreelistArena::DrainRemoteFrees()
+	{
+		// The frees of another thread would be pushed straight back on the stack.
+		if (IsRemoteThread())
+		{
+			return;
+		}
+
+		ARemoteFreeNode* Node = TakeRemoteFrees();
+		while (Node)
+		{
+			// The node is stored in the allocation, so it must be read before the allocation is freed.
+			ARemoteFreeNode* Next = Node->Next;
+			Free(Node, Node->Size);
+			Node = Next;
+		}
+	}
+
+	void AFreelistArena::GarbageCollect()
+	{
+		DrainRemoteFrees();
+
+		for (int64 Index = (int64)m_Pages.Size() - 1; Index >= (int64)m_Specification.PagesCount; Index--)
+		{
+			APage* Page = m_Pages[Index];
+			ABlock* FirstBlock = (ABlock*)Page->MemoryBlock;
+
+			// A page without allocations is a single free block.
+			if (Utils::IsBlockFree(FirstBlock) && Utils::IsBlockLast(FirstBlock))
+			{
+				RemoveFreeBlock(FirstBlock);
+				m_TotalBytes -= Page->SizeBytes;
+
+				if (!m_Specification.bUseArenaMemoryAlways)
+				{
+					FreeArenaMemory(Page, GetPageMemoryRequirement(Page->SizeBytes), m_Specification.MemoryOptions);
+				}
+
+				m_Pages.Erase(Index);
+			}
+		}
+	}
+
+	void* AFreelistArena::AllocateBlock(uint64 Size, uint64 Alignment)
+	{
+		uint64 AdjustedSize = Utils::AlignSizeUp(Size < MinimumBlockSize ? MinimumBlockSize : Size, Granularity);
+
+		// Leave room for carving a leading free block, in case the payload isn't aligned.
+		uint64 SearchSize = AdjustedSize;
+		if (Alignment > Granularity)
+		{
+			SearchSize += Alignment + BlockHeaderSize + MinimumBlockSize;
+		}
+
+		ABlock* Block = FindFreeBlock(SearchSize);
+		if (!Block)
+		{
+			if (!m_Specification.bShouldGrow)
+			{
+				return nullptr;
+			}
+
+			AllocateNewPage(GetOptimalPageSize(SearchSize));
+			Block = FindFreeBlock(SearchSize);
+			if (!Block)
+			{
+				return nullptr;
+			}
+		}
+
+		if (Alignment > Granularity)
+		{
+			uint8* Payload = (uint8*)Utils::GetBlockPayload(Block);
+			if (GetAlignmentOffset(Payload, Alignment) != 0)
+			{
+				// The leading block must be big enough to be a valid free block.
+				uint64 LeadingSize = BlockHeaderSize + MinimumBlockSize;
+				LeadingSize += GetAlignmentOffset(Payload + LeadingSize, Alignment);
+
+				ABlock* AlignedBlock = (ABlock*)(Payload + LeadingSize - BlockHeaderSize);
+				AlignedBlock->PreviousPhysicalBlock = Block;
+				AlignedBlock->SizeAndFlags = 0;
+				Utils::SetBlockSize(AlignedBlock, Utils::GetBlockSize(Block) - LeadingSize);
+				Utils::SetBlockFlag(AlignedBlock, Utils::BlockLastFlag, Utils::IsBlockLast(Block));
+				if (!Utils::IsBlockLast(AlignedBlock))
+				{
+					Utils::GetNextPhysicalBlock(AlignedBlock)->PreviousPhysicalBlock = AlignedBlock;
+				}
+
+				// The leading block's physical neighbours are used, so there is nothing to coalesce with.
+				Utils::SetBlockSize(Block, LeadingSize - BlockHeaderSize);
+				Utils::SetBlockFlag(Block, Utils::BlockLastFlag, false);
+				Utils::SetBlockFlag(Block, Utils::BlockFreeFlag, true);
+				InsertFreeBlock(Block);
+
+				Block = AlignedBlock;
+			}
+		}
+
+		SplitBlock(Block, AdjustedSize);
+
+		Utils::SetBlockFlag(Block, Utils::BlockFreeFlag, false);
+		m_AllocatedBytes += Utils::GetBlockSize(Block);
+		void* Payload = Utils::GetBlockPayload(Block);
+		SubmitAllocationStats(Payload, Size, Alignment);
+		return Payload;
+	}
+
+	void AFreelistArena::FreeBlock(ABlock* Block)
+	{
+		m_AllocatedBytes -= Utils::GetBlockSize(Block);
+		Utils::SetBlockFlag(Block, Utils::BlockFreeFlag, true);
+
+		ABlock* PreviousBlock = Block->PreviousPhysicalBlock;
+		if (PreviousBlock && Utils::IsBlockFree(PreviousBlock))
+		{
+			RemoveFreeBlock(PreviousBlock);
+
+			Utils::SetBlockSize(PreviousBlock, Utils::GetBlockSize(PreviousBlock) + BlockHeaderSize + Utils::GetBlockSize(Block));
+			Utils::SetBlockFlag(PreviousBlock, Utils::BlockLastFlag, Utils::IsBlockLast(Block));
+			Block = PreviousBlock;
+
+			if (!Utils::IsBlockLast(Block))
+			{
+				Utils::GetNextPhysicalBlock(Block)->PreviousPhysicalBlock = Block;
+			}
+		}
+
+		if (!Utils::IsBlockLast(Block))
+		{
+			ABlock* NextBlock = Utils::GetNextPhysicalBlock(Block);
+			if (Utils::IsBlockFree(NextBlock))
+			{
+				RemoveFreeBlock(NextBlock);
+
+				Utils::SetBlockSize(Block, Utils::GetBlockSize(Block) + BlockHeaderSize + Utils::GetBlockSize(NextBlock));
+				Utils::SetBlockFlag(Block, Utils::BlockLastFlag, Utils::IsBlockLast(NextBlock));
+
+				if (!Utils::IsBlockLast(Block))
+				{
+					Utils::GetNextPhysicalBlock(Block)->PreviousPhysicalBlock = Block;
+				}
+			}
+		}
+
+		InsertFreeBlock(Block);
+	}
+
+	AFreelistArena::ABlock* AFreelistArena::FindFreeBlock(uint64 Size)
+	{
+		if (Size > MaximumBlockSize)
+		{
+			return nullptr;
+		}
+
+		uint64 FirstLevel, SecondLevel;
+		Utils::MappingSearch(Size, FirstLevel, SecondLevel);
+		if (FirstLevel >= FirstLevelCount)
+		{
+			return nullptr;
+		}
+
+		// Search for a non-empty list in the same first-level class, starting from the rounded-up second-level class.
+		uint32 SecondLevelMap = m_SecondLevelBitmaps[FirstLevel] & (~0u << SecondLevel);
+		if (!SecondLevelMap)
+		{
+			// Otherwise, take the smallest non-empty list from a bigger first-level class.
+			uint64 FirstLevelMap = m_FirstLevelBitmap & (~0ull << (FirstLevel + 1));
+			if (!FirstLevelMap)
+			{
+				return nullptr;
+			}
+
+			FirstLevel = FindFirstSetBit(FirstLevelMap);
+			SecondLevelMap = m_SecondLevelBitmaps[FirstLevel];
+		}
+		SecondLevel = FindFirstSetBit(SecondLevelMap);
+
+		ABlock* Block = m_FreeLists[FirstLevel][SecondLevel];
+		RemoveFreeBlock(Block);
+		return Block;
+	}
+
+	void AFreelistArena::InsertFreeBlock(ABlock* Block)
+	{
+		uint64 FirstLevel, SecondLevel;
+		Utils::MappingInsert(Utils::GetBlockSize(Block), FirstLevel, SecondLevel);
+
+		ABlock* Head = m_FreeLists[FirstLevel][SecondLevel];
+		Block->NextFree = Head;
+		Block->PreviousFree = nullptr;
+		if (Head)
+		{
+			Head->PreviousFree = Block;
+		}
+
+		m_FreeLists[FirstLevel][SecondLevel] = Block;
+		m_FirstLevelBitmap |= (1ull << FirstLevel);
+		m_SecondLevelBitmaps[FirstLevel] |= (1u << SecondLevel);
+
+		m_FreeBytes += Utils::GetBlockSize(Block);
+	}
+
+	void AFreelistArena::RemoveFreeBlock(ABlock* Block)
+	{
+		uint64 FirstLevel, SecondLevel;
+		Utils::MappingInsert(Utils::GetBlockSize(Block), FirstLevel, SecondLevel);
+
+		if (Block->NextFree)
+		{
+			Block->NextFree->PreviousFree = Block->PreviousFree;
+		}
+		if (Block->PreviousFree)
+		{
+			Block->PreviousFree->NextFree = Block->NextFree;
+		}
+
+		if (m_FreeLists[FirstLevel][SecondLevel] == Block)
+		{
+			m_FreeLists[FirstLevel][SecondLevel] = Block->NextFree;
+			if (!Block->NextFree)
+			{
+				m_SecondLevelBitmaps[FirstLevel] &= ~(1u << SecondLevel);
+				if (!m_SecondLevelBitmaps[FirstLevel])
+				{
+					m_FirstLevelBitmap &= ~(1ull << FirstLevel);
+				}
+			}
+		}
+
+		Block->NextFree = nullptr;
+		Block->PreviousFree = nullptr;
+
+		m_FreeBytes -= Utils::GetBlockSize(Block);
+	}
+
+	void AFreelistArena::SplitBlock(ABlock* Block, uint64 Size)
+	{
+		uint64 BlockSize = Utils::GetBlockSize(Block);
+		if (BlockSize < Size + BlockHeaderSize + MinimumBlockSize)
+		{
+			// The remainder is too small to be a block. It stays as internal padding.
+			return;
+		}
+
+		ABlock* Remainder = (ABlock*)((uint8*)Utils::GetBlockPayload(Block) + Size);
+		Remainder->PreviousPhysicalBlock = Block;
+		Remainder->SizeAndFlags = 0;
+		Utils::SetBlockSize(Remainder, BlockSize - Size - BlockHeaderSize);
+		Utils::SetBlockFlag(Remainder, Utils::BlockLastFlag, Utils::IsBlockLast(Block));
+		Utils::SetBlockFlag(Remainder, Utils::BlockFreeFlag, true);
+		if (!Utils::IsBlockLast(Remainder))
+		{
+			Utils::GetNextPhysicalBlock(Remainder)->PreviousPhysicalBlock = Remainder;
+		}
+
+		Utils::SetBlockSize(Block, Size);
+		Utils::SetBlockFlag(Block, Utils::BlockLastFlag, false);
+
+		// The block was taken out of a free list, so its next physical neighbour is used. Nothing to coalesce with.
+		InsertFreeBlock(Remainder);
+	}
+
+	void AFreelistArena::ResetPage(APage* Page)
+	{
+		ABlock* Block = (ABlock*)Page->MemoryBlock;
+		Block->PreviousPhysicalBlock = nullptr;
+		Block->SizeAndFlags = 0;
+		Utils::SetBlockSize(Block, (Page->SizeBytes - BlockHeaderSize) & ~(Granularity - 1));
+		Utils::SetBlockFlag(Block, Utils::BlockFreeFlag, true);
+		Utils::SetBlockFlag(Block, Utils::BlockLastFlag, true);
+
+		InsertFreeBlock(Block);
+	}
+
+	uint64 AFreelistArena::GetOptimalPageSize(uint64 RequestedAllocationSize) const
+	{
+		uint64 RequiredSize = BlockHeaderSize + RequestedAllocationSize;
+
+		// Round the requested size up to the next size class, so that the new page's block is found by the mapping search.
+		if (RequiredSize >= SmallBlockSize)
+		{
+			RequiredSize += (1ull << (FindLastSetBit(RequiredSize) - SecondLevelCountLog2));
+		}
+
+		uint64 LastPageSize = m_Pages.IsEmpty() ? 0 : m_Pages.Back()->SizeBytes;
+		return LastPageSize > RequiredSize ? LastPageSize : RequiredSize;
+	}
+
+	AFreelistArena::APage* AFreelistArena::AllocateNewPage(uint64 PageSize)
+	{
+		APage* NewPage = nullptr;
+		if (m_Specification.bUseArenaMemoryAlways)
+		{
+			NewPage = Utils::ConstructNewPage((uint8*)m_Specification.ArenaMemory, m_Specification.ArenaMemoryOffset, PageSize);
+		}
+		else
+		{
+			uint64 Offset = 0;
+			NewPage = Utils::ConstructNewPage((uint8*)AllocateArenaMemory(GetPageMemoryRequirement(PageSize), m_Specification.MemoryOptions), Offset, PageSize);
+		}
+
+		m_Pages.PushBack(NewPage);
+		m_TotalBytes += NewPage->SizeBytes;
+		ResetPage(NewPage);
+
+		return NewPage;
+	}
+
+	bool8 AFreelistArena::OwnsAllocation(const void* Allocation) const
+	{
+		for (uint64 Index = 0; Index < m_Pages.Size(); Index++)
+		{
+			const APage* Page = m_Pages[Index];
+			if (IsAddressBetween(Allocation, (uint8*)Page->MemoryBlock + BlockHeaderSize, (uint8*)Page->MemoryBlock + Page->SizeBytes - 1))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+}
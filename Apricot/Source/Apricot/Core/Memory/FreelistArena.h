@@ -7,44 +7,373 @@
 #include "Apricot/Core/AClass.h"
 
 namespace Apricot {
-	
+
+	/**
+	* AFreelistArena Specification
+	*
+	* These are the initial arena's specifications. Might not be up-to-date.
+	*/
+	struct AFreelistArenaSpecification
+	{
+		/**
+		* Count of initial pages. These are allocated at the same time as the arena itself.
+		*/
+		uint64 PagesCount = 0;
+
+		/**
+		* Array of sizes for the initial pages. Must be the same size as 'PagesCount'.
+		* Might be invalid after the arena creation. So this is a temporary parameter.
+		*/
+		uint64* PageSizes = nullptr;
+
+		/**
+		* Pointer to a memory block that will be used to allocate memory for the arena. Pointer should
+		*	be valid on the entire arena's lifetime. If this is nullptr, the memory will be allocated from the global heap.
+		*/
+		void* ArenaMemory = nullptr;
+
+		/**
+		* Offset in 'ArenaMemory' where the next page will be constructed.
+		*/
+		uint64 ArenaMemoryOffset = 0;
+
+		/**
+		* Tells the arena if it can allocate new pages when it gets out of memory.
+		* If this is false, and the arena runs out of memory, an 'error' will be issued.
+		*/
+		bool bShouldGrow = true;
+
+		/**
+		* If true, the new pages will also be constructed in 'ArenaMemory'.
+		*/
+		bool bUseArenaMemoryAlways = false;
+
+		/**
+		* If true, all specification pages are allocated as a single memory block.
+		*/
+		bool bBulkAllocateSpecPages = true;
+
+		/**
+		* Controls how the pages' memory is obtained from the system (huge pages, prefaulting, locking).
+		* Doesn't apply to the memory provided through 'ArenaMemory'.
+		*/
+		AArenaMemoryOptions MemoryOptions;
+	};
+
 	/**
 	* C++ Core Engine Architecture
-	* 
-	* Freelist Arena implementation
+	*
+	* Freelist Arena implementation.
+	* General purpose allocator based on the TLSF (Two-Level Segregated Fit) strategy. Free blocks are kept in segregated
+	*	lists, indexed by a two-level bitmap, so both allocation and freeing run in constant time, regardless of the
+	*	number of blocks. Freed blocks are immediately coalesced with their free physical neighbours.
 	*/
 	class APRICOT_API AFreelistArena : public AMemoryArena
 	{
 		ACLASS_CORE()
 
 	public:
-		NODISCARD static TSharedPtr<AFreelistArena> Create();
-	
-		/* Constructors & Deconstructor */
+		NODISCARD static TSharedPtr<AFreelistArena> Create(const AFreelistArenaSpecification& Specification);
+
+		NODISCARD static uint64 GetPageMemoryRequirement(uint64 PageSizeBytes);
+
+		NODISCARD static uint64 GetMemoryRequirement(const AFreelistArenaSpecification& Specification);
+
+	/* Constructors & Deconstructor */
 	private:
-		AFreelistArena();
+		AFreelistArena(const AFreelistArenaSpecification& Specification);
 		virtual ~AFreelistArena() override;
 
 		AFreelistArena(const AFreelistArena&) = delete;
 		AFreelistArena&operator=(const AFreelistArena&) = delete;
 		AFreelistArena(AFreelistArena&&) = delete;
 		AFreelistArena& operator=(AFreelistArena&&) = delete;
-	
+
 	/* Typedefs */
 	public:
-		
+		struct APage
+		{
+			/**
+			* Pointer to the page's memory. The first block header lives at its beginning.
+			*/
+			void* MemoryBlock = nullptr;
+
+			/**
+			* The size (in bytes) of the memory block.
+			*/
+			uint64 SizeBytes = AE_INVALID_MEMSIZE;
+		};
+
+		struct ABlock
+		{
+			/**
+			* The block that is physically before this one. nullptr if this is the first block of a page.
+			*/
+			ABlock* PreviousPhysicalBlock = nullptr;
+
+			/**
+			* The size (in bytes) of the block's payload. The low bits store the block's flags.
+			*/
+			uint64 SizeAndFlags = 0;
+
+			/**
+			* Free list links. They overlap the payload, so they cost nothing for the used blocks.
+			*/
+			ABlock* NextFree = nullptr;
+			ABlock* PreviousFree = nullptr;
+		};
+
+		/**
+		* log2 of the size granularity. All block sizes are multiples of (1 << GranularityLog2).
+		*/
+		static constexpr uint64 GranularityLog2 = 3;
+		static constexpr uint64 Granularity = 1ull << GranularityLog2;
+
+		/**
+		* log2 of the number of second-level lists each first-level class is split into.
+		*/
+		static constexpr uint64 SecondLevelCountLog2 = 5;
+		static constexpr uint64 SecondLevelCount = 1ull << SecondLevelCountLog2;
 
-	/* API */
+		/**
+		* Blocks smaller than 'SmallBlockSize' are all mapped in the first first-level class, linearly.
+		*/
+		static constexpr uint64 FirstLevelShift = SecondLevelCountLog2 + GranularityLog2;
+		static constexpr uint64 SmallBlockSize = 1ull << FirstLevelShift;
+
+		/**
+		* Blocks must be smaller than (1 << FirstLevelMax) bytes.
+		*/
+		static constexpr uint64 FirstLevelMax = 40;
+		static constexpr uint64 FirstLevelCount = FirstLevelMax - FirstLevelShift + 1;
+
+		/**
+		* The size of a block header that precedes every payload. The free links are not part of it.
+		*/
+		static constexpr uint64 BlockHeaderSize = sizeof(ABlock*) + sizeof(uint64);
+
+		/**
+		* The smallest payload of a block. It must be able to hold the free list links.
+		*/
+		static constexpr uint64 MinimumBlockSize = sizeof(ABlock) - BlockHeaderSize;
+
+		static constexpr uint64 MaximumBlockSize = (1ull << FirstLevelMax) - 1;
+
+	/* API interface */
 	public:
+		/**
+		* Allocates a block of memory, in constant time.
+		* Issues errors based on the value of EFailureMode.
+		*
+		* @param Size The size of the allocation.
+		*
+		* @param Alignment The alignment of the memory block. Must be a power of two.
+		*			Default value is sizeof(void*), which, in case of allocating structs bigger than sizeof(void) bytes, is optimal for most platforms.
+		*
+		* @returns Pointer to the aligned memory block. In case of failure, it will return nullptr.
+		*/
+		NODISCARD void* Alloc(uint64 Size, uint64 Alignment = sizeof(void*));
+
+		/**
+		* Allocates a block of memory, in constant time.
+		* Same as 'Alloc', but it returns a flag indicating failure or success.
+		*
+		* @param Size The size of the allocation.
+		*
+		* @param OutPointer Out parameter, holds the 'returned' pointer. Must NOT be nullptr.
+		*
+		* @param Alignment The alignment of the memory block. Must be a power of two.
+		*
+		* @returns A flag specifying if any errors were encountered. A simple 'if' statement will check for any error flags.
+		*/
+		NODISCARD int32 TryAlloc(uint64 Size, void** OutPointer, uint64 Alignment = sizeof(void*));
+
+		/**
+		* Allocates a block of memory, in constant time.
+		* Does NOT issue ANY errors.
+		*
+		* @param Size The size of the allocation.
+		*
+		* @param Alignment The alignment of the memory block. Must be a power of two.
+		*
+		* @returns Pointer to the aligned memory block. It will return nullptr ONLY when the arena is out of memory and 'bShouldGrow' is false.
+		*/
+		NODISCARD void* AllocUnsafe(uint64 Size, uint64 Alignment = sizeof(void*));
+
+		/**
+		* Frees the block where Allocation is placed, and coalesces it with its free neighbours. Runs in constant time.
+		* Generates errors based on EFailureMode enum value.
+		*
+		* @param Allocation Pointer to the memory to be freed.
+		*
+		* @param Size Size of the allocation. Currently, used only for debugging.
+		*/
+		void Free(void* Allocation, uint64 Size);
+
+		/**
+		* Frees the block where Allocation is placed.
+		* Same behavior as 'Free', but it validates the pointer and returns a flag specifying if any errors were encountered.
+		*
+		* @param Allocation Pointer to the memory to be freed.
+		*
+		* @param Size Size of the allocation. Currently, used only for debugging.
+		*
+		* @returns A flag specifying if any errors were encountered. A simple 'if' statement will check for any error flags.
+		*/
+		int32 TryFree(void* Allocation, uint64 Size);
+
+		/**
+		* Frees the block where Allocation is placed.
+		* It doesn't perform ANY error checking and will most likely unreportedly crash the engine if ANY errors occur.
+		*
+		* @param Allocation Pointer to the memory to be freed.
+		*
+		* @param Size Size of the allocation. Currently, used only for debugging.
+		*/
+		void FreeUnsafe(void* Allocation, uint64 Size);
+
+		/**
+		* Frees all allocations, turning every page back into a single free block. No page is deleted.
+		* It will always succeed.
+		*/
+		void FreeAll();
+
+		/**
+		* Frees all allocations, turning every page back into a single free block. No page is deleted.
+		*
+		* @returns A flag specifying if any errors were encountered. A simple 'if' statement will check for any error flags.
+		*/
+		int32 TryFreeAll();
+
+		/**
+		* Frees all allocations, turning every page back into a single free block. No page is deleted.
+		* It will always succeed.
+		*/
+		void FreeAllUnsafe();
+
+		/**
+		* Deletes all the pages that don't hold any allocation. It cannot delete the specification pages, because they aren't allocated individually.
+		*/
 		virtual void GarbageCollect() override;
 
+		/**
+		* Frees the allocations that the other threads freed since the last allocation. Does nothing when called by a thread other than the owner.
+		*/
+		virtual void DrainRemoteFrees() override;
+
 	/* Getters & Setters */
 	public:
+		/**
+		* Returns the total size of all pages.
+		*/
+		virtual uint64 GetTotalSize() const override;
+
+		/**
+		* Returns the total size of the used blocks.
+		* Might not be accurate with the requested allocations' sizes.
+		*/
+		uint64 GetAllocatedSize() const;
+
+		/**
+		* Returns the total size of the free blocks. Remember that this memory might not be contiguous, so this is not
+		*	the biggest size that can be allocated without having to allocate a new page.
+		*/
+		uint64 GetFreeSize() const;
+
+		/**
+		* Returns the debug tag of the arena.
+		*/
 		virtual const TChar* GetDebugName() const override;
 
+		/**
+		* Returns the arena's specification.
+		*/
+		FORCEINLINE const AFreelistArenaSpecification& GetSpecification() const { return m_Specification; }
+
+	private:
+		/**
+		* Allocates a block, growing the arena if needed. Doesn't report any errors.
+		*/
+		void* AllocateBlock(uint64 Size, uint64 Alignment);
+
+		/**
+		* Returns a used block to the free lists, coalescing it with its free neighbours.
+		*/
+		void FreeBlock(ABlock* Block);
+
+		/**
+		* Finds a free block that can hold 'Size' bytes and removes it from its free list.
+		*
+		* @returns The found block or nullptr if there isn't any block big enough.
+		*/
+		ABlock* FindFreeBlock(uint64 Size);
+
+		void InsertFreeBlock(ABlock* Block);
+
+		void RemoveFreeBlock(ABlock* Block);
+
+		/**
+		* Splits 'Block' so that its payload is 'Size' bytes. The remainder becomes a new free block.
+		*/
+		void SplitBlock(ABlock* Block, uint64 Size);
+
+		/**
+		* Turns the page in a single free block and inserts it in the free lists.
+		*/
+		void ResetPage(APage* Page);
+
+		/**
+		* Calculates the size of the next allocated page. Takes into account the requested allocation size and the sizes of the existing pages.
+		*/
+		uint64 GetOptimalPageSize(uint64 RequestedAllocationSize) const;
+
+		/**
+		* Allocates enough memory for a page metadata and its block.
+		* Also, it pushes the page pointer to the arena's vector.
+		*/
+		APage* AllocateNewPage(uint64 PageSize);
+
+		/**
+		* Returns true if the pointer is placed inside one of the arena's pages.
+		*/
+		bool8 OwnsAllocation(const void* Allocation) const;
+
 	/* Member variables */
 	private:
-		
+		/**
+		* Vector of all available arena's pages (pointers to them).
+		*/
+		TVector<APage*> m_Pages;
+
+		/**
+		* Bit 'Fl' is set if any of the second-level lists of the first-level class 'Fl' is not empty.
+		*/
+		uint64 m_FirstLevelBitmap = 0;
+
+		/**
+		* Bit 'Sl' of entry 'Fl' is set if the list 'm_FreeLists[Fl][Sl]' is not empty.
+		*/
+		uint32 m_SecondLevelBitmaps[FirstLevelCount] = {};
+
+		/**
+		* Heads of the segregated free lists.
+		*/
+		ABlock* m_FreeLists[FirstLevelCount][SecondLevelCount] = {};
+
+		uint64 m_TotalBytes = 0;
+		uint64 m_AllocatedBytes = 0;
+		uint64 m_FreeBytes = 0;
+
+		/**
+		* Arena's specification. Can't be modified after the creation.
+		*/
+		AFreelistArenaSpecification m_Specification;
+
+		/**
+		* Size of the memory block that holds the specification's pages, if they are bulk allocated. The specification's page
+		*	arrays are only valid during the creation, so the block can't be measured again when the arena is destroyed.
+		*/
+		uint64 m_BulkMemoryBytes = 0;
 
 	/* Friends */
 	private:
@@ -52,4 +381,4 @@ namespace Apricot {
 		friend constexpr T* MemConstruct(void*, Args&&...);
 	};
 
-}
\ No newline at end of file
+}
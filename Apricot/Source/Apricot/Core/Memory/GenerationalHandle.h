@@ -0,0 +1,80 @@
+// Part of Apricot Engine. 2022-2022.
+// Module: Memory
+
+#pragma once
+
+#include "Apricot/Core/Base.h"
+
+namespace Apricot {
+
+	/**
+	* Reference to an entry of a table whose entries are reused, like the objects of a TObjectPool or the relocatable
+	*	allocations of an APoolArena. It stays a plain 64-bit value, so it can be copied and stored freely.
+	* The generation changes every time the entry is released, so a handle that outlives its entry is detected by comparing
+	*	the generations, without touching the referenced memory.
+	* A generation of 0 is never given to an entry, so a default constructed handle is null.
+	*/
+	struct AGenerationalHandle
+	{
+	public:
+		uint32 Index = 0;
+		uint32 Generation = 0;
+
+	public:
+		FORCEINLINE bool8 IsNull() const { return Generation == 0; }
+
+		FORCEINLINE uint64 Pack() const { return ((uint64)Generation << 32) | (uint64)Index; }
+
+		FORCEINLINE static AGenerationalHandle Unpack(uint64 PackedHandle)
+		{
+			AGenerationalHandle Handle;
+			Handle.Index = (uint32)(PackedHandle & 0xFFFFFFFF);
+			Handle.Generation = (uint32)(PackedHandle >> 32);
+			return Handle;
+		}
+
+		FORCEINLINE bool8 operator==(const AGenerationalHandle& Other) const { return Pack() == Other.Pack(); }
+		FORCEINLINE bool8 operator!=(const AGenerationalHandle& Other) const { return Pack() != Other.Pack(); }
+	};
+
+	/**
+	* The generation of a table entry referenced by AGenerationalHandle. It is odd while the entry is live, and incremented
+	*	when the entry is acquired and when it is released.
+	*/
+	struct AGenerationalSlot
+	{
+	public:
+		uint32 Generation = 0;
+
+	public:
+		FORCEINLINE bool8 IsLive() const { return Generation & 1; }
+
+		FORCEINLINE bool8 Matches(AGenerationalHandle Handle) const { return Generation == Handle.Generation && IsLive(); }
+
+		/**
+		* Makes the entry live and returns its new handle.
+		*/
+		FORCEINLINE AGenerationalHandle Acquire(uint32 Index)
+		{
+			Generation++;
+
+			AGenerationalHandle Handle;
+			Handle.Index = Index;
+			Handle.Generation = Generation;
+			return Handle;
+		}
+
+		/**
+		* Invalidates the entry's handles.
+		*
+		* @returns False if the generation wrapped around. The entry must then be retired instead of reused, so that very old
+		*			handles can never match a new entry.
+		*/
+		FORCEINLINE bool8 Release()
+		{
+			Generation++;
+			return Generation != 0;
+		}
+	};
+
+}
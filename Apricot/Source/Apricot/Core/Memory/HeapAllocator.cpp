@@ -4,6 +4,9 @@
 #include "aepch.h"
 #include "HeapAllocator.h"
 
+#include "Apricot/Core/Platform.h"
+#include "Apricot/Profiling/MemoryProfiler.h"
+
 namespace Apricot {
 
 	extern APRICOT_API HeapAllocator* GHeapAllocator = nullptr;
@@ -13,24 +16,149 @@ namespace Apricot {
 		return GHeapAllocator;
 	}
 
+	HeapAllocator::HeapAllocator()
+	{
+		// The range is over-reserved by a slab, so that the heaps can be aligned to the slab size.
+		m_ReservedBytes = HintsCount * AEC_HINT_HEAP_RESERVE_SIZE + AHintHeap::SlabSize;
+		m_ReservedMemory = APlatform::Reserve(m_ReservedBytes);
+		if (!m_ReservedMemory)
+		{
+			// Without the hint heaps, every block is allocated from GMalloc.
+			m_ReservedBytes = 0;
+			return;
+		}
+
+		m_HintHeapsMemory = (uint8*)m_ReservedMemory + GetAlignmentOffset(m_ReservedMemory, AHintHeap::SlabSize);
+		for (uint64 hint = 0; hint < HintsCount; hint++)
+		{
+			m_HintHeaps[hint] = MemNew<AHintHeap>(m_HintHeapsMemory + hint * AEC_HINT_HEAP_RESERVE_SIZE, AEC_HINT_HEAP_RESERVE_SIZE);
+		}
+	}
+
+	HeapAllocator::~HeapAllocator()
+	{
+		for (uint64 hint = 0; hint < HintsCount; hint++)
+		{
+			if (m_HintHeaps[hint])
+			{
+				MemDelete<AHintHeap>(m_HintHeaps[hint]);
+				m_HintHeaps[hint] = nullptr;
+			}
+		}
+
+		if (m_ReservedMemory)
+		{
+			APlatform::Release(m_ReservedMemory, m_ReservedBytes);
+			m_ReservedMemory = nullptr;
+			m_HintHeapsMemory = nullptr;
+		}
+	}
+
 	void* HeapAllocator::Alloc(uint64 size, EAllocatorHint hint)
 	{
-		return GMalloc->Alloc(size);
+		void* block = nullptr;
+
+		AHintHeap* hintHeap = m_HintHeaps[(uint16)hint];
+		if (hintHeap && size <= AHintHeap::MaximumBlockSize)
+		{
+			// The hint heaps don't go through GMalloc, so their blocks are submitted as heap allocations here.
+			block = hintHeap->Alloc(size);
+			AMemoryProfiler::SubmitHeapAllocation(block, size, AHintHeap::BlockAlignment);
+		}
+
+		if (!block)
+		{
+			block = GMalloc->Alloc(size);
+		}
+
+		if (block)
+		{
+			AMemoryProfiler::SubmitHintAllocation(hint, block, size);
+		}
+		return block;
 	}
 
-	void* HeapAllocator::Realloc(void* oldBlock, uint64 size, EAllocatorHint hint)
+	void* HeapAllocator::Realloc(void* oldBlock, uint64 oldSize, uint64 size, EAllocatorHint hint)
 	{
-		return GMalloc->Alloc(size);
+		if (!oldBlock)
+		{
+			return Alloc(size, hint);
+		}
+
+		AHintHeap* oldHintHeap = FindHintHeap(oldBlock);
+		if (!oldHintHeap && (size > AHintHeap::MaximumBlockSize || !m_HintHeaps[(uint16)hint]))
+		{
+			// Both blocks belong to GMalloc, which might be able to grow the block in place.
+			void* block = GMalloc->Realloc(oldBlock, oldSize, size);
+			if (block)
+			{
+				AMemoryProfiler::SubmitHintReallocation(hint, block, oldSize, size);
+			}
+			return block;
+		}
+
+		if (ExpandBlock(oldBlock, oldSize, size, hint))
+		{
+			return oldBlock;
+		}
+
+		void* block = Alloc(size, hint);
+		if (!block)
+		{
+			return nullptr;
+		}
+
+		MemCpy(block, oldBlock, oldSize < size ? oldSize : size);
+		Free(oldBlock, oldSize, hint);
+		return block;
 	}
 
-	void* HeapAllocator::ExpandBlock(void* block, uint64 newSize, EAllocatorHint hint)
+	void* HeapAllocator::ExpandBlock(void* block, uint64 oldSize, uint64 newSize, EAllocatorHint hint)
 	{
-		return nullptr;
+		if (FindHintHeap(block))
+		{
+			// The block can grow up to the size of its size class.
+			if (newSize > AHintHeap::GetBlockSize(block))
+			{
+				return nullptr;
+			}
+
+			AMemoryProfiler::SubmitHeapReallocation(block, oldSize, block, newSize);
+		}
+		else if (!GMalloc->Expand(block, oldSize, newSize))
+		{
+			return nullptr;
+		}
+
+		AMemoryProfiler::SubmitHintReallocation(hint, block, oldSize, newSize);
+		return block;
 	}
 
 	void HeapAllocator::Free(void* block, uint64 size, EAllocatorHint hint)
 	{
+		if (!block)
+		{
+			return;
+		}
+
+		AMemoryProfiler::SubmitHintDeallocation(hint, size);
+
+		// The heap is found from the address, so a block can be freed with a different hint than it was allocated with.
+		AHintHeap* hintHeap = FindHintHeap(block);
+		if (hintHeap)
+		{
+			AMemoryProfiler::SubmitHeapDeallocation(block, size);
+			hintHeap->Free(block);
+			return;
+		}
+
 		GMalloc->Free(block, size);
 	}
 
+	AHintHeapStats HeapAllocator::GetHintHeapStats(EAllocatorHint hint) const
+	{
+		const AHintHeap* hintHeap = m_HintHeaps[(uint16)hint];
+		return hintHeap ? hintHeap->GetStats() : AHintHeapStats();
+	}
+
 }
\ No newline at end of file
@@ -4,28 +4,74 @@
 #pragma once
 
 #include "ApricotAllocator.h"
+#include "HintHeap.h"
 #include "Apricot/Core/UUID.h"
 
 namespace Apricot {
 
+	/**
+	* The default allocator of the containers. Every hint has its own AHintHeap, which serves the blocks of up to
+	*	AEC_HINT_HEAP_MAX_BLOCK_SIZE bytes from size-class slabs, so that the blocks of the same kind of container are co-located.
+	* The bigger blocks, and all the blocks if the hint heaps couldn't be reserved, are allocated from GMalloc.
+	*/
 	class APRICOT_API HeapAllocator
 	{
 	public:
 		static HeapAllocator* GetDefault();
 
+	public:
+		HeapAllocator();
+		~HeapAllocator();
+
+		HeapAllocator(const HeapAllocator&) = delete;
+		HeapAllocator& operator=(const HeapAllocator&) = delete;
+
 	public:
 		UUID GetUUID() const { return m_UUID; }
 		static EAllocatorType GetStaticType() { return EAllocatorType::Heap; }
 
 	public:
 		void* Alloc(uint64 size, EAllocatorHint hint);
-		void* Realloc(void* oldBlock, uint64 size, EAllocatorHint hint);
-		void* ExpandBlock(void* block, uint64 newSize, EAllocatorHint hint);
+		/**
+		* Resizes the block, preserving its content. Returns nullptr on failure, leaving the old block valid.
+		*/
+		void* Realloc(void* oldBlock, uint64 oldSize, uint64 size, EAllocatorHint hint);
+
+		/**
+		* Grows the block without moving it. Returns the block on success, or nullptr if it can't be grown in place.
+		*/
+		void* ExpandBlock(void* block, uint64 oldSize, uint64 newSize, EAllocatorHint hint);
 
 		void Free(void* block, uint64 size, EAllocatorHint hint);
 
+		/**
+		* Returns the counters of the hint's heap. They are always kept, even if AE_ENABLE_MEMORY_STATS isn't defined.
+		*/
+		AHintHeapStats GetHintHeapStats(EAllocatorHint hint) const;
+
 	private:
+		/**
+		* Returns the hint heap that allocated the block, or nullptr if it was allocated from GMalloc.
+		*/
+		FORCEINLINE AHintHeap* FindHintHeap(const void* block) const
+		{
+			const uint64 offset = (uint64)((const uint8*)block - m_HintHeapsMemory);
+			return offset < HintsCount * AEC_HINT_HEAP_RESERVE_SIZE ? m_HintHeaps[offset / AEC_HINT_HEAP_RESERVE_SIZE] : nullptr;
+		}
+
+	private:
+		static constexpr uint64 HintsCount = (uint64)EAllocatorHint::MaxEnumValue;
+
 		UUID m_UUID;
+
+		/**
+		* The heaps of all the hints are carved out of a single reserved range, one after the other.
+		*/
+		AHintHeap* m_HintHeaps[HintsCount] = {};
+		uint8* m_HintHeapsMemory = nullptr;
+
+		void* m_ReservedMemory = nullptr;
+		uint64 m_ReservedBytes = 0;
 	};
 
 	extern APRICOT_API HeapAllocator* GHeapAllocator;
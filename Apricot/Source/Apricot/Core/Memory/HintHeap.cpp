@@ -0,0 +1,252 @@
+// Part of Apricot Engine. 2022-2022.
+// Module: Memory
+
+#include "aepch.h"
+#include "HintHeap.h"
+
+#include "Apricot/Core/Assert.h"
+#include "Apricot/Core/Platform.h"
+
+namespace Apricot {
+
+	AHintHeap::AHintHeap(void* ReservedMemory, uint64 ReservedBytes)
+		: m_ReservedMemory((uint8*)ReservedMemory)
+		, m_ReservedBytes(ReservedBytes - ReservedBytes % SlabSize)
+	{
+		AE_CORE_ASSERT(GetAlignmentOffset(ReservedMemory, SlabSize) == 0, TEXT("The hint heap's memory must be aligned to the slab size!"));
+
+		// If the pages are as big as a slab, the empty slabs are never decommitted.
+		m_SlabHeaderPageSize = APlatform::GetPageSize();
+		if (m_SlabHeaderPageSize > SlabSize)
+		{
+			m_SlabHeaderPageSize = SlabSize;
+		}
+	}
+
+	void* AHintHeap::Alloc(uint64 Size)
+	{
+		AE_CORE_ASSERT(Size <= MaximumBlockSize, TEXT("The block is too big for the hint heap!"));
+
+		const uint32 SizeClassIndex = GetSizeClass(Size);
+		ASizeClass& SizeClass = m_SizeClasses[SizeClassIndex];
+		TScopedLock<ASpinLock> Lock(SizeClass.Lock);
+
+		ASlab* Slab = SizeClass.PartialSlabs;
+		if (!Slab)
+		{
+			Slab = AcquireSlab();
+			if (!Slab)
+			{
+				return nullptr;
+			}
+
+			// The header might still describe the size class that the slab belonged to before it was emptied.
+			MemConstruct<ASlab>(Slab);
+			Slab->BlockSize = (uint32)GetSizeClassBlockSize(SizeClassIndex);
+			Slab->BlocksCount = (uint32)((SlabSize - SlabHeaderSize) / Slab->BlockSize);
+			Slab->SizeClass = SizeClassIndex;
+
+			PushSlab(SizeClass.PartialSlabs, Slab);
+			SizeClass.SlabsCount.Store(SizeClass.SlabsCount.Load(EMemoryOrder::Relaxed) + 1, EMemoryOrder::Relaxed);
+		}
+
+		void* MemoryBlock = Slab->FreeList;
+		if (MemoryBlock)
+		{
+			Slab->FreeList = *(void**)MemoryBlock;
+		}
+		else
+		{
+			MemoryBlock = (uint8*)Slab + SlabHeaderSize + (uint64)Slab->CarvedBlocksCount * Slab->BlockSize;
+			Slab->CarvedBlocksCount++;
+		}
+
+		Slab->AllocatedBlocksCount++;
+		if (Slab->AllocatedBlocksCount == Slab->BlocksCount)
+		{
+			RemoveSlab(SizeClass.PartialSlabs, Slab);
+		}
+
+		SizeClass.AllocatedBlocksCount.Store(SizeClass.AllocatedBlocksCount.Load(EMemoryOrder::Relaxed) + 1, EMemoryOrder::Relaxed);
+		return MemoryBlock;
+	}
+
+	void AHintHeap::Free(void* MemoryBlock)
+	{
+		ASlab* Slab = GetSlab(MemoryBlock);
+
+	#if defined(AE_ENABLE_MEMORY_CHECK) && defined(AE_ENABLE_CORE_ASSERTS)
+		const uint64 BlockOffset = (uint64)((uint8*)MemoryBlock - (uint8*)Slab) - SlabHeaderSize;
+		AE_CORE_ASSERT(Owns(MemoryBlock) && BlockOffset % Slab->BlockSize == 0 && BlockOffset / Slab->BlockSize < Slab->CarvedBlocksCount,
+			TEXT("The block wasn't allocated by the hint heap!"));
+	#endif
+
+		// The size class of the slab can't change while one of its blocks is allocated.
+		ASizeClass& SizeClass = m_SizeClasses[Slab->SizeClass];
+		TScopedLock<ASpinLock> Lock(SizeClass.Lock);
+
+		AE_CORE_ASSERT(Slab->AllocatedBlocksCount > 0, TEXT("The block was already freed!"));
+
+		const bool8 bWasFull = Slab->AllocatedBlocksCount == Slab->BlocksCount;
+
+		*(void**)MemoryBlock = Slab->FreeList;
+		Slab->FreeList = MemoryBlock;
+		Slab->AllocatedBlocksCount--;
+
+		SizeClass.AllocatedBlocksCount.Store(SizeClass.AllocatedBlocksCount.Load(EMemoryOrder::Relaxed) - 1, EMemoryOrder::Relaxed);
+
+		if (bWasFull)
+		{
+			PushSlab(SizeClass.PartialSlabs, Slab);
+		}
+		else if (Slab->AllocatedBlocksCount == 0 && (SizeClass.PartialSlabs != Slab || Slab->Next))
+		{
+			// The last partial slab of the size class is kept, so that a block that is repeatedly allocated and freed doesn't
+			//	move a slab in and out of the empty lists every time.
+			RemoveSlab(SizeClass.PartialSlabs, Slab);
+			SizeClass.SlabsCount.Store(SizeClass.SlabsCount.Load(EMemoryOrder::Relaxed) - 1, EMemoryOrder::Relaxed);
+			ReleaseSlab(Slab);
+		}
+	}
+
+	uint64 AHintHeap::GetBlockSize(const void* MemoryBlock)
+	{
+		return GetSlab(MemoryBlock)->BlockSize;
+	}
+
+	AHintHeapStats AHintHeap::GetStats() const
+	{
+		AHintHeapStats Stats;
+		Stats.CommittedBytes = m_CommittedBytes.Load(EMemoryOrder::Relaxed);
+		Stats.EmptySlabsCount = m_EmptySlabsCount.Load(EMemoryOrder::Relaxed);
+
+		for (uint32 SizeClassIndex = 0; SizeClassIndex < SizeClassesCount; SizeClassIndex++)
+		{
+			const uint64 BlocksCount = m_SizeClasses[SizeClassIndex].AllocatedBlocksCount.Load(EMemoryOrder::Relaxed);
+			Stats.AllocatedBlocksCount += BlocksCount;
+			Stats.AllocatedBytes += BlocksCount * GetSizeClassBlockSize(SizeClassIndex);
+			Stats.SlabsCount += m_SizeClasses[SizeClassIndex].SlabsCount.Load(EMemoryOrder::Relaxed);
+		}
+
+		return Stats;
+	}
+
+	uint32 AHintHeap::GetSizeClass(uint64 Size)
+	{
+		if (Size <= 128)
+		{
+			return Size <= 16 ? 0 : (uint32)((Size - 1) >> 4);
+		}
+
+		// Four classes for every power of two, so a block wastes at most a fifth of its size.
+		const uint32 Log2 = FindLastSetBit(Size - 1);
+		return 8 + (Log2 - 7) * 4 + (uint32)((Size - 1) >> (Log2 - 2)) - 4;
+	}
+
+	uint64 AHintHeap::GetSizeClassBlockSize(uint32 SizeClass)
+	{
+		if (SizeClass < 8)
+		{
+			return ((uint64)SizeClass + 1) * 16;
+		}
+
+		const uint64 PowerOfTwo = 128ull << ((SizeClass - 8) / 4);
+		return PowerOfTwo + ((SizeClass - 8) % 4 + 1) * (PowerOfTwo / 4);
+	}
+
+	AHintHeap::ASlab* AHintHeap::AcquireSlab()
+	{
+		TScopedLock<ASpinLock> Lock(m_SlabsLock);
+
+		ASlab* Slab = m_EmptySlabs;
+		if (Slab)
+		{
+			m_EmptySlabs = Slab->Next;
+			m_CommittedEmptySlabsCount--;
+			m_EmptySlabsCount.Store(m_EmptySlabsCount.Load(EMemoryOrder::Relaxed) - 1, EMemoryOrder::Relaxed);
+			return Slab;
+		}
+
+		Slab = m_DecommittedSlabs;
+		if (Slab)
+		{
+			if (!APlatform::Commit((uint8*)Slab + m_SlabHeaderPageSize, SlabSize - m_SlabHeaderPageSize))
+			{
+				return nullptr;
+			}
+
+			m_DecommittedSlabs = Slab->Next;
+			m_EmptySlabsCount.Store(m_EmptySlabsCount.Load(EMemoryOrder::Relaxed) - 1, EMemoryOrder::Relaxed);
+			m_CommittedBytes.Store(m_CommittedBytes.Load(EMemoryOrder::Relaxed) + SlabSize - m_SlabHeaderPageSize, EMemoryOrder::Relaxed);
+			return Slab;
+		}
+
+		if (m_SlabsEnd + SlabSize > m_ReservedBytes)
+		{
+			return nullptr;
+		}
+
+		Slab = (ASlab*)(m_ReservedMemory + m_SlabsEnd);
+		if (!APlatform::Commit(Slab, SlabSize))
+		{
+			return nullptr;
+		}
+
+		m_SlabsEnd += SlabSize;
+		m_CommittedBytes.Store(m_CommittedBytes.Load(EMemoryOrder::Relaxed) + SlabSize, EMemoryOrder::Relaxed);
+		return Slab;
+	}
+
+	void AHintHeap::ReleaseSlab(ASlab* Slab)
+	{
+		TScopedLock<ASpinLock> Lock(m_SlabsLock);
+
+		if (m_CommittedEmptySlabsCount < AEC_HINT_HEAP_MAX_EMPTY_SLABS || m_SlabHeaderPageSize == SlabSize)
+		{
+			Slab->Next = m_EmptySlabs;
+			m_EmptySlabs = Slab;
+			m_CommittedEmptySlabsCount++;
+		}
+		else
+		{
+			APlatform::Decommit((uint8*)Slab + m_SlabHeaderPageSize, SlabSize - m_SlabHeaderPageSize);
+			Slab->Next = m_DecommittedSlabs;
+			m_DecommittedSlabs = Slab;
+			m_CommittedBytes.Store(m_CommittedBytes.Load(EMemoryOrder::Relaxed) - (SlabSize - m_SlabHeaderPageSize), EMemoryOrder::Relaxed);
+		}
+
+		m_EmptySlabsCount.Store(m_EmptySlabsCount.Load(EMemoryOrder::Relaxed) + 1, EMemoryOrder::Relaxed);
+	}
+
+	void AHintHeap::PushSlab(ASlab*& Head, ASlab* Slab)
+	{
+		Slab->Previous = nullptr;
+		Slab->Next = Head;
+		if (Head)
+		{
+			Head->Previous = Slab;
+		}
+		Head = Slab;
+	}
+
+	void AHintHeap::RemoveSlab(ASlab*& Head, ASlab* Slab)
+	{
+		if (Slab->Previous)
+		{
+			Slab->Previous->Next = Slab->Next;
+		}
+		else
+		{
+			Head = Slab->Next;
+		}
+
+		if (Slab->Next)
+		{
+			Slab->Next->Previous = Slab->Previous;
+		}
+
+		Slab->Next = nullptr;
+		Slab->Previous = nullptr;
+	}
+
+}
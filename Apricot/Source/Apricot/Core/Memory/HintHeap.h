@@ -0,0 +1,213 @@
+// Part of Apricot Engine. 2022-2022.
+// Module: Memory
+
+#pragma once
+
+#include "ApricotMemory.h"
+
+#include "Apricot/Core/Atomic.h"
+#include "Apricot/Core/Config.h"
+
+namespace Apricot {
+
+	namespace Utils {
+
+		constexpr uint32 ConstexprLog2(uint64 Value)
+		{
+			uint32 Log2 = 0;
+			while (Value > 1)
+			{
+				Value >>= 1;
+				Log2++;
+			}
+			return Log2;
+		}
+
+	}
+
+	/**
+	* C++ Core Engine Architecture
+	*
+	* Small-block heap that serves the allocations of a single EAllocatorHint, owned by HeapAllocator.
+	* It carves fixed-size slabs out of its own address range. Every slab holds the blocks of a single size class, so the blocks of
+	*	the containers of the same kind are packed together and never share a cache line or a page with the other hints.
+	*
+	* Every size class has its own lock, so threads only contend when they allocate blocks of the same hint and size class.
+	* The slab header is stored at the beginning of the slab, which is aligned to its size, so a block finds its slab with a mask.
+	*/
+	class APRICOT_API AHintHeap
+	{
+	public:
+		/**
+		* The alignment of every block. The size classes are multiples of it.
+		*/
+		static constexpr uint64 BlockAlignment = 16;
+
+		static constexpr uint64 SlabSize = AEC_HINT_HEAP_SLAB_SIZE;
+
+		static constexpr uint64 MaximumBlockSize = AEC_HINT_HEAP_MAX_BLOCK_SIZE;
+
+		/**
+		* The classes grow by 16 bytes up to 128 bytes, then by a quarter of the previous power of two (160, 192, 224, 256, 320...).
+		*/
+		static constexpr uint32 SizeClassesCount = 8 + 4 * (Utils::ConstexprLog2(MaximumBlockSize) - 7);
+
+		AE_STATIC_ASSERT(IsPowerOfTwo(MaximumBlockSize) && MaximumBlockSize >= 128, "AEC_HINT_HEAP_MAX_BLOCK_SIZE must be a power of two, at least 128!");
+		AE_STATIC_ASSERT(IsPowerOfTwo(SlabSize) && SlabSize >= 16 * MaximumBlockSize, "AEC_HINT_HEAP_SLAB_SIZE must be a power of two, big enough for 16 of the biggest blocks!");
+
+	/* Constructors & Deconstructor */
+	public:
+		/**
+		* The heap only uses the given range, which must be reserved (but not committed) and aligned to the slab size. It is
+		*	released by the owner, after the heap is destroyed.
+		*/
+		AHintHeap(void* ReservedMemory, uint64 ReservedBytes);
+		~AHintHeap() = default;
+
+		AHintHeap(const AHintHeap&) = delete;
+		AHintHeap(AHintHeap&&) = delete;
+		AHintHeap& operator=(const AHintHeap&) = delete;
+		AHintHeap& operator=(AHintHeap&&) = delete;
+
+	public:
+		/**
+		* 'Size' must not be greater than MaximumBlockSize.
+		*
+		* @returns The block, or nullptr if the heap's address range is full.
+		*/
+		NODISCARD void* Alloc(uint64 Size);
+
+		/**
+		* The block must have been allocated by this heap. Its size isn't needed, because the slab knows its size class.
+		*/
+		void Free(void* MemoryBlock);
+
+		FORCEINLINE bool8 Owns(const void* MemoryBlock) const
+		{
+			return (uint64)((const uint8*)MemoryBlock - m_ReservedMemory) < m_ReservedBytes;
+		}
+
+		/**
+		* Returns the usable size of a block allocated by any hint heap, which is the size of its size class.
+		*/
+		NODISCARD static uint64 GetBlockSize(const void* MemoryBlock);
+
+		NODISCARD AHintHeapStats GetStats() const;
+
+		NODISCARD static uint32 GetSizeClass(uint64 Size);
+		NODISCARD static uint64 GetSizeClassBlockSize(uint32 SizeClass);
+
+	/* Typedefs */
+	private:
+		/**
+		* Stored at the beginning of every slab. Its first page is never decommitted, so the header stays readable while the
+		*	slab is empty.
+		*/
+		struct ASlab
+		{
+			/**
+			* Links in the list of the size class' slabs that have free blocks, or in one of the empty slab lists.
+			*/
+			ASlab* Next = nullptr;
+			ASlab* Previous = nullptr;
+
+			/**
+			* The freed blocks, linked through their first bytes.
+			*/
+			void* FreeList = nullptr;
+
+			uint32 BlockSize = 0;
+			uint32 BlocksCount = 0;
+
+			/**
+			* The blocks are carved lazily, so the pages of a new slab are only touched when they are needed.
+			*/
+			uint32 CarvedBlocksCount = 0;
+
+			uint32 AllocatedBlocksCount = 0;
+
+			uint32 SizeClass = 0;
+		};
+
+		/**
+		* The first block starts on its own cache line, after the header.
+		*/
+		static constexpr uint64 SlabHeaderSize = 64;
+
+		AE_STATIC_ASSERT(sizeof(ASlab) <= SlabHeaderSize, "The slab header doesn't fit before the first block!");
+
+		/**
+		* Every instance starts on its own cache line, so the locks of different size classes are never falsely shared.
+		*/
+		struct ASizeClass
+		{
+			alignas(64) ASpinLock Lock;
+
+			/**
+			* The slabs that have free (or not yet carved) blocks. The head is always allocated from first.
+			*/
+			ASlab* PartialSlabs = nullptr;
+
+			/**
+			* Only modified with the lock held. They are atomics so that the statistics can be read without it.
+			*/
+			TAtomic<uint64> AllocatedBlocksCount = 0;
+			TAtomic<uint64> SlabsCount = 0;
+		};
+
+	private:
+		/**
+		* Takes a slab from the empty lists or commits a new one. Called with the lock of the size class held.
+		*/
+		ASlab* AcquireSlab();
+
+		/**
+		* Puts an empty slab in the empty lists, decommitting it if enough empty slabs are already committed.
+		*/
+		void ReleaseSlab(ASlab* Slab);
+
+		/**
+		* Links the slab at the head of a list of partial slabs.
+		*/
+		static void PushSlab(ASlab*& Head, ASlab* Slab);
+		static void RemoveSlab(ASlab*& Head, ASlab* Slab);
+
+		FORCEINLINE static ASlab* GetSlab(const void* MemoryBlock)
+		{
+			return (ASlab*)((uint64)MemoryBlock & ~(SlabSize - 1));
+		}
+
+	private:
+		ASizeClass m_SizeClasses[SizeClassesCount];
+
+		alignas(64) ASpinLock m_SlabsLock;
+
+		uint8* m_ReservedMemory = nullptr;
+		uint64 m_ReservedBytes = 0;
+
+		/**
+		* Offset of the first slab that was never committed. The slabs below it are used or in the empty lists.
+		*/
+		uint64 m_SlabsEnd = 0;
+
+		/**
+		* Number of bytes at the beginning of a slab that stay committed when the slab is decommitted. It holds the header.
+		*/
+		uint64 m_SlabHeaderPageSize = 0;
+
+		/**
+		* The empty slabs that are fully committed, and the ones that only have their header page committed.
+		*/
+		ASlab* m_EmptySlabs = nullptr;
+		ASlab* m_DecommittedSlabs = nullptr;
+
+		/**
+		* Only modified with the slabs lock held.
+		*/
+		uint64 m_CommittedEmptySlabsCount = 0;
+
+		TAtomic<uint64> m_EmptySlabsCount = 0;
+		TAtomic<uint64> m_CommittedBytes = 0;
+	};
+
+}
@@ -4,6 +4,8 @@
 #include "aepch.h"
 #include "LinearArena.h"
 
+#include "Apricot/Core/Platform.h"
+
 namespace Apricot {
 
 	namespace Utils {
@@ -25,6 +27,28 @@ namespace Apricot {
 			return NewPage;
 		}
 
+		/**
+		* Reads the allocated bytes of the page that 'ConstructNewPage' would construct at 'Offset'.
+		*/
+		static uint64 ReadRestoredAllocatedBytes(uint8* ArenaMemory, uint64 Offset)
+		{
+			Offset += GetAlignmentOffset(Offset, sizeof(void*));
+			return ((const ALinearArena::APage*)(ArenaMemory + Offset))->AllocatedBytes;
+		}
+
+		FORCEINLINE static uint64 AlignToPageSize(uint64 Size)
+		{
+			return Size + GetAlignmentOffset(Size, APlatform::GetPageSize());
+		}
+
+		/**
+		* Extends a committed range so that it ends on a huge page boundary. Transparent huge pages can only back the ranges that are fully committed.
+		*/
+		FORCEINLINE static uint64 AlignToHugePageBoundary(uint8* RangeBegin, uint64 Size, const AArenaMemoryOptions& Options)
+		{
+			return Options.bUseHugePages ? Size + GetAlignmentOffset(RangeBegin + Size, APlatform::GetHugePageSize()) : Size;
+		}
+
 	}
 
 	NODISCARD TSharedPtr<ALinearArena> ALinearArena::Create(const ALinearArenaSpecification& Specification)
@@ -46,6 +70,12 @@ namespace Apricot {
 	{
 		uint64 MemoryRequirement = 0;
 
+		// The memory of a virtual memory arena isn't provided by the user or the heap.
+		if (Specification.bUseVirtualMemory)
+		{
+			return MemoryRequirement;
+		}
+
 		for (uint64 Index = 0; Index < Specification.PagesCount; Index++)
 		{
 			MemoryRequirement += GetAlignmentOffset(MemoryRequirement, sizeof(void*));
@@ -62,17 +92,69 @@ namespace Apricot {
 
 		uint8* ArenaMemory = (uint8*)m_Specification.ArenaMemory;
 
-		if (m_Specification.bBulkAllocateSpecPages || ArenaMemory)
+		if (m_Specification.bUseVirtualMemory)
+		{
+			// The page's header lives at the beginning of the reserved range.
+			m_ReservedBytes = Utils::AlignToPageSize(sizeof(APage) + m_Specification.VirtualReserveSize);
+			ArenaMemory = (uint8*)APlatform::Reserve(m_ReservedBytes);
+			if (ArenaMemory == nullptr)
+			{
+				// The arena is left without pages, so its allocations fail with InvalidArena.
+				GCrashReporter->MemoryState.Arena = this;
+				GCrashReporter->MemoryState.Size = m_ReservedBytes;
+				GCrashReporter->SubmitArenaFailure(ACrashReporter::EMemoryOperation::Allocate, EMemoryError::OutOfMemory);
+				m_ReservedBytes = 0;
+				return;
+			}
+
+			if (m_Specification.MemoryOptions.bUseHugePages)
+			{
+				APlatform::AdviseHugePages(ArenaMemory, m_ReservedBytes);
+			}
+
+			uint64 InitialSizeBytes = m_Specification.PagesCount > 0 ? m_Specification.PageSizes[0] : 0;
+			uint64 CommittedBytes = Utils::AlignToPageSize(sizeof(APage) + InitialSizeBytes);
+			CommittedBytes = Utils::AlignToHugePageBoundary(ArenaMemory, CommittedBytes, m_Specification.MemoryOptions);
+			if (CommittedBytes > m_ReservedBytes)
+			{
+				CommittedBytes = m_ReservedBytes;
+			}
+			if (!APlatform::Commit(ArenaMemory, CommittedBytes))
+			{
+				GCrashReporter->MemoryState.Arena = this;
+				GCrashReporter->MemoryState.Size = CommittedBytes;
+				GCrashReporter->SubmitArenaFailure(ACrashReporter::EMemoryOperation::Allocate, EMemoryError::OutOfMemory);
+				APlatform::Release(ArenaMemory, m_ReservedBytes);
+				m_ReservedBytes = 0;
+				return;
+			}
+			PrepareArenaMemory(ArenaMemory, CommittedBytes, m_Specification.MemoryOptions);
+
+			uint64 MemoryOffset = 0;
+			m_Pages.PushBack(Utils::ConstructNewPage(ArenaMemory, MemoryOffset, CommittedBytes - sizeof(APage)));
+		}
+		else if (m_Specification.bBulkAllocateSpecPages || ArenaMemory)
 		{
 			if (!ArenaMemory)
 			{
-				ArenaMemory = (uint8*)GMalloc->Alloc(GetMemoryRequirement(m_Specification));
+				m_BulkMemoryBytes = GetMemoryRequirement(m_Specification);
+				ArenaMemory = (uint8*)AllocateArenaMemory(m_BulkMemoryBytes, m_Specification.MemoryOptions);
 			}
 			uint64 MemoryOffset = 0;
 
 			for (uint64 Index = 0; Index < m_Specification.PagesCount; Index++)
 			{
+				// The header of a restored page is rebuilt, as its memory block pointer is stale. Only its allocated bytes are kept.
+				uint64 RestoredBytes = m_Specification.bRestoreArenaMemory ? Utils::ReadRestoredAllocatedBytes(ArenaMemory, MemoryOffset) : 0;
 				m_Pages.PushBack(Utils::ConstructNewPage(ArenaMemory, MemoryOffset, m_Specification.PageSizes[Index]));
+
+				AE_CORE_ASSERT(RestoredBytes <= m_Pages.Back()->SizeBytes, TEXT("The restored arena memory doesn't match the page sizes!"));
+				m_Pages.Back()->AllocatedBytes = RestoredBytes;
+				if (RestoredBytes > 0)
+				{
+					SetCurrentPage(Index);
+					SubmitAllocationStats(m_Pages.Back()->MemoryBlock, RestoredBytes, 1);
+				}
 			}
 
 			if (ArenaMemory)
@@ -87,55 +169,66 @@ namespace Apricot {
 				uint64 MemoryOffset = 0;
 				uint64 PageSizeBytes = m_Specification.PageSizes[Index];
 
-				ArenaMemory = (uint8*)GMalloc->Alloc(GetPageMemoryRequirement(PageSizeBytes));
+				ArenaMemory = (uint8*)AllocateArenaMemory(GetPageMemoryRequirement(PageSizeBytes), m_Specification.MemoryOptions);
 				m_Pages.PushBack(Utils::ConstructNewPage(ArenaMemory, MemoryOffset, PageSizeBytes));
 			}
 		}
+
+		for (uint64 Index = 0; Index < m_Pages.Size(); Index++)
+		{
+			m_TotalBytes += m_Pages[Index]->SizeBytes;
+		}
 	}
 
 	ALinearArena::~ALinearArena()
 	{
-		if (!m_Specification.bUseArenaMemoryAlways)
+		if (m_Specification.bUseVirtualMemory)
+		{
+			// The pages are empty if the range couldn't be reserved or committed.
+			if (!m_Pages.IsEmpty())
+			{
+				APlatform::Release(m_Pages[0], m_ReservedBytes);
+			}
+			return;
+		}
+
+		bool8 bSpecPagesAreBulk = m_Specification.bBulkAllocateSpecPages || m_Specification.ArenaMemory;
+
+		for (uint64 Index = 0; Index < m_Pages.Size(); Index++)
 		{
-			for (uint64 Index = m_Specification.PagesCount; Index < m_Pages.Size(); Index++)
+			bool8 bIsSpecPage = Index < m_Specification.PagesCount;
+			if ((bIsSpecPage && !bSpecPagesAreBulk) || (!bIsSpecPage && !m_Specification.bUseArenaMemoryAlways))
 			{
-				GMalloc->Free(m_Pages[Index], GetPageMemoryRequirement(m_Pages[Index]->SizeBytes));
+				FreeArenaMemory(m_Pages[Index], GetPageMemoryRequirement(m_Pages[Index]->SizeBytes), m_Specification.MemoryOptions);
 			}
 		}
-		if (!m_Specification.ArenaMemory && !m_Pages.IsEmpty())
+		if (bSpecPagesAreBulk && !m_Specification.ArenaMemory && m_Specification.PagesCount > 0)
 		{
-			GMalloc->Free(m_Pages[0], GetMemoryRequirement(m_Specification));
+			FreeArenaMemory(m_Pages[0], m_BulkMemoryBytes, m_Specification.MemoryOptions);
 		}
 	}
 
 	uint64 ALinearArena::GetTotalSize() const
 	{
-		uint64 TotalSizeBytes = 0;
-		for (uint64 Index = 0; Index < m_Pages.Size(); Index++)
-		{
-			TotalSizeBytes += m_Pages[Index]->SizeBytes;
-		}
-		return TotalSizeBytes;
+		return m_TotalBytes;
 	}
 
 	uint64 ALinearArena::GetAllocatedSize() const
 	{
-		uint64 AllocatedBytes = 0;
-		for (uint64 Index = 0; Index < m_Pages.Size(); Index++)
+		if (m_Pages.IsEmpty())
 		{
-			AllocatedBytes += m_Pages[Index]->AllocatedBytes;
+			return 0;
 		}
-		return AllocatedBytes;
+		return m_PassedPagesAllocatedBytes + m_Pages[m_CurrentPage]->AllocatedBytes;
 	}
 
 	uint64 ALinearArena::GetFreeSize() const
 	{
-		uint64 FreeSizeBytes = 0;
-		for (uint64 Index = m_CurrentPage; Index < m_Pages.Size(); Index++)
+		if (m_Pages.IsEmpty())
 		{
-			FreeSizeBytes += (m_Pages[Index]->SizeBytes - m_Pages[Index]->AllocatedBytes);
+			return 0;
 		}
-		return FreeSizeBytes;
+		return m_TotalBytes - m_PassedPagesBytes - m_Pages[m_CurrentPage]->AllocatedBytes;
 	}
 
 	const TChar* ALinearArena::GetDebugName() const
@@ -145,10 +238,17 @@ namespace Apricot {
 
 	NODISCARD void* ALinearArena::Alloc(uint64 Size, uint64 Alignment /*= sizeof(void*)*/)
 	{
+		if (m_Pages.IsEmpty())
+		{
+			GCrashReporter->MemoryState.Arena = this;
+			GCrashReporter->SubmitArenaFailure(ACrashReporter::EMemoryOperation::Allocate, EMemoryError::InvalidArena);
+			return nullptr;
+		}
+
 		APage* Page = m_Pages[m_CurrentPage];
 		uint64 AlignmentOffset = GetAlignmentOffset((uint8*)Page->MemoryBlock + Page->AllocatedBytes, Alignment);
 
-		if (Page->AllocatedBytes + AlignmentOffset + Size > Page->SizeBytes)
+		if (Page->AllocatedBytes + AlignmentOffset + Size > Page->SizeBytes && !CommitPageMemory(Page, Page->AllocatedBytes + AlignmentOffset + Size))
 		{
 			for (uint64 Index = m_CurrentPage + 1; Index < m_Pages.Size(); Index++)
 			{
@@ -156,25 +256,34 @@ namespace Apricot {
 				AlignmentOffset = GetAlignmentOffset((uint8*)Page->MemoryBlock + Page->AllocatedBytes, Alignment);
 				if (Page->AllocatedBytes + AlignmentOffset + Size <= Page->SizeBytes)
 				{
-					m_CurrentPage = Index;
+					SetCurrentPage(Index);
+					void* Memory = (uint8*)Page->MemoryBlock + Page->AllocatedBytes + AlignmentOffset;
 					Page->AllocatedBytes += (AlignmentOffset + Size);
-					return (uint8*)Page->MemoryBlock + AlignmentOffset;
+					SubmitAllocationStats(Memory, Size, Alignment);
+					return Memory;
 				}
 			}
 
-			if (!m_Specification.bShouldGrow)
+			if (!m_Specification.bShouldGrow || m_Specification.bUseVirtualMemory)
 			{
+				GCrashReporter->MemoryState.Arena = this;
+				GCrashReporter->MemoryState.Size = Size;
+				GCrashReporter->MemoryState.Alignment = Alignment;
+				GCrashReporter->MemoryState.FreeSize = GetFreeSize();
+				GCrashReporter->SubmitArenaFailure(ACrashReporter::EMemoryOperation::Allocate, EMemoryError::OutOfMemoryUnableToGrow);
 				return nullptr;
 			}
 
-			Page = AllocateNewPage(GetOptimalPageSize(Size));
-			m_CurrentPage = m_Pages.Size() - 1;
+			Page = AllocateNewPage(GetOptimalPageSize(Size + Alignment - 1));
+			SetCurrentPage(m_Pages.Size() - 1);
 
 			AlignmentOffset = GetAlignmentOffset((uint8*)Page->MemoryBlock + Page->AllocatedBytes, Alignment);
 		}
 
+		void* Memory = (uint8*)Page->MemoryBlock + Page->AllocatedBytes + AlignmentOffset;
 		Page->AllocatedBytes += (AlignmentOffset + Size);
-		return (uint8*)Page->MemoryBlock + AlignmentOffset;
+		SubmitAllocationStats(Memory, Size, Alignment);
+		return Memory;
 	}
 
 	NODISCARD int32 ALinearArena::TryAlloc(uint64 Size, void** OutPointer, uint64 Alignment /*= sizeof(void*)*/)
@@ -202,7 +311,7 @@ namespace Apricot {
 		APage* Page = m_Pages[m_CurrentPage];
 		uint64 AlignmentOffset = GetAlignmentOffset((uint8*)Page->MemoryBlock + Page->AllocatedBytes, Alignment);
 
-		if (Page->AllocatedBytes + AlignmentOffset + Size > Page->SizeBytes)
+		if (Page->AllocatedBytes + AlignmentOffset + Size > Page->SizeBytes && !CommitPageMemory(Page, Page->AllocatedBytes + AlignmentOffset + Size))
 		{
 			for (uint64 Index = m_CurrentPage + 1; Index < m_Pages.Size(); Index++)
 			{
@@ -210,33 +319,35 @@ namespace Apricot {
 				AlignmentOffset = GetAlignmentOffset((uint8*)Page->MemoryBlock + Page->AllocatedBytes, Alignment);
 				if (Page->AllocatedBytes + AlignmentOffset + Size <= Page->SizeBytes)
 				{
-					m_CurrentPage = Index;
+					SetCurrentPage(Index);
+					*OutPointer = (uint8*)Page->MemoryBlock + Page->AllocatedBytes + AlignmentOffset;
 					Page->AllocatedBytes += (AlignmentOffset + Size);
-					*OutPointer = (uint8*)Page->MemoryBlock + AlignmentOffset;
+					SubmitAllocationStats(*OutPointer, Size, Alignment);
 					return (int16)EMemoryError::Success;
 				}
 			}
 
-			if (!m_Specification.bShouldGrow)
+			if (!m_Specification.bShouldGrow || m_Specification.bUseVirtualMemory)
 			{
 				*OutPointer = nullptr;
 				return (int16)EMemoryError::OutOfMemoryUnableToGrow;
 			}
 
-			Page = AllocateNewPage(GetOptimalPageSize(Size));
-			m_CurrentPage = m_Pages.Size() - 1;
+			Page = AllocateNewPage(GetOptimalPageSize(Size + Alignment - 1));
+			SetCurrentPage(m_Pages.Size() - 1);
 
 			AlignmentOffset = GetAlignmentOffset((uint8*)Page->MemoryBlock + Page->AllocatedBytes, Alignment);
 		}
 
+		*OutPointer = (uint8*)Page->MemoryBlock + Page->AllocatedBytes + AlignmentOffset;
 		Page->AllocatedBytes += (AlignmentOffset + Size);
-		*OutPointer = (uint8*)Page->MemoryBlock + AlignmentOffset;
+		SubmitAllocationStats(*OutPointer, Size, Alignment);
 		return (int16)EMemoryError::Success;
 	}
 
 	NODISCARD void* ALinearArena::AllocUnsafe(uint64 Size, uint64 Alignment /*= sizeof(void*)*/)
 	{
-		return nullptr;
+		return Alloc(Size, Alignment);
 	}
 
 	void ALinearArena::Free(void* Allocation, uint64 Size)
@@ -263,53 +374,140 @@ namespace Apricot {
 
 	void ALinearArena::FreeAll()
 	{
+		SetCurrentPage(0);
 		for (uint64 Index = 0; Index < m_Pages.Size(); Index++)
 		{
 			m_Pages[Index]->AllocatedBytes = 0;
 		}
-		m_CurrentPage = 0;
+		SubmitDeallocationOfAllStats();
 	}
 
 	int32 ALinearArena::TryFreeAll()
 	{
+		SetCurrentPage(0);
 		for (uint64 Index = 0; Index < m_Pages.Size(); Index++)
 		{
 			m_Pages[Index]->AllocatedBytes = 0;
 		}
-		m_CurrentPage = 0;
+		SubmitDeallocationOfAllStats();
 		return (int16)EMemoryError::Success;
 	}
 
 	void ALinearArena::FreeAllUnsafe()
 	{
+		SetCurrentPage(0);
 		for (uint64 Index = 0; Index < m_Pages.Size(); Index++)
 		{
 			m_Pages[Index]->AllocatedBytes = 0;
 		}
-		m_CurrentPage = 0;
+		SubmitDeallocationOfAllStats();
 	}
 
 	void ALinearArena::GarbageCollect()
 	{
-		for (int64 Index = m_Pages.Size() - 1; Index >= (int64)m_CurrentPage; Index--)
+		if (m_Pages.IsEmpty())
+		{
+			return;
+		}
+
+		if (m_Specification.bUseVirtualMemory)
+		{
+			APage* Page = m_Pages[0];
+
+			// The header lives in the first committed page, so it is never decommitted.
+			uint64 UsedBytes = Utils::AlignToPageSize(sizeof(APage) + Page->AllocatedBytes);
+			UsedBytes = Utils::AlignToHugePageBoundary((uint8*)Page, UsedBytes, m_Specification.MemoryOptions);
+			uint64 CommittedBytes = sizeof(APage) + Page->SizeBytes;
+			if (CommittedBytes > UsedBytes)
+			{
+				if (m_Specification.MemoryOptions.bLockMemory)
+				{
+					APlatform::Unlock((uint8*)Page + UsedBytes, CommittedBytes - UsedBytes);
+				}
+				APlatform::Decommit((uint8*)Page + UsedBytes, CommittedBytes - UsedBytes);
+				Page->SizeBytes = UsedBytes - sizeof(APage);
+				m_TotalBytes -= CommittedBytes - UsedBytes;
+			}
+			return;
+		}
+
+		// The specification pages aren't allocated individually, so they can't be deleted.
+		int64 FirstGrownPage = (int64)m_Specification.PagesCount > (int64)m_CurrentPage + 1 ? (int64)m_Specification.PagesCount : (int64)m_CurrentPage + 1;
+		for (int64 Index = m_Pages.Size() - 1; Index >= FirstGrownPage; Index--)
 		{
 			if (m_Pages[Index]->AllocatedBytes > 0)
 			{
 				break;
 			}
 
+			m_TotalBytes -= m_Pages[Index]->SizeBytes;
+			if (!m_Specification.bUseArenaMemoryAlways)
+			{
+				FreeArenaMemory(m_Pages[Index], GetPageMemoryRequirement(m_Pages[Index]->SizeBytes), m_Specification.MemoryOptions);
+			}
 			m_Pages.PopBack();
 		}
-		m_CurrentPage = m_Pages.Size() - 1;
+	}
+
+	AArenaPosition ALinearArena::GetPosition() const
+	{
+		AArenaPosition Position;
+		Position.PageIndex = m_CurrentPage;
+		Position.AllocatedBytes = m_Pages.IsEmpty() ? 0 : m_Pages[m_CurrentPage]->AllocatedBytes;
+		CapturePositionStats(Position);
+		return Position;
+	}
+
+	void ALinearArena::RewindTo(const AArenaPosition& Position)
+	{
+		if (m_Pages.IsEmpty())
+		{
+			return;
+		}
+		AE_CORE_ASSERT(Position.PageIndex < m_CurrentPage || (Position.PageIndex == m_CurrentPage && Position.AllocatedBytes <= m_Pages[m_CurrentPage]->AllocatedBytes),
+			TEXT("The arena can't be rewound to a position that is ahead of it!"));
+
+		// Only the pages up to the current one can hold allocations.
+		// The current page is moved first, so that the cached sizes drop the passed pages with the bytes they were counted with.
+		uint64 PreviousPage = m_CurrentPage;
+		SetCurrentPage(Position.PageIndex);
+		for (uint64 Index = Position.PageIndex + 1; Index <= PreviousPage; Index++)
+		{
+			m_Pages[Index]->AllocatedBytes = 0;
+		}
+		m_Pages[Position.PageIndex]->AllocatedBytes = Position.AllocatedBytes;
+
+		SubmitRewindStats(Position);
+	}
+
+	void ALinearArena::TakeFragmentationReport(AArenaFragmentationReport& OutReport) const
+	{
+		OutReport = {};
+		OutReport.TotalBytes = m_TotalBytes;
+		OutReport.AllocatedBytes = GetAllocatedSize();
+		OutReport.FreeBytes = GetFreeSize();
+		OutReport.PaddingBytes = GetPaddingBytes(OutReport.AllocatedBytes);
+		OutReport.TailWasteBytes = m_PassedPagesBytes - m_PassedPagesAllocatedBytes;
+		OutReport.PagesCount = m_Pages.Size();
+
+		for (uint64 Index = 0; Index < m_Pages.Size() && Index < AArenaFragmentationReport::MaxPagesCount; Index++)
+		{
+			AArenaPageReport& PageReport = OutReport.Pages[Index];
+			PageReport.SizeBytes = m_Pages[Index]->SizeBytes;
+			PageReport.AllocatedBytes = m_Pages[Index]->AllocatedBytes;
+			PageReport.TailWasteBytes = Index < m_CurrentPage ? PageReport.SizeBytes - PageReport.AllocatedBytes : 0;
+		}
 	}
 
 	uint64 ALinearArena::GetOptimalPageSize(uint64 RequestedAllocationSize) const
 	{
-		return m_Pages.Back()->SizeBytes;
+		return m_Pages.Back()->SizeBytes > RequestedAllocationSize ? m_Pages.Back()->SizeBytes : RequestedAllocationSize;
 	}
 
 	ALinearArena::APage* ALinearArena::AllocateNewPage(uint64 PageSize)
 	{
+		m_TotalBytes += PageSize;
+
 		if (m_Specification.bUseArenaMemoryAlways)
 		{
 			APage* NewPage = Utils::ConstructNewPage((uint8*)m_Specification.ArenaMemory, m_Specification.ArenaMemoryOffset, PageSize);
@@ -319,10 +517,62 @@ namespace Apricot {
 		else
 		{
 			uint64 Offset = 0;
-			APage* NewPage = Utils::ConstructNewPage((uint8*)GMalloc->Alloc(GetPageMemoryRequirement(PageSize)), Offset, PageSize);
+			APage* NewPage = Utils::ConstructNewPage((uint8*)AllocateArenaMemory(GetPageMemoryRequirement(PageSize), m_Specification.MemoryOptions), Offset, PageSize);
 			m_Pages.PushBack(NewPage);
 			return NewPage;
 		}
 	}
 
-}
\ No newline at end of file
+	bool8 ALinearArena::CommitPageMemory(APage* Page, uint64 RequiredBytes)
+	{
+		if (!m_Specification.bUseVirtualMemory)
+		{
+			return false;
+		}
+
+		uint64 CommittedBytes = sizeof(APage) + Page->SizeBytes;
+		uint64 RequiredCommittedBytes = Utils::AlignToPageSize(sizeof(APage) + RequiredBytes);
+		if (RequiredCommittedBytes > m_ReservedBytes)
+		{
+			return false;
+		}
+
+		uint64 NewCommittedBytes = CommittedBytes + VirtualCommitGranularity;
+		if (NewCommittedBytes < RequiredCommittedBytes)
+		{
+			NewCommittedBytes = RequiredCommittedBytes;
+		}
+		NewCommittedBytes = Utils::AlignToHugePageBoundary((uint8*)Page, NewCommittedBytes, m_Specification.MemoryOptions);
+		if (NewCommittedBytes > m_ReservedBytes)
+		{
+			NewCommittedBytes = m_ReservedBytes;
+		}
+
+		if (!APlatform::Commit((uint8*)Page + CommittedBytes, NewCommittedBytes - CommittedBytes))
+		{
+			return false;
+		}
+		PrepareArenaMemory((uint8*)Page + CommittedBytes, NewCommittedBytes - CommittedBytes, m_Specification.MemoryOptions);
+
+		Page->SizeBytes = NewCommittedBytes - sizeof(APage);
+		m_TotalBytes += NewCommittedBytes - CommittedBytes;
+		return true;
+	}
+
+	void ALinearArena::SetCurrentPage(uint64 PageIndex)
+	{
+		while (m_CurrentPage < PageIndex)
+		{
+			m_PassedPagesBytes += m_Pages[m_CurrentPage]->SizeBytes;
+			m_PassedPagesAllocatedBytes += m_Pages[m_CurrentPage]->AllocatedBytes;
+			m_CurrentPage++;
+		}
+		while (m_CurrentPage > PageIndex)
+		{
+			m_CurrentPage--;
+			m_PassedPagesBytes -= m_Pages[m_CurrentPage]->SizeBytes;
+			m_PassedPagesAllocatedBytes -= m_Pages[m_CurrentPage]->AllocatedBytes;
+		}
+	}
+
+}
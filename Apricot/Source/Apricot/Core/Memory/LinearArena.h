@@ -37,12 +37,37 @@ namespace Apricot {
 		*/
 		uint64 ArenaMemoryOffset = 0;
 
+		/**
+		* If true, 'ArenaMemory' already holds the pages of an arena with the same page sizes (for example, a memory-mapped
+		*	snapshot of it). The pages keep their allocations, so the arena continues from where the previous one stopped.
+		* The pages might be mapped at another address than before, so the data in them should only use offset pointers.
+		*/
+		bool bRestoreArenaMemory = false;
+
 		/**
 		* Tells the arena if it can allocate new pages when it gets out of memory.
 		* If this is false, and the arena runs out of memory, an 'error' will be issued.
 		*/
 		bool bShouldGrow = true;
 
+		/**
+		* If true, the arena reserves 'VirtualReserveSize' bytes of address space when it is created, and commits physical memory
+		*	only when it needs it. The arena has a single page that grows in place, so it never becomes non-contiguous.
+		* The first page size is used as the initial committed size. The other pages, 'ArenaMemory' and 'bShouldGrow' are ignored.
+		*/
+		bool bUseVirtualMemory = false;
+
+		/**
+		* The size of the reserved address range. It is the maximum size of a virtual memory arena.
+		*/
+		uint64 VirtualReserveSize = 0;
+
+		/**
+		* Controls how the pages' memory is obtained from the system (huge pages, prefaulting, locking).
+		* Doesn't apply to the memory provided through 'ArenaMemory'.
+		*/
+		AArenaMemoryOptions MemoryOptions;
+
 		/**
 		* 
 		*/
@@ -102,6 +127,11 @@ namespace Apricot {
 			uint64 AllocatedBytes = AE_INVALID_MEMSIZE;
 		};
 
+		/**
+		* Virtual memory arenas commit memory in steps of at least this size, so that small allocations don't enter the kernel every time.
+		*/
+		static constexpr uint64 VirtualCommitGranularity = AE_KILOBYTES(64);
+
 	/* API interface */
 	public:
 		/**
@@ -192,25 +222,41 @@ namespace Apricot {
 
 		/**
 		* Deletes all the unused pages. It cannot delete the specification pages, because they aren't allocated individually.
+		* For virtual memory arenas, it decommits the unused tail of the page.
 		*/
 		virtual void GarbageCollect() override;
 
+		/**
+		* Returns the current position of the arena, which can be passed to 'RewindTo' later. Usually used through AArenaMark.
+		*/
+		virtual AArenaPosition GetPosition() const override;
+
+		/**
+		* Frees everything allocated after 'Position', across all the pages filled since. The pages are kept, so the memory is reused.
+		*/
+		virtual void RewindTo(const AArenaPosition& Position) override;
+
+		/**
+		* Reports the occupancy of every page. The pages before the current one report their unused ends as tail waste.
+		*/
+		virtual void TakeFragmentationReport(AArenaFragmentationReport& OutReport) const override;
+
 	/* Getters & Setters */
 	public:
 		/**
-		* Returns the total size of all pages.
+		* Returns the total size of all pages. Cached, so it runs in constant time.
 		*/
-		uint64 GetTotalSize() const;
+		virtual uint64 GetTotalSize() const override;
 
 		/**
-		* Returns the total allocated size from each page.
+		* Returns the total allocated size from each page. Cached, so it runs in constant time.
 		* Might not be accurate with the requested allocations' sizes.
 		*/
 		uint64 GetAllocatedSize() const;
 
 		/**
 		* Returns the available size. Remember that this memory might not be contiguous, so this is not as the biggest size
-		*	that can be allocated without having to allocate a new page.
+		*	that can be allocated without having to allocate a new page. Cached, so it runs in constant time.
 		*/
 		uint64 GetFreeSize() const;
 
@@ -244,6 +290,23 @@ namespace Apricot {
 		*/
 		APage* AllocateNewPage(uint64 PageSize);
 
+		/**
+		* Commits enough memory for the page to hold 'RequiredBytes' bytes. Only virtual memory arenas can do this.
+		* 
+		* @param Page The arena's page. Its size is updated to the new committed size.
+		* 
+		* @param RequiredBytes The size the page must have.
+		* 
+		* @returns True if the page can now hold 'RequiredBytes' bytes. False if the reserved range is too small or the arena doesn't use virtual memory.
+		*/
+		bool8 CommitPageMemory(APage* Page, uint64 RequiredBytes);
+
+		/**
+		* Makes 'PageIndex' the current page and updates the cached sizes of the pages before it.
+		* The pages that are passed must not change their allocated bytes until the arena moves back before them.
+		*/
+		void SetCurrentPage(uint64 PageIndex);
+
 	/* Member variables */
 	private:
 		/**
@@ -256,11 +319,30 @@ namespace Apricot {
 		*/
 		uint64 m_CurrentPage;
 
+		/**
+		* Cached sizes, so that the getters don't have to walk the pages. The pages after the current one are always empty,
+		*	so the allocated bytes are the ones of the pages before it, plus the ones of the current page.
+		*/
+		uint64 m_TotalBytes = 0;
+		uint64 m_PassedPagesBytes = 0;
+		uint64 m_PassedPagesAllocatedBytes = 0;
+
+		/**
+		* The size of the reserved address range, including the page's header. Zero if the arena doesn't use virtual memory.
+		*/
+		uint64 m_ReservedBytes = 0;
+
 		/**
 		* Arena's specification. Can't be modified after the creation.
 		*/
 		ALinearArenaSpecification m_Specification;
 
+		/**
+		* Size of the memory block that holds the specification's pages, if they are bulk allocated. The specification's page
+		*	arrays are only valid during the creation, so the block can't be measured again when the arena is destroyed.
+		*/
+		uint64 m_BulkMemoryBytes = 0;
+
 	/* Friends */
 	private:
 		template<typename T, typename... Args>
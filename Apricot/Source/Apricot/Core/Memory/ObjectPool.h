@@ -0,0 +1,303 @@
+// Part of Apricot Engine. 2022-2022.
+// Module: Memory
+
+#pragma once
+
+#include "GenerationalHandle.h"
+#include "PoolArena.h"
+
+#include "Apricot/Core/Assert.h"
+
+#include "Apricot/Containers/Vector.h"
+
+namespace Apricot {
+
+	/**
+	* Reference to an object of a TObjectPool (see AGenerationalHandle). The object's type is part of the handle's type, so
+	*	the handles of different pools can't be mixed up.
+	*/
+	template<typename T>
+	struct TObjectHandle : public AGenerationalHandle
+	{
+	public:
+		TObjectHandle() = default;
+
+		explicit TObjectHandle(AGenerationalHandle Handle)
+			: AGenerationalHandle(Handle)
+		{
+		}
+
+	public:
+		FORCEINLINE static TObjectHandle Unpack(uint64 PackedHandle)
+		{
+			return TObjectHandle(AGenerationalHandle::Unpack(PackedHandle));
+		}
+	};
+
+	/**
+	* C++ Core Engine Architecture
+	*
+	* Typed object pool, built on an APoolArena. The objects are constructed in place in the arena's chunks, so they never move
+	*	and never go through the heap. They are referenced through generational handles (see AGenerationalHandle).
+	*
+	* Besides the slots (indexed by the handles), the pool keeps a dense array with the live objects, so iterating them doesn't
+	*	skip over the destroyed ones. Destroying an object moves the last dense entry in its place, so the iteration order
+	*	isn't stable and an object must not be destroyed while iterating, except the current one through 'DestroyAt'.
+	*
+	* The pool grows geometrically, by adding arena pages as big as its current capacity. It isn't thread-safe.
+	*/
+	template<typename T>
+	class TObjectPool
+	{
+	/* Typedefs */
+	public:
+		using ValueType = T;
+		using THandle = TObjectHandle<T>;
+
+		static constexpr uint32 InvalidIndex = 0xFFFFFFFF;
+
+		/**
+		* The chunks are a multiple of the object's alignment and the chunks of every arena page start at 'APoolArena::ChunksAlignment',
+		*	so all the chunks are aligned without any padding.
+		*/
+		static constexpr uint64 ChunkSize = sizeof(T) + ((alignof(T) - sizeof(T) % alignof(T)) % alignof(T));
+		AE_STATIC_ASSERT(alignof(T) <= APoolArena::ChunksAlignment, "The object's alignment is bigger than the arena's chunks alignment!");
+
+	private:
+		struct ASlot : public AGenerationalSlot
+		{
+			T* Object = nullptr;
+
+			/**
+			* The object's index in the dense array while the slot is used, otherwise the next free slot.
+			*/
+			uint32 DenseIndexOrNextFree = InvalidIndex;
+		};
+
+	/* Constructors & Deconstructor */
+	public:
+		TObjectPool(uint32 InitialCapacity = 64)
+		{
+			uint64 ChunksCount = InitialCapacity > 0 ? InitialCapacity : 1;
+			uint64 ChunkSizes = ChunkSize;
+
+			APoolArenaSpecification Specification;
+			Specification.PagesCount = 1;
+			Specification.PageChunkCounts = &ChunksCount;
+			Specification.PageChunkSizes = &ChunkSizes;
+			Specification.bShouldGrow = false;
+			m_Arena = APoolArena::Create(Specification);
+			m_Capacity = ChunksCount;
+
+			m_Slots.SetCapacity(ChunksCount);
+			m_DenseObjects.SetCapacity(ChunksCount);
+			m_DenseSlots.SetCapacity(ChunksCount);
+		}
+
+		~TObjectPool()
+		{
+			Clear();
+		}
+
+		TObjectPool(const TObjectPool&) = delete;
+		TObjectPool& operator=(const TObjectPool&) = delete;
+
+	/* API interface */
+	public:
+		/**
+		* Constructs a new object in the pool.
+		*
+		* @returns The handle of the new object, or a null handle if the arena couldn't allocate it.
+		*/
+		template<typename... Args>
+		THandle Create(Args&&... args)
+		{
+			if (m_DenseObjects.Size() >= m_Capacity)
+			{
+				Grow();
+			}
+
+			// The arena already reported the failure, so no slot is taken and a null handle is returned.
+			T* Object = (T*)m_Arena->AllocUnsafe(ChunkSize, 1);
+			if (Object == nullptr)
+			{
+				return THandle();
+			}
+
+			uint32 SlotIndex = m_FirstFreeSlot;
+			if (SlotIndex != InvalidIndex)
+			{
+				m_FirstFreeSlot = m_Slots[SlotIndex].DenseIndexOrNextFree;
+			}
+			else
+			{
+				AE_CORE_ASSERT(m_Slots.Size() < InvalidIndex, TEXT("TObjectPool ran out of handle indices!"));
+				SlotIndex = (uint32)m_Slots.Size();
+				m_Slots.EmplaceBack();
+			}
+
+			MemConstruct<T>(Object, Forward<Args>(args)...);
+
+			ASlot& Slot = m_Slots[SlotIndex];
+			Slot.Object = Object;
+			Slot.DenseIndexOrNextFree = (uint32)m_DenseObjects.Size();
+
+			m_DenseObjects.PushBack(Object);
+			m_DenseSlots.PushBack(SlotIndex);
+
+			return THandle(Slot.Acquire(SlotIndex));
+		}
+
+		/**
+		* Destroys the handle's object. Stale and null handles are ignored.
+		*
+		* @returns True if an object was destroyed.
+		*/
+		bool8 Destroy(THandle Handle)
+		{
+			if (!IsValid(Handle))
+			{
+				return false;
+			}
+
+			DestroyAt(m_Slots[Handle.Index].DenseIndexOrNextFree);
+			return true;
+		}
+
+		/**
+		* Destroys the object at the given dense index. The last object takes its place, so when iterating by index,
+		*	the same index must be visited again.
+		*/
+		void DestroyAt(uint64 DenseIndex)
+		{
+			AE_CORE_ASSERT(DenseIndex < m_DenseObjects.Size());
+
+			uint32 SlotIndex = m_DenseSlots[DenseIndex];
+			ASlot& Slot = m_Slots[SlotIndex];
+
+			Slot.Object->~T();
+			m_Arena->FreeUnsafe(Slot.Object, ChunkSize);
+
+			uint64 LastIndex = m_DenseObjects.Size() - 1;
+			if (DenseIndex != LastIndex)
+			{
+				m_DenseObjects[DenseIndex] = m_DenseObjects[LastIndex];
+				m_DenseSlots[DenseIndex] = m_DenseSlots[LastIndex];
+				m_Slots[m_DenseSlots[DenseIndex]].DenseIndexOrNextFree = (uint32)DenseIndex;
+			}
+			m_DenseObjects.PopBack();
+			m_DenseSlots.PopBack();
+
+			Slot.Object = nullptr;
+			if (Slot.Release())
+			{
+				Slot.DenseIndexOrNextFree = m_FirstFreeSlot;
+				m_FirstFreeSlot = SlotIndex;
+			}
+		}
+
+		/**
+		* Destroys all the objects. The handles given so far all become stale. The arena's pages are kept.
+		*/
+		void Clear()
+		{
+			while (!m_DenseObjects.IsEmpty())
+			{
+				DestroyAt(m_DenseObjects.Size() - 1);
+			}
+		}
+
+		/**
+		* Checks the handle's generation against the slot's. Doesn't touch the object.
+		*/
+		FORCEINLINE bool8 IsValid(THandle Handle) const
+		{
+			return Handle.Index < m_Slots.Size() && m_Slots[Handle.Index].Matches(Handle);
+		}
+
+		/**
+		* @returns The handle's object, or nullptr if the handle is stale or null.
+		*/
+		FORCEINLINE T* Get(THandle Handle) const
+		{
+			return IsValid(Handle) ? m_Slots[Handle.Index].Object : nullptr;
+		}
+
+		/**
+		* Calls 'Function' with every live object, in the dense order.
+		*/
+		template<typename TFunction>
+		void ForEach(TFunction Function) const
+		{
+			for (uint64 Index = 0; Index < m_DenseObjects.Size(); Index++)
+			{
+				Function(*m_DenseObjects[Index]);
+			}
+		}
+
+	/* Getters & Setters */
+	public:
+		/**
+		* Returns the number of live objects.
+		*/
+		FORCEINLINE uint64 Size() const { return m_DenseObjects.Size(); }
+
+		FORCEINLINE bool8 IsEmpty() const { return m_DenseObjects.IsEmpty(); }
+
+		/**
+		* Returns the number of objects the pool can hold before it grows.
+		*/
+		FORCEINLINE uint64 Capacity() const { return m_Capacity; }
+
+		FORCEINLINE T& GetAt(uint64 DenseIndex) const
+		{
+			AE_CORE_ASSERT(DenseIndex < m_DenseObjects.Size());
+			return *m_DenseObjects[DenseIndex];
+		}
+
+		FORCEINLINE THandle GetHandleAt(uint64 DenseIndex) const
+		{
+			AE_CORE_ASSERT(DenseIndex < m_DenseObjects.Size());
+
+			THandle Handle;
+			Handle.Index = m_DenseSlots[DenseIndex];
+			Handle.Generation = m_Slots[Handle.Index].Generation;
+			return Handle;
+		}
+
+		FORCEINLINE const TSharedPtr<APoolArena>& GetArena() const { return m_Arena; }
+
+	private:
+		/**
+		* Doubles the capacity, with a new arena page.
+		*/
+		void Grow()
+		{
+			uint64 ChunksCount = m_Capacity;
+			m_Arena->AllocateNewPage(ChunksCount, ChunkSize);
+			m_Capacity += ChunksCount;
+
+			m_DenseObjects.SetCapacity(m_Capacity);
+			m_DenseSlots.SetCapacity(m_Capacity);
+		}
+
+	private:
+		TSharedPtr<APoolArena> m_Arena;
+
+		uint64 m_Capacity = 0;
+
+		TVector<ASlot> m_Slots;
+
+		/**
+		* The live objects and their slots, kept in separate arrays so that iterating the objects reads only the pointers.
+		*/
+		TVector<T*> m_DenseObjects;
+		TVector<uint32> m_DenseSlots;
+
+		/**
+		* Head of the list of free slots, linked through 'DenseIndexOrNextFree'.
+		*/
+		uint32 m_FirstFreeSlot = InvalidIndex;
+	};
+
+}
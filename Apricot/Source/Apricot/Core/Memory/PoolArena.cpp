@@ -8,6 +8,70 @@ namespace Apricot {
 
 	namespace Utils {
 		
+		FORCEINLINE static uint64 GetAllocatedChunksBitmapSize(uint64 ChunksCount)
+		{
+			return ((ChunksCount + 63) / 64) * sizeof(uint64);
+		}
+
+		FORCEINLINE static bool8 IsChunkAllocated(const APoolArena::APage* Page, uint64 ChunkIndex)
+		{
+			return (Page->AllocatedChunks[ChunkIndex / 64] & (1ull << (ChunkIndex % 64))) != 0;
+		}
+
+		FORCEINLINE static void SetChunkAllocated(APoolArena::APage* Page, uint64 ChunkIndex, bool8 bIsAllocated)
+		{
+			if (bIsAllocated)
+			{
+				Page->AllocatedChunks[ChunkIndex / 64] |= (1ull << (ChunkIndex % 64));
+			}
+			else
+			{
+				Page->AllocatedChunks[ChunkIndex / 64] &= ~(1ull << (ChunkIndex % 64));
+			}
+		}
+
+		FORCEINLINE static bool8 IsChunkRelocatable(const APoolArena::APage* Page, uint64 ChunkIndex)
+		{
+			return (Page->RelocatableChunks[ChunkIndex / 64] & (1ull << (ChunkIndex % 64))) != 0;
+		}
+
+		FORCEINLINE static void SetChunkRelocatable(APoolArena::APage* Page, uint64 ChunkIndex, bool8 bIsRelocatable)
+		{
+			if (bIsRelocatable)
+			{
+				Page->RelocatableChunks[ChunkIndex / 64] |= (1ull << (ChunkIndex % 64));
+			}
+			else
+			{
+				Page->RelocatableChunks[ChunkIndex / 64] &= ~(1ull << (ChunkIndex % 64));
+			}
+		}
+
+		FORCEINLINE static uint64 GetChunkIndex(const APoolArena::APage* Page, const void* Allocation)
+		{
+			return ((uintptr)Allocation - (uintptr)Page->MemoryBlock) / Page->ChunkSize;
+		}
+
+		/**
+		* Marks all the page's chunks as free.
+		*/
+		static void ResetPageChunks(APoolArena::APage* Page)
+		{
+			Page->FreeChunksCount = Page->ChunksCount;
+
+			uint8* Chunk = (uint8*)Page->MemoryBlock;
+			for (uint64 Index = 0; Index < Page->FreeChunksCount; Index++)
+			{
+				Page->FreeChunks[Index] = Chunk;
+				Chunk += Page->ChunkSize;
+			}
+
+		#ifdef AE_ENABLE_MEMORY_CHECK
+			MemZero(Page->AllocatedChunks, GetAllocatedChunksBitmapSize(Page->ChunksCount));
+			MemZero(Page->RelocatableChunks, GetAllocatedChunksBitmapSize(Page->ChunksCount));
+		#endif
+		}
+
 		static APoolArena::APage* ConstructNewPage(uint8* ArenaMemory, uint64& Offset, uint64 ChunksCount, uint64 ChunkSize)
 		{
 			Offset += GetAlignmentOffset(Offset, sizeof(void*));
@@ -20,19 +84,45 @@ namespace Apricot {
 			NewPage->FreeChunks = (void**)(ArenaMemory + Offset);
 			Offset += NewPage->FreeChunksCount * sizeof(void*);
 
+		#ifdef AE_ENABLE_MEMORY_CHECK
+			NewPage->AllocatedChunks = (uint64*)(ArenaMemory + Offset);
+			Offset += GetAllocatedChunksBitmapSize(ChunksCount);
+
+			NewPage->RelocatableChunks = (uint64*)(ArenaMemory + Offset);
+			Offset += GetAllocatedChunksBitmapSize(ChunksCount);
+		#endif
+
+			Offset += GetAlignmentOffset(ArenaMemory + Offset, APoolArena::ChunksAlignment);
+
 			NewPage->MemoryBlock = ArenaMemory + Offset;
 			NewPage->ChunksCount = ChunksCount;
 			NewPage->ChunkSize = ChunkSize;
 
-			for (uint64 Index = 0; Index < NewPage->FreeChunksCount; Index++)
-			{
-				NewPage->FreeChunks[Index] = ArenaMemory + Offset;
-				Offset += NewPage->ChunkSize;
-			}
+			Offset += NewPage->ChunksCount * NewPage->ChunkSize;
+
+			ResetPageChunks(NewPage);
 
 			return NewPage;
 		}
 
+		FORCEINLINE static uint64 GetSizeClass(uint64 ChunkSize)
+		{
+			return FindLastSetBit(ChunkSize | 1);
+		}
+
+		/**
+		* Invalidates the entry's handles and pushes it to the list of free entries.
+		*/
+		static void ReleaseRelocatableEntry(APoolArena::ARelocatableEntry& Entry, uint32 EntryIndex, uint32& FirstFreeEntry)
+		{
+			Entry.Allocation = nullptr;
+			if (Entry.Release())
+			{
+				Entry.NextFree = FirstFreeEntry;
+				FirstFreeEntry = EntryIndex;
+			}
+		}
+
 	}
 
 	TSharedPtr<APoolArena> APoolArena::Create(const APoolArenaSpecification& Specification)
@@ -59,6 +149,11 @@ namespace Apricot {
 
 		MemoryRequirement += sizeof(APage);
 		MemoryRequirement += ChunksCount * sizeof(void*);
+	#ifdef AE_ENABLE_MEMORY_CHECK
+		// The allocated and the relocatable chunks bitmaps.
+		MemoryRequirement += 2 * Utils::GetAllocatedChunksBitmapSize(ChunksCount);
+	#endif
+		MemoryRequirement += ChunksAlignment - 1;
 		MemoryRequirement += ChunksCount * ChunkSize;
 
 		return MemoryRequirement;
@@ -68,6 +163,7 @@ namespace Apricot {
 		: m_Specification(Specification)
 	{
 		m_Pages.SetCapacity(m_Specification.PagesCount);
+		m_SortedPages.SetCapacity(m_Specification.PagesCount);
 
 		uint8* ArenaMemory = (uint8*)m_Specification.ArenaMemory;
 
@@ -75,13 +171,14 @@ namespace Apricot {
 		{
 			if (!ArenaMemory)
 			{
-				ArenaMemory = (uint8*)GMalloc->Alloc(GetMemoryRequirement(m_Specification));
+				m_BulkMemoryBytes = GetMemoryRequirement(m_Specification);
+				ArenaMemory = (uint8*)AllocateArenaMemory(m_BulkMemoryBytes, m_Specification.MemoryOptions);
 			}
 			uint64 MemoryOffset = 0;
 
 			for (uint64 Index = 0; Index < m_Specification.PagesCount; Index++)
 			{
-				m_Pages.PushBack(Utils::ConstructNewPage(ArenaMemory, MemoryOffset, m_Specification.PageChunkCounts[Index], m_Specification.PageChunkSizes[Index]));
+				RegisterPage(Utils::ConstructNewPage(ArenaMemory, MemoryOffset, m_Specification.PageChunkCounts[Index], m_Specification.PageChunkSizes[Index]));
 			}
 		}
 		else
@@ -92,37 +189,33 @@ namespace Apricot {
 				uint64 PageChunksCount = m_Specification.PageChunkCounts[Index];
 				uint64 PageChunkSize = m_Specification.PageChunkSizes[Index];
 
-				ArenaMemory = (uint8*)GMalloc->Alloc(GetPageMemoryRequirement(PageChunksCount, PageChunkSize));
-				m_Pages.PushBack(Utils::ConstructNewPage(ArenaMemory, MemoryOffset, PageChunksCount, PageChunkSize));
+				ArenaMemory = (uint8*)AllocateArenaMemory(GetPageMemoryRequirement(PageChunksCount, PageChunkSize), m_Specification.MemoryOptions);
+				RegisterPage(Utils::ConstructNewPage(ArenaMemory, MemoryOffset, PageChunksCount, PageChunkSize));
 			}
 		}
 	}
 
 	APoolArena::~APoolArena()
 	{
-		if (!m_Specification.bUseArenaMemoryAlways)
+		bool8 bSpecPagesAreBulk = m_Specification.bBulkAllocateSpecPages || m_Specification.ArenaMemory;
+
+		for (uint64 Index = 0; Index < m_Pages.Size(); Index++)
 		{
-			for (uint64 Index = m_Specification.PagesCount; Index < m_Pages.Size(); Index++)
+			bool8 bIsSpecPage = Index < m_Specification.PagesCount;
+			if ((bIsSpecPage && !bSpecPagesAreBulk) || (!bIsSpecPage && !m_Specification.bUseArenaMemoryAlways))
 			{
-				GMalloc->Free(m_Pages[Index], GetPageMemoryRequirement(m_Pages[Index]->ChunksCount, m_Pages[Index]->ChunkSize));
+				FreeArenaMemory(m_Pages[Index], GetPageMemoryRequirement(m_Pages[Index]->ChunksCount, m_Pages[Index]->ChunkSize), m_Specification.MemoryOptions);
 			}
 		}
-		if (!m_Specification.ArenaMemory && !m_Pages.IsEmpty())
+		if (bSpecPagesAreBulk && !m_Specification.ArenaMemory && m_Specification.PagesCount > 0)
 		{
-			GMalloc->Free(m_Pages[0], GetMemoryRequirement(m_Specification));
+			FreeArenaMemory(m_Pages[0], m_BulkMemoryBytes, m_Specification.MemoryOptions);
 		}
 	}
 
 	uint64 APoolArena::GetAllocatedSize() const
 	{
-		uint64 AllocatedSize = 0;
-
-		for (uint64 Index = 0; Index < m_Pages.Size(); Index++)
-		{
-			AllocatedSize += (m_Pages[Index]->ChunksCount - m_Pages[Index]->FreeChunksCount) * m_Pages[Index]->ChunkSize;
-		}
-
-		return AllocatedSize;
+		return m_TotalBytes - m_FreeBytes;
 	}
 
 	const TChar* APoolArena::GetDebugName() const
@@ -132,158 +225,297 @@ namespace Apricot {
 
 	uint64 APoolArena::GetFreeSize() const
 	{
-		uint64 FreeSize = 0;
-
-		for (uint64 Index = 0; Index < m_Pages.Size(); Index++)
-		{
-			FreeSize += m_Pages[Index]->FreeChunksCount * m_Pages[Index]->ChunkSize;
-		}
-
-		return FreeSize;
+		return m_FreeBytes;
 	}
 
 	uint64 APoolArena::GetTotalSize() const
 	{
-		uint64 TotalSize = 0;
-
-		for (uint64 Index = 0; Index < m_Pages.Size(); Index++)
-		{
-			TotalSize += m_Pages[Index]->ChunksCount * m_Pages[Index]->ChunkSize;
-		}
-
-		return TotalSize;
+		return m_TotalBytes;
 	}
 
 	NODISCARD void* APoolArena::Alloc(uint64 Size, uint64 Alignment /*= sizeof(void*)*/, EAllocStrategy Mode /*= EFindMode::BestFit*/)
 	{
-		if (Mode == EAllocStrategy::BestFit)
+		if (Size == 0)
 		{
-			uint64 MinimumSize = AE_UINT64_MAX;
-			APage* BestPage = nullptr;
+			GCrashReporter->MemoryState.Arena = this;
+			GCrashReporter->MemoryState.Size = Size;
+			GCrashReporter->SubmitArenaFailure(ACrashReporter::EMemoryOperation::Allocate, EMemoryError::InvalidSize);
+			return nullptr;
+		}
+		if (Alignment == 0)
+		{
+			GCrashReporter->MemoryState.Arena = this;
+			GCrashReporter->MemoryState.Alignment = Alignment;
+			GCrashReporter->SubmitArenaFailure(ACrashReporter::EMemoryOperation::Allocate, EMemoryError::InvalidAlignment);
+			return nullptr;
+		}
 
-			for (uint64 Index = 0; Index < m_Pages.Size(); Index++)
-			{
-				if (m_Pages[Index]->FreeChunksCount > 0 && Size + Alignment - 1 <= m_Pages[Index]->ChunkSize)
-				{
-					if (m_Pages[Index]->ChunkSize < MinimumSize)
-					{
-						MinimumSize = m_Pages[Index]->ChunkSize;
-						BestPage = m_Pages[Index];
-						if (MinimumSize == Size + Alignment - 1)
-						{
-							break;
-						}
-					}
-				}
-			}
+		BeginOwnerAllocation();
+
+		uint64 RequiredSize = Size + Alignment - 1;
 
-			if (BestPage != nullptr)
+		APage* Page = FindAvailablePage(RequiredSize);
+		if (Page == nullptr)
+		{
+			if (!m_Specification.bShouldGrow)
 			{
-				uint8* Memory = (uint8*)BestPage->FreeChunks[--BestPage->FreeChunksCount];
-				uint64 AlignmentOffset = GetAlignmentOffset(Memory, Alignment);
-				return Memory + AlignmentOffset;
+				GCrashReporter->MemoryState.Arena = this;
+				GCrashReporter->MemoryState.Size = Size;
+				GCrashReporter->MemoryState.Alignment = Alignment;
+				GCrashReporter->MemoryState.FreeSize = m_FreeBytes;
+				GCrashReporter->SubmitArenaFailure(ACrashReporter::EMemoryOperation::Allocate, EMemoryError::OutOfMemoryUnableToGrow);
+				return nullptr;
 			}
+
+			Page = Grow(RequiredSize);
 		}
-		else if (Mode == EAllocStrategy::FirstFit)
+
+		void* Allocation = AllocateChunk(Page, Alignment);
+		SubmitAllocationStats(Allocation, Size, Alignment);
+		return Allocation;
+	}
+
+	NODISCARD int32 APoolArena::TryAlloc(uint64 Size, void** OutPointer, uint64 Alignment /*= sizeof(void*)*/, EAllocStrategy Mode /*= EFindMode::BestFit*/)
+	{
+		if (OutPointer == nullptr)
 		{
-			for (uint64 Index = 0; Index < m_Pages.Size(); Index++)
-			{
-				if (m_Pages[Index]->FreeChunksCount > 0 && Size + Alignment - 1 <= m_Pages[Index]->ChunkSize)
-				{
-					uint8* Memory = (uint8*)m_Pages[Index]->FreeChunks[--m_Pages[Index]->FreeChunksCount];
-					uint64 AlignmentOffset = GetAlignmentOffset(Memory, Alignment);
-					return Memory + AlignmentOffset;
-				}
-			}
+			return (int32)EMemoryError::InvalidOuterPointer;
 		}
+		*OutPointer = nullptr;
 
-		if (!m_Specification.bShouldGrow)
+		if (Size == 0)
 		{
-			// TODO: Report error
-			return nullptr;
+			return (int32)EMemoryError::InvalidSize;
+		}
+		if (Alignment == 0)
+		{
+			return (int32)EMemoryError::InvalidAlignment;
 		}
 
-		// Arbitrary number
-		// TODO (Avr): Think about a better way of calculating these values 
-		uint64 NewPageChunksCount = 32;
-		uint64 NewPageChunkSize = Size + Alignment - 1;
-		if (!m_Pages.IsEmpty())
+		BeginOwnerAllocation();
+
+		uint64 RequiredSize = Size + Alignment - 1;
+
+		APage* Page = FindAvailablePage(RequiredSize);
+		if (Page == nullptr)
 		{
-			uint64 MedianChunksCount = 0;
-			uint64 MedianChunkSize = 0;
-			for (const APage* Page : m_Pages)
+			if (!m_Specification.bShouldGrow)
 			{
-				MedianChunksCount += Page->ChunksCount;
-				MedianChunkSize += Page->ChunkSize;
+				return (int32)EMemoryError::OutOfMemoryUnableToGrow;
 			}
-			MedianChunksCount /= m_Pages.Size();
-			MedianChunkSize /= m_Pages.Size();
 
-			NewPageChunksCount = MedianChunksCount;
-			if (NewPageChunkSize < MedianChunkSize)
-			{
-				NewPageChunkSize = MedianChunkSize;
-			}
+			Page = Grow(RequiredSize);
 		}
 
-		AllocateNewPage(NewPageChunksCount, NewPageChunkSize);
-		APage* NewPage = m_Pages.Back();
-
-		uint8* Memory = (uint8*)NewPage->FreeChunks[--NewPage->FreeChunksCount];
-		uint64 AlignmentOffset = GetAlignmentOffset(Memory, Alignment);
-		return Memory + AlignmentOffset;
-	}
-
-	NODISCARD int32 APoolArena::TryAlloc(uint64 Size, void** OutPointer, uint64 Alignment /*= sizeof(void*)*/, EAllocStrategy Mode /*= EFindMode::BestFit*/)
-	{
+		*OutPointer = AllocateChunk(Page, Alignment);
+		SubmitAllocationStats(*OutPointer, Size, Alignment);
 		return (int32)EMemoryError::Success;
 	}
 
 	NODISCARD void* APoolArena::AllocUnsafe(uint64 Size, uint64 Alignment /*= sizeof(void*)*/, EAllocStrategy Mode /*= EFindMode::BestFit*/)
 	{
-		return nullptr;
+		BeginOwnerAllocation();
+
+		uint64 RequiredSize = Size + Alignment - 1;
+
+		APage* Page = FindAvailablePage(RequiredSize);
+		if (Page == nullptr)
+		{
+			if (!m_Specification.bShouldGrow)
+			{
+				return nullptr;
+			}
+
+			Page = Grow(RequiredSize);
+		}
+
+		void* Allocation = AllocateChunk(Page, Alignment);
+		SubmitAllocationStats(Allocation, Size, Alignment);
+		return Allocation;
 	}
 
 	void APoolArena::Free(void* Allocation, uint64 Size)
 	{
-		
+		if (Allocation == nullptr)
+		{
+			GCrashReporter->MemoryState.Arena = this;
+			GCrashReporter->SubmitArenaFailure(ACrashReporter::EMemoryOperation::Free, EMemoryError::InvalidMemoryPtr);
+			return;
+		}
+
+		if (IsRemoteThread())
+		{
+			// Nothing that the owner writes is read here, so the page isn't looked up.
+			AE_CORE_ASSERT(Size >= sizeof(ARemoteFreeNode), TEXT("The allocation is too small to be freed from another thread!"));
+			PushRemoteFree(Allocation, Size);
+			return;
+		}
+
+		APage* Page = FindOwningPage(Allocation);
+		if (Page == nullptr)
+		{
+			GCrashReporter->MemoryState.Arena = this;
+			GCrashReporter->MemoryState.MemoryBlock = Allocation;
+			GCrashReporter->MemoryState.Size = Size;
+			GCrashReporter->SubmitArenaFailure(ACrashReporter::EMemoryOperation::Free, EMemoryError::PointerOutOfRange);
+			return;
+		}
+
+	#ifdef AE_ENABLE_MEMORY_CHECK
+		if (!Utils::IsChunkAllocated(Page, Utils::GetChunkIndex(Page, Allocation)))
+		{
+			GCrashReporter->MemoryState.Arena = this;
+			GCrashReporter->MemoryState.MemoryBlock = Allocation;
+			GCrashReporter->MemoryState.Size = Size;
+			GCrashReporter->SubmitArenaFailure(ACrashReporter::EMemoryOperation::Free, EMemoryError::AlreadyFreed);
+			return;
+		}
+
+		// Freeing it here would leave its handle live, so 'Compact' would later move a chunk that was reused.
+		if (Utils::IsChunkRelocatable(Page, Utils::GetChunkIndex(Page, Allocation)))
+		{
+			GCrashReporter->MemoryState.Arena = this;
+			GCrashReporter->MemoryState.MemoryBlock = Allocation;
+			GCrashReporter->MemoryState.Size = Size;
+			GCrashReporter->SubmitArenaFailure(ACrashReporter::EMemoryOperation::Free, EMemoryError::InvalidMemoryPtr);
+			return;
+		}
+	#endif
+
+		FreeChunk(Page, Allocation);
+		SubmitDeallocationStats(Allocation, Size);
 	}
 
 	int32 APoolArena::TryFree(void* Allocation, uint64 Size)
 	{
+		if (Allocation == nullptr)
+		{
+			return (int32)EMemoryError::InvalidMemoryPtr;
+		}
+
+		if (IsRemoteThread())
+		{
+			// Nothing that the owner writes is read here, so the page isn't looked up.
+			AE_CORE_ASSERT(Size >= sizeof(ARemoteFreeNode), TEXT("The allocation is too small to be freed from another thread!"));
+			PushRemoteFree(Allocation, Size);
+			return (int32)EMemoryError::Success;
+		}
+
+		APage* Page = FindOwningPage(Allocation);
+		if (Page == nullptr)
+		{
+			return (int32)EMemoryError::PointerOutOfRange;
+		}
+
+	#ifdef AE_ENABLE_MEMORY_CHECK
+		if (!Utils::IsChunkAllocated(Page, Utils::GetChunkIndex(Page, Allocation)))
+		{
+			return (int32)EMemoryError::AlreadyFreed;
+		}
+
+		if (Utils::IsChunkRelocatable(Page, Utils::GetChunkIndex(Page, Allocation)))
+		{
+			return (int32)EMemoryError::InvalidMemoryPtr;
+		}
+	#endif
+
+		FreeChunk(Page, Allocation);
+		SubmitDeallocationStats(Allocation, Size);
 		return (int32)EMemoryError::Success;
 	}
 
 	void APoolArena::FreeUnsafe(void* Allocation, uint64 Size)
 	{
-		
+		if (IsRemoteThread())
+		{
+			// Nothing that the owner writes is read here, so the page isn't looked up.
+			AE_CORE_ASSERT(Size >= sizeof(ARemoteFreeNode), TEXT("The allocation is too small to be freed from another thread!"));
+			PushRemoteFree(Allocation, Size);
+			return;
+		}
+
+		APage* Page = FindOwningPage(Allocation);
+
+	#ifdef AE_ENABLE_MEMORY_CHECK
+		AE_CORE_ASSERT(!Utils::IsChunkRelocatable(Page, Utils::GetChunkIndex(Page, Allocation)), TEXT("Relocatable allocations must be freed with 'FreeRelocatable'!"));
+	#endif
+
+		FreeChunk(Page, Allocation);
+		SubmitDeallocationStats(Allocation, Size);
 	}
 
 	void APoolArena::FreeAll()
 	{
-		
+		FreeAllUnsafe();
 	}
 
 	int32 APoolArena::TryFreeAll()
 	{
+		FreeAllUnsafe();
 		return (int32)EMemoryError::Success;
 	}
 
 	void APoolArena::FreeAllUnsafe()
 	{
-		
+		// The blocks freed by the other threads are freed with everything else.
+		TakeRemoteFrees();
+
+		AE_MEMZERO_ARRAY(m_AvailablePages);
+		m_AvailableSizeClasses = 0;
+
+		for (uint64 Index = 0; Index < m_Pages.Size(); Index++)
+		{
+			APage* Page = m_Pages[Index];
+			Utils::ResetPageChunks(Page);
+			Page->RelocatableChunksCount = 0;
+
+			if (Page->FreeChunksCount > 0)
+			{
+				LinkAvailablePage(Page);
+			}
+		}
+
+		m_FreeBytes = m_TotalBytes;
+		SubmitDeallocationOfAllStats();
+
+		// All the handles given so far become stale.
+		for (uint64 Index = 0; Index < m_RelocatableEntries.Size(); Index++)
+		{
+			ARelocatableEntry& Entry = m_RelocatableEntries[Index];
+			if (Entry.IsLive())
+			{
+				Utils::ReleaseRelocatableEntry(Entry, (uint32)Index, m_FirstFreeRelocatableEntry);
+			}
+		}
+		m_RelocatableCount = 0;
 	}
 
 	void APoolArena::GarbageCollect()
 	{
+		DrainRemoteFrees();
+
 		for (int64 Index = m_Pages.Size() - 1; Index >= (int64)m_Specification.PagesCount; Index--)
 		{
 			APage* Page = m_Pages[Index];
 			if (Page->FreeChunksCount == Page->ChunksCount)
 			{
+				UnlinkAvailablePage(Page);
+				for (uint64 SortedIndex = 0; SortedIndex < m_SortedPages.Size(); SortedIndex++)
+				{
+					if (m_SortedPages[SortedIndex] == Page)
+					{
+						m_SortedPages.Erase(SortedIndex);
+						break;
+					}
+				}
+				m_TotalBytes -= Page->ChunksCount * Page->ChunkSize;
+				m_FreeBytes -= Page->ChunksCount * Page->ChunkSize;
+				m_ChunksCountSum -= Page->ChunksCount;
+				m_ChunkSizeSum -= Page->ChunkSize;
+
 				if (!m_Specification.bUseArenaMemoryAlways)
 				{
-					GMalloc->Free(Page, GetPageMemoryRequirement(Page->ChunksCount, Page->ChunkSize));
+					FreeArenaMemory(Page, GetPageMemoryRequirement(Page->ChunksCount, Page->ChunkSize), m_Specification.MemoryOptions);
 				}
 
 				m_Pages.Erase(Index);
@@ -293,18 +525,403 @@ namespace Apricot {
 		// TODO (Avr): Garbage collect the specification pages as well
 	}
 
+	void APoolArena::DrainRemoteFrees()
+	{
+		// The frees of another thread would be pushed straight back on the stack.
+		if (IsRemoteThread())
+		{
+			return;
+		}
+
+		ARemoteFreeNode* Node = TakeRemoteFrees();
+		while (Node)
+		{
+			// The node is stored in the allocation, so it must be read before the allocation is freed.
+			ARemoteFreeNode* Next = Node->Next;
+			Free(Node, Node->Size);
+			Node = Next;
+		}
+	}
+
+	void APoolArena::TakeFragmentationReport(AArenaFragmentationReport& OutReport) const
+	{
+		OutReport = {};
+		OutReport.TotalBytes = m_TotalBytes;
+		OutReport.AllocatedBytes = m_TotalBytes - m_FreeBytes;
+		OutReport.FreeBytes = m_FreeBytes;
+		OutReport.PaddingBytes = GetPaddingBytes(OutReport.AllocatedBytes);
+		OutReport.PagesCount = m_Pages.Size();
+
+		for (uint64 Index = 0; Index < m_Pages.Size() && Index < AArenaFragmentationReport::MaxPagesCount; Index++)
+		{
+			const APage* Page = m_Pages[Index];
+			AArenaPageReport& PageReport = OutReport.Pages[Index];
+			PageReport.SizeBytes = Page->ChunksCount * Page->ChunkSize;
+			PageReport.AllocatedBytes = (Page->ChunksCount - Page->FreeChunksCount) * Page->ChunkSize;
+		}
+	}
+
 	void APoolArena::AllocateNewPage(uint64 ChunksCount, uint64 ChunkSize)
 	{
 		if (m_Specification.bUseArenaMemoryAlways)
 		{
-			m_Pages.PushBack(Utils::ConstructNewPage((uint8*)m_Specification.ArenaMemory, m_Specification.ArenaMemoryOffset, ChunksCount, ChunkSize));
+			RegisterPage(Utils::ConstructNewPage((uint8*)m_Specification.ArenaMemory, m_Specification.ArenaMemoryOffset, ChunksCount, ChunkSize));
 		}
 		else
 		{
-			uint8* Memory = (uint8*)GMalloc->Alloc(GetPageMemoryRequirement(ChunksCount, ChunkSize));
+			uint8* Memory = (uint8*)AllocateArenaMemory(GetPageMemoryRequirement(ChunksCount, ChunkSize), m_Specification.MemoryOptions);
 			uint64 Offset = 0;
-			m_Pages.PushBack(Utils::ConstructNewPage(Memory, Offset, ChunksCount, ChunkSize));
+			RegisterPage(Utils::ConstructNewPage(Memory, Offset, ChunksCount, ChunkSize));
+		}
+	}
+
+	NODISCARD APoolHandle APoolArena::AllocRelocatable(uint64 Size, uint64 Alignment /*= sizeof(void*)*/)
+	{
+		void* Allocation = Alloc(Size, Alignment);
+		if (Allocation == nullptr)
+		{
+			return {};
+		}
+
+		uint32 EntryIndex = m_FirstFreeRelocatableEntry;
+		if (EntryIndex != InvalidRelocatableIndex)
+		{
+			m_FirstFreeRelocatableEntry = m_RelocatableEntries[EntryIndex].NextFree;
+		}
+		else
+		{
+			AE_CORE_ASSERT(m_RelocatableEntries.Size() < InvalidRelocatableIndex, TEXT("APoolArena ran out of relocatable handle indices!"));
+			EntryIndex = (uint32)m_RelocatableEntries.Size();
+			m_RelocatableEntries.EmplaceBack();
+		}
+
+		ARelocatableEntry& Entry = m_RelocatableEntries[EntryIndex];
+		Entry.Allocation = Allocation;
+		Entry.Size = Size;
+		Entry.Alignment = Alignment;
+
+		APage* Page = FindOwningPage(Allocation);
+		Page->RelocatableChunksCount++;
+		m_RelocatableCount++;
+
+	#ifdef AE_ENABLE_MEMORY_CHECK
+		Utils::SetChunkRelocatable(Page, Utils::GetChunkIndex(Page, Allocation), true);
+	#endif
+
+		return Entry.Acquire(EntryIndex);
+	}
+
+	bool8 APoolArena::FreeRelocatable(APoolHandle Handle)
+	{
+		if (!IsValid(Handle))
+		{
+			return false;
+		}
+
+		ARelocatableEntry& Entry = m_RelocatableEntries[Handle.Index];
+		APage* Page = FindOwningPage(Entry.Allocation);
+		Page->RelocatableChunksCount--;
+		FreeChunk(Page, Entry.Allocation);
+		SubmitDeallocationStats(Entry.Allocation, Entry.Size);
+
+		Utils::ReleaseRelocatableEntry(Entry, Handle.Index, m_FirstFreeRelocatableEntry);
+		m_RelocatableCount--;
+		return true;
+	}
+
+	uint64 APoolArena::Compact()
+	{
+		DrainRemoteFrees();
+
+		if (m_RelocatableCount == 0)
+		{
+			return 0;
+		}
+
+		// The candidates are sorted by their allocated chunks, so the sparsest pages are emptied first.
+		TVector<APage*> Candidates;
+		for (uint64 Index = m_Specification.PagesCount; Index < m_Pages.Size(); Index++)
+		{
+			APage* Page = m_Pages[Index];
+			uint64 AllocatedChunksCount = Page->ChunksCount - Page->FreeChunksCount;
+			if (AllocatedChunksCount == 0 || AllocatedChunksCount != Page->RelocatableChunksCount || AllocatedChunksCount * 2 > Page->ChunksCount)
+			{
+				continue;
+			}
+
+			Candidates.PushBack(Page);
+			uint64 InsertIndex = Candidates.Size() - 1;
+			while (InsertIndex > 0 && Candidates[InsertIndex - 1]->FreeChunksCount < Page->FreeChunksCount)
+			{
+				Candidates[InsertIndex] = Candidates[InsertIndex - 1];
+				InsertIndex--;
+			}
+			Candidates[InsertIndex] = Page;
+		}
+
+		// A page is only evacuated if the remaining pages have enough free chunks that are big enough for its allocations.
+		// The chunks reserved by the previous candidates are all subtracted, even if they are too small for this one.
+		TVector<APage*> EvacuatingPages;
+		uint64 ReservedChunksCount = 0;
+		for (uint64 CandidateIndex = 0; CandidateIndex < Candidates.Size(); CandidateIndex++)
+		{
+			APage* Candidate = Candidates[CandidateIndex];
+			uint64 AllocatedChunksCount = Candidate->ChunksCount - Candidate->FreeChunksCount;
+
+			uint64 AvailableChunksCount = 0;
+			for (uint64 Index = 0; Index < m_Pages.Size(); Index++)
+			{
+				APage* Page = m_Pages[Index];
+				if (Page != Candidate && !Page->bIsEvacuating && Page->ChunkSize >= Candidate->ChunkSize)
+				{
+					AvailableChunksCount += Page->FreeChunksCount;
+				}
+			}
+
+			if (AvailableChunksCount >= ReservedChunksCount + AllocatedChunksCount)
+			{
+				Candidate->bIsEvacuating = true;
+				UnlinkAvailablePage(Candidate);
+				EvacuatingPages.PushBack(Candidate);
+				ReservedChunksCount += AllocatedChunksCount;
+			}
+		}
+
+		if (EvacuatingPages.IsEmpty())
+		{
+			return 0;
+		}
+
+		for (uint64 Index = 0; Index < m_RelocatableEntries.Size(); Index++)
+		{
+			ARelocatableEntry& Entry = m_RelocatableEntries[Index];
+			if (!Entry.IsLive())
+			{
+				continue;
+			}
+
+			APage* Page = FindOwningPage(Entry.Allocation);
+			if (!Page->bIsEvacuating)
+			{
+				continue;
+			}
+
+			// The evacuated pages aren't available, so they are never picked as destinations.
+			// If no page has room left (the estimate above was too optimistic), the allocation stays and its page is simply not emptied.
+			APage* Destination = FindAvailablePage(Entry.Size + Entry.Alignment - 1);
+			if (Destination == nullptr)
+			{
+				continue;
+			}
+
+			void* NewAllocation = AllocateChunk(Destination, Entry.Alignment);
+			MemCpy(NewAllocation, Entry.Allocation, Entry.Size);
+			Destination->RelocatableChunksCount++;
+
+		#ifdef AE_ENABLE_MEMORY_CHECK
+			Utils::SetChunkRelocatable(Destination, Utils::GetChunkIndex(Destination, NewAllocation), true);
+		#endif
+
+			// The evacuated pages are at most half full, so they already have free chunks and 'FreeChunk' never links them back.
+			FreeChunk(Page, Entry.Allocation);
+			Page->RelocatableChunksCount--;
+
+			SubmitRelocation(Entry.Allocation, NewAllocation, Entry.Size, Entry.Alignment);
+			Entry.Allocation = NewAllocation;
+		}
+
+		uint64 EmptiedPagesCount = 0;
+		for (uint64 Index = 0; Index < EvacuatingPages.Size(); Index++)
+		{
+			APage* Page = EvacuatingPages[Index];
+			Page->bIsEvacuating = false;
+			LinkAvailablePage(Page);
+
+			if (Page->FreeChunksCount == Page->ChunksCount)
+			{
+				EmptiedPagesCount++;
+			}
+		}
+
+		return EmptiedPagesCount;
+	}
+
+	APoolArena::APage* APoolArena::FindAvailablePage(uint64 RequiredSize) const
+	{
+		uint64 SizeClass = Utils::GetSizeClass(RequiredSize);
+
+		// The request's own size class holds the tightest chunks, but not all of them are big enough.
+		// Only its first page is checked, so the search stays constant time. Skipping it would make a pool whose pages all fall
+		//	in the request's class grow on every allocation.
+		APage* Page = m_AvailablePages[SizeClass];
+		if (Page && Page->ChunkSize >= RequiredSize)
+		{
+			return Page;
+		}
+
+		// Any page from the next size classes can hold the allocation.
+		uint64 FirstFittingClass = IsPowerOfTwo(RequiredSize) ? SizeClass : SizeClass + 1;
+		if (FirstFittingClass >= SizeClassesCount)
+		{
+			return nullptr;
+		}
+
+		uint64 FittingClasses = m_AvailableSizeClasses & (~0ull << FirstFittingClass);
+		if (!FittingClasses)
+		{
+			return nullptr;
+		}
+
+		return m_AvailablePages[FindFirstSetBit(FittingClasses)];
+	}
+
+	void* APoolArena::AllocateChunk(APage* Page, uint64 Alignment)
+	{
+		uint8* Memory = (uint8*)Page->FreeChunks[--Page->FreeChunksCount];
+		m_FreeBytes -= Page->ChunkSize;
+
+	#ifdef AE_ENABLE_MEMORY_CHECK
+		Utils::SetChunkAllocated(Page, Utils::GetChunkIndex(Page, Memory), true);
+	#endif
+
+		if (Page->FreeChunksCount == 0)
+		{
+			UnlinkAvailablePage(Page);
+		}
+
+		uint64 AlignmentOffset = GetAlignmentOffset(Memory, Alignment);
+		return Memory + AlignmentOffset;
+	}
+
+	void APoolArena::FreeChunk(APage* Page, void* Allocation)
+	{
+		// The allocation might be offset inside its chunk, because of alignment.
+		uint64 ChunkIndex = Utils::GetChunkIndex(Page, Allocation);
+
+	#ifdef AE_ENABLE_MEMORY_CHECK
+		Utils::SetChunkAllocated(Page, ChunkIndex, false);
+		Utils::SetChunkRelocatable(Page, ChunkIndex, false);
+	#endif
+
+		Page->FreeChunks[Page->FreeChunksCount++] = (uint8*)Page->MemoryBlock + ChunkIndex * Page->ChunkSize;
+		m_FreeBytes += Page->ChunkSize;
+
+		if (Page->FreeChunksCount == 1)
+		{
+			LinkAvailablePage(Page);
+		}
+	}
+
+	APoolArena::APage* APoolArena::FindOwningPage(const void* Allocation) const
+	{
+		// Find the last page whose chunks start before the allocation.
+		uint64 Begin = 0;
+		uint64 End = m_SortedPages.Size();
+		while (Begin < End)
+		{
+			uint64 Middle = Begin + (End - Begin) / 2;
+			if ((const uint8*)Allocation < (const uint8*)m_SortedPages[Middle]->MemoryBlock)
+			{
+				End = Middle;
+			}
+			else
+			{
+				Begin = Middle + 1;
+			}
+		}
+
+		if (Begin == 0)
+		{
+			return nullptr;
+		}
+
+		APage* Page = m_SortedPages[Begin - 1];
+		return (const uint8*)Allocation < (const uint8*)Page->MemoryBlock + Page->ChunksCount * Page->ChunkSize ? Page : nullptr;
+	}
+
+	APoolArena::APage* APoolArena::Grow(uint64 RequiredSize)
+	{
+		// Arbitrary number
+		// TODO (Avr): Think about a better way of calculating these values 
+		uint64 NewPageChunksCount = 32;
+		uint64 NewPageChunkSize = RequiredSize;
+		if (!m_Pages.IsEmpty())
+		{
+			uint64 MedianChunksCount = m_ChunksCountSum / m_Pages.Size();
+			uint64 MedianChunkSize = m_ChunkSizeSum / m_Pages.Size();
+
+			NewPageChunksCount = MedianChunksCount;
+			if (NewPageChunkSize < MedianChunkSize)
+			{
+				NewPageChunkSize = MedianChunkSize;
+			}
 		}
+
+		AllocateNewPage(NewPageChunksCount, NewPageChunkSize);
+		return m_Pages.Back();
+	}
+
+	void APoolArena::RegisterPage(APage* Page)
+	{
+		m_Pages.PushBack(Page);
+
+		m_SortedPages.PushBack(Page);
+		for (uint64 Index = m_SortedPages.Size() - 1; Index > 0 && m_SortedPages[Index - 1]->MemoryBlock > Page->MemoryBlock; Index--)
+		{
+			m_SortedPages[Index] = m_SortedPages[Index - 1];
+			m_SortedPages[Index - 1] = Page;
+		}
+
+		m_TotalBytes += Page->ChunksCount * Page->ChunkSize;
+		m_FreeBytes += Page->FreeChunksCount * Page->ChunkSize;
+		m_ChunksCountSum += Page->ChunksCount;
+		m_ChunkSizeSum += Page->ChunkSize;
+
+		if (Page->FreeChunksCount > 0)
+		{
+			LinkAvailablePage(Page);
+		}
+	}
+
+	void APoolArena::LinkAvailablePage(APage* Page)
+	{
+		uint64 SizeClass = Utils::GetSizeClass(Page->ChunkSize);
+
+		APage* Head = m_AvailablePages[SizeClass];
+		Page->NextAvailablePage = Head;
+		Page->PreviousAvailablePage = nullptr;
+		if (Head)
+		{
+			Head->PreviousAvailablePage = Page;
+		}
+
+		m_AvailablePages[SizeClass] = Page;
+		m_AvailableSizeClasses |= (1ull << SizeClass);
+	}
+
+	void APoolArena::UnlinkAvailablePage(APage* Page)
+	{
+		uint64 SizeClass = Utils::GetSizeClass(Page->ChunkSize);
+
+		if (Page->NextAvailablePage)
+		{
+			Page->NextAvailablePage->PreviousAvailablePage = Page->PreviousAvailablePage;
+		}
+		if (Page->PreviousAvailablePage)
+		{
+			Page->PreviousAvailablePage->NextAvailablePage = Page->NextAvailablePage;
+		}
+		else if (m_AvailablePages[SizeClass] == Page)
+		{
+			m_AvailablePages[SizeClass] = Page->NextAvailablePage;
+			if (!m_AvailablePages[SizeClass])
+			{
+				m_AvailableSizeClasses &= ~(1ull << SizeClass);
+			}
+		}
+
+		Page->NextAvailablePage = nullptr;
+		Page->PreviousAvailablePage = nullptr;
 	}
 
-}
\ No newline at end of file
+}
@@ -4,6 +4,7 @@
 #pragma once
 
 #include "ApricotMemory.h"
+#include "GenerationalHandle.h"
 
 #include "Apricot/Core/AClass.h"
 
@@ -31,8 +32,16 @@ namespace Apricot {
 		bool bBulkAllocateSpecPages = true;
 
 		bool bUseArenaMemoryAlways = false;
+
+		AArenaMemoryOptions MemoryOptions;
 	};
 
+	/**
+	* Reference to a relocatable allocation of an APoolArena (see 'APoolArena::AllocRelocatable').
+	* It stays valid when 'APoolArena::Compact' moves the allocation, unlike the pointer returned by 'APoolArena::Resolve'.
+	*/
+	using APoolHandle = AGenerationalHandle;
+
 	/**
 	* C++ Core Engine Architecture
 	* 
@@ -76,7 +85,64 @@ namespace Apricot {
 			void** FreeChunks = nullptr;
 
 			uint64 FreeChunksCount = 0;
+
+			/**
+			* Links in the list of pages from the same size class that still have free chunks.
+			*/
+			APage* NextAvailablePage = nullptr;
+			APage* PreviousAvailablePage = nullptr;
+
+			/**
+			* One bit for every chunk, set while the chunk is allocated. Used to detect double frees.
+			* Only allocated when AE_ENABLE_MEMORY_CHECK is defined, otherwise it is nullptr.
+			*/
+			uint64* AllocatedChunks = nullptr;
+
+			/**
+			* One bit for every chunk, set while the chunk holds a relocatable allocation. Used to reject the relocatable allocations
+			*	that are freed with 'Free' instead of 'FreeRelocatable'. Only allocated when AE_ENABLE_MEMORY_CHECK is defined.
+			*/
+			uint64* RelocatableChunks = nullptr;
+
+			/**
+			* Number of the allocated chunks that hold relocatable allocations. A page whose allocated chunks are all relocatable can be emptied by 'Compact'.
+			*/
+			uint64 RelocatableChunksCount = 0;
+
+			/**
+			* Set while 'Compact' moves the page's chunks out. The page isn't linked in the available lists meanwhile.
+			*/
+			bool8 bIsEvacuating = false;
 		};
+
+		static constexpr uint32 InvalidRelocatableIndex = 0xFFFFFFFF;
+
+		/**
+		* Entry of the indirection table of the relocatable allocations.
+		*/
+		struct ARelocatableEntry : public AGenerationalSlot
+		{
+			void* Allocation = nullptr;
+			uint64 Size = 0;
+			uint64 Alignment = 0;
+
+			/**
+			* The next free entry, while the entry is free.
+			*/
+			uint32 NextFree = InvalidRelocatableIndex;
+		};
+
+		/**
+		* Pages are bucketed by the floor of log2 of their chunk size. Every page of a size class bigger than the one
+		*	of a request can hold that request.
+		*/
+		static constexpr uint64 SizeClassesCount = 64;
+
+		/**
+		* The chunks of every page start on a cache line, so when the chunk size is a multiple of an alignment up to this one,
+		*	all the chunks are aligned without padding.
+		*/
+		static constexpr uint64 ChunksAlignment = 64;
 	
 	/* API interface */
 	public:
@@ -126,8 +192,9 @@ namespace Apricot {
 		NODISCARD void* AllocUnsafe(uint64 Size, uint64 Alignment = sizeof(void*), EAllocStrategy Mode = EAllocStrategy::BestFit);
 
 		/**
-		* Frees the chunk where Allocation is placed.
-		* Generates errors based on EFailureMode enum value.
+		* Frees the chunk where Allocation is placed. The owning page is found with a binary search of the pages.
+		* Generates errors based on EFailureMode enum value. Double frees are detected only when AE_ENABLE_MEMORY_CHECK is defined.
+		* Relocatable allocations must be freed with 'FreeRelocatable'. When AE_ENABLE_MEMORY_CHECK is defined, they are rejected with InvalidMemoryPtr.
 		* 
 		* @param Allocation Pointer to the memory to be freed.
 		* 
@@ -144,7 +211,8 @@ namespace Apricot {
 		* @param Size Size of the allocation. Currently, used only for debugging.
 		* 
 		* @returns A flag specifying if any errors were encountered. A simple 'if' statement will check for any error flags.
-		*				All possible error return flags: AE_FREE_BAD_ARENA, AE_FREE_POINTER_OUT_OF_RANGE, AE_FREE_ALREADY_FREED.
+		*				All possible error return flags: InvalidMemoryPtr, PointerOutOfRange, AlreadyFreed (only when AE_ENABLE_MEMORY_CHECK is defined).
+		*				InvalidMemoryPtr is also returned for a relocatable allocation, when AE_ENABLE_MEMORY_CHECK is defined.
 		*/
 		int32 TryFree(void* Allocation, uint64 Size);
 
@@ -159,21 +227,21 @@ namespace Apricot {
 		void FreeUnsafe(void* Allocation, uint64 Size);
 
 		/**
-		* 
-		* 
-		* @returns 
+		* Frees all the chunks of all pages. No page is deleted.
+		* It will always succeed.
 		*/
 		void FreeAll();
 
 		/**
+		* Frees all the chunks of all pages. No page is deleted.
 		* 
-		* 
-		* @returns 
+		* @returns A flag specifying if any errors were encountered. A simple 'if' statement will check for any error flags.
 		*/
 		int32 TryFreeAll();
 
 		/**
-		* 
+		* Frees all the chunks of all pages. No page is deleted.
+		* It will always succeed.
 		*/
 		void FreeAllUnsafe();
 
@@ -182,8 +250,70 @@ namespace Apricot {
 		*/
 		virtual void GarbageCollect() override;
 
+		/**
+		* Frees the allocations that the other threads freed since the last allocation. Does nothing when called by a thread other than the owner.
+		* The allocations freed from the other threads must be at least 16 bytes, as the deferred free is stored in them.
+		*/
+		virtual void DrainRemoteFrees() override;
+
+		/**
+		* Reports the occupancy of every page, by whole chunks. The pools never leave tail waste, as any free chunk can be reused.
+		*/
+		virtual void TakeFragmentationReport(AArenaFragmentationReport& OutReport) const override;
+
 		void AllocateNewPage(uint64 ChunksCount, uint64 ChunkSize);
 
+	/* Relocatable allocations */
+	public:
+		/**
+		* Allocates like 'Alloc', but the allocation is referenced through a handle, so 'Compact' is allowed to move it.
+		* Generates errors based on the EFailureMode enum value.
+		*
+		* @returns The allocation's handle, or a null handle on error.
+		*/
+		NODISCARD APoolHandle AllocRelocatable(uint64 Size, uint64 Alignment = sizeof(void*));
+
+		/**
+		* Frees the handle's allocation. Stale and null handles are ignored.
+		*
+		* @returns True if an allocation was freed.
+		*/
+		bool8 FreeRelocatable(APoolHandle Handle);
+
+		/**
+		* Checks the handle's generation against the entry's. Doesn't touch the allocation.
+		*/
+		FORCEINLINE bool8 IsValid(APoolHandle Handle) const
+		{
+			return Handle.Index < m_RelocatableEntries.Size() && m_RelocatableEntries[Handle.Index].Matches(Handle);
+		}
+
+		/**
+		* Returns the current address of the handle's allocation, or nullptr if the handle is stale or null.
+		* The pointer is only valid until the next call to 'Compact', so it must not be stored.
+		*/
+		FORCEINLINE void* Resolve(APoolHandle Handle) const
+		{
+			return IsValid(Handle) ? m_RelocatableEntries[Handle.Index].Allocation : nullptr;
+		}
+
+		/**
+		* Moves the relocatable allocations out of the sparse pages and into the denser ones, so that the sparse pages end up empty.
+		* Only the grown pages (not the specification ones) whose allocated chunks are all relocatable and that are at most half
+		*	full are emptied, starting with the sparsest, and only if the other pages have enough free chunks to hold their allocations.
+		* The emptied pages are kept, so 'GarbageCollect' must be called afterwards to release their memory.
+		*
+		* Every pointer returned by 'Resolve' becomes invalid. The statistics aren't changed, as no allocation is made or freed.
+		*
+		* @returns The number of pages that were emptied.
+		*/
+		uint64 Compact();
+
+		/**
+		* Returns the number of live relocatable allocations.
+		*/
+		FORCEINLINE uint64 GetRelocatableCount() const { return m_RelocatableCount; }
+
 	/* Getters & Setters */
 	public:
 		/**
@@ -205,14 +335,99 @@ namespace Apricot {
 		/**
 		* Returns the total size of all chunks (free or not).
 		*/
-		uint64 GetTotalSize() const;
+		virtual uint64 GetTotalSize() const override;
 
 		FORCEINLINE const APoolArenaSpecification& GetSpecification() const { return m_Specification; }
 
+	private:
+		/**
+		* Finds a page with a free chunk of at least 'RequiredSize' bytes, in constant time.
+		* The pages are indexed by size class, so the tightest available class is as cheap to find as any fitting one. Because of
+		*	this, both EAllocStrategy modes use the same search.
+		* 
+		* @returns The found page or nullptr if no available page can hold the allocation.
+		*/
+		APage* FindAvailablePage(uint64 RequiredSize) const;
+
+		/**
+		* Pops a free chunk from 'Page' and aligns it. The page must have at least one free chunk.
+		*/
+		void* AllocateChunk(APage* Page, uint64 Alignment);
+
+		/**
+		* Pushes the chunk that contains 'Allocation' back to the page's free chunks.
+		*/
+		void FreeChunk(APage* Page, void* Allocation);
+
+		/**
+		* Returns the page whose chunks contain 'Allocation', with a binary search of the pages. nullptr if the arena doesn't own the pointer.
+		*/
+		APage* FindOwningPage(const void* Allocation) const;
+
+		/**
+		* Creates a new page that can hold 'RequiredSize' bytes. Its size is based on the existing pages.
+		*/
+		APage* Grow(uint64 RequiredSize);
+
+		/**
+		* Pushes the page to the arena's vectors, updates the cached sizes and links it in its size class list.
+		*/
+		void RegisterPage(APage* Page);
+
+		void LinkAvailablePage(APage* Page);
+
+		void UnlinkAvailablePage(APage* Page);
+
 	private:
 		APoolArenaSpecification m_Specification;
 
+		/**
+		* Size of the memory block that holds the specification's pages, if they are bulk allocated. The specification's page
+		*	arrays are only valid during the creation, so the block can't be measured again when the arena is destroyed.
+		*/
+		uint64 m_BulkMemoryBytes = 0;
+
 		TVector<APage*> m_Pages;
+
+		/**
+		* Heads of the lists of pages with free chunks, one for each size class.
+		*/
+		APage* m_AvailablePages[SizeClassesCount] = {};
+
+		/**
+		* Bit 'Class' is set if 'm_AvailablePages[Class]' is not empty.
+		*/
+		uint64 m_AvailableSizeClasses = 0;
+
+		/**
+		* Cached sizes, so that the getters don't have to walk the pages.
+		*/
+		uint64 m_TotalBytes = 0;
+		uint64 m_FreeBytes = 0;
+
+		/**
+		* Sums of the pages' chunk counts and chunk sizes. Used to size the new pages.
+		*/
+		uint64 m_ChunksCountSum = 0;
+		uint64 m_ChunkSizeSum = 0;
+
+		/**
+		* The same pages as 'm_Pages', sorted by their chunks' addresses, so that the owning page of an allocation can be found
+		*	with a binary search. 'm_Pages' keeps the creation order, which tells the specification's pages apart.
+		*/
+		TVector<APage*> m_SortedPages;
+
+		/**
+		* Indirection table of the relocatable allocations, indexed by the handles.
+		*/
+		TVector<ARelocatableEntry> m_RelocatableEntries;
+
+		/**
+		* Head of the list of free entries, linked through 'NextFree'.
+		*/
+		uint32 m_FirstFreeRelocatableEntry = InvalidRelocatableIndex;
+
+		uint64 m_RelocatableCount = 0;
 	
 	/* Friends */
 	private:
@@ -0,0 +1,58 @@
+// Part of Apricot Engine. 2022-2022.
+// Module: Memory
+
+#include "aepch.h"
+#include "ScratchArena.h"
+
+namespace Apricot {
+
+	namespace Utils {
+
+		/**
+		* Destroys the thread's arena when the thread exits. The threads that exit after ApricotMemoryDestroy must have destroyed
+		*	their arena already, because the arena's memory can't be released without the heap.
+		*/
+		struct AScratchArenaHolder
+		{
+			TSharedPtr<ALinearArena> Arena;
+
+			~AScratchArenaHolder()
+			{
+				AE_CORE_ASSERT(!Arena || GMalloc, TEXT("A thread exited with its scratch arena alive after the memory system was destroyed!"));
+				Arena = NULL_SHARED;
+			}
+		};
+
+		static thread_local AScratchArenaHolder GScratchArenaHolder;
+
+		static TSharedPtr<ALinearArena> CreateScratchArena()
+		{
+			uint64 InitialSize = AEC_SCRATCH_ARENA_INITIAL_SIZE;
+
+			ALinearArenaSpecification Specification;
+			Specification.PagesCount = 1;
+			Specification.PageSizes = &InitialSize;
+			Specification.bUseVirtualMemory = true;
+			Specification.VirtualReserveSize = AEC_SCRATCH_ARENA_RESERVE_SIZE;
+
+			return ALinearArena::Create(Specification);
+		}
+
+	}
+
+	APRICOT_API ALinearArena* GetScratchArena()
+	{
+		Utils::AScratchArenaHolder& Holder = Utils::GScratchArenaHolder;
+		if (!Holder.Arena)
+		{
+			Holder.Arena = Utils::CreateScratchArena();
+		}
+		return Holder.Arena.Get();
+	}
+
+	APRICOT_API void DestroyScratchArena()
+	{
+		Utils::GScratchArenaHolder.Arena = NULL_SHARED;
+	}
+
+}
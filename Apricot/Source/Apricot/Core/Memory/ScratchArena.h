@@ -0,0 +1,28 @@
+// Part of Apricot Engine. 2022-2022.
+// Module: Memory
+
+#pragma once
+
+#include "LinearArena.h"
+
+namespace Apricot {
+
+	/**
+	* Returns the calling thread's scratch arena, creating it on the thread's first call.
+	* It is a virtual memory linear arena, meant for short-lived allocations (formatting, path building, temporary vectors) that
+	*	would otherwise go through GMalloc. The allocations are freed by rewinding the arena, usually with an AArenaMark:
+	*
+	*	AArenaMark Mark(GetScratchArena());
+	*	TChar* Path = (TChar*)GetScratchArena()->Alloc(PathSize * sizeof(TChar));
+	*
+	* The arena is never shared between threads, so the allocations can't be handed to other threads.
+	*/
+	APRICOT_API NODISCARD ALinearArena* GetScratchArena();
+
+	/**
+	* Destroys the calling thread's scratch arena. It is called automatically when a thread exits and by ApricotMemoryDestroy,
+	*	for the thread that tears down the memory system. A later call to 'GetScratchArena' creates a new arena.
+	*/
+	APRICOT_API void DestroyScratchArena();
+
+}
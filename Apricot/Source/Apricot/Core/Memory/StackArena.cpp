@@ -4,6 +4,8 @@
 #include "aepch.h"
 #include "StackArena.h"
 
+#include "Apricot/Core/Platform.h"
+
 namespace Apricot {
 
 	namespace Utils {
@@ -25,6 +27,19 @@ namespace Apricot {
 			return NewPage;
 		}
 
+		FORCEINLINE static uint64 AlignToPageSize(uint64 Size)
+		{
+			return Size + GetAlignmentOffset(Size, APlatform::GetPageSize());
+		}
+
+		/**
+		* Extends a committed range so that it ends on a huge page boundary. Transparent huge pages can only back the ranges that are fully committed.
+		*/
+		FORCEINLINE static uint64 AlignToHugePageBoundary(uint8* RangeBegin, uint64 Size, const AArenaMemoryOptions& Options)
+		{
+			return Options.bUseHugePages ? Size + GetAlignmentOffset(RangeBegin + Size, APlatform::GetHugePageSize()) : Size;
+		}
+
 	}
 
 	NODISCARD TSharedPtr<AStackArena> AStackArena::Create(const AStackArenaSpecification& Specification)
@@ -46,6 +61,11 @@ namespace Apricot {
 	{
 		uint64 MemoryRequirement = 0;
 
+		if (Specification.bUseVirtualMemory)
+		{
+			return MemoryRequirement;
+		}
+
 		for (uint64 Index = 0; Index < Specification.PagesCount; Index++)
 		{
 			MemoryRequirement += GetAlignmentOffset(MemoryRequirement, sizeof(void*));
@@ -62,11 +82,51 @@ namespace Apricot {
 
 		uint8* ArenaMemory = (uint8*)m_Specification.ArenaMemory;
 
-		if (m_Specification.bBulkAllocateSpecPages || ArenaMemory)
+		if (m_Specification.bUseVirtualMemory)
+		{
+			m_ReservedBytes = Utils::AlignToPageSize(sizeof(APage) + m_Specification.VirtualReserveSize);
+			ArenaMemory = (uint8*)APlatform::Reserve(m_ReservedBytes);
+			if (ArenaMemory == nullptr)
+			{
+				// The arena is left without pages, so its allocations fail with InvalidArena.
+				GCrashReporter->MemoryState.Arena = this;
+				GCrashReporter->MemoryState.Size = m_ReservedBytes;
+				GCrashReporter->SubmitArenaFailure(ACrashReporter::EMemoryOperation::Allocate, EMemoryError::OutOfMemory);
+				m_ReservedBytes = 0;
+				return;
+			}
+
+			if (m_Specification.MemoryOptions.bUseHugePages)
+			{
+				APlatform::AdviseHugePages(ArenaMemory, m_ReservedBytes);
+			}
+
+			uint64 CommittedBytes = Utils::AlignToPageSize(sizeof(APage) + (m_Specification.PagesCount > 0 ? m_Specification.PageSizes[0] : 0));
+			CommittedBytes = Utils::AlignToHugePageBoundary(ArenaMemory, CommittedBytes, m_Specification.MemoryOptions);
+			if (CommittedBytes > m_ReservedBytes)
+			{
+				CommittedBytes = m_ReservedBytes;
+			}
+			if (!APlatform::Commit(ArenaMemory, CommittedBytes))
+			{
+				GCrashReporter->MemoryState.Arena = this;
+				GCrashReporter->MemoryState.Size = CommittedBytes;
+				GCrashReporter->SubmitArenaFailure(ACrashReporter::EMemoryOperation::Allocate, EMemoryError::OutOfMemory);
+				APlatform::Release(ArenaMemory, m_ReservedBytes);
+				m_ReservedBytes = 0;
+				return;
+			}
+			PrepareArenaMemory(ArenaMemory, CommittedBytes, m_Specification.MemoryOptions);
+
+			uint64 MemoryOffset = 0;
+			m_Pages.PushBack(Utils::ConstructNewPage(ArenaMemory, MemoryOffset, CommittedBytes - sizeof(APage)));
+		}
+		else if (m_Specification.bBulkAllocateSpecPages || ArenaMemory)
 		{
 			if (!ArenaMemory)
 			{
-				ArenaMemory = (uint8*)GMalloc->Alloc(GetMemoryRequirement(m_Specification));
+				m_BulkMemoryBytes = GetMemoryRequirement(m_Specification);
+				ArenaMemory = (uint8*)AllocateArenaMemory(m_BulkMemoryBytes, m_Specification.MemoryOptions);
 			}
 			uint64 MemoryOffset = 0;
 
@@ -82,55 +142,66 @@ namespace Apricot {
 				uint64 MemoryOffset = 0;
 				uint64 PageSizeBytes = m_Specification.PageSizes[Index];
 
-				ArenaMemory = (uint8*)GMalloc->Alloc(GetPageMemoryRequirement(PageSizeBytes));
+				ArenaMemory = (uint8*)AllocateArenaMemory(GetPageMemoryRequirement(PageSizeBytes), m_Specification.MemoryOptions);
 				m_Pages.PushBack(Utils::ConstructNewPage(ArenaMemory, MemoryOffset, PageSizeBytes));
 			}
 		}
+
+		for (uint64 Index = 0; Index < m_Pages.Size(); Index++)
+		{
+			m_TotalBytes += m_Pages[Index]->SizeBytes;
+		}
 	}
 
 	AStackArena::~AStackArena()
 	{
-		if (!m_Specification.bUseArenaMemoryAlways)
+		if (m_Specification.bUseVirtualMemory)
+		{
+			// The pages are empty if the range couldn't be reserved or committed.
+			if (!m_Pages.IsEmpty())
+			{
+				APlatform::Release(m_Pages[0], m_ReservedBytes);
+			}
+			return;
+		}
+
+		bool8 bSpecPagesAreBulk = m_Specification.bBulkAllocateSpecPages || m_Specification.ArenaMemory;
+
+		for (uint64 Index = 0; Index < m_Pages.Size(); Index++)
 		{
-			for (uint64 Index = m_Specification.PagesCount; Index < m_Pages.Size(); Index++)
+			bool8 bIsSpecPage = Index < m_Specification.PagesCount;
+			if ((bIsSpecPage && !bSpecPagesAreBulk) || (!bIsSpecPage && !m_Specification.bUseArenaMemoryAlways))
 			{
-				GMalloc->Free(m_Pages[Index], GetPageMemoryRequirement(m_Pages[Index]->SizeBytes));
+				FreeArenaMemory(m_Pages[Index], GetPageMemoryRequirement(m_Pages[Index]->SizeBytes), m_Specification.MemoryOptions);
 			}
 		}
-		if (!m_Specification.ArenaMemory && !m_Pages.IsEmpty())
+		if (bSpecPagesAreBulk && !m_Specification.ArenaMemory && m_Specification.PagesCount > 0)
 		{
-			GMalloc->Free(m_Pages[0], GetMemoryRequirement(m_Specification));
+			FreeArenaMemory(m_Pages[0], m_BulkMemoryBytes, m_Specification.MemoryOptions);
 		}
 	}
 
 	uint64 AStackArena::GetTotalSize() const
 	{
-		uint64 TotalSizeBytes = 0;
-		for (uint64 Index = 0; Index < m_Pages.Size(); Index++)
-		{
-			TotalSizeBytes += m_Pages[Index]->SizeBytes;
-		}
-		return TotalSizeBytes;
+		return m_TotalBytes;
 	}
 
 	uint64 AStackArena::GetAllocatedSize() const
 	{
-		uint64 AllocatedBytes = 0;
-		for (uint64 Index = 0; Index < m_Pages.Size(); Index++)
+		if (m_Pages.IsEmpty())
 		{
-			AllocatedBytes += m_Pages[Index]->AllocatedBytes;
+			return 0;
 		}
-		return AllocatedBytes;
+		return m_PassedPagesAllocatedBytes + m_Pages[m_CurrentPage]->AllocatedBytes;
 	}
 
 	uint64 AStackArena::GetFreeSize() const
 	{
-		uint64 FreeSizeBytes = 0;
-		for (uint64 Index = m_CurrentPage; Index < m_Pages.Size(); Index++)
+		if (m_Pages.IsEmpty())
 		{
-			FreeSizeBytes += (m_Pages[Index]->SizeBytes - m_Pages[Index]->AllocatedBytes);
+			return 0;
 		}
-		return FreeSizeBytes;
+		return m_TotalBytes - m_PassedPagesBytes - m_Pages[m_CurrentPage]->AllocatedBytes;
 	}
 
 	const TChar* AStackArena::GetDebugName() const
@@ -166,22 +237,32 @@ namespace Apricot {
 			uint64 CurrentPage = m_CurrentPage;
 			for (uint64 Index = CurrentPage; Index < m_Pages.Size(); Index++)
 			{
-				m_CurrentPage = Index;
+				SetCurrentPage(Index);
 				APage* Page = m_Pages[Index];
 
 				uint64 AlignmentOffset = GetAlignmentOffset((uint8*)Page->MemoryBlock + Page->AllocatedBytes, Alignment);
-				if (Page->AllocatedBytes + AlignmentOffset + Size + sizeof(AAlignmentInfo) <= Page->SizeBytes)
+				if (Page->AllocatedBytes + AlignmentOffset + Size + sizeof(AAlignmentInfo) <= Page->SizeBytes || CommitPageMemory(Page, Page->AllocatedBytes + AlignmentOffset + Size + sizeof(AAlignmentInfo)))
 				{
 					void* Memory = (uint8*)Page->MemoryBlock + Page->AllocatedBytes + AlignmentOffset;
 					AAlignmentInfo* AlignmentInfo = (AAlignmentInfo*)((uint8*)Memory + Size);
 					AlignmentInfo->AlignmentOffset = (uint16)AlignmentOffset;
 					Page->AllocatedBytes += (AlignmentOffset + Size + sizeof(AAlignmentInfo));
+					SubmitAllocationStats(Memory, Size, Alignment);
 					return Memory;
 				}
 			}
 
+			if (m_Specification.bUseVirtualMemory)
+			{
+				GCrashReporter->MemoryState.Arena = this;
+				GCrashReporter->MemoryState.Size = Size;
+				GCrashReporter->MemoryState.FreeSize = GetFreeSize();
+				GCrashReporter->SubmitArenaFailure(ACrashReporter::EMemoryOperation::Allocate, EMemoryError::OutOfMemoryUnableToGrow);
+				return nullptr;
+			}
+
 			APage* NewPage = AllocateNewPage(GetOptimalPageSize(Size));
-			m_CurrentPage = m_Pages.Size() - 1;
+			SetCurrentPage(m_Pages.Size() - 1);
 
 			uint64 AlignmentOffset = GetAlignmentOffset((uint8*)NewPage->MemoryBlock, Alignment);
 
@@ -189,6 +270,7 @@ namespace Apricot {
 			AAlignmentInfo* AlignmentInfo = (AAlignmentInfo*)((uint8*)Memory + Size);
 			AlignmentInfo->AlignmentOffset = (uint16)AlignmentOffset;
 			NewPage->AllocatedBytes += (AlignmentOffset + Size + sizeof(AAlignmentInfo));
+			SubmitAllocationStats(Memory, Size, Alignment);
 			return Memory;
 		}
 		else
@@ -196,22 +278,33 @@ namespace Apricot {
 			uint64 CurrentPage = m_CurrentPage;
 			for (uint64 Index = CurrentPage; Index < m_Pages.Size(); Index++)
 			{
-				m_CurrentPage = Index;
+				SetCurrentPage(Index);
 				APage* Page = m_Pages[Index];
 
-				if (Page->AllocatedBytes + Size <= Page->SizeBytes)
+				if (Page->AllocatedBytes + Size <= Page->SizeBytes || CommitPageMemory(Page, Page->AllocatedBytes + Size))
 				{
 					void* Memory = (uint8*)Page->MemoryBlock + Page->AllocatedBytes;
 					Page->AllocatedBytes += Size;
+					SubmitAllocationStats(Memory, Size, Alignment);
 					return Memory;
 				}
 			}
 
+			if (m_Specification.bUseVirtualMemory)
+			{
+				GCrashReporter->MemoryState.Arena = this;
+				GCrashReporter->MemoryState.Size = Size;
+				GCrashReporter->MemoryState.FreeSize = GetFreeSize();
+				GCrashReporter->SubmitArenaFailure(ACrashReporter::EMemoryOperation::Allocate, EMemoryError::OutOfMemoryUnableToGrow);
+				return nullptr;
+			}
+
 			APage* NewPage = AllocateNewPage(GetOptimalPageSize(Size));
-			m_CurrentPage = m_Pages.Size() - 1;
+			SetCurrentPage(m_Pages.Size() - 1);
 
 			void* Memory = (uint8*)NewPage->MemoryBlock;
 			NewPage->AllocatedBytes += Size;
+			SubmitAllocationStats(Memory, Size, Alignment);
 			return Memory;
 		}
 	}
@@ -243,23 +336,30 @@ namespace Apricot {
 			uint64 CurrentPage = m_CurrentPage;
 			for (uint64 Index = CurrentPage; Index < m_Pages.Size(); Index++)
 			{
-				m_CurrentPage = Index;
+				SetCurrentPage(Index);
 				APage* Page = m_Pages[Index];
 
 				uint64 AlignmentOffset = GetAlignmentOffset((uint8*)Page->MemoryBlock + Page->AllocatedBytes, Alignment);
-				if (Page->AllocatedBytes + AlignmentOffset + Size + sizeof(AAlignmentInfo) <= Page->SizeBytes)
+				if (Page->AllocatedBytes + AlignmentOffset + Size + sizeof(AAlignmentInfo) <= Page->SizeBytes || CommitPageMemory(Page, Page->AllocatedBytes + AlignmentOffset + Size + sizeof(AAlignmentInfo)))
 				{
 					void* Memory = (uint8*)Page->MemoryBlock + Page->AllocatedBytes + AlignmentOffset;
 					AAlignmentInfo* AlignmentInfo = (AAlignmentInfo*)((uint8*)Memory + Size);
 					AlignmentInfo->AlignmentOffset = (uint16)AlignmentOffset;
 					Page->AllocatedBytes += (AlignmentOffset + Size + sizeof(AAlignmentInfo));
+					SubmitAllocationStats(Memory, Size, Alignment);
 					*OutPointer = Memory;
 					return (int32)EMemoryError::Success;
 				}
 			}
 
+			if (m_Specification.bUseVirtualMemory)
+			{
+				*OutPointer = nullptr;
+				return (int32)EMemoryError::OutOfMemoryUnableToGrow;
+			}
+
 			APage* NewPage = AllocateNewPage(GetOptimalPageSize(Size));
-			m_CurrentPage = m_Pages.Size() - 1;
+			SetCurrentPage(m_Pages.Size() - 1);
 
 			uint64 AlignmentOffset = GetAlignmentOffset((uint8*)NewPage->MemoryBlock, Alignment);
 
@@ -267,6 +367,7 @@ namespace Apricot {
 			AAlignmentInfo* AlignmentInfo = (AAlignmentInfo*)((uint8*)Memory + Size);
 			AlignmentInfo->AlignmentOffset = (uint16)AlignmentOffset;
 			NewPage->AllocatedBytes += (AlignmentOffset + Size + sizeof(AAlignmentInfo));
+			SubmitAllocationStats(Memory, Size, Alignment);
 			*OutPointer = Memory;
 			return (int32)EMemoryError::Success;
 		}
@@ -275,23 +376,31 @@ namespace Apricot {
 			uint64 CurrentPage = m_CurrentPage;
 			for (uint64 Index = CurrentPage; Index < m_Pages.Size(); Index++)
 			{
-				m_CurrentPage = Index;
+				SetCurrentPage(Index);
 				APage* Page = m_Pages[Index];
 
-				if (Page->AllocatedBytes + Size <= Page->SizeBytes)
+				if (Page->AllocatedBytes + Size <= Page->SizeBytes || CommitPageMemory(Page, Page->AllocatedBytes + Size))
 				{
 					void* Memory = (uint8*)Page->MemoryBlock + Page->AllocatedBytes;
 					Page->AllocatedBytes += Size;
+					SubmitAllocationStats(Memory, Size, Alignment);
 					*OutPointer = Memory;
 					return (int32)EMemoryError::Success;
 				}
 			}
 
+			if (m_Specification.bUseVirtualMemory)
+			{
+				*OutPointer = nullptr;
+				return (int32)EMemoryError::OutOfMemoryUnableToGrow;
+			}
+
 			APage* NewPage = AllocateNewPage(GetOptimalPageSize(Size));
-			m_CurrentPage = m_Pages.Size() - 1;
+			SetCurrentPage(m_Pages.Size() - 1);
 
 			void* Memory = (uint8*)NewPage->MemoryBlock;
 			NewPage->AllocatedBytes += Size;
+			SubmitAllocationStats(Memory, Size, Alignment);
 			*OutPointer = Memory;
 			return (int32)EMemoryError::Success;
 		}
@@ -304,22 +413,28 @@ namespace Apricot {
 			uint64 CurrentPage = m_CurrentPage;
 			for (uint64 Index = CurrentPage; Index < m_Pages.Size(); Index++)
 			{
-				m_CurrentPage = Index;
+				SetCurrentPage(Index);
 				APage* Page = m_Pages[Index];
 
 				uint64 AlignmentOffset = GetAlignmentOffset((uint8*)Page->MemoryBlock + Page->AllocatedBytes, Alignment);
-				if (Page->AllocatedBytes + AlignmentOffset + Size + sizeof(AAlignmentInfo) <= Page->SizeBytes)
+				if (Page->AllocatedBytes + AlignmentOffset + Size + sizeof(AAlignmentInfo) <= Page->SizeBytes || CommitPageMemory(Page, Page->AllocatedBytes + AlignmentOffset + Size + sizeof(AAlignmentInfo)))
 				{
 					void* Memory = (uint8*)Page->MemoryBlock + Page->AllocatedBytes + AlignmentOffset;
 					AAlignmentInfo* AlignmentInfo = (AAlignmentInfo*)((uint8*)Memory + Size);
 					AlignmentInfo->AlignmentOffset = (uint16)AlignmentOffset;
 					Page->AllocatedBytes += (AlignmentOffset + Size + sizeof(AAlignmentInfo));
+					SubmitAllocationStats(Memory, Size, Alignment);
 					return Memory;
 				}
 			}
 
+			if (m_Specification.bUseVirtualMemory)
+			{
+				return nullptr;
+			}
+
 			APage* NewPage = AllocateNewPage(GetOptimalPageSize(Size));
-			m_CurrentPage = m_Pages.Size() - 1;
+			SetCurrentPage(m_Pages.Size() - 1);
 
 			uint64 AlignmentOffset = GetAlignmentOffset((uint8*)NewPage->MemoryBlock, Alignment);
 
@@ -327,6 +442,7 @@ namespace Apricot {
 			AAlignmentInfo* AlignmentInfo = (AAlignmentInfo*)((uint8*)Memory + Size);
 			AlignmentInfo->AlignmentOffset = (uint16)AlignmentOffset;
 			NewPage->AllocatedBytes += (AlignmentOffset + Size + sizeof(AAlignmentInfo));
+			SubmitAllocationStats(Memory, Size, Alignment);
 			return Memory;
 		}
 		else
@@ -334,22 +450,29 @@ namespace Apricot {
 			uint64 CurrentPage = m_CurrentPage;
 			for (uint64 Index = CurrentPage; Index < m_Pages.Size(); Index++)
 			{
-				m_CurrentPage = Index;
+				SetCurrentPage(Index);
 				APage* Page = m_Pages[Index];
 
-				if (Page->AllocatedBytes + Size <= Page->SizeBytes)
+				if (Page->AllocatedBytes + Size <= Page->SizeBytes || CommitPageMemory(Page, Page->AllocatedBytes + Size))
 				{
 					void* Memory = (uint8*)Page->MemoryBlock + Page->AllocatedBytes;
 					Page->AllocatedBytes += Size;
+					SubmitAllocationStats(Memory, Size, Alignment);
 					return Memory;
 				}
 			}
 
+			if (m_Specification.bUseVirtualMemory)
+			{
+				return nullptr;
+			}
+
 			APage* NewPage = AllocateNewPage(GetOptimalPageSize(Size));
-			m_CurrentPage = m_Pages.Size() - 1;
+			SetCurrentPage(m_Pages.Size() - 1);
 
 			void* Memory = (uint8*)NewPage->MemoryBlock;
 			NewPage->AllocatedBytes += Size;
+			SubmitAllocationStats(Memory, Size, Alignment);
 			return Memory;
 		}
 	}
@@ -360,7 +483,7 @@ namespace Apricot {
 		if (m_Specification.bAllowAlignment)
 		{
 			AAlignmentInfo* AlignmentInfo = (AAlignmentInfo*)((uint8*)Allocation + Size);
-			PopSize += AlignmentInfo->AlignmentOffset;
+			PopSize += AlignmentInfo->AlignmentOffset + sizeof(AAlignmentInfo);
 		}
 
 		bool8 bFoundHomePage = false;
@@ -384,6 +507,7 @@ namespace Apricot {
 		}
 
 		Pop(PopSize);
+		SubmitDeallocationStats(Allocation, Size);
 	}
 
 	int32 AStackArena::TryFree(void* Allocation, uint64 Size)
@@ -405,7 +529,8 @@ namespace Apricot {
 		APage* Page = m_Pages[m_CurrentPage];
 		if (Page->AllocatedBytes == 0)
 		{
-			Page = m_Pages[--m_CurrentPage];
+			SetCurrentPage(m_CurrentPage - 1);
+			Page = m_Pages[m_CurrentPage];
 		}
 
 		if (m_Specification.bAllowAlignment)
@@ -416,6 +541,7 @@ namespace Apricot {
 			}
 
 			AAlignmentInfo* AlignmentInfo = (AAlignmentInfo*)((uint8*)Allocation + Size);
+			SubmitDeallocationStats(Allocation, Size);
 			return TryPop(AlignmentInfo->AlignmentOffset + Size + sizeof(AAlignmentInfo));
 		}
 		else
@@ -425,6 +551,7 @@ namespace Apricot {
 				return (int32)EMemoryError::PointerOutOfRange;
 			}
 
+			SubmitDeallocationStats(Allocation, Size);
 			return TryPop(Size);
 		}
 		return (int32)EMemoryError::Success;
@@ -432,10 +559,13 @@ namespace Apricot {
 
 	void AStackArena::FreeUnsafe(void* Allocation, uint64 Size)
 	{
+		SubmitDeallocationStats(Allocation, Size);
+
 		APage* Page = m_Pages[m_CurrentPage];
 		if (Page->AllocatedBytes == 0)
 		{
-			Page = m_Pages[--m_CurrentPage];
+			SetCurrentPage(m_CurrentPage - 1);
+			Page = m_Pages[m_CurrentPage];
 		}
 
 		if (m_Specification.bAllowAlignment)
@@ -451,41 +581,75 @@ namespace Apricot {
 
 	void AStackArena::FreeAll()
 	{
-		for (uint64 Index = 0; Index < m_CurrentPage + 1; Index++)
+		SetCurrentPage(0);
+		for (uint64 Index = 0; Index < m_Pages.Size(); Index++)
 		{
 			m_Pages[Index]->AllocatedBytes = 0;
 		}
+		SubmitDeallocationOfAllStats();
 	}
 
 	int32 AStackArena::TryFreeAll()
 	{
-		for (uint64 Index = 0; Index < m_CurrentPage + 1; Index++)
+		SetCurrentPage(0);
+		for (uint64 Index = 0; Index < m_Pages.Size(); Index++)
 		{
 			m_Pages[Index]->AllocatedBytes = 0;
 		}
+		SubmitDeallocationOfAllStats();
 		return (int32)EMemoryError::Success;
 	}
 
 	void AStackArena::FreeAllUnsafe()
 	{
-		for (uint64 Index = 0; Index < m_CurrentPage + 1; Index++)
+		SetCurrentPage(0);
+		for (uint64 Index = 0; Index < m_Pages.Size(); Index++)
 		{
 			m_Pages[Index]->AllocatedBytes = 0;
 		}
+		SubmitDeallocationOfAllStats();
 	}
 
 	void AStackArena::GarbageCollect()
 	{
-		for (int64 Index = m_Pages.Size() - 1; Index >= (int64)m_CurrentPage; Index--)
+		if (m_Pages.IsEmpty())
+		{
+			return;
+		}
+
+		if (m_Specification.bUseVirtualMemory)
+		{
+			APage* Page = m_Pages[0];
+
+			uint64 UsedBytes = Utils::AlignToPageSize(sizeof(APage) + Page->AllocatedBytes);
+			UsedBytes = Utils::AlignToHugePageBoundary((uint8*)Page, UsedBytes, m_Specification.MemoryOptions);
+			uint64 CommittedBytes = sizeof(APage) + Page->SizeBytes;
+			if (CommittedBytes > UsedBytes)
+			{
+				if (m_Specification.MemoryOptions.bLockMemory)
+				{
+					APlatform::Unlock((uint8*)Page + UsedBytes, CommittedBytes - UsedBytes);
+				}
+				APlatform::Decommit((uint8*)Page + UsedBytes, CommittedBytes - UsedBytes);
+				Page->SizeBytes = UsedBytes - sizeof(APage);
+				m_TotalBytes -= CommittedBytes - UsedBytes;
+			}
+			return;
+		}
+
+		// The specification pages aren't allocated individually, so they can't be deleted.
+		int64 FirstGrownPage = (int64)m_Specification.PagesCount > (int64)m_CurrentPage + 1 ? (int64)m_Specification.PagesCount : (int64)m_CurrentPage + 1;
+		for (int64 Index = m_Pages.Size() - 1; Index >= FirstGrownPage; Index--)
 		{
 			if (m_Pages[Index]->AllocatedBytes > 0)
 			{
 				break;
 			}
 
+			m_TotalBytes -= m_Pages[Index]->SizeBytes;
+			FreeArenaMemory(m_Pages[Index], GetPageMemoryRequirement(m_Pages[Index]->SizeBytes), m_Specification.MemoryOptions);
 			m_Pages.PopBack();
 		}
-		m_CurrentPage = m_Pages.Size() - 1;
 	}
 
 	void AStackArena::Pop(uint64 Size)
@@ -495,7 +659,7 @@ namespace Apricot {
 		for (int64 Index = m_CurrentPage; Index >= 0; Index--)
 		{
 			APage* Page = m_Pages[Index];
-			m_CurrentPage = Index;
+			SetCurrentPage(Index);
 
 			if (PopSize > Page->AllocatedBytes)
 			{
@@ -517,7 +681,7 @@ namespace Apricot {
 
 		for (int64 Index = m_CurrentPage; Index >= 0; Index--)
 		{
-			m_CurrentPage = Index;
+			SetCurrentPage(Index);
 			APage* Page = m_Pages[Index];
 
 			if (PopSize > Page->AllocatedBytes)
@@ -541,7 +705,7 @@ namespace Apricot {
 
 		for (int64 Index = m_CurrentPage; Index >= 0; Index--)
 		{
-			m_CurrentPage = Index;
+			SetCurrentPage(Index);
 			APage* Page = m_Pages[Index];
 
 			if (PopSize > Page->AllocatedBytes)
@@ -558,14 +722,65 @@ namespace Apricot {
 		}
 	}
 
+	AArenaPosition AStackArena::GetPosition() const
+	{
+		AArenaPosition Position;
+		Position.PageIndex = m_CurrentPage;
+		Position.AllocatedBytes = m_Pages.IsEmpty() ? 0 : m_Pages[m_CurrentPage]->AllocatedBytes;
+		CapturePositionStats(Position);
+		return Position;
+	}
+
+	void AStackArena::RewindTo(const AArenaPosition& Position)
+	{
+		if (m_Pages.IsEmpty())
+		{
+			return;
+		}
+		AE_CORE_ASSERT(Position.PageIndex < m_CurrentPage || (Position.PageIndex == m_CurrentPage && Position.AllocatedBytes <= m_Pages[m_CurrentPage]->AllocatedBytes),
+			TEXT("The arena can't be rewound to a position that is ahead of it!"));
+
+		// Only the pages up to the current one can hold allocations.
+		// The current page is moved first, so that the cached sizes drop the passed pages with the bytes they were counted with.
+		uint64 PreviousPage = m_CurrentPage;
+		SetCurrentPage(Position.PageIndex);
+		for (uint64 Index = Position.PageIndex + 1; Index <= PreviousPage; Index++)
+		{
+			m_Pages[Index]->AllocatedBytes = 0;
+		}
+		m_Pages[Position.PageIndex]->AllocatedBytes = Position.AllocatedBytes;
+
+		SubmitRewindStats(Position);
+	}
+
+	void AStackArena::TakeFragmentationReport(AArenaFragmentationReport& OutReport) const
+	{
+		OutReport = {};
+		OutReport.TotalBytes = m_TotalBytes;
+		OutReport.AllocatedBytes = GetAllocatedSize();
+		OutReport.FreeBytes = GetFreeSize();
+		OutReport.PaddingBytes = GetPaddingBytes(OutReport.AllocatedBytes);
+		OutReport.TailWasteBytes = m_PassedPagesBytes - m_PassedPagesAllocatedBytes;
+		OutReport.PagesCount = m_Pages.Size();
+
+		for (uint64 Index = 0; Index < m_Pages.Size() && Index < AArenaFragmentationReport::MaxPagesCount; Index++)
+		{
+			AArenaPageReport& PageReport = OutReport.Pages[Index];
+			PageReport.SizeBytes = m_Pages[Index]->SizeBytes;
+			PageReport.AllocatedBytes = m_Pages[Index]->AllocatedBytes;
+			PageReport.TailWasteBytes = Index < m_CurrentPage ? PageReport.SizeBytes - PageReport.AllocatedBytes : 0;
+		}
+	}
+
 	AStackArena::APage* AStackArena::AllocateNewPage(uint64 PageSize)
 	{
-		APage* NewPage = (APage*)GMalloc->Alloc(sizeof(APage) + PageSize);
+		APage* NewPage = (APage*)AllocateArenaMemory(GetPageMemoryRequirement(PageSize), m_Specification.MemoryOptions);
 		m_Pages.PushBack(NewPage);
 
 		NewPage->MemoryBlock = (uint8*)NewPage + sizeof(APage);
 		NewPage->SizeBytes = PageSize;
 		NewPage->AllocatedBytes = 0;
+		m_TotalBytes += PageSize;
 
 		return NewPage;
 	}
@@ -580,4 +795,56 @@ namespace Apricot {
 		return true;
 	}
 
-}
\ No newline at end of file
+	bool8 AStackArena::CommitPageMemory(APage* Page, uint64 RequiredBytes)
+	{
+		if (!m_Specification.bUseVirtualMemory)
+		{
+			return false;
+		}
+
+		uint64 CommittedBytes = sizeof(APage) + Page->SizeBytes;
+		uint64 RequiredCommittedBytes = Utils::AlignToPageSize(sizeof(APage) + RequiredBytes);
+		if (RequiredCommittedBytes > m_ReservedBytes)
+		{
+			return false;
+		}
+
+		uint64 NewCommittedBytes = CommittedBytes + VirtualCommitGranularity;
+		if (NewCommittedBytes < RequiredCommittedBytes)
+		{
+			NewCommittedBytes = RequiredCommittedBytes;
+		}
+		NewCommittedBytes = Utils::AlignToHugePageBoundary((uint8*)Page, NewCommittedBytes, m_Specification.MemoryOptions);
+		if (NewCommittedBytes > m_ReservedBytes)
+		{
+			NewCommittedBytes = m_ReservedBytes;
+		}
+
+		if (!APlatform::Commit((uint8*)Page + CommittedBytes, NewCommittedBytes - CommittedBytes))
+		{
+			return false;
+		}
+		PrepareArenaMemory((uint8*)Page + CommittedBytes, NewCommittedBytes - CommittedBytes, m_Specification.MemoryOptions);
+
+		Page->SizeBytes = NewCommittedBytes - sizeof(APage);
+		m_TotalBytes += NewCommittedBytes - CommittedBytes;
+		return true;
+	}
+
+	void AStackArena::SetCurrentPage(uint64 PageIndex)
+	{
+		while (m_CurrentPage < PageIndex)
+		{
+			m_PassedPagesBytes += m_Pages[m_CurrentPage]->SizeBytes;
+			m_PassedPagesAllocatedBytes += m_Pages[m_CurrentPage]->AllocatedBytes;
+			m_CurrentPage++;
+		}
+		while (m_CurrentPage > PageIndex)
+		{
+			m_CurrentPage--;
+			m_PassedPagesBytes -= m_Pages[m_CurrentPage]->SizeBytes;
+			m_PassedPagesAllocatedBytes -= m_Pages[m_CurrentPage]->AllocatedBytes;
+		}
+	}
+
+}
@@ -38,6 +38,23 @@ namespace Apricot {
 		*/
 		bool bShouldGrow = false;
 
+		/**
+		* If true, the arena reserves 'VirtualReserveSize' bytes of address space up front and commits physical memory on demand.
+		* The arena then has a single, contiguous page that grows in place. Its initial committed size is the first page size.
+		*/
+		bool bUseVirtualMemory = false;
+
+		/**
+		* The maximum size of a virtual memory arena.
+		*/
+		uint64 VirtualReserveSize = 0;
+
+		/**
+		* Controls how the pages' memory is obtained from the system (huge pages, prefaulting, locking).
+		* Doesn't apply to the memory provided through 'ArenaMemory'.
+		*/
+		AArenaMemoryOptions MemoryOptions;
+
 		/**
 		* 
 		*/
@@ -105,6 +122,11 @@ namespace Apricot {
 			uint16 AlignmentOffset = 0;
 		};
 
+		/**
+		* The minimum amount of memory that a virtual memory arena commits at once.
+		*/
+		static constexpr uint64 VirtualCommitGranularity = AE_KILOBYTES(64);
+
 	/* API interface */
 	public:
 		/**
@@ -153,7 +175,7 @@ namespace Apricot {
 		void FreeAllUnsafe();
 
 		/**
-		*
+		* Deletes the unused pages. Virtual memory arenas decommit the unused tail of their page instead.
 		*/
 		virtual void GarbageCollect() override;
 
@@ -171,21 +193,37 @@ namespace Apricot {
 		*
 		*/
 		void PopUnsafe(uint64 Size);
+
+		/**
+		* Returns the current position of the arena, which can be passed to 'RewindTo' later. Usually used through AArenaMark.
+		*/
+		virtual AArenaPosition GetPosition() const override;
+
+		/**
+		* Pops everything allocated after 'Position', across all the pages filled since. Same as popping the allocations one by one,
+		*	but it doesn't need their sizes. The allocations made before the position must still be alive.
+		*/
+		virtual void RewindTo(const AArenaPosition& Position) override;
+
+		/**
+		* Reports the occupancy of every page. The pages before the current one report their unused ends as tail waste.
+		*/
+		virtual void TakeFragmentationReport(AArenaFragmentationReport& OutReport) const override;
 	
 	/* Getters & Setters */
 	public:
 		/**
-		*
+		* Returns the total size of all pages. Cached, so it runs in constant time.
 		*/
-		uint64 GetTotalSize() const;
+		virtual uint64 GetTotalSize() const override;
 
 		/**
-		*
+		* Returns the total allocated size from each page, padding and alignment headers included. Cached, so it runs in constant time.
 		*/
 		uint64 GetAllocatedSize() const;
 
 		/**
-		*
+		* Returns the size that can still be allocated from the current page and the ones after it. Cached, so it runs in constant time.
 		*/
 		uint64 GetFreeSize() const;
 
@@ -229,6 +267,19 @@ namespace Apricot {
 		*/
 		bool8 CouldBeFreed(void* Allocation, uint64 Size) const;
 
+		/**
+		* Extends the committed memory of a virtual memory arena's page, so that it can hold 'RequiredBytes' bytes.
+		* 
+		* @returns False if the arena doesn't use virtual memory or if its reserved range is exhausted.
+		*/
+		bool8 CommitPageMemory(APage* Page, uint64 RequiredBytes);
+
+		/**
+		* Makes 'PageIndex' the current page and updates the cached sizes of the pages before it.
+		* The pages that are passed must not change their allocated bytes until the arena moves back before them.
+		*/
+		void SetCurrentPage(uint64 PageIndex);
+
 	/* Member variables */
 	private:
 		/**
@@ -236,6 +287,12 @@ namespace Apricot {
 		*/
 		AStackArenaSpecification m_Specification;
 
+		/**
+		* Size of the memory block that holds the specification's pages, if they are bulk allocated. The specification's page
+		*	arrays are only valid during the creation, so the block can't be measured again when the arena is destroyed.
+		*/
+		uint64 m_BulkMemoryBytes = 0;
+
 		/**
 		* 
 		*/
@@ -246,6 +303,19 @@ namespace Apricot {
 		*/
 		uint64 m_CurrentPage;
 
+		/**
+		* Cached sizes, so that the getters don't have to walk the pages. The pages after the current one are always empty,
+		*	so the allocated bytes are the ones of the pages before it, plus the ones of the current page.
+		*/
+		uint64 m_TotalBytes = 0;
+		uint64 m_PassedPagesBytes = 0;
+		uint64 m_PassedPagesAllocatedBytes = 0;
+
+		/**
+		* Size of the reserved address range (page header included). Only used by virtual memory arenas.
+		*/
+		uint64 m_ReservedBytes = 0;
+
 	/* Friends */
 	private:
 		template<typename T, typename... Args>
@@ -31,6 +31,74 @@ namespace Apricot {
 			MaxEnum
 		};
 
+		/**
+		* Executable address range of a module (the executable or a shared library) that is loaded in the process.
+		*/
+		struct AModuleRange
+		{
+			uintptr Begin = 0;
+			uintptr End = 0;
+
+			/**
+			* Offset of the range in the module's file.
+			*/
+			uint64 FileOffset = 0;
+
+			const char8* Path = nullptr;
+		};
+
+		using PFN_ModuleRangeCallback = void(*)(const AModuleRange& Range, void* UserData);
+
+		/**
+		* Physical memory used by the whole process, as seen by the system.
+		*/
+		struct AProcessMemoryUsage
+		{
+			/**
+			* The resident set size (the working set, on Windows).
+			*/
+			uint64 ResidentBytes = 0;
+
+			uint64 PeakResidentBytes = 0;
+		};
+
+		enum class EFileMapMode : uint8
+		{
+			/**
+			* Creates the file, or truncates it, to the requested size. The writes reach the file.
+			*/
+			Create,
+
+			/**
+			* Maps an existing file. The writes reach the file.
+			*/
+			ReadWrite,
+
+			/**
+			* Maps an existing file. The pages are shared with the file until they are written, and the writes never reach it.
+			*/
+			CopyOnWrite,
+		};
+
+		/**
+		* A file that is mapped in the address space. Filled by 'MapFile' and released by 'UnmapFile'.
+		*/
+		struct AMappedFile
+		{
+			void* Address = nullptr;
+			uint64 Size = 0;
+
+			/**
+			* The system's handles of the file and of the mapping object (Windows only).
+			*/
+			uintptr FileHandle = 0;
+			uintptr MappingHandle = 0;
+
+			EFileMapMode Mode = EFileMapMode::Create;
+
+			FORCEINLINE bool8 IsValid() const { return Address != nullptr; }
+		};
+
 	/* Init & Destroy */
 	public:
 		static void Init();
@@ -41,18 +109,155 @@ namespace Apricot {
 		NODISCARD static void* Malloc(uint64 Size, uint64 Alignment);
 		static void Free(void* MemoryBlock, uint64 Size);
 
+		/**
+		* Resizes a block allocated with 'Malloc'. The content is preserved, up to the smaller of the two sizes.
+		* The block is grown in place when possible. Big blocks are moved by remapping their pages, so they are never copied.
+		* 
+		* @returns The resized block. On failure, nullptr is returned and the old block is left untouched.
+		*/
+		NODISCARD static void* Realloc(void* MemoryBlock, uint64 OldSize, uint64 NewSize, uint64 Alignment);
+
+		/**
+		* Grows a block allocated with 'Malloc', without moving it.
+		* 
+		* @returns True if the block was grown. From now on, it must be freed with the new size.
+		*/
+		NODISCARD static bool8 Expand(void* MemoryBlock, uint64 OldSize, uint64 NewSize);
+
 		static void MemCpy(void* Destination, const void* Source, uint64 SizeBytes);
 		static void MemSet(void* Destination, int32 Value, uint64 SizeBytes);
 		static void MemZero(void* Destination, uint64 SizeBytes);
 
 		static uint64 GetAllocationSize(void* Allocation);
 
+	/* Virtual memory */
+	public:
+		/**
+		* Reserves a range of the address space, without backing it by physical memory. The range can't be accessed until it is committed.
+		* 
+		* @returns The beginning of the reserved range, aligned to the page size. nullptr on failure.
+		*/
+		NODISCARD static void* Reserve(uint64 Size);
+
+		/**
+		* Backs a part of a reserved range by physical memory. 'Address' and 'Size' must be multiples of the page size.
+		* 
+		* @returns True if the memory was committed successfully.
+		*/
+		static bool8 Commit(void* Address, uint64 Size);
+
+		/**
+		* Returns the physical memory of a committed part of a reserved range to the system. The range stays reserved.
+		*/
+		static void Decommit(void* Address, uint64 Size);
+
+		/**
+		* Releases a whole reserved range. 'Size' must be the size passed to 'Reserve'.
+		*/
+		static void Release(void* Address, uint64 Size);
+
+		/**
+		* Returns the granularity of 'Commit' and 'Decommit'.
+		*/
+		static uint64 GetPageSize();
+
+		/**
+		* Returns the size of a huge (large) page. Falls back to the regular page size if the system doesn't support them.
+		*/
+		static uint64 GetHugePageSize();
+
+		/**
+		* Allocates committed memory backed by huge pages, if the system can provide them. Otherwise, it falls back to regular pages.
+		* 'Size' must be a multiple of the huge page size. The memory must be freed with 'Release'.
+		*/
+		NODISCARD static void* AllocateHugePages(uint64 Size);
+
+		/**
+		* Hints the system that the range should be backed by huge pages, when they become available (transparent huge pages).
+		*/
+		static void AdviseHugePages(void* Address, uint64 Size);
+
+		/**
+		* Backs the committed range by physical memory now, instead of on first touch. The content of the memory is preserved.
+		*/
+		static void Prefault(void* Address, uint64 Size);
+
+		/**
+		* Locks the committed range in physical memory, so that it is never paged out.
+		* 
+		* @returns False if the system refused to lock the memory (usually because of the process' locked memory limit).
+		*/
+		static bool8 Lock(void* Address, uint64 Size);
+
+		static void Unlock(void* Address, uint64 Size);
+
+		/**
+		* Reads the memory usage of the process. Doesn't allocate from GMalloc.
+		*
+		* @returns False if the system couldn't be queried.
+		*/
+		static bool8 GetProcessMemoryUsage(AProcessMemoryUsage& OutUsage);
+
+	/* Memory-mapped files */
+	public:
+		/**
+		* Maps a whole file in the address space. The address is aligned to the page size.
+		* 
+		* @param Size The size of the file to create. Ignored when an existing file is mapped.
+		* 
+		* @returns False if the file couldn't be opened, created or mapped. 'OutFile' is left invalid.
+		*/
+		NODISCARD static bool8 MapFile(const char8* FilePath, EFileMapMode Mode, uint64 Size, AMappedFile& OutFile);
+
+		/**
+		* Writes the modified pages of the mapping to the file, and waits for them to be stored.
+		* 
+		* @returns False if the mapping is copy-on-write, or if the writes failed.
+		*/
+		static bool8 FlushMappedFile(const AMappedFile& File);
+
+		/**
+		* Unmaps the file and closes it. The file is left invalid.
+		*/
+		static void UnmapFile(AMappedFile& File);
+
+	/* Debugging */
+	public:
+		/**
+		* Captures the return addresses of the calling thread's stack, innermost first. The frame of this function is never included.
+		* Doesn't allocate from GMalloc, so it is safe to call from inside the allocator.
+		*
+		* @param FramesToSkip The number of innermost frames (of the caller and its callers) that aren't captured.
+		*
+		* @returns The number of captured frames.
+		*/
+		static uint32 CaptureBacktrace(void** OutFrames, uint32 MaxFramesCount, uint32 FramesToSkip);
+
+		/**
+		* Writes the (demangled, if possible) name of the function that contains 'Address'. Might allocate from the C runtime, but never from GMalloc.
+		*
+		* @returns False if the name couldn't be resolved.
+		*/
+		static bool8 GetSymbolName(const void* Address, char8* OutBuffer, uint64 BufferSize);
+
+		/**
+		* Calls 'Callback' for every executable address range of the loaded modules. Used by profilers to symbolize addresses offline.
+		*/
+		static void EnumerateModuleRanges(PFN_ModuleRangeCallback Callback, void* UserData);
+
 	/* Timing */
 	public:
-		static NODISCARD Time GetSystemPerformanceTime();
+		NODISCARD static Time GetSystemPerformanceTime();
 
 		static void SleepFor(Time duration);
 
+	/* Threads */
+	public:
+		/**
+		* Returns the system's identifier of the calling thread. Never 0. Cached per thread, so it is cheap to call often.
+		*/
+		static uint64 GetCurrentThreadId();
+
 	/* Console */
 	public:
 		static bool IsConsoleAvailable();
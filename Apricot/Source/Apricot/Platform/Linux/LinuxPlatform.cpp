@@ -0,0 +1,724 @@
+// Part of Apricot Engine. 2022-2022.
+// Module: Platform
+
+#include "aepch.h"
+
+#ifdef AE_PLATFORM_LINUX
+
+#include "Apricot/Core/Platform.h"
+
+#include "Apricot/Profiling/MemoryProfiler.h"
+
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <errno.h>
+#include <execinfo.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <link.h>
+#include <malloc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+* Allocations bigger or equal to this size are served directly by mmap, instead of the C heap.
+* Because 'Free' receives the allocation size, no header is required to tell the two kinds of blocks apart.
+* Freed big blocks are returned to the system immediately.
+*/
+#define AE_LINUX_MMAP_THRESHOLD AE_KILOBYTES(256)
+
+/**
+* Size of the console staging buffer. A colored message is sent with a single 'write' call if it fits.
+* The buffer lives on the stack of the writing thread, so the threads can log at the same time.
+*/
+#define AE_LINUX_CONSOLE_BUFFER_SIZE AE_KILOBYTES(4)
+
+/**
+* Size of the huge pages used for MAP_HUGETLB and transparent huge pages. 2 MiB is the PMD page size of x86-64 and AArch64 (with 4 KiB pages).
+*/
+#define AE_LINUX_HUGE_PAGE_SIZE AE_MEGABYTES(2)
+
+namespace Apricot {
+
+	AE_STATIC_ASSERT(sizeof(TChar) == 1, "The Linux console backend only supports the ANSII charset!");
+
+	namespace Utils {
+
+		static const char8* GetConsoleColor(APlatform::EConsoleTextColor Color)
+		{
+			// Mirrors the Windows console attributes.
+			switch (Color)
+			{
+				case APlatform::EConsoleTextColor::Gray:        return "\033[90m";
+				case APlatform::EConsoleTextColor::DarkPurple:  return "\033[95m";
+				case APlatform::EConsoleTextColor::Green:       return "\033[32m";
+				case APlatform::EConsoleTextColor::PaleYellow:  return "\033[93m";
+				case APlatform::EConsoleTextColor::BrightRed:   return "\033[91m";
+				case APlatform::EConsoleTextColor::Black_RedBg: return "\033[30;41m";
+				default:                                        break;
+			}
+			AE_CORE_RASSERT_NO_ENTRY();
+			return "";
+		}
+
+		static uint64 GetTimespecNanoseconds(const timespec& Timespec)
+		{
+			return (uint64)Timespec.tv_sec * 1000000000ull + (uint64)Timespec.tv_nsec;
+		}
+
+		static void WriteAll(int32 FileDescriptor, const char8* Buffer, uint64 Size)
+		{
+			while (Size > 0)
+			{
+				ssize_t Written = write(FileDescriptor, Buffer, Size);
+				if (Written < 0)
+				{
+					if (errno == EINTR)
+					{
+						continue;
+					}
+					return;
+				}
+				Buffer += Written;
+				Size -= (uint64)Written;
+			}
+		}
+
+	}
+
+	struct LinuxPlatformData
+	{
+		uint64 MonotonicStart = 0;
+
+		uint64 PageSize = 4096;
+
+		bool8 bIsConsoleAttached = false;
+		bool8 bIsOutputColored = false;
+		bool8 bIsErrorColored = false;
+	};
+	static LinuxPlatformData SLinuxPlatformData;
+
+	namespace Utils {
+
+		static void* MapMemory(uint64 Size, uint64 Alignment)
+		{
+			if (Alignment <= SLinuxPlatformData.PageSize)
+			{
+				void* MemoryBlock = mmap(nullptr, Size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+				return MemoryBlock != MAP_FAILED ? MemoryBlock : nullptr;
+			}
+
+			// Over-map and trim both ends, so the returned block is an exact mapping that 'munmap' can release.
+			uint64 MappedSize = Size + Alignment;
+			uint8* Mapping = (uint8*)mmap(nullptr, MappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			if (Mapping == MAP_FAILED)
+			{
+				return nullptr;
+			}
+
+			uint64 HeadSize = GetAlignmentOffset(Mapping, Alignment);
+			uint64 BlockSize = Size + GetAlignmentOffset(Size, SLinuxPlatformData.PageSize);
+
+			if (HeadSize > 0)
+			{
+				munmap(Mapping, HeadSize);
+			}
+			if (MappedSize - HeadSize > BlockSize)
+			{
+				munmap(Mapping + HeadSize + BlockSize, MappedSize - HeadSize - BlockSize);
+			}
+
+			return Mapping + HeadSize;
+		}
+
+	}
+
+	void APlatform::Init()
+	{
+		timespec Now;
+		const int32 ClockResult = clock_gettime(CLOCK_MONOTONIC, &Now);
+		if (ClockResult == 0)
+		{
+			SLinuxPlatformData.MonotonicStart = Utils::GetTimespecNanoseconds(Now);
+		}
+		else
+		{
+			// The time is then measured from the clock's own origin, instead of from the engine's start.
+			AE_CORE_ASSERT_NO_ENTRY();
+		}
+
+		long PageSize = sysconf(_SC_PAGESIZE);
+		if (PageSize > 0)
+		{
+			SLinuxPlatformData.PageSize = (uint64)PageSize;
+		}
+	}
+
+	void APlatform::Destroy()
+	{
+
+	}
+
+	void* APlatform::Malloc(uint64 Size, uint64 Alignment)
+	{
+		if (Size == 0)
+		{
+			return nullptr;
+		}
+
+		void* MemoryBlock = nullptr;
+		if (Size >= AE_LINUX_MMAP_THRESHOLD)
+		{
+			MemoryBlock = Utils::MapMemory(Size, Alignment);
+		}
+		else if (Alignment <= alignof(max_align_t))
+		{
+			MemoryBlock = malloc(Size);
+		}
+		else if (posix_memalign(&MemoryBlock, Alignment, Size) != 0)
+		{
+			MemoryBlock = nullptr;
+		}
+
+		AMemoryProfiler::SubmitHeapAllocation(MemoryBlock, Size, Alignment);
+		return MemoryBlock;
+	}
+
+	void APlatform::Free(void* MemoryBlock, uint64 Size)
+	{
+		AMemoryProfiler::SubmitHeapDeallocation(MemoryBlock, Size);
+
+		if (Size >= AE_LINUX_MMAP_THRESHOLD)
+		{
+			munmap(MemoryBlock, Size);
+			return;
+		}
+
+		free(MemoryBlock);
+	}
+
+	void* APlatform::Realloc(void* MemoryBlock, uint64 OldSize, uint64 NewSize, uint64 Alignment)
+	{
+		if (MemoryBlock == nullptr)
+		{
+			return Malloc(NewSize, Alignment);
+		}
+		if (NewSize == 0)
+		{
+			Free(MemoryBlock, OldSize);
+			return nullptr;
+		}
+
+		bool8 bIsMapped = OldSize >= AE_LINUX_MMAP_THRESHOLD;
+		bool8 bWillBeMapped = NewSize >= AE_LINUX_MMAP_THRESHOLD;
+
+		void* NewBlock = nullptr;
+		if (bIsMapped && bWillBeMapped && Alignment <= SLinuxPlatformData.PageSize)
+		{
+			// The kernel moves the pages, if the block can't grow in place. The content is never copied.
+			uint64 OldMappedSize = OldSize + GetAlignmentOffset(OldSize, SLinuxPlatformData.PageSize);
+			uint64 NewMappedSize = NewSize + GetAlignmentOffset(NewSize, SLinuxPlatformData.PageSize);
+			NewBlock = mremap(MemoryBlock, OldMappedSize, NewMappedSize, MREMAP_MAYMOVE);
+			if (NewBlock == MAP_FAILED)
+			{
+				return nullptr;
+			}
+		}
+		else if (!bIsMapped && !bWillBeMapped && Alignment <= alignof(max_align_t))
+		{
+			NewBlock = realloc(MemoryBlock, NewSize);
+			if (NewBlock == nullptr)
+			{
+				return nullptr;
+			}
+		}
+		else
+		{
+			if (Expand(MemoryBlock, OldSize, NewSize))
+			{
+				return MemoryBlock;
+			}
+
+			NewBlock = Malloc(NewSize, Alignment);
+			if (NewBlock == nullptr)
+			{
+				return nullptr;
+			}
+			memcpy(NewBlock, MemoryBlock, OldSize < NewSize ? OldSize : NewSize);
+			Free(MemoryBlock, OldSize);
+			return NewBlock;
+		}
+
+		AMemoryProfiler::SubmitHeapReallocation(MemoryBlock, OldSize, NewBlock, NewSize);
+		return NewBlock;
+	}
+
+	bool8 APlatform::Expand(void* MemoryBlock, uint64 OldSize, uint64 NewSize)
+	{
+		if (MemoryBlock == nullptr || NewSize < OldSize)
+		{
+			return false;
+		}
+
+		// 'Free' tells the two kinds of blocks apart by their size, so a block can't cross the threshold.
+		bool8 bIsMapped = OldSize >= AE_LINUX_MMAP_THRESHOLD;
+		if (bIsMapped != (NewSize >= AE_LINUX_MMAP_THRESHOLD))
+		{
+			return false;
+		}
+
+		if (bIsMapped)
+		{
+			uint64 OldMappedSize = OldSize + GetAlignmentOffset(OldSize, SLinuxPlatformData.PageSize);
+			uint64 NewMappedSize = NewSize + GetAlignmentOffset(NewSize, SLinuxPlatformData.PageSize);
+			if (NewMappedSize > OldMappedSize && mremap(MemoryBlock, OldMappedSize, NewMappedSize, 0) == MAP_FAILED)
+			{
+				return false;
+			}
+		}
+		else if (malloc_usable_size(MemoryBlock) < NewSize)
+		{
+			// The C heap rounds the blocks up to its size classes, so the headroom can be used without moving the block.
+			return false;
+		}
+
+		AMemoryProfiler::SubmitHeapReallocation(MemoryBlock, OldSize, MemoryBlock, NewSize);
+		return true;
+	}
+
+	void APlatform::MemCpy(void* Destination, const void* Source, uint64 SizeBytes)
+	{
+		memcpy(Destination, Source, SizeBytes);
+	}
+
+	void APlatform::MemSet(void* Destination, int32 Value, uint64 SizeBytes)
+	{
+		memset(Destination, Value, SizeBytes);
+	}
+
+	void APlatform::MemZero(void* Destination, uint64 SizeBytes)
+	{
+		memset(Destination, 0, SizeBytes);
+	}
+
+	uint64 APlatform::GetAllocationSize(void* Allocation)
+	{
+		// NOTE: Only meaningful for blocks served by the C heap. The mmap'ed blocks don't carry any header,
+		// so their size is only known by the caller.
+		return malloc_usable_size(Allocation);
+	}
+
+	void* APlatform::Reserve(uint64 Size)
+	{
+		// MAP_NORESERVE keeps the range out of the overcommit accounting until it is committed.
+		void* Address = mmap(nullptr, Size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+		return Address != MAP_FAILED ? Address : nullptr;
+	}
+
+	bool8 APlatform::Commit(void* Address, uint64 Size)
+	{
+		// Anonymous pages are backed on first touch.
+		return mprotect(Address, Size, PROT_READ | PROT_WRITE) == 0;
+	}
+
+	void APlatform::Decommit(void* Address, uint64 Size)
+	{
+		madvise(Address, Size, MADV_DONTNEED);
+		mprotect(Address, Size, PROT_NONE);
+	}
+
+	void APlatform::Release(void* Address, uint64 Size)
+	{
+		munmap(Address, Size);
+	}
+
+	uint64 APlatform::GetPageSize()
+	{
+		return SLinuxPlatformData.PageSize;
+	}
+
+	uint64 APlatform::GetHugePageSize()
+	{
+		return AE_LINUX_HUGE_PAGE_SIZE;
+	}
+
+	void* APlatform::AllocateHugePages(uint64 Size)
+	{
+		// Explicit huge pages only exist if the administrator reserved them ('vm.nr_hugepages').
+		void* MemoryBlock = mmap(nullptr, Size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+		if (MemoryBlock != MAP_FAILED)
+		{
+			return MemoryBlock;
+		}
+
+		// Fall back to transparent huge pages. They need the range to be aligned to the huge page size.
+		MemoryBlock = Utils::MapMemory(Size, AE_LINUX_HUGE_PAGE_SIZE);
+		if (MemoryBlock)
+		{
+			AdviseHugePages(MemoryBlock, Size);
+		}
+		return MemoryBlock;
+	}
+
+	void APlatform::AdviseHugePages(void* Address, uint64 Size)
+	{
+		madvise(Address, Size, MADV_HUGEPAGE);
+	}
+
+	void APlatform::Prefault(void* Address, uint64 Size)
+	{
+	#ifdef MADV_POPULATE_WRITE
+		if (madvise(Address, Size, MADV_POPULATE_WRITE) == 0)
+		{
+			return;
+		}
+	#endif
+
+		// Older kernels: write to every page. Writing the value back keeps the memory's content.
+		volatile uint8* Memory = (volatile uint8*)Address;
+		for (uint64 Offset = 0; Offset < Size; Offset += SLinuxPlatformData.PageSize)
+		{
+			Memory[Offset] = Memory[Offset];
+		}
+	}
+
+	bool8 APlatform::Lock(void* Address, uint64 Size)
+	{
+		return mlock(Address, Size) == 0;
+	}
+
+	void APlatform::Unlock(void* Address, uint64 Size)
+	{
+		munlock(Address, Size);
+	}
+
+	bool8 APlatform::GetProcessMemoryUsage(AProcessMemoryUsage& OutUsage)
+	{
+		// The second field of 'statm' is the resident set size, in pages. Read with the raw calls, so that nothing is allocated.
+		int FileDescriptor = open("/proc/self/statm", O_RDONLY | O_CLOEXEC);
+		if (FileDescriptor < 0)
+		{
+			return false;
+		}
+
+		char Buffer[128];
+		ssize_t ReadBytes = read(FileDescriptor, Buffer, sizeof(Buffer) - 1);
+		close(FileDescriptor);
+		if (ReadBytes <= 0)
+		{
+			return false;
+		}
+		Buffer[ReadBytes] = 0;
+
+		unsigned long long TotalPages = 0;
+		unsigned long long ResidentPages = 0;
+		if (sscanf(Buffer, "%llu %llu", &TotalPages, &ResidentPages) != 2)
+		{
+			return false;
+		}
+		OutUsage.ResidentBytes = (uint64)ResidentPages * GetPageSize();
+
+		// 'ru_maxrss' is in kilobytes on Linux.
+		struct rusage Usage;
+		OutUsage.PeakResidentBytes = getrusage(RUSAGE_SELF, &Usage) == 0 ? (uint64)Usage.ru_maxrss * 1024 : OutUsage.ResidentBytes;
+		return true;
+	}
+
+	bool8 APlatform::MapFile(const char8* FilePath, EFileMapMode Mode, uint64 Size, AMappedFile& OutFile)
+	{
+		OutFile = {};
+
+		int OpenFlags = O_CLOEXEC;
+		switch (Mode)
+		{
+			case EFileMapMode::Create:      OpenFlags |= O_RDWR | O_CREAT | O_TRUNC; break;
+			case EFileMapMode::ReadWrite:   OpenFlags |= O_RDWR; break;
+			case EFileMapMode::CopyOnWrite: OpenFlags |= O_RDONLY; break;
+		}
+
+		int FileDescriptor = open(FilePath, OpenFlags, 0644);
+		if (FileDescriptor < 0)
+		{
+			return false;
+		}
+
+		if (Mode == EFileMapMode::Create)
+		{
+			if (ftruncate(FileDescriptor, (off_t)Size) != 0)
+			{
+				close(FileDescriptor);
+				return false;
+			}
+		}
+		else
+		{
+			struct stat FileStatus;
+			if (fstat(FileDescriptor, &FileStatus) != 0)
+			{
+				close(FileDescriptor);
+				return false;
+			}
+			Size = (uint64)FileStatus.st_size;
+		}
+
+		if (Size == 0)
+		{
+			close(FileDescriptor);
+			return false;
+		}
+
+		// A private mapping of a read-only file can still be written; the written pages are copied.
+		int MapFlags = Mode == EFileMapMode::CopyOnWrite ? MAP_PRIVATE : MAP_SHARED;
+		void* Address = mmap(nullptr, Size, PROT_READ | PROT_WRITE, MapFlags, FileDescriptor, 0);
+		if (Address == MAP_FAILED)
+		{
+			close(FileDescriptor);
+			return false;
+		}
+
+		OutFile.Address = Address;
+		OutFile.Size = Size;
+		OutFile.FileHandle = (uintptr)FileDescriptor;
+		OutFile.Mode = Mode;
+		return true;
+	}
+
+	bool8 APlatform::FlushMappedFile(const AMappedFile& File)
+	{
+		if (!File.IsValid() || File.Mode == EFileMapMode::CopyOnWrite)
+		{
+			return false;
+		}
+		return msync(File.Address, File.Size, MS_SYNC) == 0;
+	}
+
+	void APlatform::UnmapFile(AMappedFile& File)
+	{
+		if (!File.IsValid())
+		{
+			return;
+		}
+
+		munmap(File.Address, File.Size);
+		close((int)File.FileHandle);
+		File = {};
+	}
+
+	uint32 APlatform::CaptureBacktrace(void** OutFrames, uint32 MaxFramesCount, uint32 FramesToSkip)
+	{
+		// 'backtrace' also captures the frame of this function, so it is skipped as well.
+		void* Frames[128];
+		uint32 RequestedCount = MaxFramesCount + FramesToSkip + 1;
+		if (RequestedCount > AE_ARRAY_LENGTH(Frames))
+		{
+			RequestedCount = AE_ARRAY_LENGTH(Frames);
+		}
+
+		int32 FramesCount = (int32)backtrace(Frames, (int)RequestedCount);
+		if (FramesCount <= (int32)FramesToSkip + 1)
+		{
+			return 0;
+		}
+
+		uint32 CapturedCount = (uint32)FramesCount - FramesToSkip - 1;
+		memcpy(OutFrames, Frames + FramesToSkip + 1, CapturedCount * sizeof(void*));
+		return CapturedCount;
+	}
+
+	bool8 APlatform::GetSymbolName(const void* Address, char8* OutBuffer, uint64 BufferSize)
+	{
+		if (BufferSize == 0)
+		{
+			return false;
+		}
+
+		// Only the exported (dynamic) symbols can be resolved. The others are left to the offline tools.
+		Dl_info Info;
+		if (dladdr(Address, &Info) == 0 || Info.dli_sname == nullptr)
+		{
+			return false;
+		}
+
+		int Status = 0;
+		char* DemangledName = abi::__cxa_demangle(Info.dli_sname, nullptr, nullptr, &Status);
+		const char8* Name = (Status == 0 && DemangledName) ? DemangledName : Info.dli_sname;
+
+		uint64 NameLength = strlen(Name);
+		NameLength = NameLength < BufferSize - 1 ? NameLength : BufferSize - 1;
+		memcpy(OutBuffer, Name, NameLength);
+		OutBuffer[NameLength] = 0;
+
+		// Allocated with the C runtime's malloc.
+		free(DemangledName);
+		return true;
+	}
+
+	namespace Utils {
+
+		struct AModuleRangesContext
+		{
+			APlatform::PFN_ModuleRangeCallback Callback;
+			void* UserData;
+			uint64 PageSize;
+			char8 ExecutablePath[PATH_MAX];
+		};
+
+		static int OnLoadedModule(dl_phdr_info* Module, size_t, void* Data)
+		{
+			AModuleRangesContext* Context = (AModuleRangesContext*)Data;
+
+			// The executable is reported without a name.
+			const char8* Path = (Module->dlpi_name && Module->dlpi_name[0]) ? Module->dlpi_name : Context->ExecutablePath;
+
+			for (uint32 Index = 0; Index < (uint32)Module->dlpi_phnum; Index++)
+			{
+				const ElfW(Phdr)& Segment = Module->dlpi_phdr[Index];
+				if (Segment.p_type != PT_LOAD || (Segment.p_flags & PF_X) == 0)
+				{
+					continue;
+				}
+
+				// The segment is mapped starting from a page boundary. Its address and file offset are equal modulo the page size.
+				uintptr Begin = (uintptr)(Module->dlpi_addr + Segment.p_vaddr);
+				uint64 PageOffset = Begin % Context->PageSize;
+
+				APlatform::AModuleRange Range;
+				Range.Begin = Begin - PageOffset;
+				Range.End = Begin + Segment.p_memsz;
+				Range.FileOffset = Segment.p_offset - PageOffset;
+				Range.Path = Path;
+				Context->Callback(Range, Context->UserData);
+			}
+
+			return 0;
+		}
+
+	}
+
+	void APlatform::EnumerateModuleRanges(PFN_ModuleRangeCallback Callback, void* UserData)
+	{
+		Utils::AModuleRangesContext Context;
+		Context.Callback = Callback;
+		Context.UserData = UserData;
+		Context.PageSize = SLinuxPlatformData.PageSize;
+
+		ssize_t PathLength = readlink("/proc/self/exe", Context.ExecutablePath, sizeof(Context.ExecutablePath) - 1);
+		Context.ExecutablePath[PathLength > 0 ? PathLength : 0] = 0;
+
+		dl_iterate_phdr(Utils::OnLoadedModule, &Context);
+	}
+
+	NODISCARD Time APlatform::GetSystemPerformanceTime()
+	{
+		// CLOCK_MONOTONIC is resolved through the vDSO, so this doesn't enter the kernel.
+		timespec Now;
+		clock_gettime(CLOCK_MONOTONIC, &Now);
+
+		return Utils::GetTimespecNanoseconds(Now) - SLinuxPlatformData.MonotonicStart;
+	}
+
+	void APlatform::SleepFor(Time duration)
+	{
+		timespec Remaining;
+		Remaining.tv_sec = (time_t)((uint64)duration / 1000000000ull);
+		Remaining.tv_nsec = (long)((uint64)duration % 1000000000ull);
+
+		while (nanosleep(&Remaining, &Remaining) != 0 && errno == EINTR)
+		{
+		}
+	}
+
+	uint64 APlatform::GetCurrentThreadId()
+	{
+		static thread_local uint64 SThreadId = 0;
+		if (SThreadId == 0)
+		{
+			SThreadId = (uint64)syscall(SYS_gettid);
+		}
+		return SThreadId;
+	}
+
+	bool APlatform::IsConsoleAvailable()
+	{
+		return SLinuxPlatformData.bIsConsoleAttached;
+	}
+
+	void APlatform::ConsoleAttach()
+	{
+		if (SLinuxPlatformData.bIsConsoleAttached)
+		{
+			return;
+		}
+
+		// Don't pollute redirected output (log files, CI) with escape sequences.
+		SLinuxPlatformData.bIsOutputColored = isatty(STDOUT_FILENO);
+		SLinuxPlatformData.bIsErrorColored = isatty(STDERR_FILENO);
+		SLinuxPlatformData.bIsConsoleAttached = true;
+	}
+
+	void APlatform::ConsoleFree()
+	{
+		if (!SLinuxPlatformData.bIsConsoleAttached)
+		{
+			return;
+		}
+
+		SLinuxPlatformData.bIsOutputColored = false;
+		SLinuxPlatformData.bIsErrorColored = false;
+		SLinuxPlatformData.bIsConsoleAttached = false;
+	}
+
+	namespace Utils {
+
+		static void ConsoleWriteColored(int32 FileDescriptor, bool8 bIsColored, const TChar* Message, uint64 MessageSize, APlatform::EConsoleTextColor Color)
+		{
+			static const char8 SResetColor[] = "\033[0m";
+
+			const char8* ColorCode = bIsColored ? GetConsoleColor(Color) : "";
+			uint64 ColorCodeSize = strlen(ColorCode);
+			uint64 ResetSize = bIsColored ? sizeof(SResetColor) - 1 : 0;
+
+			if (ColorCodeSize + MessageSize + ResetSize > AE_LINUX_CONSOLE_BUFFER_SIZE)
+			{
+				// Too big to be staged, so it will take three syscalls.
+				WriteAll(FileDescriptor, ColorCode, ColorCodeSize);
+				WriteAll(FileDescriptor, Message, MessageSize);
+				WriteAll(FileDescriptor, SResetColor, ResetSize);
+				return;
+			}
+
+			char8 Buffer[AE_LINUX_CONSOLE_BUFFER_SIZE];
+			memcpy(Buffer, ColorCode, ColorCodeSize);
+			memcpy(Buffer + ColorCodeSize, Message, MessageSize);
+			memcpy(Buffer + ColorCodeSize + MessageSize, SResetColor, ResetSize);
+			WriteAll(FileDescriptor, Buffer, ColorCodeSize + MessageSize + ResetSize);
+		}
+
+	}
+
+	void APlatform::ConsoleWrite(const TChar* Message, uint64 MessageSize, EConsoleTextColor Color)
+	{
+		if (SLinuxPlatformData.bIsConsoleAttached)
+		{
+			Utils::ConsoleWriteColored(STDOUT_FILENO, SLinuxPlatformData.bIsOutputColored, Message, MessageSize, Color);
+		}
+	}
+
+	void APlatform::ConsoleWriteError(const TChar* Message, uint64 MessageSize, EConsoleTextColor Color)
+	{
+		if (SLinuxPlatformData.bIsConsoleAttached)
+		{
+			Utils::ConsoleWriteColored(STDERR_FILENO, SLinuxPlatformData.bIsErrorColored, Message, MessageSize, Color);
+		}
+	}
+
+}
+
+#endif
@@ -16,6 +16,8 @@
 #include <Windows.h>
 #include <consoleapi.h>
 #include <consoleapi2.h>
+#include <DbgHelp.h>
+#include <Psapi.h>
 
 namespace Apricot {
 
@@ -43,6 +45,8 @@ namespace Apricot {
 		LARGE_INTEGER PerformanceCounterStart = { 0 };
 		LARGE_INTEGER PerformanceFrequency = { 0 };
 
+		uint64 PageSize = 4096;
+
 		HANDLE ConsoleOutputHandle = INVALID_HANDLE_VALUE;
 		HANDLE ConsoleErrorHandle = INVALID_HANDLE_VALUE;
 		bool8 bIsConsoleAttached = false;
@@ -54,6 +58,10 @@ namespace Apricot {
 		AE_CORE_VERIFY(QueryPerformanceCounter(&SWindowsPlatformData.PerformanceCounterStart));
 
 		AE_CORE_VERIFY(QueryPerformanceFrequency(&SWindowsPlatformData.PerformanceFrequency));
+
+		SYSTEM_INFO SystemInfo;
+		GetSystemInfo(&SystemInfo);
+		SWindowsPlatformData.PageSize = (uint64)SystemInfo.dwPageSize;
 	}
 
 	void APlatform::Destroy()
@@ -67,8 +75,10 @@ namespace Apricot {
 		{
 			return nullptr;
 		}
-		AMemoryProfiler::SubmitHeapAllocation(Size, Alignment);
-		return ::operator new(Size);
+
+		void* MemoryBlock = ::operator new(Size);
+		AMemoryProfiler::SubmitHeapAllocation(MemoryBlock, Size, Alignment);
+		return MemoryBlock;
 	}
 
 	void APlatform::Free(void* MemoryBlock, uint64 Size)
@@ -77,6 +87,51 @@ namespace Apricot {
 		::operator delete(MemoryBlock, Size);
 	}
 
+	void* APlatform::Realloc(void* MemoryBlock, uint64 OldSize, uint64 NewSize, uint64 Alignment)
+	{
+		if (MemoryBlock == nullptr)
+		{
+			return Malloc(NewSize, Alignment);
+		}
+		if (NewSize == 0)
+		{
+			Free(MemoryBlock, OldSize);
+			return nullptr;
+		}
+
+		if (Expand(MemoryBlock, OldSize, NewSize))
+		{
+			return MemoryBlock;
+		}
+
+		// The blocks come from 'operator new', so they can't be passed to 'realloc'.
+		void* NewBlock = Malloc(NewSize, Alignment);
+		if (NewBlock == nullptr)
+		{
+			return nullptr;
+		}
+		memcpy(NewBlock, MemoryBlock, OldSize < NewSize ? OldSize : NewSize);
+		Free(MemoryBlock, OldSize);
+		return NewBlock;
+	}
+
+	bool8 APlatform::Expand(void* MemoryBlock, uint64 OldSize, uint64 NewSize)
+	{
+		if (MemoryBlock == nullptr || NewSize < OldSize)
+		{
+			return false;
+		}
+
+		// The CRT heap grows the block in place or fails.
+		if (_expand(MemoryBlock, NewSize) == nullptr)
+		{
+			return false;
+		}
+
+		AMemoryProfiler::SubmitHeapReallocation(MemoryBlock, OldSize, MemoryBlock, NewSize);
+		return true;
+	}
+
 	void APlatform::MemCpy(void* Destination, const void* Source, uint64 SizeBytes)
 	{
 		memcpy(Destination, Source, SizeBytes);
@@ -97,6 +152,239 @@ namespace Apricot {
 		return _msize(Allocation);
 	}
 
+	void* APlatform::Reserve(uint64 Size)
+	{
+		return VirtualAlloc(nullptr, Size, MEM_RESERVE, PAGE_NOACCESS);
+	}
+
+	bool8 APlatform::Commit(void* Address, uint64 Size)
+	{
+		return VirtualAlloc(Address, Size, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+	}
+
+	void APlatform::Decommit(void* Address, uint64 Size)
+	{
+		VirtualFree(Address, Size, MEM_DECOMMIT);
+	}
+
+	void APlatform::Release(void* Address, uint64 Size)
+	{
+		VirtualFree(Address, 0, MEM_RELEASE);
+	}
+
+	uint64 APlatform::GetPageSize()
+	{
+		return SWindowsPlatformData.PageSize;
+	}
+
+	uint64 APlatform::GetHugePageSize()
+	{
+		uint64 LargePageSize = (uint64)GetLargePageMinimum();
+		return LargePageSize > 0 ? LargePageSize : SWindowsPlatformData.PageSize;
+	}
+
+	void* APlatform::AllocateHugePages(uint64 Size)
+	{
+		// Large pages require the 'SeLockMemoryPrivilege' privilege. Without it, the allocation fails.
+		void* MemoryBlock = VirtualAlloc(nullptr, Size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+		if (MemoryBlock)
+		{
+			return MemoryBlock;
+		}
+
+		return VirtualAlloc(nullptr, Size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+	}
+
+	void APlatform::AdviseHugePages(void* Address, uint64 Size)
+	{
+		// Windows doesn't have transparent huge pages. Large pages can only be requested at allocation time.
+	}
+
+	void APlatform::Prefault(void* Address, uint64 Size)
+	{
+		volatile uint8* Memory = (volatile uint8*)Address;
+		for (uint64 Offset = 0; Offset < Size; Offset += SWindowsPlatformData.PageSize)
+		{
+			Memory[Offset] = Memory[Offset];
+		}
+	}
+
+	bool8 APlatform::Lock(void* Address, uint64 Size)
+	{
+		return VirtualLock(Address, Size) != 0;
+	}
+
+	void APlatform::Unlock(void* Address, uint64 Size)
+	{
+		VirtualUnlock(Address, Size);
+	}
+
+	bool8 APlatform::GetProcessMemoryUsage(AProcessMemoryUsage& OutUsage)
+	{
+		PROCESS_MEMORY_COUNTERS Counters;
+		if (!K32GetProcessMemoryInfo(GetCurrentProcess(), &Counters, sizeof(Counters)))
+		{
+			return false;
+		}
+
+		OutUsage.ResidentBytes = Counters.WorkingSetSize;
+		OutUsage.PeakResidentBytes = Counters.PeakWorkingSetSize;
+		return true;
+	}
+
+	bool8 APlatform::MapFile(const char8* FilePath, EFileMapMode Mode, uint64 Size, AMappedFile& OutFile)
+	{
+		OutFile = {};
+
+		DWORD DesiredAccess = Mode == EFileMapMode::CopyOnWrite ? GENERIC_READ : GENERIC_READ | GENERIC_WRITE;
+		DWORD CreationDisposition = Mode == EFileMapMode::Create ? CREATE_ALWAYS : OPEN_EXISTING;
+		HANDLE FileHandle = CreateFileA(FilePath, DesiredAccess, FILE_SHARE_READ, nullptr, CreationDisposition, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (FileHandle == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+
+		if (Mode != EFileMapMode::Create)
+		{
+			LARGE_INTEGER FileSize;
+			if (!GetFileSizeEx(FileHandle, &FileSize))
+			{
+				CloseHandle(FileHandle);
+				return false;
+			}
+			Size = (uint64)FileSize.QuadPart;
+		}
+
+		if (Size == 0)
+		{
+			CloseHandle(FileHandle);
+			return false;
+		}
+
+		// Mapping a created file with its final size extends it.
+		DWORD Protection = Mode == EFileMapMode::CopyOnWrite ? PAGE_WRITECOPY : PAGE_READWRITE;
+		HANDLE MappingHandle = CreateFileMappingA(FileHandle, nullptr, Protection, (DWORD)(Size >> 32), (DWORD)(Size & 0xFFFFFFFF), nullptr);
+		if (MappingHandle == nullptr)
+		{
+			CloseHandle(FileHandle);
+			return false;
+		}
+
+		void* Address = MapViewOfFile(MappingHandle, Mode == EFileMapMode::CopyOnWrite ? FILE_MAP_COPY : FILE_MAP_WRITE, 0, 0, Size);
+		if (Address == nullptr)
+		{
+			CloseHandle(MappingHandle);
+			CloseHandle(FileHandle);
+			return false;
+		}
+
+		OutFile.Address = Address;
+		OutFile.Size = Size;
+		OutFile.FileHandle = (uintptr)FileHandle;
+		OutFile.MappingHandle = (uintptr)MappingHandle;
+		OutFile.Mode = Mode;
+		return true;
+	}
+
+	bool8 APlatform::FlushMappedFile(const AMappedFile& File)
+	{
+		if (!File.IsValid() || File.Mode == EFileMapMode::CopyOnWrite)
+		{
+			return false;
+		}
+		return FlushViewOfFile(File.Address, File.Size) && FlushFileBuffers((HANDLE)File.FileHandle);
+	}
+
+	void APlatform::UnmapFile(AMappedFile& File)
+	{
+		if (!File.IsValid())
+		{
+			return;
+		}
+
+		UnmapViewOfFile(File.Address);
+		CloseHandle((HANDLE)File.MappingHandle);
+		CloseHandle((HANDLE)File.FileHandle);
+		File = {};
+	}
+
+	uint32 APlatform::CaptureBacktrace(void** OutFrames, uint32 MaxFramesCount, uint32 FramesToSkip)
+	{
+		// The frame of this function is skipped as well.
+		return (uint32)RtlCaptureStackBackTrace((DWORD)(FramesToSkip + 1), (DWORD)MaxFramesCount, OutFrames, nullptr);
+	}
+
+	bool8 APlatform::GetSymbolName(const void* Address, char8* OutBuffer, uint64 BufferSize)
+	{
+		if (BufferSize == 0)
+		{
+			return false;
+		}
+
+		// DbgHelp isn't thread-safe, so all the calls into it are serialized.
+		static ASpinLock SymbolsLock;
+		static bool8 bAreSymbolsInitialized = false;
+		TScopedLock<ASpinLock> Lock(SymbolsLock);
+
+		HANDLE Process = GetCurrentProcess();
+		if (!bAreSymbolsInitialized)
+		{
+			SymSetOptions(SYMOPT_UNDNAME | SYMOPT_DEFERRED_LOADS);
+			SymInitialize(Process, nullptr, TRUE);
+			bAreSymbolsInitialized = true;
+		}
+
+		alignas(SYMBOL_INFO) uint8 SymbolStorage[sizeof(SYMBOL_INFO) + MAX_SYM_NAME];
+		SYMBOL_INFO* Symbol = (SYMBOL_INFO*)SymbolStorage;
+		memset(Symbol, 0, sizeof(SYMBOL_INFO));
+		Symbol->SizeOfStruct = sizeof(SYMBOL_INFO);
+		Symbol->MaxNameLen = MAX_SYM_NAME;
+
+		if (!SymFromAddr(Process, (DWORD64)Address, nullptr, Symbol))
+		{
+			return false;
+		}
+
+		uint64 NameLength = (uint64)Symbol->NameLen;
+		NameLength = NameLength < BufferSize - 1 ? NameLength : BufferSize - 1;
+		memcpy(OutBuffer, Symbol->Name, NameLength);
+		OutBuffer[NameLength] = 0;
+		return true;
+	}
+
+	void APlatform::EnumerateModuleRanges(PFN_ModuleRangeCallback Callback, void* UserData)
+	{
+		HANDLE Process = GetCurrentProcess();
+
+		HMODULE Modules[1024];
+		DWORD RequiredBytes = 0;
+		if (!K32EnumProcessModules(Process, Modules, sizeof(Modules), &RequiredBytes))
+		{
+			return;
+		}
+
+		uint32 ModulesCount = (uint32)(RequiredBytes / sizeof(HMODULE));
+		ModulesCount = ModulesCount < AE_ARRAY_LENGTH(Modules) ? ModulesCount : (uint32)AE_ARRAY_LENGTH(Modules);
+
+		for (uint32 Index = 0; Index < ModulesCount; Index++)
+		{
+			MODULEINFO Info;
+			char8 Path[MAX_PATH];
+			if (!K32GetModuleInformation(Process, Modules[Index], &Info, sizeof(Info)) || GetModuleFileNameA(Modules[Index], Path, MAX_PATH) == 0)
+			{
+				continue;
+			}
+
+			// The whole image is reported as a single range.
+			AModuleRange Range;
+			Range.Begin = (uintptr)Info.lpBaseOfDll;
+			Range.End = Range.Begin + Info.SizeOfImage;
+			Range.FileOffset = 0;
+			Range.Path = Path;
+			Callback(Range, UserData);
+		}
+	}
+
 	NODISCARD Time APlatform::GetSystemPerformanceTime()
 	{
 		LARGE_INTEGER performanceTimerNow;
@@ -117,6 +405,12 @@ namespace Apricot {
 		Sleep((DWORD)(duration.Miliseconds()));
 	}
 
+	uint64 APlatform::GetCurrentThreadId()
+	{
+		// Reads the thread's environment block, so there's nothing to cache.
+		return (uint64)::GetCurrentThreadId();
+	}
+
 	bool APlatform::IsConsoleAvailable()
 	{
 		return SWindowsPlatformData.bIsConsoleAttached;
@@ -0,0 +1,427 @@
+// Part of Apricot Engine. 2022-2022.
+// Submodule: Profiling
+
+#include "aepch.h"
+#include "AllocationRecorder.h"
+
+#include "Apricot/Core/Atomic.h"
+#include "Apricot/Core/Platform.h"
+#include "Apricot/Core/Memory/ApricotMemory.h"
+
+#include <stdio.h>
+
+namespace Apricot {
+
+#ifdef AE_ENABLE_MEMORY_RECORDING
+
+	/**
+	* The events buffered by a thread. The slot's lock is only contended when the recording is stopped, so taking it
+	*	on every event is cheap.
+	*/
+	struct ARecordingSlot
+	{
+		ASpinLock Lock;
+
+		/**
+		* The recording the slot was claimed in. 0 once the recording is stopped, so that the threads that still hold
+		*	the slot never touch its events again.
+		*/
+		TAtomic<uint64> Session;
+
+		AAllocationTraceEvent* Events;
+		uint64 EventsCount;
+	};
+
+	/**
+	* The calling thread's slot. Flushed when the thread exits, so that its last events aren't lost.
+	*/
+	struct AThreadRecordingState
+	{
+		uint64 Session = 0;
+
+		/**
+		* AEC_MEMORY_RECORDING_MAX_THREADS if all the slots were claimed, so the thread's events are dropped until the next recording.
+		*/
+		uint64 SlotIndex = 0;
+
+		~AThreadRecordingState();
+	};
+
+	static TAtomic<bool8> GbIsRecording = false;
+
+	/**
+	* Incremented by every 'Start'. The threads claim a new slot when they see a new session.
+	*/
+	static TAtomic<uint64> GRecordingSession;
+
+	static TAtomic<uint16> GNextArenaId;
+	static TAtomic<uint64> GDroppedEventsCount;
+
+	/**
+	* Serializes the writes to the file, the slot claims, and 'Start' and 'Stop'.
+	* When both locks are needed, the slot's lock is always taken first.
+	*/
+	static ASpinLock GRecorderLock;
+
+	static FILE* GRecordingFile = nullptr;
+	static Time GRecordingStartTime;
+	static uint64 GWrittenEventsCount = 0;
+
+	static ARecordingSlot GRecordingSlots[AEC_MEMORY_RECORDING_MAX_THREADS];
+	static uint64 GClaimedSlotsCount = 0;
+
+	/**
+	* The events of all the slots, reserved at 'Start'. The slot's part is committed when it is claimed.
+	*/
+	static AAllocationTraceEvent* GRecordingEvents = nullptr;
+
+	static thread_local AThreadRecordingState GThreadRecordingState;
+
+	namespace Utils {
+
+		static constexpr uint64 SlotEventsSize = AEC_MEMORY_RECORDING_BUFFER_EVENTS * sizeof(AAllocationTraceEvent);
+
+		/**
+		* Must be called with the slot's lock held.
+		*/
+		static void FlushSlot(ARecordingSlot& Slot)
+		{
+			TScopedLock<ASpinLock> Lock(GRecorderLock);
+
+			if (GRecordingFile && Slot.EventsCount > 0)
+			{
+				fwrite(Slot.Events, sizeof(AAllocationTraceEvent), Slot.EventsCount, GRecordingFile);
+				GWrittenEventsCount += Slot.EventsCount;
+			}
+			Slot.EventsCount = 0;
+		}
+
+		/**
+		* @returns False if the recording was stopped. The state's slot index is AEC_MEMORY_RECORDING_MAX_THREADS if
+		*	no slot could be claimed.
+		*/
+		static bool8 ClaimSlot(AThreadRecordingState& State)
+		{
+			TScopedLock<ASpinLock> Lock(GRecorderLock);
+
+			if (!GbIsRecording.Load(EMemoryOrder::Relaxed))
+			{
+				return false;
+			}
+
+			// Marks the thread, so that it doesn't try again on every event.
+			State.Session = GRecordingSession.Load(EMemoryOrder::Relaxed);
+			State.SlotIndex = AEC_MEMORY_RECORDING_MAX_THREADS;
+
+			if (GClaimedSlotsCount == AEC_MEMORY_RECORDING_MAX_THREADS)
+			{
+				return true;
+			}
+
+			AAllocationTraceEvent* Events = GRecordingEvents + GClaimedSlotsCount * AEC_MEMORY_RECORDING_BUFFER_EVENTS;
+			if (!APlatform::Commit(Events, SlotEventsSize))
+			{
+				return true;
+			}
+
+			// The slot was released by the previous recording, so no thread can be using its events.
+			ARecordingSlot& Slot = GRecordingSlots[GClaimedSlotsCount];
+			Slot.Events = Events;
+			Slot.EventsCount = 0;
+
+			State.SlotIndex = GClaimedSlotsCount++;
+			Slot.Session.Store(State.Session, EMemoryOrder::Release);
+			return true;
+		}
+
+		static void RecordEvent(uint16 ArenaId, EAllocationEventType Type, const void* Block, uint64 Size, uint64 Alignment)
+		{
+			if (!GbIsRecording.Load(EMemoryOrder::Acquire))
+			{
+				return;
+			}
+
+			AThreadRecordingState& State = GThreadRecordingState;
+			if (State.Session != GRecordingSession.Load(EMemoryOrder::Acquire) && !ClaimSlot(State))
+			{
+				return;
+			}
+			if (State.SlotIndex == AEC_MEMORY_RECORDING_MAX_THREADS)
+			{
+				GDroppedEventsCount.FetchAdd(1, EMemoryOrder::Relaxed);
+				return;
+			}
+
+			ARecordingSlot& Slot = GRecordingSlots[State.SlotIndex];
+			TScopedLock<ASpinLock> Lock(Slot.Lock);
+
+			if (Slot.Session.Load(EMemoryOrder::Relaxed) != State.Session)
+			{
+				return;
+			}
+
+			// Flushed before the event is added, so the last event stays in the buffer for 'SetLastAllocationHint'.
+			if (Slot.EventsCount == AEC_MEMORY_RECORDING_BUFFER_EVENTS)
+			{
+				FlushSlot(Slot);
+			}
+
+			AAllocationTraceEvent& Event = Slot.Events[Slot.EventsCount++];
+			Event.Timestamp = (uint64)APlatform::GetSystemPerformanceTime() - (uint64)GRecordingStartTime;
+			Event.Block = (uint64)(uintptr)Block;
+			Event.Size = Size;
+			Event.ArenaId = ArenaId;
+			Event.ThreadIndex = (uint16)State.SlotIndex;
+			Event.Type = Type;
+			Event.Hint = (uint8)EAllocatorHint::None;
+			Event.AlignmentLog2 = Alignment > 1 ? (uint8)FindLastSetBit(Alignment) : 0;
+			Event.Reserved = 0;
+		}
+
+		/**
+		* @returns nullptr if the recording started, otherwise the error.
+		*/
+		static const TChar* BeginRecording(const char8* FilePath)
+		{
+			TScopedLock<ASpinLock> Lock(GRecorderLock);
+
+			if (GbIsRecording.Load(EMemoryOrder::Relaxed))
+			{
+				return TEXT("A recording is already running!");
+			}
+
+			// The C runtime's file functions never allocate from GMalloc, so they can't recurse into the recorder.
+		#ifdef AE_COMPILER_MSVC
+			FILE* File = nullptr;
+			if (fopen_s(&File, FilePath, "wb") != 0)
+			{
+				File = nullptr;
+			}
+		#else
+			FILE* File = fopen(FilePath, "wb");
+		#endif
+			if (!File)
+			{
+				return TEXT("Failed to create the trace file!");
+			}
+
+			GRecordingEvents = (AAllocationTraceEvent*)APlatform::Reserve(AEC_MEMORY_RECORDING_MAX_THREADS * SlotEventsSize);
+			if (!GRecordingEvents)
+			{
+				fclose(File);
+				return TEXT("Failed to reserve the event buffers!");
+			}
+
+			AAllocationTraceHeader Header;
+			Header.EventSize = (uint32)sizeof(AAllocationTraceEvent);
+			fwrite(&Header, sizeof(Header), 1, File);
+
+			GRecordingFile = File;
+			GRecordingStartTime = APlatform::GetSystemPerformanceTime();
+			GWrittenEventsCount = 0;
+			GDroppedEventsCount.Store(0, EMemoryOrder::Relaxed);
+			GClaimedSlotsCount = 0;
+
+			GRecordingSession.FetchAdd(1, EMemoryOrder::Relaxed);
+			GbIsRecording.Store(true, EMemoryOrder::Release);
+			return nullptr;
+		}
+
+	}
+
+	AThreadRecordingState::~AThreadRecordingState()
+	{
+		if (Session == 0 || SlotIndex == AEC_MEMORY_RECORDING_MAX_THREADS)
+		{
+			return;
+		}
+
+		ARecordingSlot& Slot = GRecordingSlots[SlotIndex];
+		TScopedLock<ASpinLock> Lock(Slot.Lock);
+
+		if (Slot.Session.Load(EMemoryOrder::Relaxed) == Session)
+		{
+			Utils::FlushSlot(Slot);
+		}
+	}
+
+#endif // AE_ENABLE_MEMORY_RECORDING
+
+	bool8 AAllocationRecorder::Start(const char8* FilePath)
+	{
+#ifdef AE_ENABLE_MEMORY_RECORDING
+
+		// The errors are logged once the lock is released, because the log might allocate, which records an event.
+		const TChar* Error = Utils::BeginRecording(FilePath);
+		if (Error)
+		{
+			AE_CORE_ERROR(TEXT("AllocationRecorder - {}"), Error);
+			return false;
+		}
+		return true;
+
+#else
+
+		return false;
+
+#endif // AE_ENABLE_MEMORY_RECORDING
+	}
+
+	void AAllocationRecorder::Stop()
+	{
+#ifdef AE_ENABLE_MEMORY_RECORDING
+
+		uint64 ClaimedSlotsCount = 0;
+		{
+			TScopedLock<ASpinLock> Lock(GRecorderLock);
+
+			if (!GbIsRecording.Load(EMemoryOrder::Relaxed))
+			{
+				return;
+			}
+
+			// Once the flag is cleared under the lock, no slot can be claimed anymore.
+			GbIsRecording.Store(false, EMemoryOrder::Release);
+			ClaimedSlotsCount = GClaimedSlotsCount;
+		}
+
+		// Waits for the threads that are recording an event, then releases their slots.
+		for (uint64 Index = 0; Index < ClaimedSlotsCount; Index++)
+		{
+			ARecordingSlot& Slot = GRecordingSlots[Index];
+			TScopedLock<ASpinLock> Lock(Slot.Lock);
+
+			if (Slot.Session.Load(EMemoryOrder::Relaxed) != 0)
+			{
+				Utils::FlushSlot(Slot);
+				Slot.Session.Store(0, EMemoryOrder::Relaxed);
+			}
+		}
+
+		bool8 bSucceeded = false;
+		uint64 WrittenEventsCount = 0;
+		{
+			TScopedLock<ASpinLock> Lock(GRecorderLock);
+
+			bSucceeded = ferror(GRecordingFile) == 0;
+			bSucceeded = (fclose(GRecordingFile) == 0) && bSucceeded;
+			GRecordingFile = nullptr;
+			WrittenEventsCount = GWrittenEventsCount;
+
+			APlatform::Release(GRecordingEvents, AEC_MEMORY_RECORDING_MAX_THREADS * Utils::SlotEventsSize);
+			GRecordingEvents = nullptr;
+			GClaimedSlotsCount = 0;
+		}
+
+		if (!bSucceeded)
+		{
+			AE_CORE_ERROR(TEXT("AllocationRecorder - Failed to write the trace file!"));
+		}
+
+		uint64 DroppedEventsCount = GDroppedEventsCount.Load(EMemoryOrder::Relaxed);
+		if (DroppedEventsCount > 0)
+		{
+			AE_CORE_WARN(TEXT("AllocationRecorder - {} events were dropped, because too many threads were recording or their buffers couldn't be committed!"), DroppedEventsCount);
+		}
+		AE_CORE_INFO(TEXT("AllocationRecorder - Recorded {} events from {} threads."), WrittenEventsCount, ClaimedSlotsCount);
+
+#endif // AE_ENABLE_MEMORY_RECORDING
+	}
+
+	bool8 AAllocationRecorder::IsRecording()
+	{
+#ifdef AE_ENABLE_MEMORY_RECORDING
+
+		return GbIsRecording.Load(EMemoryOrder::Relaxed);
+
+#else
+
+		return false;
+
+#endif // AE_ENABLE_MEMORY_RECORDING
+	}
+
+	uint16 AAllocationRecorder::GenerateArenaId()
+	{
+#ifdef AE_ENABLE_MEMORY_RECORDING
+
+		// 0 is the heap's identifier.
+		uint16 ArenaId = GNextArenaId.FetchAdd(1, EMemoryOrder::Relaxed) + 1;
+		return ArenaId != 0 ? ArenaId : GNextArenaId.FetchAdd(1, EMemoryOrder::Relaxed) + 1;
+
+#else
+
+		return 0;
+
+#endif // AE_ENABLE_MEMORY_RECORDING
+	}
+
+	void AAllocationRecorder::RecordAllocation(uint16 ArenaId, const void* Block, uint64 Size, uint64 Alignment)
+	{
+#ifdef AE_ENABLE_MEMORY_RECORDING
+
+		Utils::RecordEvent(ArenaId, EAllocationEventType::Allocate, Block, Size, Alignment);
+
+#endif // AE_ENABLE_MEMORY_RECORDING
+	}
+
+	void AAllocationRecorder::RecordDeallocation(uint16 ArenaId, const void* Block, uint64 Size)
+	{
+#ifdef AE_ENABLE_MEMORY_RECORDING
+
+		Utils::RecordEvent(ArenaId, EAllocationEventType::Free, Block, Size, 0);
+
+#endif // AE_ENABLE_MEMORY_RECORDING
+	}
+
+	void AAllocationRecorder::RecordDeallocationOfAll(uint16 ArenaId)
+	{
+#ifdef AE_ENABLE_MEMORY_RECORDING
+
+		Utils::RecordEvent(ArenaId, EAllocationEventType::FreeAll, nullptr, 0, 0);
+
+#endif // AE_ENABLE_MEMORY_RECORDING
+	}
+
+	void AAllocationRecorder::RecordRewind(uint16 ArenaId, uint64 LiveBytes)
+	{
+#ifdef AE_ENABLE_MEMORY_RECORDING
+
+		Utils::RecordEvent(ArenaId, EAllocationEventType::Rewind, nullptr, LiveBytes, 0);
+
+#endif // AE_ENABLE_MEMORY_RECORDING
+	}
+
+	void AAllocationRecorder::SetLastAllocationHint(const void* Block, EAllocatorHint Hint)
+	{
+#ifdef AE_ENABLE_MEMORY_RECORDING
+
+		if (!GbIsRecording.Load(EMemoryOrder::Acquire))
+		{
+			return;
+		}
+
+		AThreadRecordingState& State = GThreadRecordingState;
+		if (State.Session != GRecordingSession.Load(EMemoryOrder::Acquire) || State.SlotIndex == AEC_MEMORY_RECORDING_MAX_THREADS)
+		{
+			return;
+		}
+
+		ARecordingSlot& Slot = GRecordingSlots[State.SlotIndex];
+		TScopedLock<ASpinLock> Lock(Slot.Lock);
+
+		if (Slot.Session.Load(EMemoryOrder::Relaxed) != State.Session || Slot.EventsCount == 0)
+		{
+			return;
+		}
+
+		AAllocationTraceEvent& Event = Slot.Events[Slot.EventsCount - 1];
+		if (Event.Type == EAllocationEventType::Allocate && Event.ArenaId == 0 && Event.Block == (uint64)(uintptr)Block)
+		{
+			Event.Hint = (uint8)Hint;
+		}
+
+#endif // AE_ENABLE_MEMORY_RECORDING
+	}
+
+}
@@ -0,0 +1,144 @@
+// Part of Apricot Engine. 2022-2022.
+// Submodule: Profiling
+
+#pragma once
+
+#include "Apricot/Core/Base.h"
+#include "Apricot/Core/Memory/ApricotAllocator.h"
+
+namespace Apricot {
+
+	enum class EAllocationEventType : uint8
+	{
+		Allocate = 0,
+		Free,
+
+		/**
+		* An arena's 'FreeAll'. Frees all the live allocations of the arena.
+		*/
+		FreeAll,
+
+		/**
+		* An arena's 'RewindTo'. Frees the newest live allocations of the arena, until its live bytes are the event's size.
+		*/
+		Rewind,
+
+		MaxEnumValue
+	};
+
+	/**
+	* The beginning of a trace file. The events follow it, until the end of the file.
+	*/
+	struct AAllocationTraceHeader
+	{
+		/**
+		* "AEALLOCT", in little endian.
+		*/
+		static constexpr uint64 TraceMagic = 0x54434F4C4C414541ull;
+		static constexpr uint32 TraceVersion = 1;
+
+		uint64 Magic = TraceMagic;
+		uint32 Version = TraceVersion;
+		uint32 EventSize = 0;
+	};
+
+	/**
+	* A single allocation event, as it is stored in the trace file.
+	* Every thread writes its events in batches, so the events of a thread are in order, but they are interleaved with
+	*	the other threads' in batches. Sort them by their timestamp to get the global order.
+	*/
+	struct AAllocationTraceEvent
+	{
+		/**
+		* Nanoseconds since the recording started.
+		*/
+		uint64 Timestamp;
+
+		/**
+		* Address of the allocation. Only meaningful to match a free with its allocation, because the addresses are reused.
+		*/
+		uint64 Block;
+
+		/**
+		* The requested size. The target live bytes for a 'Rewind', and 0 for a 'FreeAll'.
+		*/
+		uint64 Size;
+
+		/**
+		* 0 for the allocations made through GMalloc. The arenas are numbered in the order they are created, and the
+		*	numbers wrap around after 65535 arenas.
+		*/
+		uint16 ArenaId;
+
+		/**
+		* The threads are numbered in the order of their first event of the recording.
+		*/
+		uint16 ThreadIndex;
+
+		EAllocationEventType Type;
+
+		/**
+		* The EAllocatorHint of the heap allocations made through HeapAllocator. Always 'None' for the arenas.
+		*/
+		uint8 Hint;
+
+		uint8 AlignmentLog2;
+		uint8 Reserved;
+	};
+	AE_STATIC_ASSERT(sizeof(AAllocationTraceEvent) == 32, "The trace events should be 32 bytes!");
+
+	/**
+	* C++ Core Profiling Tool
+	*
+	* Records every allocation and free made through GMalloc and the arenas to a compact binary trace file, so that
+	*	the allocators can be tuned by replaying the real workload (see the replay in ApricotBench).
+	* Every thread buffers its events and writes them in batches, so the recording threads only contend for the file.
+	* It is fed by AMemoryProfiler and by the arenas' statistics functions. The buffers live directly in the platform's
+	*	virtual memory, so the recorder never allocates from GMalloc itself.
+	*
+	* Only active when AE_ENABLE_MEMORY_RECORDING is defined. Otherwise, all the functions do nothing.
+	*/
+	class APRICOT_API AAllocationRecorder
+	{
+	/* Constructors & Deconstructor */
+	private:
+		AAllocationRecorder() = delete;
+		AAllocationRecorder(const AAllocationRecorder&) = delete;
+		AAllocationRecorder& operator=(const AAllocationRecorder&) = delete;
+
+	/* Recording */
+	public:
+		/**
+		* Creates the trace file, or overwrites it, and starts recording the events of all the threads.
+		*
+		* @returns False if a recording is already running, if the file couldn't be created or AE_ENABLE_MEMORY_RECORDING isn't defined.
+		*/
+		static bool8 Start(const char8* FilePath);
+
+		/**
+		* Writes the events that are still buffered and closes the trace file. Can be called from any thread.
+		*/
+		static void Stop();
+
+		static bool8 IsRecording();
+
+		/**
+		* Returns a new arena identifier. Called once by every arena, when it is constructed.
+		*/
+		static uint16 GenerateArenaId();
+
+	/* Events */
+	public:
+		static void RecordAllocation(uint16 ArenaId, const void* Block, uint64 Size, uint64 Alignment);
+		static void RecordDeallocation(uint16 ArenaId, const void* Block, uint64 Size);
+		static void RecordDeallocationOfAll(uint16 ArenaId);
+		static void RecordRewind(uint16 ArenaId, uint64 LiveBytes);
+
+		/**
+		* Sets the hint of the calling thread's last event, if it is the heap allocation of the block. Called by
+		*	HeapAllocator, right after the block is allocated through GMalloc.
+		*/
+		static void SetLastAllocationHint(const void* Block, EAllocatorHint Hint);
+	};
+
+}
@@ -0,0 +1,405 @@
+// Part of Apricot Engine. 2022-2022.
+// Submodule: Profiling
+
+#include "aepch.h"
+#include "AllocationRegistry.h"
+
+#include "MemoryProfiler.h"
+
+#include "Apricot/Core/Atomic.h"
+#include "Apricot/Core/Platform.h"
+#include "Apricot/Core/Memory/ApricotMemory.h"
+
+#include <stdio.h>
+
+namespace Apricot {
+
+#ifdef AE_ENABLE_MEMORY_LEAK_CHECK
+
+	/**
+	* The call site array can't be empty, even if the call sites aren't captured.
+	*/
+	static constexpr uint32 GCallSiteFramesCapacity = AEC_MEMORY_LEAK_CHECK_CALL_SITE_FRAMES > 0 ? AEC_MEMORY_LEAK_CHECK_CALL_SITE_FRAMES : 1;
+
+	struct ARegisteredBlock
+	{
+		void* Block = nullptr;
+		uint64 Size = 0;
+		EAllocatorHint Hint = EAllocatorHint::None;
+		uint32 CallSiteFramesCount = 0;
+
+		/**
+		* Return addresses, innermost first. The first one is in the function that called GMalloc (or HeapAllocator).
+		*/
+		void* CallSite[GCallSiteFramesCapacity] = {};
+	};
+
+	/**
+	* Open addressing hash table with linear probing. Deletions shift the following entries back, so there are no tombstones.
+	* The table is doubled when it gets half full. Its memory comes zeroed from the platform, which makes every entry empty.
+	*/
+	static ARegisteredBlock* GRegisteredBlocks = nullptr;
+	static uint64 GRegisteredBlocksCapacity = 0;
+	static uint64 GRegisteredBlocksCount = 0;
+	static uint64 GRegisteredBlocksMemorySize = 0;
+
+	/**
+	* Blocks that couldn't be registered, because the table couldn't grow. The report is incomplete if it isn't 0.
+	*/
+	static uint64 GDroppedBlocksCount = 0;
+
+	static ASpinLock GRegistryLock;
+
+	namespace Utils {
+
+		static constexpr uint64 InitialRegistryCapacity = 4096;
+
+		FORCEINLINE static uint64 GetRegisteredBlockHome(const void* Block, uint64 Capacity)
+		{
+			// The low bits of a block's address are mostly zero, because of its alignment.
+			return ((((uint64)Block >> 4) * 0x9E3779B97F4A7C15ull) >> 32) & (Capacity - 1);
+		}
+
+		/**
+		* @returns The slot of the block or the capacity, if the block isn't registered.
+		*/
+		static uint64 FindRegisteredBlock(const void* Block)
+		{
+			if (GRegisteredBlocksCapacity == 0)
+			{
+				return 0;
+			}
+
+			uint64 Slot = GetRegisteredBlockHome(Block, GRegisteredBlocksCapacity);
+			while (GRegisteredBlocks[Slot].Block != Block)
+			{
+				if (GRegisteredBlocks[Slot].Block == nullptr)
+				{
+					return GRegisteredBlocksCapacity;
+				}
+				Slot = (Slot + 1) & (GRegisteredBlocksCapacity - 1);
+			}
+			return Slot;
+		}
+
+		static void InsertRegisteredBlock(ARegisteredBlock* Table, uint64 Capacity, const ARegisteredBlock& Entry)
+		{
+			uint64 Slot = GetRegisteredBlockHome(Entry.Block, Capacity);
+			while (Table[Slot].Block != nullptr)
+			{
+				Slot = (Slot + 1) & (Capacity - 1);
+			}
+			Table[Slot] = Entry;
+		}
+
+		static void RemoveRegisteredBlock(uint64 Slot)
+		{
+			uint64 Mask = GRegisteredBlocksCapacity - 1;
+
+			// Backward shift deletion: every following entry of the cluster that may live in the freed slot is moved into it.
+			uint64 FreeSlot = Slot;
+			uint64 NextSlot = (Slot + 1) & Mask;
+			while (GRegisteredBlocks[NextSlot].Block != nullptr)
+			{
+				uint64 NextHome = GetRegisteredBlockHome(GRegisteredBlocks[NextSlot].Block, GRegisteredBlocksCapacity);
+				if (((FreeSlot - NextHome) & Mask) < ((NextSlot - NextHome) & Mask))
+				{
+					GRegisteredBlocks[FreeSlot] = GRegisteredBlocks[NextSlot];
+					FreeSlot = NextSlot;
+				}
+				NextSlot = (NextSlot + 1) & Mask;
+			}
+			GRegisteredBlocks[FreeSlot] = ARegisteredBlock();
+
+			GRegisteredBlocksCount--;
+		}
+
+		/**
+		* Doubles the table. Must be called with the registry lock held.
+		*
+		* @returns False if the platform couldn't provide the memory. The old table is kept in that case.
+		*/
+		static bool8 GrowRegistry()
+		{
+			uint64 NewCapacity = GRegisteredBlocksCapacity > 0 ? GRegisteredBlocksCapacity * 2 : InitialRegistryCapacity;
+			uint64 NewMemorySize = NewCapacity * sizeof(ARegisteredBlock);
+			NewMemorySize += GetAlignmentOffset(NewMemorySize, APlatform::GetPageSize());
+
+			ARegisteredBlock* NewBlocks = (ARegisteredBlock*)APlatform::Reserve(NewMemorySize);
+			if (!NewBlocks)
+			{
+				return false;
+			}
+			if (!APlatform::Commit(NewBlocks, NewMemorySize))
+			{
+				APlatform::Release(NewBlocks, NewMemorySize);
+				return false;
+			}
+
+			for (uint64 Slot = 0; Slot < GRegisteredBlocksCapacity; Slot++)
+			{
+				if (GRegisteredBlocks[Slot].Block != nullptr)
+				{
+					InsertRegisteredBlock(NewBlocks, NewCapacity, GRegisteredBlocks[Slot]);
+				}
+			}
+
+			if (GRegisteredBlocks)
+			{
+				APlatform::Release(GRegisteredBlocks, GRegisteredBlocksMemorySize);
+			}
+
+			GRegisteredBlocks = NewBlocks;
+			GRegisteredBlocksCapacity = NewCapacity;
+			GRegisteredBlocksMemorySize = NewMemorySize;
+			return true;
+		}
+
+		/**
+		* The symbol names and the addresses are narrow strings, but the logger expects TChar strings.
+		*/
+		static void AppendNarrowString(TChar* Buffer, uint64 BufferSize, uint64& Offset, const char8* String)
+		{
+			while (*String && Offset + 1 < BufferSize)
+			{
+				Buffer[Offset++] = (TChar)*String++;
+			}
+			Buffer[Offset] = 0;
+		}
+
+		static void FormatCallSite(const ARegisteredBlock& Entry, TChar* Buffer, uint64 BufferSize)
+		{
+			uint64 Offset = 0;
+			Buffer[0] = 0;
+
+			char8 Name[256];
+			for (uint32 Frame = 0; Frame < Entry.CallSiteFramesCount; Frame++)
+			{
+				if (Frame > 0)
+				{
+					AppendNarrowString(Buffer, BufferSize, Offset, " <- ");
+				}
+
+				// Return addresses point after the call, which might already be the next function.
+				if (!APlatform::GetSymbolName((const uint8*)Entry.CallSite[Frame] - 1, Name, sizeof(Name)))
+				{
+					snprintf(Name, sizeof(Name), "0x%llx", (unsigned long long)(uintptr)Entry.CallSite[Frame]);
+				}
+				AppendNarrowString(Buffer, BufferSize, Offset, Name);
+			}
+
+			if (Entry.CallSiteFramesCount == 0)
+			{
+				AppendNarrowString(Buffer, BufferSize, Offset, "Unknown");
+			}
+		}
+
+	}
+
+#endif // AE_ENABLE_MEMORY_LEAK_CHECK
+
+	void AAllocationRegistry::RegisterBlock(void* Block, uint64 Size)
+	{
+#ifdef AE_ENABLE_MEMORY_LEAK_CHECK
+
+		ARegisteredBlock Entry;
+		Entry.Block = Block;
+		Entry.Size = Size;
+
+	#if AEC_MEMORY_LEAK_CHECK_CALL_SITE_FRAMES > 0
+		// Skips this function, AMemoryProfiler's submit function and the platform allocator. Captured before taking the lock, because it is slow.
+		Entry.CallSiteFramesCount = APlatform::CaptureBacktrace(Entry.CallSite, AEC_MEMORY_LEAK_CHECK_CALL_SITE_FRAMES, 3);
+	#endif
+
+		TScopedLock<ASpinLock> Lock(GRegistryLock);
+
+		if ((GRegisteredBlocksCount + 1) * 2 > GRegisteredBlocksCapacity && !Utils::GrowRegistry())
+		{
+			GDroppedBlocksCount++;
+			return;
+		}
+
+		Utils::InsertRegisteredBlock(GRegisteredBlocks, GRegisteredBlocksCapacity, Entry);
+		GRegisteredBlocksCount++;
+
+#endif // AE_ENABLE_MEMORY_LEAK_CHECK
+	}
+
+	void AAllocationRegistry::UnregisterBlock(void* Block)
+	{
+#ifdef AE_ENABLE_MEMORY_LEAK_CHECK
+
+		TScopedLock<ASpinLock> Lock(GRegistryLock);
+
+		uint64 Slot = Utils::FindRegisteredBlock(Block);
+		if (Slot < GRegisteredBlocksCapacity)
+		{
+			Utils::RemoveRegisteredBlock(Slot);
+		}
+
+#endif // AE_ENABLE_MEMORY_LEAK_CHECK
+	}
+
+	void AAllocationRegistry::MoveBlock(void* OldBlock, void* NewBlock, uint64 NewSize)
+	{
+#ifdef AE_ENABLE_MEMORY_LEAK_CHECK
+
+		TScopedLock<ASpinLock> Lock(GRegistryLock);
+
+		uint64 Slot = Utils::FindRegisteredBlock(OldBlock);
+		if (Slot == GRegisteredBlocksCapacity)
+		{
+			return;
+		}
+
+		ARegisteredBlock Entry = GRegisteredBlocks[Slot];
+		Entry.Block = NewBlock;
+		Entry.Size = NewSize;
+
+		if (OldBlock == NewBlock)
+		{
+			GRegisteredBlocks[Slot] = Entry;
+			return;
+		}
+
+		// The table can't grow here, because an entry is removed before the new one is inserted.
+		Utils::RemoveRegisteredBlock(Slot);
+		Utils::InsertRegisteredBlock(GRegisteredBlocks, GRegisteredBlocksCapacity, Entry);
+		GRegisteredBlocksCount++;
+
+#endif // AE_ENABLE_MEMORY_LEAK_CHECK
+	}
+
+	void AAllocationRegistry::SetBlockHint(void* Block, EAllocatorHint Hint)
+	{
+#ifdef AE_ENABLE_MEMORY_LEAK_CHECK
+
+		TScopedLock<ASpinLock> Lock(GRegistryLock);
+
+		uint64 Slot = Utils::FindRegisteredBlock(Block);
+		if (Slot < GRegisteredBlocksCapacity)
+		{
+			GRegisteredBlocks[Slot].Hint = Hint;
+		}
+
+#endif // AE_ENABLE_MEMORY_LEAK_CHECK
+	}
+
+	void AAllocationRegistry::TakeCensus(AAllocationCensus& OutCensus)
+	{
+		OutCensus = AAllocationCensus();
+
+#ifdef AE_ENABLE_MEMORY_LEAK_CHECK
+
+		TScopedLock<ASpinLock> Lock(GRegistryLock);
+
+		for (uint64 Slot = 0; Slot < GRegisteredBlocksCapacity; Slot++)
+		{
+			const ARegisteredBlock& Entry = GRegisteredBlocks[Slot];
+			if (Entry.Block == nullptr)
+			{
+				continue;
+			}
+
+			OutCensus.BlocksCount++;
+			OutCensus.Bytes += Entry.Size;
+			OutCensus.HintBlocksCount[(uint16)Entry.Hint]++;
+			OutCensus.HintBytes[(uint16)Entry.Hint] += Entry.Size;
+		}
+
+#endif // AE_ENABLE_MEMORY_LEAK_CHECK
+	}
+
+	uint64 AAllocationRegistry::ReportOutstandingBlocks()
+	{
+#ifdef AE_ENABLE_MEMORY_LEAK_CHECK
+
+		AAllocationCensus Census;
+		TakeCensus(Census);
+
+		// The reported entries are copied, so that the lock isn't held while the call sites are symbolized and logged.
+		ARegisteredBlock Entries[AEC_MEMORY_LEAK_REPORT_MAX_BLOCKS];
+		uint64 EntriesCount = 0;
+		uint64 DroppedBlocksCount = 0;
+		{
+			TScopedLock<ASpinLock> Lock(GRegistryLock);
+
+			for (uint64 Slot = 0; Slot < GRegisteredBlocksCapacity && EntriesCount < AEC_MEMORY_LEAK_REPORT_MAX_BLOCKS; Slot++)
+			{
+				if (GRegisteredBlocks[Slot].Block != nullptr)
+				{
+					Entries[EntriesCount++] = GRegisteredBlocks[Slot];
+				}
+			}
+			DroppedBlocksCount = GDroppedBlocksCount;
+		}
+
+		if (DroppedBlocksCount > 0)
+		{
+			AE_CORE_WARN(TEXT("AllocationRegistry - {} blocks were never registered, because the registry couldn't grow! The report is incomplete."), DroppedBlocksCount);
+		}
+
+		if (Census.BlocksCount == 0)
+		{
+			return 0;
+		}
+
+		AE_CORE_WARN(TEXT("AllocationRegistry - {} heap blocks ({} bytes) are still alive!"), Census.BlocksCount, Census.Bytes);
+		for (uint16 Hint = 0; Hint < (uint16)EAllocatorHint::MaxEnumValue; Hint++)
+		{
+			if (Census.HintBlocksCount[Hint] > 0)
+			{
+				AE_CORE_WARN(TEXT("    Hint '{}': {} blocks, {} bytes"), AMemoryProfiler::GetAllocatorHintName((EAllocatorHint)Hint), Census.HintBlocksCount[Hint], Census.HintBytes[Hint]);
+			}
+		}
+
+		TChar Address[32];
+		TChar CallSite[2048];
+		char8 NarrowAddress[32];
+		for (uint64 Index = 0; Index < EntriesCount; Index++)
+		{
+			snprintf(NarrowAddress, sizeof(NarrowAddress), "0x%llx", (unsigned long long)(uintptr)Entries[Index].Block);
+			uint64 Offset = 0;
+			Utils::AppendNarrowString(Address, AE_ARRAY_LENGTH(Address), Offset, NarrowAddress);
+
+			Utils::FormatCallSite(Entries[Index], CallSite, AE_ARRAY_LENGTH(CallSite));
+
+			AE_CORE_WARN(TEXT("    {} bytes at {}, Hint '{}', Call site: {}"), Entries[Index].Size, (const TChar*)Address,
+				AMemoryProfiler::GetAllocatorHintName(Entries[Index].Hint), (const TChar*)CallSite);
+		}
+
+		if (Census.BlocksCount > EntriesCount)
+		{
+			AE_CORE_WARN(TEXT("    ... and {} more blocks."), Census.BlocksCount - EntriesCount);
+		}
+
+		return Census.BlocksCount;
+
+#else
+
+		return 0;
+
+#endif // AE_ENABLE_MEMORY_LEAK_CHECK
+	}
+
+	void AAllocationRegistry::Destroy()
+	{
+#ifdef AE_ENABLE_MEMORY_LEAK_CHECK
+
+		TScopedLock<ASpinLock> Lock(GRegistryLock);
+
+		if (GRegisteredBlocks)
+		{
+			APlatform::Release(GRegisteredBlocks, GRegisteredBlocksMemorySize);
+		}
+
+		GRegisteredBlocks = nullptr;
+		GRegisteredBlocksCapacity = 0;
+		GRegisteredBlocksCount = 0;
+		GRegisteredBlocksMemorySize = 0;
+		GDroppedBlocksCount = 0;
+
+#endif // AE_ENABLE_MEMORY_LEAK_CHECK
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,78 @@
+// Part of Apricot Engine. 2022-2022.
+// Submodule: Profiling
+
+#pragma once
+
+#include "Apricot/Core/Base.h"
+#include "Apricot/Core/Memory/ApricotAllocator.h"
+
+namespace Apricot {
+
+	/**
+	* Number and size of the registered blocks, in total and broken down by their allocator hint.
+	*/
+	struct AAllocationCensus
+	{
+		uint64 BlocksCount = 0;
+		uint64 Bytes = 0;
+
+		uint64 HintBlocksCount[(uint16)EAllocatorHint::MaxEnumValue] = {};
+		uint64 HintBytes[(uint16)EAllocatorHint::MaxEnumValue] = {};
+	};
+
+	/**
+	* C++ Core Profiling Tool
+	*
+	* Registry of the blocks allocated through GMalloc that are still alive, kept in an open addressing hash table keyed by their address.
+	* It is fed by AMemoryProfiler and checked by ApricotMemoryDestroy, which reports the blocks that were never freed.
+	* The table lives directly in the platform's virtual memory, so the registry never allocates from GMalloc itself.
+	*
+	* Only active when AE_ENABLE_MEMORY_LEAK_CHECK is defined. Otherwise, all the functions do nothing.
+	*/
+	class APRICOT_API AAllocationRegistry
+	{
+	/* Constructors & Deconstructor */
+	private:
+		AAllocationRegistry() = delete;
+		AAllocationRegistry(const AAllocationRegistry&) = delete;
+		AAllocationRegistry& operator=(const AAllocationRegistry&) = delete;
+
+	/* Registration */
+	public:
+		/**
+		* Registers a new block, with the 'None' hint. Captures the call site, if AEC_MEMORY_LEAK_CHECK_CALL_SITE_FRAMES isn't 0.
+		* Must be called from the submit function of AMemoryProfiler, because the frames it skips are counted from there.
+		*/
+		static void RegisterBlock(void* Block, uint64 Size);
+
+		static void UnregisterBlock(void* Block);
+
+		/**
+		* Moves the entry of a reallocated block to its new address, keeping its hint and its call site.
+		*/
+		static void MoveBlock(void* OldBlock, void* NewBlock, uint64 NewSize);
+
+		/**
+		* Sets the hint of a registered block. Called by HeapAllocator, after the block is allocated through GMalloc.
+		*/
+		static void SetBlockHint(void* Block, EAllocatorHint Hint);
+
+	/* Reporting */
+	public:
+		static void TakeCensus(AAllocationCensus& OutCensus);
+
+		/**
+		* Logs the census of the registered blocks, followed by the first AEC_MEMORY_LEAK_REPORT_MAX_BLOCKS of them, with their call sites.
+		* Logs nothing if no block is registered.
+		*
+		* @returns The number of registered blocks.
+		*/
+		static uint64 ReportOutstandingBlocks();
+
+		/**
+		* Returns the table's memory to the system. The blocks allocated afterwards are registered in a new table.
+		*/
+		static void Destroy();
+	};
+
+}
@@ -0,0 +1,304 @@
+// Part of Apricot Engine. 2022-2022.
+// Submodule: Profiling
+
+#include "aepch.h"
+#include "MemoryBudgets.h"
+
+#include "Apricot/Core/Atomic.h"
+#include "Apricot/Core/CrashReporter.h"
+
+namespace Apricot {
+
+#ifdef AE_ENABLE_MEMORY_BUDGETS
+
+	struct ANamedArenaBudget
+	{
+		const TChar* DebugName = nullptr;
+		AMemoryBudget Budget;
+	};
+
+	static AMemoryBudgetState GHintBudgetStates[(uint16)EAllocatorHint::MaxEnumValue];
+	static AMemoryArena::EFailureMode GHintFailureModes[(uint16)EAllocatorHint::MaxEnumValue];
+
+	static ANamedArenaBudget GArenaBudgets[AEC_MEMORY_BUDGETS_MAX_ARENAS];
+	static uint64 GArenaBudgetsCount = 0;
+	static ASpinLock GArenaBudgetsLock;
+
+	static AMemoryBudgetState GProcessBudgetState;
+	static AMemoryArena::EFailureMode GProcessFailureMode = AMemoryArena::EFailureMode::Error;
+	static APlatform::AProcessMemoryUsage GProcessUsage;
+	static uint64 GProcessPollCountdown = 0;
+
+	namespace Utils {
+
+		static bool8 AreNamesEqual(const TChar* A, const TChar* B)
+		{
+			while (*A && *A == *B)
+			{
+				A++;
+				B++;
+			}
+			return *A == *B;
+		}
+
+		static void ReportBudgetLevel(EMemoryBudgetLevel Level, const TChar* Name, AMemoryArena* Arena, uint64 UsedBytes,
+			const AMemoryBudgetState& State, AMemoryArena::EFailureMode FailureMode)
+		{
+			if (Level == EMemoryBudgetLevel::Warning)
+			{
+				AE_CORE_WARN(TEXT("MemoryBudgets - '{}' uses {} bytes, over its warning threshold of {} bytes!"), Name, UsedBytes, State.GetWarningBytes());
+				return;
+			}
+			if (Level != EMemoryBudgetLevel::Exceeded)
+			{
+				return;
+			}
+
+			// Budgets might be exceeded by allocations made before the crash reporter exists.
+			if (GCrashReporter)
+			{
+				GCrashReporter->MemoryState.Arena = Arena;
+				GCrashReporter->MemoryState.BudgetName = Name;
+				GCrashReporter->MemoryState.Size = UsedBytes;
+				GCrashReporter->MemoryState.BudgetSize = State.GetLimitBytes();
+				GCrashReporter->SubmitArenaFailure(ACrashReporter::EMemoryOperation::Allocate, EMemoryError::BudgetExceeded);
+			}
+
+			switch (FailureMode)
+			{
+				case AMemoryArena::EFailureMode::Assert:
+					AE_CORE_RASSERT_NO_ENTRY();
+					break;
+				case AMemoryArena::EFailureMode::Error:
+					AE_CORE_ERROR(TEXT("MemoryBudgets - '{}' exceeded its budget of {} bytes!"), Name, State.GetLimitBytes());
+					break;
+				case AMemoryArena::EFailureMode::Ignore:
+					// The exceeded budget was only reported to the crash reporter above, and the allocation goes on as usual.
+					break;
+				default:
+					break;
+			}
+		}
+
+		static void ApplyNamedArenaBudget(AMemoryArena* Arena, const TChar* DebugName, void* UserData)
+		{
+			const ANamedArenaBudget* NamedBudget = (const ANamedArenaBudget*)UserData;
+			if (AreNamesEqual(NamedBudget->DebugName, DebugName))
+			{
+				Arena->SetNamedBudget(NamedBudget->Budget.LimitBytes, NamedBudget->Budget.WarningBytes);
+			}
+		}
+
+		static void LogBudgetUsage(const TChar* Name, uint64 UsedBytes, uint64 PeakBytes, const AMemoryBudgetState& State)
+		{
+			AE_CORE_INFO(TEXT("    {}: Used {} / Peak {} bytes, Limit {} / Warning {} bytes"), Name, UsedBytes, PeakBytes, State.GetLimitBytes(), State.GetWarningBytes());
+		}
+
+	}
+
+#endif // AE_ENABLE_MEMORY_BUDGETS
+
+	void AMemoryBudgets::SetHintBudget(EAllocatorHint Hint, const AMemoryBudget& Budget)
+	{
+#ifdef AE_ENABLE_MEMORY_BUDGETS
+
+		GHintFailureModes[(uint16)Hint] = Budget.FailureMode;
+		GHintBudgetStates[(uint16)Hint].Set(Budget.LimitBytes, Budget.WarningBytes);
+
+#endif // AE_ENABLE_MEMORY_BUDGETS
+	}
+
+	void AMemoryBudgets::SetArenaBudget(const TChar* DebugName, const AMemoryBudget& Budget)
+	{
+#ifdef AE_ENABLE_MEMORY_BUDGETS
+
+		{
+			TScopedLock<ASpinLock> Lock(GArenaBudgetsLock);
+
+			bool8 bIsRegistered = false;
+			for (uint64 Index = 0; Index < GArenaBudgetsCount; Index++)
+			{
+				if (Utils::AreNamesEqual(GArenaBudgets[Index].DebugName, DebugName))
+				{
+					GArenaBudgets[Index].Budget = Budget;
+					bIsRegistered = true;
+					break;
+				}
+			}
+
+			if (!bIsRegistered)
+			{
+				if (GArenaBudgetsCount >= AEC_MEMORY_BUDGETS_MAX_ARENAS)
+				{
+					AE_CORE_WARN(TEXT("MemoryBudgets - Too many arena budgets! The budget of '{}' is ignored."), DebugName);
+					return;
+				}
+				GArenaBudgets[GArenaBudgetsCount++] = { DebugName, Budget };
+			}
+		}
+
+		// The arenas that register from now on pick the budget up by themselves. The lock of the budgets is released first,
+		//	so that it is never held together with the memory profiler's lock.
+		ANamedArenaBudget NamedBudget = { DebugName, Budget };
+		AMemoryProfiler::EnumerateArenas(Utils::ApplyNamedArenaBudget, &NamedBudget);
+
+#endif // AE_ENABLE_MEMORY_BUDGETS
+	}
+
+	void AMemoryBudgets::SetProcessBudget(const AMemoryBudget& Budget)
+	{
+#ifdef AE_ENABLE_MEMORY_BUDGETS
+
+		GProcessFailureMode = Budget.FailureMode;
+		GProcessBudgetState.Set(Budget.LimitBytes, Budget.WarningBytes);
+		GProcessPollCountdown = 0;
+
+#endif // AE_ENABLE_MEMORY_BUDGETS
+	}
+
+	void AMemoryBudgets::Update()
+	{
+#ifdef AE_ENABLE_MEMORY_BUDGETS
+
+		if (GProcessPollCountdown > 0)
+		{
+			GProcessPollCountdown--;
+			return;
+		}
+		GProcessPollCountdown = AEC_MEMORY_BUDGETS_PROCESS_POLL_FRAMES - 1;
+
+		if (!APlatform::GetProcessMemoryUsage(GProcessUsage))
+		{
+			return;
+		}
+
+		if (GProcessBudgetState.NeedsUpdate(GProcessUsage.ResidentBytes))
+		{
+			EMemoryBudgetLevel Level = GProcessBudgetState.Update(GProcessUsage.ResidentBytes);
+			Utils::ReportBudgetLevel(Level, TEXT("Process"), nullptr, GProcessUsage.ResidentBytes, GProcessBudgetState, GProcessFailureMode);
+		}
+
+#endif // AE_ENABLE_MEMORY_BUDGETS
+	}
+
+	APlatform::AProcessMemoryUsage AMemoryBudgets::GetProcessUsage()
+	{
+#ifdef AE_ENABLE_MEMORY_BUDGETS
+
+		return GProcessUsage;
+
+#else
+
+		return {};
+
+#endif // AE_ENABLE_MEMORY_BUDGETS
+	}
+
+	void AMemoryBudgets::GetArenaUsage(const AMemoryArena* Arena, AArenaBudgetUsage& OutUsage)
+	{
+		OutUsage.CommittedBytes = Arena->GetTotalSize();
+
+#ifdef AE_ENABLE_MEMORY_BUDGETS
+
+		const AMemoryBudgetState& State = Arena->GetBudgetState();
+		OutUsage.UsedBytes = Arena->GetStats().GetLiveBytes();
+		OutUsage.LimitBytes = State.GetLimitBytes();
+		OutUsage.WarningBytes = State.GetWarningBytes();
+		OutUsage.Level = State.GetLevel();
+
+#endif // AE_ENABLE_MEMORY_BUDGETS
+	}
+
+	void AMemoryBudgets::LogReport(const AMemoryStatsSnapshot& Snapshot)
+	{
+#ifdef AE_ENABLE_MEMORY_BUDGETS
+
+		AE_CORE_INFO(TEXT("MemoryBudgets - Process:"));
+		Utils::LogBudgetUsage(TEXT("Resident"), GProcessUsage.ResidentBytes, GProcessUsage.PeakResidentBytes, GProcessBudgetState);
+
+		AE_CORE_INFO(TEXT("MemoryBudgets - Heap Allocator Hints:"));
+		for (uint16 Hint = 0; Hint < (uint16)EAllocatorHint::MaxEnumValue; Hint++)
+		{
+			if (GHintBudgetStates[Hint].IsSet())
+			{
+				const AAllocationStatsSnapshot& Stats = Snapshot.Hints[Hint];
+				Utils::LogBudgetUsage(AMemoryProfiler::GetAllocatorHintName((EAllocatorHint)Hint), Stats.LiveBytes, Stats.PeakBytes, GHintBudgetStates[Hint]);
+			}
+		}
+
+		AE_CORE_INFO(TEXT("MemoryBudgets - Arenas:"));
+		TScopedLock<ASpinLock> Lock(GArenaBudgetsLock);
+
+		for (uint64 Index = 0; Index < Snapshot.ArenasCount; Index++)
+		{
+			const AMemoryStatsSnapshot::AArenaEntry& Entry = Snapshot.Arenas[Index];
+			for (uint64 BudgetIndex = 0; BudgetIndex < GArenaBudgetsCount; BudgetIndex++)
+			{
+				if (Utils::AreNamesEqual(GArenaBudgets[BudgetIndex].DebugName, Entry.DebugName))
+				{
+					AMemoryBudgetState State;
+					State.Set(GArenaBudgets[BudgetIndex].Budget.LimitBytes, GArenaBudgets[BudgetIndex].Budget.WarningBytes);
+					Utils::LogBudgetUsage(Entry.DebugName, Entry.Stats.LiveBytes, Entry.Stats.PeakBytes, State);
+					break;
+				}
+			}
+		}
+
+#endif // AE_ENABLE_MEMORY_BUDGETS
+	}
+
+	void AMemoryBudgets::SubmitHintUsage(EAllocatorHint Hint, uint64 UsedBytes)
+	{
+#ifdef AE_ENABLE_MEMORY_BUDGETS
+
+		AMemoryBudgetState& State = GHintBudgetStates[(uint16)Hint];
+		EMemoryBudgetLevel Level = State.Update(UsedBytes);
+		Utils::ReportBudgetLevel(Level, AMemoryProfiler::GetAllocatorHintName(Hint), nullptr, UsedBytes, State, GHintFailureModes[(uint16)Hint]);
+
+#endif // AE_ENABLE_MEMORY_BUDGETS
+	}
+
+	AMemoryBudgetState& AMemoryBudgets::GetHintBudgetState(EAllocatorHint Hint)
+	{
+#ifdef AE_ENABLE_MEMORY_BUDGETS
+
+		return GHintBudgetStates[(uint16)Hint];
+
+#else
+
+		static AMemoryBudgetState SEmptyState;
+		return SEmptyState;
+
+#endif // AE_ENABLE_MEMORY_BUDGETS
+	}
+
+	void AMemoryBudgets::SubmitArenaUsage(AMemoryArena* Arena, AMemoryBudgetState& State, uint64 UsedBytes)
+	{
+#ifdef AE_ENABLE_MEMORY_BUDGETS
+
+		EMemoryBudgetLevel Level = State.Update(UsedBytes);
+		Utils::ReportBudgetLevel(Level, Arena->GetDebugName(), Arena, UsedBytes, State, Arena->GetFailureMode());
+
+#endif // AE_ENABLE_MEMORY_BUDGETS
+	}
+
+	void AMemoryBudgets::ApplyArenaBudget(const AMemoryArena* Arena, AMemoryBudgetState& State)
+	{
+#ifdef AE_ENABLE_MEMORY_BUDGETS
+
+		TScopedLock<ASpinLock> Lock(GArenaBudgetsLock);
+
+		const TChar* DebugName = Arena->GetDebugName();
+		for (uint64 Index = 0; Index < GArenaBudgetsCount; Index++)
+		{
+			if (Utils::AreNamesEqual(GArenaBudgets[Index].DebugName, DebugName))
+			{
+				State.Set(GArenaBudgets[Index].Budget.LimitBytes, GArenaBudgets[Index].Budget.WarningBytes);
+				return;
+			}
+		}
+
+#endif // AE_ENABLE_MEMORY_BUDGETS
+	}
+
+}
@@ -0,0 +1,131 @@
+// Part of Apricot Engine. 2022-2022.
+// Submodule: Profiling
+
+#pragma once
+
+#include "Apricot/Core/Base.h"
+#include "Apricot/Core/Platform.h"
+#include "Apricot/Core/Memory/ApricotMemory.h"
+
+#include "MemoryProfiler.h"
+
+namespace Apricot {
+
+	/**
+	* Memory budget of an allocator hint, of the arenas with a given debug name or of the whole process.
+	*/
+	struct AMemoryBudget
+	{
+		/**
+		* Hard limit of the used bytes. Crossing it is reported through ACrashReporter::SubmitArenaFailure, as 'BudgetExceeded'. 0 disables it.
+		*/
+		uint64 LimitBytes = 0;
+
+		/**
+		* Crossing it only logs a warning. 0 disables it.
+		*/
+		uint64 WarningBytes = 0;
+
+		/**
+		* How an exceeded limit is handled, after it is reported. Arenas use their own failure mode instead.
+		* With 'Ignore', the exceeded limit is only reported to the crash reporter and the allocation goes on as usual.
+		*/
+		AMemoryArena::EFailureMode FailureMode = AMemoryArena::EFailureMode::Error;
+	};
+
+	/**
+	* Used and committed bytes of an arena, with its budget.
+	*/
+	struct AArenaBudgetUsage
+	{
+		uint64 UsedBytes = 0;
+		uint64 CommittedBytes = 0;
+		uint64 LimitBytes = 0;
+		uint64 WarningBytes = 0;
+		EMemoryBudgetLevel Level = EMemoryBudgetLevel::Within;
+	};
+
+	/**
+	* C++ Core Profiling Tool
+	*
+	* Registry of the memory budgets. The budgets of the allocator hints and of the arenas are checked on the allocation path,
+	*	against the statistics of the memory profiler, so a crossing is reported by the allocation that causes it. The budget of
+	*	the process is checked against its resident set size (read through APlatform) by 'Update', once every
+	*	AEC_MEMORY_BUDGETS_PROCESS_POLL_FRAMES calls.
+	*
+	* Every threshold is reported once when it is crossed and again only after the used bytes drop below it.
+	* The allocations are never refused, so an exceeded budget is only enforced through the failure mode.
+	*
+	* Only active when AE_ENABLE_MEMORY_BUDGETS is defined. Otherwise, all the functions do nothing.
+	*/
+	class APRICOT_API AMemoryBudgets
+	{
+	/* Constructors & Deconstructor */
+	private:
+		AMemoryBudgets() = delete;
+		AMemoryBudgets(const AMemoryBudgets&) = delete;
+		AMemoryBudgets& operator=(const AMemoryBudgets&) = delete;
+
+	/* Budgets */
+	public:
+		/**
+		* Sets the budget of the blocks allocated through HeapAllocator with the given hint.
+		*/
+		static void SetHintBudget(EAllocatorHint Hint, const AMemoryBudget& Budget);
+
+		/**
+		* Sets the budget of every arena whose debug name is 'DebugName'. Each arena is checked separately.
+		* It is applied to the arenas that already allocated and to the others when they allocate for the first time.
+		* The arenas given their own budget with 'AMemoryArena::SetBudget' keep it.
+		* The name isn't copied, so it must be a string literal (as the debug names are).
+		*/
+		static void SetArenaBudget(const TChar* DebugName, const AMemoryBudget& Budget);
+
+		static void SetProcessBudget(const AMemoryBudget& Budget);
+
+		/**
+		* Polls the process' memory usage and checks it against the process budget. Called by the engine once per frame.
+		*/
+		static void Update();
+
+	/* Reporting */
+	public:
+		/**
+		* Returns the last polled memory usage of the process.
+		*/
+		static APlatform::AProcessMemoryUsage GetProcessUsage();
+
+		/**
+		* Reads the usage of an arena. The arena must be alive for the whole call.
+		*/
+		static void GetArenaUsage(const AMemoryArena* Arena, AArenaBudgetUsage& OutUsage);
+
+		/**
+		* Logs the process usage and the usage of every hint and arena from the snapshot that has a budget.
+		*/
+		static void LogReport(const AMemoryStatsSnapshot& Snapshot);
+
+	/* Allocation path */
+	public:
+		/**
+		* Called by the memory profiler when the used bytes of a hint leave the cached bounds of its budget.
+		*/
+		static void SubmitHintUsage(EAllocatorHint Hint, uint64 UsedBytes);
+
+		/**
+		* Returns the budget state of the hint, so that the memory profiler can check it inline.
+		*/
+		static AMemoryBudgetState& GetHintBudgetState(EAllocatorHint Hint);
+
+		/**
+		* Called by an arena when its used bytes leave the cached bounds of its budget.
+		*/
+		static void SubmitArenaUsage(AMemoryArena* Arena, AMemoryBudgetState& State, uint64 UsedBytes);
+
+		/**
+		* Applies the budget registered for the arena's debug name, if any, to the state. Called when the arena allocates for the first time.
+		*/
+		static void ApplyArenaBudget(const AMemoryArena* Arena, AMemoryBudgetState& State);
+	};
+
+}
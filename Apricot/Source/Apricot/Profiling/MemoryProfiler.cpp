@@ -3,13 +3,640 @@
 
 #include "aepch.h"
 #include "MemoryProfiler.h"
+#include "AllocationRecorder.h"
+#include "AllocationRegistry.h"
+#include "MemoryBudgets.h"
+#include "NoAllocScope.h"
 
 #include "Apricot/Core/Memory/ApricotMemory.h"
+#include "Apricot/Core/Memory/HeapAllocator.h"
+#include "Apricot/Core/Platform.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
 
 namespace Apricot {
 
 	APRICOT_API extern AMemoryProfiler* GMemoryProfiler = nullptr;
 
+	namespace Utils {
+
+		FORCEINLINE static uint64 GetSizeBucket(uint64 Size)
+		{
+			if (Size <= 1)
+			{
+				return 0;
+			}
+
+			uint64 Bucket = (uint64)FindLastSetBit(Size - 1) + 1;
+			return Bucket < AAllocationStats::SizeBucketsCount ? Bucket : AAllocationStats::SizeBucketsCount - 1;
+		}
+
+		static void LogAllocationStats(const TChar* Name, const AAllocationStatsSnapshot& Stats)
+		{
+			AE_CORE_INFO(TEXT("    {}: Live {} bytes in {} allocations, Peak {} bytes, Allocations {}, Deallocations {}, Reallocations {}"),
+				Name, Stats.LiveBytes, Stats.GetLiveAllocationsCount(), Stats.PeakBytes, Stats.AllocationsCount, Stats.DeallocationsCount, Stats.ReallocationsCount);
+
+			// Only the non-empty buckets are written, as 'UpperBound: Count' pairs.
+			TChar Histogram[1024];
+			uint64 Offset = 0;
+			for (uint64 Bucket = 0; Bucket < AAllocationStatsSnapshot::SizeBucketsCount; Bucket++)
+			{
+				if (Stats.SizeHistogram[Bucket] == 0 || Offset + 64 > AE_ARRAY_LENGTH(Histogram))
+				{
+					continue;
+				}
+
+				Offset += FormatType<uint64>(1ull << Bucket, Histogram + Offset, AE_ARRAY_LENGTH(Histogram) - Offset);
+				Histogram[Offset++] = ':';
+				Histogram[Offset++] = ' ';
+				Offset += FormatType<uint64>(Stats.SizeHistogram[Bucket], Histogram + Offset, AE_ARRAY_LENGTH(Histogram) - Offset);
+				Histogram[Offset++] = ' ';
+			}
+			Histogram[Offset] = 0;
+
+			if (Offset > 0)
+			{
+				AE_CORE_INFO(TEXT("        Sizes (<= bytes: count) {}"), (const TChar*)Histogram);
+			}
+		}
+
+	}
+
+#ifdef AE_ENABLE_MEMORY_STATS
+
+	static AAllocationStats GHeapStats;
+	static AAllocationStats GHintStats[(uint16)EAllocatorHint::MaxEnumValue];
+
+	struct AArenaStatsEntry
+	{
+		AMemoryArena* Arena;
+		const TChar* DebugName;
+		AAllocationStats* Stats;
+	};
+
+	/**
+	* Registered arenas. Unregistering swaps the last entry into the freed slot, so the first 'GArenaStatsCount' entries are always valid.
+	*/
+	static AArenaStatsEntry GArenaStats[AEC_MEMORY_STATS_MAX_ARENAS];
+	static uint64 GArenaStatsCount = 0;
+	static ASpinLock GArenaStatsLock;
+
+#endif // AE_ENABLE_MEMORY_STATS
+
+#ifdef AE_ENABLE_MEMORY_BUDGETS
+
+	namespace Utils {
+
+		FORCEINLINE static void CheckHintBudget(EAllocatorHint Hint)
+		{
+			uint64 UsedBytes = GHintStats[(uint16)Hint].GetLiveBytes();
+			if (AMemoryBudgets::GetHintBudgetState(Hint).NeedsUpdate(UsedBytes))
+			{
+				AMemoryBudgets::SubmitHintUsage(Hint, UsedBytes);
+			}
+		}
+
+	}
+
+#endif // AE_ENABLE_MEMORY_BUDGETS
+
+#ifdef AE_ENABLE_MEMORY_SAMPLING
+
+	AE_STATIC_ASSERT((AEC_MEMORY_SAMPLING_MAX_LIVE_SAMPLES & (AEC_MEMORY_SAMPLING_MAX_LIVE_SAMPLES - 1)) == 0, "AEC_MEMORY_SAMPLING_MAX_LIVE_SAMPLES must be a power of two!");
+
+	/**
+	* A distinct call stack of the sampled allocations. The frames never change after the stack is published, so the profile can be
+	*	written without taking the sampling lock. The counters are only modified with the lock held.
+	*/
+	struct ASampledStack
+	{
+		void* Frames[AEC_MEMORY_SAMPLING_MAX_FRAMES] = {};
+		uint32 FramesCount = 0;
+		uint64 Hash = 0;
+
+		TAtomic<uint64> LiveCount;
+		TAtomic<uint64> LiveBytes;
+
+		/**
+		* The live bytes, scaled up by the probability of each allocation to be sampled. Estimates the live bytes of all the allocations.
+		*/
+		TAtomic<uint64> LiveEstimatedBytes;
+
+		TAtomic<uint64> TotalCount;
+		TAtomic<uint64> TotalBytes;
+	};
+
+	struct ALiveSample
+	{
+		void* Block = nullptr;
+		uint64 Size = 0;
+		uint64 EstimatedSize = 0;
+		uint32 StackIndex = 0;
+	};
+
+	struct ASamplerThreadState
+	{
+		/**
+		* Decremented by the size of every allocation. The allocation that makes it negative is sampled.
+		*/
+		int64 BytesUntilSample;
+
+		/**
+		* State of the thread's xorshift generator. Never 0 once initialized.
+		*/
+		uint64 RandomState;
+
+		bool8 bIsInitialized;
+	};
+
+	static TAtomic<uint64> GSamplingRate(AEC_MEMORY_SAMPLING_RATE);
+
+	/**
+	* Zero-initialized, so the first allocation of every thread takes the slow path, which initializes the state.
+	*/
+	static thread_local ASamplerThreadState GSamplerThreadState;
+
+	/**
+	* Serializes the modifications of the stacks and of the live samples. Only taken for sampled allocations and their deallocation.
+	*/
+	static ASpinLock GSamplingLock;
+
+	/**
+	* The stacks are only appended. A stack is written before the count is incremented, so readers never see it uninitialized.
+	*/
+	static ASampledStack GSampledStacks[AEC_MEMORY_SAMPLING_MAX_STACKS];
+	static TAtomic<uint64> GSampledStacksCount;
+
+	/**
+	* Open addressing hash table that maps the stack hashes to their index in GSampledStacks, plus one (0 means an empty slot).
+	* It has twice as many slots as there can be stacks, so the probes are always short.
+	*/
+	static constexpr uint64 GSampledStackIndexSize = AEC_MEMORY_SAMPLING_MAX_STACKS * 2;
+	static uint32 GSampledStackIndex[GSampledStackIndexSize];
+
+	/**
+	* Open addressing hash table of the sampled allocations that are alive, keyed by their address. Deletions shift the following
+	*	entries back, so the table never fills up with tombstones.
+	*/
+	static ALiveSample GLiveSamples[AEC_MEMORY_SAMPLING_MAX_LIVE_SAMPLES];
+	static uint64 GLiveSamplesCount = 0;
+
+	/**
+	* The number of live samples whose home slot is the entry's index. Read without the lock on every deallocation, so that
+	*	the blocks that were never sampled (almost all of them) are rejected with a single load.
+	*/
+	static TAtomic<uint16> GLiveSamplesFilter[AEC_MEMORY_SAMPLING_MAX_LIVE_SAMPLES];
+
+	/**
+	* Samples that were dropped, because one of the tables was full.
+	*/
+	static TAtomic<uint64> GDroppedSamplesCount;
+
+	namespace Utils {
+
+		FORCEINLINE static uint64 GetLiveSampleHome(const void* Block)
+		{
+			// The low bits of a block's address are mostly zero, because of its alignment.
+			return ((((uint64)Block >> 4) * 0x9E3779B97F4A7C15ull) >> 32) & (AEC_MEMORY_SAMPLING_MAX_LIVE_SAMPLES - 1);
+		}
+
+		FORCEINLINE static uint64 NextRandom(ASamplerThreadState& State)
+		{
+			// xorshift64*
+			State.RandomState ^= State.RandomState >> 12;
+			State.RandomState ^= State.RandomState << 25;
+			State.RandomState ^= State.RandomState >> 27;
+			return State.RandomState * 0x2545F4914F6CDD1Dull;
+		}
+
+		static int64 DrawSamplingInterval(ASamplerThreadState& State, uint64 Rate)
+		{
+			// Exponentially distributed, with the mean 'Rate'. 'Uniform' is in (0, 1], so the logarithm is always finite.
+			double Uniform = (double)((NextRandom(State) >> 11) + 1) * (1.0 / 9007199254740992.0);
+			return (int64)(-log(Uniform) * (double)Rate);
+		}
+
+		static uint64 HashStack(void* const* Frames, uint32 FramesCount)
+		{
+			uint64 Hash = 0xCBF29CE484222325ull;
+			for (uint32 Index = 0; Index < FramesCount; Index++)
+			{
+				Hash = (Hash ^ (uint64)Frames[Index]) * 0x100000001B3ull;
+				Hash ^= Hash >> 29;
+			}
+			return Hash;
+		}
+
+		/**
+		* Must be called with the sampling lock held.
+		*
+		* @returns The index of the stack or AEC_MEMORY_SAMPLING_MAX_STACKS if it is new and there is no space left for it.
+		*/
+		static uint32 FindOrAddStack(void* const* Frames, uint32 FramesCount)
+		{
+			uint64 Hash = HashStack(Frames, FramesCount);
+
+			uint64 Slot = Hash % GSampledStackIndexSize;
+			while (GSampledStackIndex[Slot] != 0)
+			{
+				uint32 StackIndex = GSampledStackIndex[Slot] - 1;
+				const ASampledStack& Stack = GSampledStacks[StackIndex];
+				if (Stack.Hash == Hash && Stack.FramesCount == FramesCount && memcmp(Stack.Frames, Frames, FramesCount * sizeof(void*)) == 0)
+				{
+					return StackIndex;
+				}
+				Slot = (Slot + 1) % GSampledStackIndexSize;
+			}
+
+			uint64 StacksCount = GSampledStacksCount.Load(EMemoryOrder::Relaxed);
+			if (StacksCount == AEC_MEMORY_SAMPLING_MAX_STACKS)
+			{
+				return AEC_MEMORY_SAMPLING_MAX_STACKS;
+			}
+
+			ASampledStack& Stack = GSampledStacks[StacksCount];
+			MemCpy(Stack.Frames, Frames, FramesCount * sizeof(void*));
+			Stack.FramesCount = FramesCount;
+			Stack.Hash = Hash;
+
+			GSampledStackIndex[Slot] = (uint32)StacksCount + 1;
+			GSampledStacksCount.Store(StacksCount + 1, EMemoryOrder::Release);
+			return (uint32)StacksCount;
+		}
+
+		/**
+		* Must be called with the sampling lock held. The caller checks that the table has free slots.
+		*/
+		static void AddLiveSample(const ALiveSample& Sample)
+		{
+			uint64 Home = GetLiveSampleHome(Sample.Block);
+
+			uint64 Slot = Home;
+			while (GLiveSamples[Slot].Block != nullptr)
+			{
+				Slot = (Slot + 1) & (AEC_MEMORY_SAMPLING_MAX_LIVE_SAMPLES - 1);
+			}
+			GLiveSamples[Slot] = Sample;
+			GLiveSamplesCount++;
+
+			GLiveSamplesFilter[Home].Store(GLiveSamplesFilter[Home].Load(EMemoryOrder::Relaxed) + 1, EMemoryOrder::Relaxed);
+
+			ASampledStack& Stack = GSampledStacks[Sample.StackIndex];
+			Stack.LiveCount.Store(Stack.LiveCount.Load(EMemoryOrder::Relaxed) + 1, EMemoryOrder::Relaxed);
+			Stack.LiveBytes.Store(Stack.LiveBytes.Load(EMemoryOrder::Relaxed) + Sample.Size, EMemoryOrder::Relaxed);
+			Stack.LiveEstimatedBytes.Store(Stack.LiveEstimatedBytes.Load(EMemoryOrder::Relaxed) + Sample.EstimatedSize, EMemoryOrder::Relaxed);
+			Stack.TotalCount.Store(Stack.TotalCount.Load(EMemoryOrder::Relaxed) + 1, EMemoryOrder::Relaxed);
+			Stack.TotalBytes.Store(Stack.TotalBytes.Load(EMemoryOrder::Relaxed) + Sample.Size, EMemoryOrder::Relaxed);
+		}
+
+		NOINLINE static void RemoveLiveSample(void* Block)
+		{
+			TScopedLock<ASpinLock> Lock(GSamplingLock);
+
+			uint64 Home = GetLiveSampleHome(Block);
+
+			// The filter only tells that a sample with the same home slot is alive, so the block might not be sampled.
+			uint64 Slot = Home;
+			while (GLiveSamples[Slot].Block != Block)
+			{
+				if (GLiveSamples[Slot].Block == nullptr)
+				{
+					return;
+				}
+				Slot = (Slot + 1) & (AEC_MEMORY_SAMPLING_MAX_LIVE_SAMPLES - 1);
+			}
+
+			const ALiveSample& Sample = GLiveSamples[Slot];
+			ASampledStack& Stack = GSampledStacks[Sample.StackIndex];
+			Stack.LiveCount.Store(Stack.LiveCount.Load(EMemoryOrder::Relaxed) - 1, EMemoryOrder::Relaxed);
+			Stack.LiveBytes.Store(Stack.LiveBytes.Load(EMemoryOrder::Relaxed) - Sample.Size, EMemoryOrder::Relaxed);
+			Stack.LiveEstimatedBytes.Store(Stack.LiveEstimatedBytes.Load(EMemoryOrder::Relaxed) - Sample.EstimatedSize, EMemoryOrder::Relaxed);
+
+			GLiveSamplesFilter[Home].Store(GLiveSamplesFilter[Home].Load(EMemoryOrder::Relaxed) - 1, EMemoryOrder::Relaxed);
+			GLiveSamplesCount--;
+
+			// Backward shift deletion: every following entry of the cluster that may live in the freed slot is moved into it.
+			uint64 FreeSlot = Slot;
+			uint64 NextSlot = (Slot + 1) & (AEC_MEMORY_SAMPLING_MAX_LIVE_SAMPLES - 1);
+			while (GLiveSamples[NextSlot].Block != nullptr)
+			{
+				uint64 NextHome = GetLiveSampleHome(GLiveSamples[NextSlot].Block);
+
+				// The distance from the home slot, measured around the end of the table.
+				uint64 FreeDistance = (FreeSlot - NextHome) & (AEC_MEMORY_SAMPLING_MAX_LIVE_SAMPLES - 1);
+				uint64 NextDistance = (NextSlot - NextHome) & (AEC_MEMORY_SAMPLING_MAX_LIVE_SAMPLES - 1);
+				if (FreeDistance < NextDistance)
+				{
+					GLiveSamples[FreeSlot] = GLiveSamples[NextSlot];
+					FreeSlot = NextSlot;
+				}
+				NextSlot = (NextSlot + 1) & (AEC_MEMORY_SAMPLING_MAX_LIVE_SAMPLES - 1);
+			}
+			GLiveSamples[FreeSlot] = ALiveSample();
+		}
+
+		NOINLINE static void SampleAllocation(ASamplerThreadState& State, void* Block, uint64 Size)
+		{
+			uint64 Rate = GSamplingRate.Load(EMemoryOrder::Relaxed);
+			if (Rate == 0)
+			{
+				// Checks the rate again later. The interval is drawn again once the sampling is enabled.
+				State.BytesUntilSample = AE_MEGABYTES(1);
+				State.bIsInitialized = false;
+				return;
+			}
+
+			if (!State.bIsInitialized)
+			{
+				if (State.RandomState == 0)
+				{
+					State.RandomState = (((uint64)&State * 0x9E3779B97F4A7C15ull) ^ (uint64)APlatform::GetSystemPerformanceTime()) | 1;
+				}
+				State.bIsInitialized = true;
+
+				// The first allocation doesn't force a sample, otherwise every thread would sample its first allocation.
+				State.BytesUntilSample = DrawSamplingInterval(State, Rate) - (int64)Size;
+				if (State.BytesUntilSample >= 0)
+				{
+					return;
+				}
+			}
+			State.BytesUntilSample = DrawSamplingInterval(State, Rate);
+
+			// Skips this function and AMemoryProfiler's submit function, so the stack starts in the platform allocator.
+			// The backtrace is captured before taking the lock, because it is by far the slowest part.
+			void* Frames[AEC_MEMORY_SAMPLING_MAX_FRAMES];
+			uint32 FramesCount = APlatform::CaptureBacktrace(Frames, AEC_MEMORY_SAMPLING_MAX_FRAMES, 2);
+
+			ALiveSample Sample;
+			Sample.Block = Block;
+			Sample.Size = Size;
+			Sample.EstimatedSize = (uint64)((double)Size / (1.0 - exp(-(double)Size / (double)Rate)));
+
+			TScopedLock<ASpinLock> Lock(GSamplingLock);
+
+			// The live samples table is kept at most 3/4 full, so its probes stay short.
+			if (GLiveSamplesCount >= AEC_MEMORY_SAMPLING_MAX_LIVE_SAMPLES / 4 * 3)
+			{
+				GDroppedSamplesCount.FetchAdd(1, EMemoryOrder::Relaxed);
+				return;
+			}
+
+			Sample.StackIndex = FindOrAddStack(Frames, FramesCount);
+			if (Sample.StackIndex == AEC_MEMORY_SAMPLING_MAX_STACKS)
+			{
+				GDroppedSamplesCount.FetchAdd(1, EMemoryOrder::Relaxed);
+				return;
+			}
+
+			AddLiveSample(Sample);
+		}
+
+		FORCEINLINE static void SubmitSampledAllocation(void* Block, uint64 Size)
+		{
+			ASamplerThreadState& State = GSamplerThreadState;
+			State.BytesUntilSample -= (int64)Size;
+			if (State.BytesUntilSample < 0)
+			{
+				SampleAllocation(State, Block, Size);
+			}
+		}
+
+		FORCEINLINE static void SubmitSampledDeallocation(void* Block)
+		{
+			if (GLiveSamplesFilter[GetLiveSampleHome(Block)].Load(EMemoryOrder::Relaxed) != 0)
+			{
+				RemoveLiveSample(Block);
+			}
+		}
+
+		static FILE* OpenFileForWriting(const char8* FilePath)
+		{
+		#ifdef AE_COMPILER_MSVC
+			FILE* File = nullptr;
+			return fopen_s(&File, FilePath, "wb") == 0 ? File : nullptr;
+		#else
+			return fopen(FilePath, "wb");
+		#endif
+		}
+
+		static void WritePprofMappedLibrary(const APlatform::AModuleRange& Range, void* UserData)
+		{
+			fprintf((FILE*)UserData, "%08llx-%08llx r-xp %08llx 00:00 0 %s\n",
+				(unsigned long long)Range.Begin, (unsigned long long)Range.End, (unsigned long long)Range.FileOffset, Range.Path);
+		}
+
+		static void WritePprofProfile(FILE* File, uint64 StacksCount)
+		{
+			uint64 LiveCount = 0, LiveBytes = 0, TotalCount = 0, TotalBytes = 0;
+			for (uint64 Index = 0; Index < StacksCount; Index++)
+			{
+				LiveCount += GSampledStacks[Index].LiveCount.Load(EMemoryOrder::Relaxed);
+				LiveBytes += GSampledStacks[Index].LiveBytes.Load(EMemoryOrder::Relaxed);
+				TotalCount += GSampledStacks[Index].TotalCount.Load(EMemoryOrder::Relaxed);
+				TotalBytes += GSampledStacks[Index].TotalBytes.Load(EMemoryOrder::Relaxed);
+			}
+
+			// The counts are the raw sampled ones. 'pprof' scales them back up, using the sampling rate from the header.
+			fprintf(File, "heap profile: %llu: %llu [%llu: %llu] @ heap_v2/%llu\n", (unsigned long long)LiveCount, (unsigned long long)LiveBytes,
+				(unsigned long long)TotalCount, (unsigned long long)TotalBytes, (unsigned long long)GSamplingRate.Load(EMemoryOrder::Relaxed));
+
+			for (uint64 Index = 0; Index < StacksCount; Index++)
+			{
+				const ASampledStack& Stack = GSampledStacks[Index];
+				fprintf(File, "%llu: %llu [%llu: %llu] @",
+					(unsigned long long)Stack.LiveCount.Load(EMemoryOrder::Relaxed), (unsigned long long)Stack.LiveBytes.Load(EMemoryOrder::Relaxed),
+					(unsigned long long)Stack.TotalCount.Load(EMemoryOrder::Relaxed), (unsigned long long)Stack.TotalBytes.Load(EMemoryOrder::Relaxed));
+
+				for (uint32 Frame = 0; Frame < Stack.FramesCount; Frame++)
+				{
+					fprintf(File, " 0x%016llx", (unsigned long long)(uintptr)Stack.Frames[Frame]);
+				}
+				fputc('\n', File);
+			}
+
+			fprintf(File, "\nMAPPED_LIBRARIES:\n");
+			APlatform::EnumerateModuleRanges(WritePprofMappedLibrary, File);
+		}
+
+		static void WriteFoldedProfile(FILE* File, uint64 StacksCount)
+		{
+			char8 Name[512];
+			for (uint64 Index = 0; Index < StacksCount; Index++)
+			{
+				const ASampledStack& Stack = GSampledStacks[Index];
+				uint64 LiveEstimatedBytes = Stack.LiveEstimatedBytes.Load(EMemoryOrder::Relaxed);
+				if (LiveEstimatedBytes == 0)
+				{
+					continue;
+				}
+
+				// The frames are captured innermost first, but the folded stacks start from the root.
+				for (uint32 Frame = Stack.FramesCount; Frame > 0; Frame--)
+				{
+					// Return addresses point after the call, which might already be the next function.
+					const void* Address = (const uint8*)Stack.Frames[Frame - 1] - 1;
+					if (APlatform::GetSymbolName(Address, Name, sizeof(Name)))
+					{
+						// ';' separates the frames.
+						for (char8* Character = Name; *Character; Character++)
+						{
+							*Character = *Character == ';' ? ':' : *Character;
+						}
+					}
+					else
+					{
+						snprintf(Name, sizeof(Name), "0x%llx", (unsigned long long)(uintptr)Stack.Frames[Frame - 1]);
+					}
+
+					if (Frame != Stack.FramesCount)
+					{
+						fputc(';', File);
+					}
+					fputs(Name, File);
+				}
+				fprintf(File, " %llu\n", (unsigned long long)LiveEstimatedBytes);
+			}
+		}
+
+	}
+
+#endif // AE_ENABLE_MEMORY_SAMPLING
+
+	void AAllocationStats::SubmitAllocation(uint64 Size)
+	{
+		uint64 LiveBytes = m_LiveBytes.FetchAdd(Size, EMemoryOrder::Relaxed) + Size;
+		UpdatePeak(LiveBytes);
+
+		m_SizeHistogram[Utils::GetSizeBucket(Size)].FetchAdd(1, EMemoryOrder::Relaxed);
+	}
+
+	void AAllocationStats::SubmitDeallocation(uint64 Size)
+	{
+		m_LiveBytes.FetchSub(Size, EMemoryOrder::Relaxed);
+		m_DeallocationsCount.FetchAdd(1, EMemoryOrder::Relaxed);
+	}
+
+	void AAllocationStats::SubmitReallocation(uint64 OldSize, uint64 NewSize)
+	{
+		uint64 LiveBytes = m_LiveBytes.FetchAdd(NewSize - OldSize, EMemoryOrder::Relaxed) + (NewSize - OldSize);
+		UpdatePeak(LiveBytes);
+
+		m_ReallocationsCount.FetchAdd(1, EMemoryOrder::Relaxed);
+	}
+
+	void AAllocationStats::SubmitAllocationExclusive(uint64 Size)
+	{
+		uint64 LiveBytes = m_LiveBytes.Load(EMemoryOrder::Relaxed) + Size;
+		m_LiveBytes.Store(LiveBytes, EMemoryOrder::Relaxed);
+		if (LiveBytes > m_PeakBytes.Load(EMemoryOrder::Relaxed))
+		{
+			m_PeakBytes.Store(LiveBytes, EMemoryOrder::Relaxed);
+		}
+
+		TAtomic<uint64>& Bucket = m_SizeHistogram[Utils::GetSizeBucket(Size)];
+		Bucket.Store(Bucket.Load(EMemoryOrder::Relaxed) + 1, EMemoryOrder::Relaxed);
+	}
+
+	void AAllocationStats::SubmitDeallocationExclusive(uint64 Size)
+	{
+		m_LiveBytes.Store(m_LiveBytes.Load(EMemoryOrder::Relaxed) - Size, EMemoryOrder::Relaxed);
+		m_DeallocationsCount.Store(m_DeallocationsCount.Load(EMemoryOrder::Relaxed) + 1, EMemoryOrder::Relaxed);
+	}
+
+	void AAllocationStats::SubmitDeallocationOfAll()
+	{
+		// Every allocation made so far is freed, so the deallocations catch up with the allocations.
+		uint64 AllocationsCount = 0;
+		for (uint64 Bucket = 0; Bucket < SizeBucketsCount; Bucket++)
+		{
+			AllocationsCount += m_SizeHistogram[Bucket].Load(EMemoryOrder::Relaxed);
+		}
+
+		m_LiveBytes.Store(0, EMemoryOrder::Relaxed);
+		m_DeallocationsCount.Store(AllocationsCount, EMemoryOrder::Relaxed);
+	}
+
+	void AAllocationStats::ResetPeak()
+	{
+		m_PeakBytes.Store(m_LiveBytes.Load(EMemoryOrder::Relaxed), EMemoryOrder::Relaxed);
+	}
+
+	void AAllocationStats::SubmitRewindExclusive(uint64 LiveBytes, uint64 FreedAllocationsCount)
+	{
+		m_LiveBytes.Store(LiveBytes, EMemoryOrder::Relaxed);
+		m_DeallocationsCount.Store(m_DeallocationsCount.Load(EMemoryOrder::Relaxed) + FreedAllocationsCount, EMemoryOrder::Relaxed);
+	}
+
+	void AAllocationStats::TakeSnapshot(AAllocationStatsSnapshot& OutSnapshot) const
+	{
+		OutSnapshot.LiveBytes = m_LiveBytes.Load(EMemoryOrder::Relaxed);
+		OutSnapshot.PeakBytes = m_PeakBytes.Load(EMemoryOrder::Relaxed);
+		OutSnapshot.DeallocationsCount = m_DeallocationsCount.Load(EMemoryOrder::Relaxed);
+		OutSnapshot.ReallocationsCount = m_ReallocationsCount.Load(EMemoryOrder::Relaxed);
+
+		OutSnapshot.AllocationsCount = 0;
+		for (uint64 Bucket = 0; Bucket < SizeBucketsCount; Bucket++)
+		{
+			OutSnapshot.SizeHistogram[Bucket] = m_SizeHistogram[Bucket].Load(EMemoryOrder::Relaxed);
+			OutSnapshot.AllocationsCount += OutSnapshot.SizeHistogram[Bucket];
+		}
+	}
+
+	void AAllocationStats::UpdatePeak(uint64 LiveBytes)
+	{
+		uint64 PeakBytes = m_PeakBytes.Load(EMemoryOrder::Relaxed);
+		while (LiveBytes > PeakBytes && !m_PeakBytes.CompareExchange(PeakBytes, LiveBytes, EMemoryOrder::Relaxed))
+		{
+		}
+	}
+
+	void AMemoryBudgetState::Set(uint64 LimitBytes, uint64 WarningBytes)
+	{
+		m_LimitBytes.Store(LimitBytes, EMemoryOrder::Relaxed);
+		m_WarningBytes.Store(WarningBytes, EMemoryOrder::Relaxed);
+		m_Level.Store(EMemoryBudgetLevel::Within, EMemoryOrder::Relaxed);
+
+		// Forces the next check to leave the fast path, so that the new thresholds are applied.
+		m_UpperBound.Store(0, EMemoryOrder::Relaxed);
+		m_LowerBound.Store(0, EMemoryOrder::Relaxed);
+	}
+
+	EMemoryBudgetLevel AMemoryBudgetState::Update(uint64 UsedBytes)
+	{
+		uint64 LimitBytes = m_LimitBytes.Load(EMemoryOrder::Relaxed);
+		uint64 WarningBytes = m_WarningBytes.Load(EMemoryOrder::Relaxed);
+
+		// A disabled threshold is never crossed.
+		uint64 Limit = LimitBytes ? LimitBytes : (uint64)-1;
+		uint64 Warning = WarningBytes ? WarningBytes : Limit;
+
+		EMemoryBudgetLevel Level = EMemoryBudgetLevel::Within;
+		uint64 LowerBound = 0;
+		uint64 UpperBound = Warning;
+
+		if (UsedBytes > Limit)
+		{
+			Level = EMemoryBudgetLevel::Exceeded;
+			LowerBound = Limit + 1;
+			UpperBound = (uint64)-1;
+		}
+		else if (UsedBytes > Warning)
+		{
+			Level = EMemoryBudgetLevel::Warning;
+			LowerBound = Warning + 1;
+			UpperBound = Limit;
+		}
+
+		m_LowerBound.Store(LowerBound, EMemoryOrder::Relaxed);
+		m_UpperBound.Store(UpperBound, EMemoryOrder::Relaxed);
+
+		EMemoryBudgetLevel PreviousLevel = m_Level.Exchange(Level, EMemoryOrder::Relaxed);
+		return Level > PreviousLevel ? Level : EMemoryBudgetLevel::Within;
+	}
+
 	AMemoryProfiler::AMemoryProfiler()
 	{
 	}
@@ -37,8 +664,44 @@ namespace Apricot {
 		GMemoryProfiler = nullptr;
 	}
 
-	void AMemoryProfiler::SubmitHeapAllocation(uint64 size, uint64 alignment)
+	void AMemoryProfiler::SubmitHeapAllocation(void* block, uint64 size, uint64 alignment)
 	{
+		if (!block)
+		{
+			return;
+		}
+
+#ifdef AE_ENABLE_MEMORY_SAMPLING
+
+		// Sampled first, so that this function's frame is never removed by a tail call.
+		Utils::SubmitSampledAllocation(block, size);
+
+#endif // AE_ENABLE_MEMORY_SAMPLING
+
+#ifdef AE_ENABLE_MEMORY_LEAK_CHECK
+
+		AAllocationRegistry::RegisterBlock(block, size);
+
+#endif // AE_ENABLE_MEMORY_LEAK_CHECK
+
+#ifdef AE_ENABLE_MEMORY_STATS
+
+		GHeapStats.SubmitAllocation(size);
+
+#endif // AE_ENABLE_MEMORY_STATS
+
+#ifdef AE_ENABLE_MEMORY_RECORDING
+
+		AAllocationRecorder::RecordAllocation(0, block, size, alignment);
+
+#endif // AE_ENABLE_MEMORY_RECORDING
+
+#ifdef AE_ENABLE_NO_ALLOC_SCOPES
+
+		ANoAllocScope::SubmitAllocation(block, size);
+
+#endif // AE_ENABLE_NO_ALLOC_SCOPES
+
 #ifdef AE_ENABLE_MEMORY_TRACE
 		
 		AE_CORE_TRACE(TEXT("MemoryProfiler - Heap Allocation Requested: Size '{}', Alignment '{}'"), size, alignment);
@@ -48,6 +711,35 @@ namespace Apricot {
 
 	void AMemoryProfiler::SubmitHeapDeallocation(void* block, uint64 size)
 	{
+		if (!block)
+		{
+			return;
+		}
+
+#ifdef AE_ENABLE_MEMORY_SAMPLING
+
+		Utils::SubmitSampledDeallocation(block);
+
+#endif // AE_ENABLE_MEMORY_SAMPLING
+
+#ifdef AE_ENABLE_MEMORY_LEAK_CHECK
+
+		AAllocationRegistry::UnregisterBlock(block);
+
+#endif // AE_ENABLE_MEMORY_LEAK_CHECK
+
+#ifdef AE_ENABLE_MEMORY_STATS
+
+		GHeapStats.SubmitDeallocation(size);
+
+#endif // AE_ENABLE_MEMORY_STATS
+
+#ifdef AE_ENABLE_MEMORY_RECORDING
+
+		AAllocationRecorder::RecordDeallocation(0, block, size);
+
+#endif // AE_ENABLE_MEMORY_RECORDING
+
 #ifdef AE_ENABLE_MEMORY_TRACE
 		
 		AE_CORE_TRACE(TEXT("MemoryProfiler - Heap Deallocation Requested: Size '{}'"), size);
@@ -55,4 +747,350 @@ namespace Apricot {
 #endif // AE_ENABLE_MEMORY_TRACE
 	}
 
+	void AMemoryProfiler::SubmitHeapReallocation(void* oldBlock, uint64 oldSize, void* newBlock, uint64 newSize)
+	{
+#ifdef AE_ENABLE_MEMORY_SAMPLING
+
+		// For the sampler, the new block is a new allocation, even if it was grown in place.
+		Utils::SubmitSampledDeallocation(oldBlock);
+		Utils::SubmitSampledAllocation(newBlock, newSize);
+
+#endif // AE_ENABLE_MEMORY_SAMPLING
+
+#ifdef AE_ENABLE_MEMORY_LEAK_CHECK
+
+		AAllocationRegistry::MoveBlock(oldBlock, newBlock, newSize);
+
+#endif // AE_ENABLE_MEMORY_LEAK_CHECK
+
+#ifdef AE_ENABLE_MEMORY_STATS
+
+		GHeapStats.SubmitReallocation(oldSize, newSize);
+
+#endif // AE_ENABLE_MEMORY_STATS
+
+#ifdef AE_ENABLE_MEMORY_RECORDING
+
+		// The trace has no reallocations, so that every allocator can replay it. The alignment isn't known here.
+		AAllocationRecorder::RecordDeallocation(0, oldBlock, oldSize);
+		AAllocationRecorder::RecordAllocation(0, newBlock, newSize, sizeof(void*));
+
+#endif // AE_ENABLE_MEMORY_RECORDING
+
+#ifdef AE_ENABLE_NO_ALLOC_SCOPES
+
+		// Counted even if the block was grown in place, because the allocator was still called.
+		ANoAllocScope::SubmitAllocation(newBlock, newSize);
+
+#endif // AE_ENABLE_NO_ALLOC_SCOPES
+
+#ifdef AE_ENABLE_MEMORY_TRACE
+		
+		AE_CORE_TRACE(TEXT("MemoryProfiler - Heap Reallocation Requested: OldSize '{}', NewSize '{}', InPlace '{}'"), oldSize, newSize, oldBlock == newBlock);
+
+#endif // AE_ENABLE_MEMORY_TRACE
+	}
+
+	void AMemoryProfiler::SubmitHintAllocation(EAllocatorHint hint, void* block, uint64 size)
+	{
+#ifdef AE_ENABLE_MEMORY_LEAK_CHECK
+
+		AAllocationRegistry::SetBlockHint(block, hint);
+
+#endif // AE_ENABLE_MEMORY_LEAK_CHECK
+
+#ifdef AE_ENABLE_MEMORY_RECORDING
+
+		AAllocationRecorder::SetLastAllocationHint(block, hint);
+
+#endif // AE_ENABLE_MEMORY_RECORDING
+
+#ifdef AE_ENABLE_NO_ALLOC_SCOPES
+
+		ANoAllocScope::SubmitAllocationHint(block, hint);
+
+#endif // AE_ENABLE_NO_ALLOC_SCOPES
+
+#ifdef AE_ENABLE_MEMORY_STATS
+
+		GHintStats[(uint16)hint].SubmitAllocation(size);
+
+#endif // AE_ENABLE_MEMORY_STATS
+
+#ifdef AE_ENABLE_MEMORY_BUDGETS
+
+		Utils::CheckHintBudget(hint);
+
+#endif // AE_ENABLE_MEMORY_BUDGETS
+	}
+
+	void AMemoryProfiler::SubmitHintDeallocation(EAllocatorHint hint, uint64 size)
+	{
+#ifdef AE_ENABLE_MEMORY_STATS
+
+		GHintStats[(uint16)hint].SubmitDeallocation(size);
+
+#endif // AE_ENABLE_MEMORY_STATS
+
+#ifdef AE_ENABLE_MEMORY_BUDGETS
+
+		Utils::CheckHintBudget(hint);
+
+#endif // AE_ENABLE_MEMORY_BUDGETS
+	}
+
+	void AMemoryProfiler::SubmitHintReallocation(EAllocatorHint hint, void* block, uint64 oldSize, uint64 newSize)
+	{
+#ifdef AE_ENABLE_MEMORY_LEAK_CHECK
+
+		// The block might have been moved by an allocation and a free, which lose the hint.
+		AAllocationRegistry::SetBlockHint(block, hint);
+
+#endif // AE_ENABLE_MEMORY_LEAK_CHECK
+
+#ifdef AE_ENABLE_MEMORY_RECORDING
+
+		AAllocationRecorder::SetLastAllocationHint(block, hint);
+
+#endif // AE_ENABLE_MEMORY_RECORDING
+
+#ifdef AE_ENABLE_NO_ALLOC_SCOPES
+
+		ANoAllocScope::SubmitAllocationHint(block, hint);
+
+#endif // AE_ENABLE_NO_ALLOC_SCOPES
+
+#ifdef AE_ENABLE_MEMORY_STATS
+
+		GHintStats[(uint16)hint].SubmitReallocation(oldSize, newSize);
+
+#endif // AE_ENABLE_MEMORY_STATS
+
+#ifdef AE_ENABLE_MEMORY_BUDGETS
+
+		Utils::CheckHintBudget(hint);
+
+#endif // AE_ENABLE_MEMORY_BUDGETS
+	}
+
+	const TChar* AMemoryProfiler::GetAllocatorHintName(EAllocatorHint hint)
+	{
+		switch (hint)
+		{
+			case EAllocatorHint::None:    return TEXT("None");
+			case EAllocatorHint::Vector:  return TEXT("Vector");
+			case EAllocatorHint::String:  return TEXT("String");
+			case EAllocatorHint::HashMap: return TEXT("HashMap");
+			default:                      return TEXT("Unknown");
+		}
+	}
+
+	void AMemoryProfiler::RegisterArena(AMemoryArena* Arena, const TChar* DebugName, AAllocationStats* Stats)
+	{
+#ifdef AE_ENABLE_MEMORY_STATS
+
+		TScopedLock<ASpinLock> Lock(GArenaStatsLock);
+
+		if (GArenaStatsCount < AEC_MEMORY_STATS_MAX_ARENAS)
+		{
+			GArenaStats[GArenaStatsCount++] = { Arena, DebugName, Stats };
+		}
+
+#endif // AE_ENABLE_MEMORY_STATS
+	}
+
+	void AMemoryProfiler::UnregisterArena(const AMemoryArena* Arena)
+	{
+#ifdef AE_ENABLE_MEMORY_STATS
+
+		TScopedLock<ASpinLock> Lock(GArenaStatsLock);
+
+		for (uint64 Index = 0; Index < GArenaStatsCount; Index++)
+		{
+			if (GArenaStats[Index].Arena == Arena)
+			{
+				GArenaStats[Index] = GArenaStats[--GArenaStatsCount];
+				return;
+			}
+		}
+
+#endif // AE_ENABLE_MEMORY_STATS
+	}
+
+	void AMemoryProfiler::EnumerateArenas(PFN_ArenaCallback Callback, void* UserData)
+	{
+#ifdef AE_ENABLE_MEMORY_STATS
+
+		TScopedLock<ASpinLock> Lock(GArenaStatsLock);
+
+		for (uint64 Index = 0; Index < GArenaStatsCount; Index++)
+		{
+			Callback(GArenaStats[Index].Arena, GArenaStats[Index].DebugName, UserData);
+		}
+
+#endif // AE_ENABLE_MEMORY_STATS
+	}
+
+	void AMemoryProfiler::TakeStatsSnapshot(AMemoryStatsSnapshot& OutSnapshot)
+	{
+		// The hint heaps keep their counters for their own bookkeeping, so they are available in every configuration.
+		for (uint16 Hint = 0; Hint < (uint16)EAllocatorHint::MaxEnumValue; Hint++)
+		{
+			OutSnapshot.HintHeaps[Hint] = GHeapAllocator ? GHeapAllocator->GetHintHeapStats((EAllocatorHint)Hint) : AHintHeapStats();
+		}
+
+#ifdef AE_ENABLE_MEMORY_STATS
+
+		GHeapStats.TakeSnapshot(OutSnapshot.Heap);
+
+		for (uint16 Hint = 0; Hint < (uint16)EAllocatorHint::MaxEnumValue; Hint++)
+		{
+			GHintStats[Hint].TakeSnapshot(OutSnapshot.Hints[Hint]);
+		}
+
+		// The lock keeps the arenas from being destroyed while their statistics are copied.
+		TScopedLock<ASpinLock> Lock(GArenaStatsLock);
+
+		OutSnapshot.ArenasCount = GArenaStatsCount;
+		for (uint64 Index = 0; Index < GArenaStatsCount; Index++)
+		{
+			OutSnapshot.Arenas[Index].Arena = GArenaStats[Index].Arena;
+			OutSnapshot.Arenas[Index].DebugName = GArenaStats[Index].DebugName;
+			GArenaStats[Index].Stats->TakeSnapshot(OutSnapshot.Arenas[Index].Stats);
+		}
+
+#endif // AE_ENABLE_MEMORY_STATS
+	}
+
+	void AMemoryProfiler::LogStatsSnapshot(const AMemoryStatsSnapshot& Snapshot)
+	{
+		AE_CORE_INFO(TEXT("MemoryProfiler - Heap:"));
+		Utils::LogAllocationStats(TEXT("GMalloc"), Snapshot.Heap);
+
+		AE_CORE_INFO(TEXT("MemoryProfiler - Heap Allocator Hints:"));
+		for (uint16 Hint = 0; Hint < (uint16)EAllocatorHint::MaxEnumValue; Hint++)
+		{
+			if (Snapshot.Hints[Hint].AllocationsCount > 0)
+			{
+				Utils::LogAllocationStats(GetAllocatorHintName((EAllocatorHint)Hint), Snapshot.Hints[Hint]);
+			}
+		}
+
+		AE_CORE_INFO(TEXT("MemoryProfiler - Hint Heaps:"));
+		for (uint16 Hint = 0; Hint < (uint16)EAllocatorHint::MaxEnumValue; Hint++)
+		{
+			const AHintHeapStats& Stats = Snapshot.HintHeaps[Hint];
+			if (Stats.CommittedBytes > 0)
+			{
+				AE_CORE_INFO(TEXT("    {}: Committed {} bytes in {} slabs ({} empty), Allocated {} bytes in {} blocks"),
+					GetAllocatorHintName((EAllocatorHint)Hint), Stats.CommittedBytes, Stats.SlabsCount + Stats.EmptySlabsCount, Stats.EmptySlabsCount,
+					Stats.AllocatedBytes, Stats.AllocatedBlocksCount);
+			}
+		}
+
+		AE_CORE_INFO(TEXT("MemoryProfiler - Arenas:"));
+		for (uint64 Index = 0; Index < Snapshot.ArenasCount; Index++)
+		{
+			Utils::LogAllocationStats(Snapshot.Arenas[Index].DebugName, Snapshot.Arenas[Index].Stats);
+		}
+	}
+
+	void AMemoryProfiler::ResetStatsPeaks()
+	{
+#ifdef AE_ENABLE_MEMORY_STATS
+
+		GHeapStats.ResetPeak();
+
+		for (uint16 Hint = 0; Hint < (uint16)EAllocatorHint::MaxEnumValue; Hint++)
+		{
+			GHintStats[Hint].ResetPeak();
+		}
+
+		TScopedLock<ASpinLock> Lock(GArenaStatsLock);
+
+		for (uint64 Index = 0; Index < GArenaStatsCount; Index++)
+		{
+			GArenaStats[Index].Stats->ResetPeak();
+		}
+
+#endif // AE_ENABLE_MEMORY_STATS
+	}
+
+	void AMemoryProfiler::SetSamplingRate(uint64 Rate)
+	{
+#ifdef AE_ENABLE_MEMORY_SAMPLING
+
+		GSamplingRate.Store(Rate, EMemoryOrder::Relaxed);
+
+#endif // AE_ENABLE_MEMORY_SAMPLING
+	}
+
+	uint64 AMemoryProfiler::GetSamplingRate()
+	{
+#ifdef AE_ENABLE_MEMORY_SAMPLING
+
+		return GSamplingRate.Load(EMemoryOrder::Relaxed);
+
+#else
+
+		return 0;
+
+#endif // AE_ENABLE_MEMORY_SAMPLING
+	}
+
+	bool8 AMemoryProfiler::DumpSampledProfile(const char8* FilePath, ESampledProfileFormat Format)
+	{
+#ifdef AE_ENABLE_MEMORY_SAMPLING
+
+		// The C runtime's file functions never allocate from GMalloc, so they can't recurse into the sampler.
+		FILE* File = Utils::OpenFileForWriting(FilePath);
+		if (!File)
+		{
+			AE_CORE_ERROR(TEXT("MemoryProfiler - Failed to open the sampled profile file!"));
+			return false;
+		}
+
+		// The stacks published before this point are fully written. Their counters might change while the profile is written.
+		uint64 StacksCount = GSampledStacksCount.Load(EMemoryOrder::Acquire);
+
+		switch (Format)
+		{
+			case ESampledProfileFormat::Pprof:  Utils::WritePprofProfile(File, StacksCount); break;
+			case ESampledProfileFormat::Folded: Utils::WriteFoldedProfile(File, StacksCount); break;
+		}
+
+		bool8 bSucceeded = ferror(File) == 0;
+		bSucceeded = (fclose(File) == 0) && bSucceeded;
+
+		uint64 DroppedSamplesCount = GDroppedSamplesCount.Load(EMemoryOrder::Relaxed);
+		if (DroppedSamplesCount > 0)
+		{
+			AE_CORE_WARN(TEXT("MemoryProfiler - {} allocation samples were dropped, because the sampling tables were full!"), DroppedSamplesCount);
+		}
+		AE_CORE_INFO(TEXT("MemoryProfiler - Wrote the sampled profile of {} call stacks."), StacksCount);
+
+		return bSucceeded;
+
+#else
+
+		return false;
+
+#endif // AE_ENABLE_MEMORY_SAMPLING
+	}
+
+	bool8 AMemoryProfiler::StartRecording(const char8* FilePath)
+	{
+		return AAllocationRecorder::Start(FilePath);
+	}
+
+	void AMemoryProfiler::StopRecording()
+	{
+		AAllocationRecorder::Stop();
+	}
+
+	bool8 AMemoryProfiler::IsRecording()
+	{
+		return AAllocationRecorder::IsRecording();
+	}
+
 }
\ No newline at end of file
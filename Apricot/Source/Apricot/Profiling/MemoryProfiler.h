@@ -4,12 +4,217 @@
 #pragma once
 
 #include "Apricot/Core/Base.h"
+#include "Apricot/Core/Config.h"
+#include "Apricot/Core/Atomic.h"
+#include "Apricot/Core/Memory/ApricotAllocator.h"
 
 namespace Apricot {
 
+	class AMemoryArena;
+
+	/**
+	* Plain copy of the allocation statistics, taken at a single point in time.
+	*/
+	struct AAllocationStatsSnapshot
+	{
+		/**
+		* Bucket 'i' of the size histogram counts the allocations whose size is in (2^(i-1), 2^i]. The last bucket also counts everything bigger.
+		*/
+		static constexpr uint64 SizeBucketsCount = 48;
+
+		uint64 LiveBytes = 0;
+		uint64 PeakBytes = 0;
+		uint64 AllocationsCount = 0;
+		uint64 DeallocationsCount = 0;
+		uint64 ReallocationsCount = 0;
+		uint64 SizeHistogram[SizeBucketsCount] = {};
+
+		FORCEINLINE uint64 GetLiveAllocationsCount() const { return AllocationsCount - DeallocationsCount; }
+	};
+
+	/**
+	* Lock-free allocation counters. They are updated with relaxed atomic operations, so they are cheap enough for the allocation path.
+	* The counters are independent, so a snapshot taken while other threads allocate isn't necessarily consistent between them.
+	*
+	* The 'Exclusive' variants don't use locked instructions. They can only be used when a single thread updates the counters at a time
+	*	(for example, by an arena that isn't thread-safe anyway), but any thread can still take snapshots.
+	*/
+	struct APRICOT_API AAllocationStats
+	{
+	public:
+		static constexpr uint64 SizeBucketsCount = AAllocationStatsSnapshot::SizeBucketsCount;
+
+		void SubmitAllocation(uint64 Size);
+		void SubmitDeallocation(uint64 Size);
+		void SubmitReallocation(uint64 OldSize, uint64 NewSize);
+
+		void SubmitAllocationExclusive(uint64 Size);
+		void SubmitDeallocationExclusive(uint64 Size);
+
+		/**
+		* Marks all the live bytes as freed at once. Used by the arenas' 'FreeAll'.
+		*/
+		void SubmitDeallocationOfAll();
+
+		/**
+		* Sets the peak to the current live bytes, so that the peak of the next interval (usually a frame) can be measured.
+		*/
+		void ResetPeak();
+
+		/**
+		* Sets the live bytes back to 'LiveBytes' and counts the freed allocations. Used when an arena is rewound.
+		*/
+		void SubmitRewindExclusive(uint64 LiveBytes, uint64 FreedAllocationsCount);
+
+		FORCEINLINE uint64 GetLiveBytes() const { return m_LiveBytes.Load(EMemoryOrder::Relaxed); }
+
+		void TakeSnapshot(AAllocationStatsSnapshot& OutSnapshot) const;
+
+	private:
+		void UpdatePeak(uint64 LiveBytes);
+
+	private:
+		/**
+		* Every instance starts on its own cache line, so the counters of different hints and arenas are never falsely shared.
+		*/
+		alignas(64) TAtomic<uint64> m_LiveBytes;
+		TAtomic<uint64> m_PeakBytes;
+		TAtomic<uint64> m_DeallocationsCount;
+		TAtomic<uint64> m_ReallocationsCount;
+		/**
+		* Every allocation lands in exactly one bucket, so the allocations count is the sum of the buckets. Reallocations aren't counted here.
+		*/
+		TAtomic<uint64> m_SizeHistogram[SizeBucketsCount];
+	};
+
+	/**
+	* Plain copy of an AHintHeap's counters, taken at a single point in time.
+	*/
+	struct AHintHeapStats
+	{
+		/**
+		* Memory of the slabs that is backed by physical memory, including the empty slabs that are kept for reuse.
+		*/
+		uint64 CommittedBytes = 0;
+
+		/**
+		* Bytes of the allocated blocks, rounded up to their size classes.
+		*/
+		uint64 AllocatedBytes = 0;
+
+		uint64 AllocatedBlocksCount = 0;
+
+		/**
+		* Slabs that belong to a size class. The empty slabs are counted separately.
+		*/
+		uint64 SlabsCount = 0;
+
+		uint64 EmptySlabsCount = 0;
+	};
+
+	enum class EMemoryBudgetLevel : uint8
+	{
+		Within = 0,
+		Warning,
+		Exceeded
+	};
+
+	/**
+	* Thresholds of a memory budget (see AMemoryBudgets), kept next to the statistics they are checked against.
+	* The allocation path only compares the used bytes with two cached bounds, so it leaves the fast path only when
+	*	the used bytes cross the warning threshold or the limit, in either direction.
+	*/
+	struct APRICOT_API AMemoryBudgetState
+	{
+	public:
+		/**
+		* Sets the thresholds. 0 disables a threshold. The level is reset, so the next check reports a crossing again.
+		*/
+		void Set(uint64 LimitBytes, uint64 WarningBytes);
+
+		FORCEINLINE bool8 NeedsUpdate(uint64 UsedBytes) const
+		{
+			return UsedBytes > m_UpperBound.Load(EMemoryOrder::Relaxed) || UsedBytes < m_LowerBound.Load(EMemoryOrder::Relaxed);
+		}
+
+		/**
+		* Recomputes the level and the cached bounds. When multiple threads cross the same threshold, only one of them sees the change.
+		*
+		* @returns The new level if it is higher than the previous one, otherwise 'Within'.
+		*/
+		EMemoryBudgetLevel Update(uint64 UsedBytes);
+
+		FORCEINLINE bool8 IsSet() const { return m_LimitBytes.Load(EMemoryOrder::Relaxed) != 0 || m_WarningBytes.Load(EMemoryOrder::Relaxed) != 0; }
+
+		FORCEINLINE uint64 GetLimitBytes() const { return m_LimitBytes.Load(EMemoryOrder::Relaxed); }
+		FORCEINLINE uint64 GetWarningBytes() const { return m_WarningBytes.Load(EMemoryOrder::Relaxed); }
+		FORCEINLINE EMemoryBudgetLevel GetLevel() const { return m_Level.Load(EMemoryOrder::Relaxed); }
+
+	private:
+		TAtomic<uint64> m_LimitBytes = 0;
+		TAtomic<uint64> m_WarningBytes = 0;
+
+		/**
+		* The used bytes must stay in [m_LowerBound, m_UpperBound] for the level to stay the same.
+		*/
+		TAtomic<uint64> m_UpperBound = (uint64)-1;
+		TAtomic<uint64> m_LowerBound = 0;
+
+		TAtomic<EMemoryBudgetLevel> m_Level = EMemoryBudgetLevel::Within;
+	};
+
+	/**
+	* Statistics of the whole memory system, filled by AMemoryProfiler::TakeStatsSnapshot.
+	* It is fairly big, so it is better to keep one around than to create it on the stack every frame.
+	*/
+	struct AMemoryStatsSnapshot
+	{
+		struct AArenaEntry
+		{
+			const AMemoryArena* Arena = nullptr;
+			const TChar* DebugName = nullptr;
+			AAllocationStatsSnapshot Stats;
+		};
+
+		/**
+		* All the allocations that went through GMalloc.
+		*/
+		AAllocationStatsSnapshot Heap;
+
+		/**
+		* The allocations that went through HeapAllocator, broken down by their hint.
+		*/
+		AAllocationStatsSnapshot Hints[(uint16)EAllocatorHint::MaxEnumValue];
+
+		/**
+		* The slabs of HeapAllocator's hint heaps, which hold the hints' blocks that are small enough.
+		*/
+		AHintHeapStats HintHeaps[(uint16)EAllocatorHint::MaxEnumValue];
+
+		AArenaEntry Arenas[AEC_MEMORY_STATS_MAX_ARENAS];
+		uint64 ArenasCount = 0;
+	};
+
+	/**
+	* File formats of the sampled allocation profile.
+	*/
+	enum class ESampledProfileFormat : uint8
+	{
+		/**
+		* Legacy text heap profile ('heap_v2'), with the sampled counts and the loaded modules. Read by 'pprof', which also symbolizes it.
+		*/
+		Pprof,
+
+		/**
+		* One 'Root;...;Leaf Bytes' line per call stack, with the estimated live bytes. Read by 'flamegraph.pl' and 'speedscope'.
+		* The frames are symbolized in-process, so only the exported functions have names.
+		*/
+		Folded
+	};
+
 	/**
 	* C++ Core Profiling Tool
-	* 
+	*
 	* Keeps track of memory allocation, providing EDITOR & RUNTIME memory information
 	*/
 	class APRICOT_API AMemoryProfiler
@@ -26,8 +231,91 @@ namespace Apricot {
 		static void Init();
 		static void Destroy();
 
-		static void SubmitHeapAllocation(uint64 size, uint64 alignment);
+		/**
+		* Must be called after the allocation, even if it failed (with a nullptr block).
+		*/
+		static void SubmitHeapAllocation(void* block, uint64 size, uint64 alignment);
 		static void SubmitHeapDeallocation(void* block, uint64 size);
+		static void SubmitHeapReallocation(void* oldBlock, uint64 oldSize, void* newBlock, uint64 newSize);
+
+		/**
+		* The block is the one returned to the caller of HeapAllocator, which was already submitted as a heap allocation.
+		*/
+		static void SubmitHintAllocation(EAllocatorHint hint, void* block, uint64 size);
+		static void SubmitHintDeallocation(EAllocatorHint hint, uint64 size);
+		static void SubmitHintReallocation(EAllocatorHint hint, void* block, uint64 oldSize, uint64 newSize);
+
+		NODISCARD static const TChar* GetAllocatorHintName(EAllocatorHint hint);
+
+	/* Statistics */
+	public:
+		/**
+		* Makes the statistics of the arena visible in the snapshots. Only arenas that have allocated at least once are registered.
+		* The debug name is stored, so that the snapshot never has to call into an arena that is being destroyed on another thread.
+		*/
+		static void RegisterArena(AMemoryArena* Arena, const TChar* DebugName, AAllocationStats* Stats);
+		static void UnregisterArena(const AMemoryArena* Arena);
+
+		using PFN_ArenaCallback = void(*)(AMemoryArena* Arena, const TChar* DebugName, void* UserData);
+
+		/**
+		* Calls 'Callback' for every registered arena. The arenas can't be destroyed until it returns, so the callback
+		*	must not create, destroy or allocate from an arena that isn't registered yet.
+		*/
+		static void EnumerateArenas(PFN_ArenaCallback Callback, void* UserData);
+
+		/**
+		* Copies all the statistics. Cheap enough to be called every frame.
+		* Only copies the hint heaps' counters if AE_ENABLE_MEMORY_STATS isn't defined.
+		*/
+		static void TakeStatsSnapshot(AMemoryStatsSnapshot& OutSnapshot);
+
+		/**
+		* Writes the snapshot to the log, skipping the hints and arenas that were never used.
+		*/
+		static void LogStatsSnapshot(const AMemoryStatsSnapshot& Snapshot);
+
+		/**
+		* Resets the peaks of all the statistics to their current live bytes. Call it once per frame to get the per-frame peaks.
+		*/
+		static void ResetStatsPeaks();
+
+	/* Sampling */
+	public:
+		/**
+		* Sets the mean number of bytes allocated through GMalloc between two sampled allocations. 0 disables the sampling.
+		* The allocations are sampled like a Poisson process over the allocated bytes, so an allocation of 'Size' bytes is sampled with
+		*	the probability 1 - e^(-Size / Rate). Every thread picks up the new rate after its next sample.
+		* Does nothing if AE_ENABLE_MEMORY_SAMPLING isn't defined.
+		*/
+		static void SetSamplingRate(uint64 Rate);
+		static uint64 GetSamplingRate();
+
+		/**
+		* Writes the call stacks of the sampled allocations that are still alive. Can be called from any thread, at any time.
+		*
+		* @returns False if the file couldn't be written or AE_ENABLE_MEMORY_SAMPLING isn't defined.
+		*/
+		static bool8 DumpSampledProfile(const char8* FilePath, ESampledProfileFormat Format);
+
+	/* Recording */
+	public:
+		/**
+		* Starts writing every allocation and free made through GMalloc and the arenas to a trace file, with its size,
+		*	alignment, hint, thread and timestamp. The trace can be replayed against any allocator by ApricotBench.
+		* Recording costs a lock and a store per allocation, so it is meant for capturing a workload, not to be left on.
+		* See AAllocationRecorder for the file format.
+		*
+		* @returns False if a recording is already running, if the file couldn't be created or AE_ENABLE_MEMORY_RECORDING isn't defined.
+		*/
+		static bool8 StartRecording(const char8* FilePath);
+
+		/**
+		* Writes the buffered events and closes the trace file. Called by ApricotMemoryDestroy if the recording is still running.
+		*/
+		static void StopRecording();
+
+		static bool8 IsRecording();
 
 	/* Friends */
 	private:
@@ -37,4 +325,4 @@ namespace Apricot {
 
 	APRICOT_API extern AMemoryProfiler* GMemoryProfiler;
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,91 @@
+// Part of Apricot Engine. 2022-2022.
+// Submodule: Profiling
+
+#include "aepch.h"
+#include "NoAllocScope.h"
+
+#include "MemoryProfiler.h"
+
+#include "Apricot/Core/Assert.h"
+
+namespace Apricot {
+
+#ifdef AE_ENABLE_NO_ALLOC_SCOPES
+
+	/**
+	* The innermost no-allocation scope of the thread, or nullptr if the thread isn't inside one.
+	*/
+	static thread_local ANoAllocScope* GCurrentNoAllocScope = nullptr;
+
+#endif // AE_ENABLE_NO_ALLOC_SCOPES
+
+	ANoAllocScope::ANoAllocScope(const TChar* File, uint32 Line)
+		: m_File(File)
+		, m_Line(Line)
+	{
+#ifdef AE_ENABLE_NO_ALLOC_SCOPES
+
+		m_Parent = GCurrentNoAllocScope;
+		GCurrentNoAllocScope = this;
+
+#endif // AE_ENABLE_NO_ALLOC_SCOPES
+	}
+
+	ANoAllocScope::~ANoAllocScope()
+	{
+#ifdef AE_ENABLE_NO_ALLOC_SCOPES
+
+		// Restored first, so that the allocations made while reporting aren't counted by this scope.
+		GCurrentNoAllocScope = m_Parent;
+
+		if (m_AllocationsCount == 0)
+		{
+			return;
+		}
+
+		AE_CORE_ERROR(TEXT("NoAllocScope - {} heap allocations ({} bytes) inside the no-allocation scope at '{}', line {}. The first one was {} bytes, with the '{}' hint."),
+			m_AllocationsCount, m_AllocatedBytes, m_File, m_Line, m_FirstSize, AMemoryProfiler::GetAllocatorHintName(m_FirstHint));
+
+	#if AEC_NO_ALLOC_SCOPE_ASSERT
+		AE_CORE_ASSERT(m_AllocationsCount == 0, TEXT("The thread allocated from the heap inside a no-allocation scope!"));
+	#endif
+
+#endif // AE_ENABLE_NO_ALLOC_SCOPES
+	}
+
+	void ANoAllocScope::SubmitAllocation(const void* Block, uint64 Size)
+	{
+#ifdef AE_ENABLE_NO_ALLOC_SCOPES
+
+		ANoAllocScope* Scope = GCurrentNoAllocScope;
+		if (!Scope)
+		{
+			return;
+		}
+
+		if (Scope->m_AllocationsCount == 0)
+		{
+			Scope->m_FirstBlock = Block;
+			Scope->m_FirstSize = Size;
+		}
+
+		Scope->m_AllocationsCount++;
+		Scope->m_AllocatedBytes += Size;
+
+#endif // AE_ENABLE_NO_ALLOC_SCOPES
+	}
+
+	void ANoAllocScope::SubmitAllocationHint(const void* Block, EAllocatorHint Hint)
+	{
+#ifdef AE_ENABLE_NO_ALLOC_SCOPES
+
+		ANoAllocScope* Scope = GCurrentNoAllocScope;
+		if (Scope && Scope->m_AllocationsCount > 0 && Scope->m_FirstBlock == Block)
+		{
+			Scope->m_FirstHint = Hint;
+		}
+
+#endif // AE_ENABLE_NO_ALLOC_SCOPES
+	}
+
+}
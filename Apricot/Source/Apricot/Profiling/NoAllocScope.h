@@ -0,0 +1,65 @@
+// Part of Apricot Engine. 2022-2022.
+// Submodule: Profiling
+
+#pragma once
+
+#include "Apricot/Core/Base.h"
+#include "Apricot/Core/Memory/ApricotAllocator.h"
+
+namespace Apricot {
+
+	/**
+	* C++ Core Profiling Tool
+	*
+	* Marks a scope in which the current thread must not allocate from the heap. Every allocation and reallocation that is
+	*	submitted to AMemoryProfiler as a heap allocation (GMalloc, APlatform::Malloc and HeapAllocator) is counted by the innermost
+	*	scope of the thread. The arenas aren't counted, because they are the intended replacement for the heap on the hot paths.
+	* When a scope with allocations is destroyed, it logs their count and the size and hint of the first one, then asserts if
+	*	AEC_NO_ALLOC_SCOPE_ASSERT is 1.
+	*
+	* Use it through AE_NO_ALLOC_SCOPE. Only active when AE_ENABLE_NO_ALLOC_SCOPES is defined. Otherwise, nothing is counted.
+	*/
+	class APRICOT_API ANoAllocScope
+	{
+	/* Constructors & Deconstructor */
+	public:
+		ANoAllocScope(const TChar* File, uint32 Line);
+		~ANoAllocScope();
+
+		ANoAllocScope(const ANoAllocScope&) = delete;
+		ANoAllocScope& operator=(const ANoAllocScope&) = delete;
+
+	public:
+		FORCEINLINE uint64 GetAllocationsCount() const { return m_AllocationsCount; }
+
+		/**
+		* Called by AMemoryProfiler for every heap allocation and reallocation.
+		*/
+		static void SubmitAllocation(const void* Block, uint64 Size);
+
+		/**
+		* Called by AMemoryProfiler after a HeapAllocator allocation, so the hint of the scope's first allocation is known.
+		*/
+		static void SubmitAllocationHint(const void* Block, EAllocatorHint Hint);
+
+	private:
+		ANoAllocScope* m_Parent = nullptr;
+
+		const TChar* m_File = nullptr;
+		uint32 m_Line = 0;
+
+		uint64 m_AllocationsCount = 0;
+		uint64 m_AllocatedBytes = 0;
+
+		const void* m_FirstBlock = nullptr;
+		uint64 m_FirstSize = 0;
+		EAllocatorHint m_FirstHint = EAllocatorHint::None;
+	};
+
+}
+
+#ifdef AE_ENABLE_NO_ALLOC_SCOPES
+	#define AE_NO_ALLOC_SCOPE() ::Apricot::ANoAllocScope AE_CONCATENATE(___NOALLOCSCOPE, AE_LINE) = ::Apricot::ANoAllocScope(AE_FILE, AE_LINE)
+#else
+	#define AE_NO_ALLOC_SCOPE()
+#endif
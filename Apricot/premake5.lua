@@ -43,6 +43,11 @@ project "AE"
 			"AE_UNICODE"
 		}
 
+		-- Symbolization of the sampled allocation call stacks.
+		links {
+			"Dbghelp"
+		}
+
 	filter { "configurations:Debug_Editor" }
 		defines {
 			"AE_CONFIG_DEBUG_EDITOR"
@@ -163,4 +168,25 @@ project "AE"
 				
 			}
 
+	filter { "system:linux" }
+		pic "On"
+		defines {
+			"AE_PLATFORM_LINUX",
+			"AE_ANSII"
+		}
+
+		targetdir "%{wks.location}/Binaries/Linux-%{cfg.buildcfg}"
+		objdir "%{wks.location}/Binaries-Int/Linux/%{prj.name}"
+
+		-- 'dladdr' and 'dl_iterate_phdr' live in libdl on older glibc versions.
+		links {
+			"dl"
+		}
+
+		-- The bundled Optick binaries and the Vulkan import library are Windows only.
+		removelinks {
+			"%{Libraries.Vulkan}",
+			"%{Libraries.Optick}"
+		}
+
 	filter {}
\ No newline at end of file
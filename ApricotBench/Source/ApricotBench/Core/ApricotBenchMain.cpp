@@ -0,0 +1,77 @@
+// Part of Apricot Engine. 2022-2022.
+// Module: Bench
+
+#include "abpch.h"
+
+#include "ApricotBench/Core/Benchmark.h"
+#include "ApricotBench/Replay/TraceReplay.h"
+#include "ApricotBench/Suites/AllocatorSuite.h"
+
+#include <Apricot/Core/CrashReporter.h>
+#include <Apricot/Core/Platform.h>
+#include <Apricot/Core/Memory/ApricotMemory.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+
+/**
+* Usage: ApricotBench [OutputPath]
+*        ApricotBench --replay <TracePath> [Allocator]
+* The results are printed and written as JSON to 'OutputPath' (ApricotBench.json by default).
+* With '--replay', the allocation trace is replayed against the allocator (GMalloc, Freelist, Pool or malloc), or against
+*	all of them if it isn't given, and nothing is written.
+* Only the Release and Shipping results are meaningful: the Debug configurations trace every heap allocation.
+*/
+int main(int ArgumentsCount, char** Arguments)
+{
+	using namespace Apricot;
+
+	// Init foundational systems.
+	APlatform::Init();
+	ApricotMemoryInit();
+	ACrashReporter::Init();
+
+#ifdef AE_DEBUG
+	printf("Warning: ApricotBench runs in a Debug configuration, so the results are not representative!\n");
+#endif
+
+	int ReturnCode = 0;
+	if (ArgumentsCount > 1 && strcmp(Arguments[1], "--replay") == 0)
+	{
+		if (ArgumentsCount < 3)
+		{
+			printf("Usage: ApricotBench --replay <TracePath> [Allocator]\n");
+			ReturnCode = 1;
+		}
+		else if (!RunTraceReplay(Arguments[2], ArgumentsCount > 3 ? Arguments[3] : nullptr))
+		{
+			ReturnCode = 1;
+		}
+	}
+	else
+	{
+		const char8* OutputPath = ArgumentsCount > 1 ? Arguments[1] : "ApricotBench.json";
+
+		// The multi-threaded scenarios use up to 8 threads, but never more than the hardware can run at once.
+		uint64 ThreadsCount = std::thread::hardware_concurrency();
+		ThreadsCount = ThreadsCount < 8 ? ThreadsCount : 8;
+
+		ABenchmarkRunner Runner;
+		ABenchmarkSpecification Specification;
+		RunAllocatorSuite(Runner, Specification, ThreadsCount);
+
+		if (!Runner.WriteJson(OutputPath))
+		{
+			printf("Failed to write the results to '%s'!\n", OutputPath);
+			ReturnCode = 1;
+		}
+	}
+
+	// Destroy foundational systems.
+	ACrashReporter::Destroy();
+	ApricotMemoryDestroy();
+	APlatform::Destroy();
+
+	return ReturnCode;
+}
@@ -0,0 +1,292 @@
+// Part of Apricot Engine. 2022-2022.
+// Module: Bench
+
+#include "abpch.h"
+#include "Benchmark.h"
+
+#include <Apricot/Core/Atomic.h>
+#include <Apricot/Core/Platform.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <thread>
+
+#if defined(AE_COMPILER_MSVC)
+	#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+	#include <x86intrin.h>
+#endif
+
+namespace Apricot {
+
+	namespace Utils {
+
+		FORCEINLINE static uint64 ReadCycleCounter()
+		{
+		#if defined(AE_COMPILER_MSVC) || defined(__x86_64__) || defined(__i386__)
+			return __rdtsc();
+		#else
+			return 0;
+		#endif
+		}
+
+		/**
+		* Reusable barrier for the benchmark's threads. The last thread to arrive releases the others by bumping the generation.
+		*/
+		class ASpinBarrier
+		{
+		public:
+			ASpinBarrier(uint64 ThreadsCount)
+				: m_ThreadsCount(ThreadsCount)
+			{
+			}
+
+			void Wait()
+			{
+				uint64 Generation = m_Generation.Load(EMemoryOrder::Acquire);
+				if (m_ArrivedCount.FetchAdd(1, EMemoryOrder::AcquireRelease) + 1 == m_ThreadsCount)
+				{
+					m_ArrivedCount.Store(0, EMemoryOrder::Relaxed);
+					m_Generation.FetchAdd(1, EMemoryOrder::Release);
+					return;
+				}
+
+				while (m_Generation.Load(EMemoryOrder::Acquire) == Generation)
+				{
+					CpuPause();
+				}
+			}
+
+		private:
+			const uint64 m_ThreadsCount;
+			TAtomic<uint64> m_ArrivedCount = 0;
+			TAtomic<uint64> m_Generation = 0;
+		};
+
+		/**
+		* The samples of a thread, for every repetition (warmup included).
+		*/
+		struct AThreadSamples
+		{
+			TVector<uint64> Nanoseconds;
+			TVector<uint64> Cycles;
+		};
+
+		static void RunBenchmarkThread(ABenchmark& Benchmark, const ABenchmarkSpecification& Specification, ASpinBarrier& Barrier,
+			uint64 ThreadIndex, AThreadSamples& OutSamples)
+		{
+			Benchmark.SetupThread(ThreadIndex);
+
+			uint64 RepetitionsCount = Specification.WarmupRepetitions + Specification.Repetitions;
+			for (uint64 Repetition = 0; Repetition < RepetitionsCount; Repetition++)
+			{
+				Benchmark.BeginRepetition(ThreadIndex);
+				Barrier.Wait();
+
+				uint64 StartNanoseconds = APlatform::GetSystemPerformanceTime();
+				uint64 StartCycles = ReadCycleCounter();
+
+				Benchmark.Run(ThreadIndex, Specification.OperationsCount);
+
+				uint64 EndCycles = ReadCycleCounter();
+				uint64 EndNanoseconds = APlatform::GetSystemPerformanceTime();
+
+				OutSamples.Nanoseconds[Repetition] = EndNanoseconds - StartNanoseconds;
+				OutSamples.Cycles[Repetition] = EndCycles - StartCycles;
+
+				Benchmark.EndRepetition(ThreadIndex);
+				Barrier.Wait();
+			}
+
+			Benchmark.TeardownThread(ThreadIndex);
+		}
+
+		static void SortSamples(TVector<float64>& Samples)
+		{
+			for (uint64 Index = 1; Index < Samples.Size(); Index++)
+			{
+				float64 Sample = Samples[Index];
+				uint64 InsertIndex = Index;
+				while (InsertIndex > 0 && Samples[InsertIndex - 1] > Sample)
+				{
+					Samples[InsertIndex] = Samples[InsertIndex - 1];
+					InsertIndex--;
+				}
+				Samples[InsertIndex] = Sample;
+			}
+		}
+
+		/**
+		* The samples must be sorted.
+		*/
+		static float64 GetMedian(const TVector<float64>& Samples)
+		{
+			uint64 Middle = Samples.Size() / 2;
+			return (Samples.Size() % 2) ? Samples[Middle] : (Samples[Middle - 1] + Samples[Middle]) * 0.5;
+		}
+
+		/**
+		* Nearest-rank percentile. The samples must be sorted.
+		*/
+		static float64 GetPercentile(const TVector<float64>& Samples, float64 Percentile)
+		{
+			uint64 Rank = (uint64)ceil(Percentile * 0.01 * (float64)Samples.Size());
+			return Samples[Rank > 0 ? Rank - 1 : 0];
+		}
+
+		static FILE* OpenFileForWriting(const char8* FilePath)
+		{
+		#ifdef AE_PLATFORM_WINDOWS
+			FILE* File = nullptr;
+			return fopen_s(&File, FilePath, "wb") == 0 ? File : nullptr;
+		#else
+			return fopen(FilePath, "wb");
+		#endif
+		}
+
+		/**
+		* Writes a JSON string. Only the quotes and the backslashes are escaped, as the names are plain identifiers.
+		*/
+		static void WriteJsonString(FILE* File, const char8* String)
+		{
+			fputc('"', File);
+			for (const char8* Character = String; *Character; Character++)
+			{
+				if (*Character == '"' || *Character == '\\')
+				{
+					fputc('\\', File);
+				}
+				fputc(*Character, File);
+			}
+			fputc('"', File);
+		}
+
+	}
+
+	const ABenchmarkResult& ABenchmarkRunner::Run(ABenchmark& Benchmark, const ABenchmarkSpecification& Specification)
+	{
+		AE_CORE_ASSERT(Specification.ThreadsCount > 0 && Specification.Repetitions > 0 && Specification.OperationsCount > 0);
+
+		uint64 RepetitionsCount = Specification.WarmupRepetitions + Specification.Repetitions;
+
+		TVector<Utils::AThreadSamples> ThreadSamples(Specification.ThreadsCount);
+		for (uint64 ThreadIndex = 0; ThreadIndex < Specification.ThreadsCount; ThreadIndex++)
+		{
+			ThreadSamples.EmplaceBack();
+			ThreadSamples[ThreadIndex].Nanoseconds.SetSize(RepetitionsCount);
+			ThreadSamples[ThreadIndex].Cycles.SetSize(RepetitionsCount);
+		}
+
+		Benchmark.Setup(Specification);
+
+		Utils::ASpinBarrier Barrier(Specification.ThreadsCount);
+		TVector<std::thread> Threads(Specification.ThreadsCount - 1);
+		for (uint64 ThreadIndex = 1; ThreadIndex < Specification.ThreadsCount; ThreadIndex++)
+		{
+			Threads.EmplaceBack(Utils::RunBenchmarkThread, std::ref(Benchmark), std::cref(Specification), std::ref(Barrier), ThreadIndex, std::ref(ThreadSamples[ThreadIndex]));
+		}
+		Utils::RunBenchmarkThread(Benchmark, Specification, Barrier, 0, ThreadSamples[0]);
+		for (uint64 Index = 0; Index < Threads.Size(); Index++)
+		{
+			Threads[Index].join();
+		}
+
+		Benchmark.Teardown();
+
+		// Every sample is the slowest thread's repetition, divided by the operations of a thread.
+		TVector<float64> Nanoseconds(Specification.Repetitions);
+		TVector<float64> Cycles(Specification.Repetitions);
+		for (uint64 Repetition = Specification.WarmupRepetitions; Repetition < RepetitionsCount; Repetition++)
+		{
+			uint64 SlowestNanoseconds = 0;
+			uint64 SlowestCycles = 0;
+			for (uint64 ThreadIndex = 0; ThreadIndex < Specification.ThreadsCount; ThreadIndex++)
+			{
+				if (ThreadSamples[ThreadIndex].Nanoseconds[Repetition] > SlowestNanoseconds)
+				{
+					SlowestNanoseconds = ThreadSamples[ThreadIndex].Nanoseconds[Repetition];
+				}
+				if (ThreadSamples[ThreadIndex].Cycles[Repetition] > SlowestCycles)
+				{
+					SlowestCycles = ThreadSamples[ThreadIndex].Cycles[Repetition];
+				}
+			}
+
+			Nanoseconds.PushBack((float64)SlowestNanoseconds / (float64)Specification.OperationsCount);
+			Cycles.PushBack((float64)SlowestCycles / (float64)Specification.OperationsCount);
+		}
+
+		Utils::SortSamples(Nanoseconds);
+		Utils::SortSamples(Cycles);
+
+		ABenchmarkResult& Result = m_Results.EmplaceBack();
+		Result.Scenario = Benchmark.GetScenario();
+		Result.Allocator = Benchmark.GetAllocator();
+		Result.Specification = Specification;
+		Result.MinNanoseconds = Nanoseconds[0];
+		Result.MedianNanoseconds = Utils::GetMedian(Nanoseconds);
+		Result.P99Nanoseconds = Utils::GetPercentile(Nanoseconds, 99.0);
+		Result.MedianCycles = Utils::GetMedian(Cycles);
+
+		float64 Sum = 0.0;
+		for (uint64 Index = 0; Index < Nanoseconds.Size(); Index++)
+		{
+			Sum += Nanoseconds[Index];
+		}
+		Result.MeanNanoseconds = Sum / (float64)Nanoseconds.Size();
+
+		float64 SquaredDeviationsSum = 0.0;
+		for (uint64 Index = 0; Index < Nanoseconds.Size(); Index++)
+		{
+			float64 Deviation = Nanoseconds[Index] - Result.MeanNanoseconds;
+			SquaredDeviationsSum += Deviation * Deviation;
+		}
+		Result.StdDevNanoseconds = Nanoseconds.Size() > 1 ? sqrt(SquaredDeviationsSum / (float64)(Nanoseconds.Size() - 1)) : 0.0;
+
+		printf("%-24s %-16s %3llu threads | median %8.2f ns | p99 %8.2f ns | min %8.2f ns | %8.1f cycles\n",
+			Result.Scenario, Result.Allocator, (unsigned long long)Specification.ThreadsCount,
+			Result.MedianNanoseconds, Result.P99Nanoseconds, Result.MinNanoseconds, Result.MedianCycles);
+
+		return Result;
+	}
+
+	bool8 ABenchmarkRunner::WriteJson(const char8* FilePath) const
+	{
+		FILE* File = Utils::OpenFileForWriting(FilePath);
+		if (File == nullptr)
+		{
+			return false;
+		}
+
+		fprintf(File, "{\n\t\"Benchmarks\": [\n");
+		for (uint64 Index = 0; Index < m_Results.Size(); Index++)
+		{
+			const ABenchmarkResult& Result = m_Results[Index];
+
+			fprintf(File, "\t\t{\n\t\t\t\"Scenario\": ");
+			Utils::WriteJsonString(File, Result.Scenario);
+			fprintf(File, ",\n\t\t\t\"Allocator\": ");
+			Utils::WriteJsonString(File, Result.Allocator);
+			fprintf(File, ",\n");
+
+			fprintf(File, "\t\t\t\"Threads\": %llu,\n", (unsigned long long)Result.Specification.ThreadsCount);
+			fprintf(File, "\t\t\t\"WarmupRepetitions\": %llu,\n", (unsigned long long)Result.Specification.WarmupRepetitions);
+			fprintf(File, "\t\t\t\"Repetitions\": %llu,\n", (unsigned long long)Result.Specification.Repetitions);
+			fprintf(File, "\t\t\t\"OperationsPerRepetition\": %llu,\n", (unsigned long long)Result.Specification.OperationsCount);
+			fprintf(File, "\t\t\t\"MinNanoseconds\": %.3f,\n", Result.MinNanoseconds);
+			fprintf(File, "\t\t\t\"MedianNanoseconds\": %.3f,\n", Result.MedianNanoseconds);
+			fprintf(File, "\t\t\t\"P99Nanoseconds\": %.3f,\n", Result.P99Nanoseconds);
+			fprintf(File, "\t\t\t\"MeanNanoseconds\": %.3f,\n", Result.MeanNanoseconds);
+			fprintf(File, "\t\t\t\"StdDevNanoseconds\": %.3f,\n", Result.StdDevNanoseconds);
+			fprintf(File, "\t\t\t\"MedianCycles\": %.3f\n", Result.MedianCycles);
+
+			fprintf(File, "\t\t}%s\n", Index + 1 < m_Results.Size() ? "," : "");
+		}
+		fprintf(File, "\t]\n}\n");
+
+		bool8 bSucceeded = ferror(File) == 0;
+		fclose(File);
+		return bSucceeded;
+	}
+
+}
@@ -0,0 +1,124 @@
+// Part of Apricot Engine. 2022-2022.
+// Module: Bench
+
+#pragma once
+
+#include <Apricot/Core/Base.h>
+#include <Apricot/Containers/Vector.h>
+
+namespace Apricot {
+
+	struct ABenchmarkSpecification
+	{
+		/**
+		* Repetitions that run before the measured ones and are discarded, so that the caches, the page tables and the
+		*	allocators' pages are warm when the measurement starts.
+		*/
+		uint64 WarmupRepetitions = 10;
+
+		/**
+		* Measured repetitions. Every repetition is one sample of the statistics, so the 99th percentile only differs from
+		*	the maximum with at least 100 repetitions.
+		*/
+		uint64 Repetitions = 101;
+
+		/**
+		* Operations run by every thread in a repetition. The results are divided by it, so they are per operation.
+		*/
+		uint64 OperationsCount = 4096;
+
+		uint64 ThreadsCount = 1;
+	};
+
+	/**
+	* Statistics of a benchmark, per operation. With multiple threads, a repetition lasts until its slowest thread finishes,
+	*	so the times measure the cost of an operation under contention.
+	*/
+	struct ABenchmarkResult
+	{
+		const char8* Scenario = nullptr;
+		const char8* Allocator = nullptr;
+
+		ABenchmarkSpecification Specification;
+
+		float64 MinNanoseconds = 0.0;
+		float64 MedianNanoseconds = 0.0;
+		float64 P99Nanoseconds = 0.0;
+		float64 MeanNanoseconds = 0.0;
+		float64 StdDevNanoseconds = 0.0;
+
+		/**
+		* Timestamp counter ticks, which run at a constant reference frequency rather than at the core's current one.
+		* 0 on the platforms without a timestamp counter.
+		*/
+		float64 MedianCycles = 0.0;
+	};
+
+	/**
+	* C++ Bench Architecture
+	*
+	* A single micro-benchmark: one scenario, run against one allocator.
+	* The runner calls 'Setup' once, then 'SetupThread' on every thread, then for every repetition (warmup included) 'BeginRepetition',
+	*	the measured 'Run' and 'EndRepetition' on every thread, then 'TeardownThread' on every thread. Only 'Run' is timed.
+	*	Thread 0 is always the runner's thread.
+	* The per-thread state that belongs to a thread, like an arena that isn't thread-safe, should be created and destroyed in
+	*	'SetupThread' and 'TeardownThread', on the thread that uses it.
+	*/
+	class ABenchmark
+	{
+	public:
+		ABenchmark(const char8* Scenario, const char8* Allocator)
+			: m_Scenario(Scenario), m_Allocator(Allocator)
+		{
+		}
+
+		virtual ~ABenchmark() = default;
+
+	public:
+		virtual void Setup(const ABenchmarkSpecification& Specification) {}
+		virtual void Teardown() {}
+
+		virtual void SetupThread(uint64 ThreadIndex) {}
+		virtual void TeardownThread(uint64 ThreadIndex) {}
+
+		virtual void BeginRepetition(uint64 ThreadIndex) {}
+		virtual void Run(uint64 ThreadIndex, uint64 OperationsCount) = 0;
+		virtual void EndRepetition(uint64 ThreadIndex) {}
+
+	public:
+		FORCEINLINE const char8* GetScenario() const { return m_Scenario; }
+		FORCEINLINE const char8* GetAllocator() const { return m_Allocator; }
+
+	private:
+		const char8* m_Scenario;
+		const char8* m_Allocator;
+	};
+
+	/**
+	* C++ Bench Architecture
+	*
+	* Runs the benchmarks and keeps their results. The threads of a benchmark are started once and synchronized with a
+	*	spinning barrier before every repetition, so the thread creation is never measured.
+	*/
+	class ABenchmarkRunner
+	{
+	public:
+		/**
+		* Runs the benchmark, prints its result and keeps it for 'WriteJson'.
+		*/
+		const ABenchmarkResult& Run(ABenchmark& Benchmark, const ABenchmarkSpecification& Specification);
+
+		/**
+		* Writes all the results as a JSON document: { "Benchmarks": [ { "Scenario": ..., "Allocator": ..., ... }, ... ] }.
+		*
+		* @returns False if the file couldn't be written.
+		*/
+		bool8 WriteJson(const char8* FilePath) const;
+
+		FORCEINLINE const TVector<ABenchmarkResult>& GetResults() const { return m_Results; }
+
+	private:
+		TVector<ABenchmarkResult> m_Results;
+	};
+
+}
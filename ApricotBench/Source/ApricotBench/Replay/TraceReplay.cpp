@@ -0,0 +1,752 @@
+// Part of Apricot Engine. 2022-2022.
+// Module: Bench
+
+#include "abpch.h"
+#include "TraceReplay.h"
+
+#include <Apricot/Core/Platform.h>
+#include <Apricot/Core/Memory/ApricotMemory.h>
+#include <Apricot/Core/Memory/FreelistArena.h>
+#include <Apricot/Core/Memory/PoolArena.h>
+#include <Apricot/Profiling/AllocationRecorder.h>
+
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace Apricot {
+
+	namespace Utils {
+
+		/**
+		* The operations are measured in batches. The resident memory and the arenas' sizes are sampled between the
+		*	batches, outside of the measurement.
+		*/
+		static constexpr uint64 ReplayBatchSize = 65536;
+
+		/**
+		* Events read from the trace file at once.
+		*/
+		static constexpr uint64 ReadChunkEventsCount = 4096;
+
+		static constexpr uint32 InvalidSlot = 0xFFFFFFFF;
+
+		enum class EReplayOperationType : uint8
+		{
+			Allocate = 0,
+			Free
+		};
+
+		/**
+		* A single operation of the replay. The blocks of the trace are mapped to slots, which hold the replayed blocks.
+		*	The slots are reused, so there are only as many as the peak count of live blocks.
+		*/
+		struct AReplayOperation
+		{
+			uint64 Size;
+			uint32 Slot;
+			uint8 AlignmentLog2;
+			EReplayOperationType Type;
+		};
+
+		/**
+		* The trace, turned into the operations of the replay. Everything that isn't an allocation or a free of a single
+		*	block (the arenas' 'FreeAll' and 'Rewind') is expanded here, so the replay itself only runs the allocator.
+		*/
+		struct AReplayTrace
+		{
+			TVector<AReplayOperation> Operations;
+			uint64 SlotsCount = 0;
+			uint64 AllocationsCount = 0;
+			uint64 PeakLiveBytes = 0;
+
+			/**
+			* Frees of blocks that weren't allocated while recording, and blocks that were allocated again before being freed.
+			*	Both happen when the recording starts or stops in the middle of the workload, or when events were dropped.
+			*	Events of an unknown type are counted too.
+			*/
+			uint64 UnmatchedEventsCount = 0;
+		};
+
+		/**
+		* Maps the blocks of the trace, keyed by their arena and address, to their slots.
+		* Linear probing with backward shift deletion, so the table never fills with tombstones, however long the trace is.
+		*/
+		class AReplayBlockMap
+		{
+		public:
+			AReplayBlockMap()
+			{
+				Rehash(1024);
+			}
+
+			/**
+			* The blocks are never null, so a key is never 0.
+			*/
+			FORCEINLINE static uint64 GetKey(uint16 ArenaId, uint64 Block)
+			{
+				return ((uint64)ArenaId << 48) | (Block & 0x0000FFFFFFFFFFFFull);
+			}
+
+			/**
+			* The key must not be in the map already.
+			*/
+			void Insert(uint64 Key, uint32 Slot)
+			{
+				if ((m_Count + 1) * 2 > m_Entries.Size())
+				{
+					Rehash(m_Entries.Size() * 2);
+				}
+
+				uint64 Index = GetHomeIndex(Key);
+				while (m_Entries[Index].Key != 0)
+				{
+					Index = (Index + 1) & m_Mask;
+				}
+
+				m_Entries[Index].Key = Key;
+				m_Entries[Index].Slot = Slot;
+				m_Count++;
+			}
+
+			/**
+			* @returns The slot of the removed key, or InvalidSlot if it wasn't in the map.
+			*/
+			uint32 Remove(uint64 Key)
+			{
+				uint64 Index = GetHomeIndex(Key);
+				while (m_Entries[Index].Key != Key)
+				{
+					if (m_Entries[Index].Key == 0)
+					{
+						return InvalidSlot;
+					}
+					Index = (Index + 1) & m_Mask;
+				}
+
+				uint32 Slot = m_Entries[Index].Slot;
+
+				// Shift back the following entries of the cluster that can't be found anymore past the hole.
+				uint64 Hole = Index;
+				for (uint64 Next = (Index + 1) & m_Mask; m_Entries[Next].Key != 0; Next = (Next + 1) & m_Mask)
+				{
+					uint64 Home = GetHomeIndex(m_Entries[Next].Key);
+					if (((Next - Home) & m_Mask) >= ((Next - Hole) & m_Mask))
+					{
+						m_Entries[Hole] = m_Entries[Next];
+						Hole = Next;
+					}
+				}
+
+				m_Entries[Hole].Key = 0;
+				m_Count--;
+				return Slot;
+			}
+
+		private:
+			struct AEntry
+			{
+				uint64 Key;
+				uint32 Slot;
+			};
+
+			FORCEINLINE uint64 GetHomeIndex(uint64 Key) const
+			{
+				return (Key * 0x9E3779B97F4A7C15ull) >> m_Shift;
+			}
+
+			void Rehash(uint64 NewCapacity)
+			{
+				TVector<AEntry> OldEntries = std::move(m_Entries);
+
+				m_Entries.SetSize(NewCapacity);
+				for (uint64 Index = 0; Index < NewCapacity; Index++)
+				{
+					m_Entries[Index].Key = 0;
+				}
+				m_Mask = NewCapacity - 1;
+				m_Shift = 64 - FindLastSetBit(NewCapacity);
+				m_Count = 0;
+
+				for (uint64 Index = 0; Index < OldEntries.Size(); Index++)
+				{
+					if (OldEntries[Index].Key != 0)
+					{
+						Insert(OldEntries[Index].Key, OldEntries[Index].Slot);
+					}
+				}
+			}
+
+		private:
+			TVector<AEntry> m_Entries;
+			uint64 m_Mask = 0;
+			uint64 m_Shift = 0;
+			uint64 m_Count = 0;
+		};
+
+		/**
+		* The state of a slot while the trace is converted.
+		*/
+		struct AReplaySlot
+		{
+			uint64 Key;
+			uint64 Size;
+
+			/**
+			* Incremented every time the slot is reused, so that the arenas' lists can tell their stale entries apart.
+			*/
+			uint32 Generation;
+
+			uint8 AlignmentLog2;
+			bool8 bIsLive;
+		};
+
+		struct AReplayArenaState
+		{
+			/**
+			* The arena's slots and their generations, in the order of their allocation, so that a 'Rewind' frees the newest
+			*	ones first. The freed blocks stay in the list until it is compacted, or until a 'FreeAll' or 'Rewind' reaches them.
+			*/
+			TVector<uint64> Slots;
+
+			uint64 LiveBytes = 0;
+			uint64 LiveBlocksCount = 0;
+		};
+
+		class AReplayTraceBuilder
+		{
+		public:
+			AReplayTraceBuilder(AReplayTrace& OutTrace)
+				: m_Trace(OutTrace)
+			{
+				m_Arenas.SetSize((uint64)0xFFFF + 1);
+			}
+
+			void Submit(const AAllocationTraceEvent& Event)
+			{
+				switch (Event.Type)
+				{
+					case EAllocationEventType::Allocate:
+					{
+						Allocate(Event);
+						break;
+					}
+					case EAllocationEventType::Free:
+					{
+						uint32 Slot = m_BlockMap.Remove(AReplayBlockMap::GetKey(Event.ArenaId, Event.Block));
+						if (Slot == InvalidSlot)
+						{
+							m_Trace.UnmatchedEventsCount++;
+							break;
+						}
+						Free(Slot, Event.ArenaId);
+						break;
+					}
+					case EAllocationEventType::FreeAll:
+					{
+						FreeArena(Event.ArenaId);
+						break;
+					}
+					case EAllocationEventType::Rewind:
+					{
+						RewindArena(Event.ArenaId, Event.Size);
+						break;
+					}
+					default:
+					{
+						// A corrupted event, or one written by a newer recorder. It is skipped.
+						m_Trace.UnmatchedEventsCount++;
+						break;
+					}
+				}
+			}
+
+		private:
+			void Allocate(const AAllocationTraceEvent& Event)
+			{
+				uint64 Key = AReplayBlockMap::GetKey(Event.ArenaId, Event.Block);
+
+				// The block was never freed, so it is freed now to keep the live set the same as the recorded one.
+				uint32 StaleSlot = m_BlockMap.Remove(Key);
+				if (StaleSlot != InvalidSlot)
+				{
+					m_Trace.UnmatchedEventsCount++;
+					Free(StaleSlot, Event.ArenaId);
+				}
+
+				uint32 Slot;
+				if (!m_FreeSlots.IsEmpty())
+				{
+					Slot = m_FreeSlots.Back();
+					m_FreeSlots.SetSize(m_FreeSlots.Size() - 1);
+				}
+				else
+				{
+					Slot = (uint32)m_Slots.Size();
+					m_Slots.PushBack({ 0, 0, 0, 0, false });
+				}
+
+				AReplaySlot& SlotState = m_Slots[Slot];
+				SlotState.Key = Key;
+				SlotState.Size = Event.Size;
+				SlotState.Generation++;
+				SlotState.AlignmentLog2 = Event.AlignmentLog2;
+				SlotState.bIsLive = true;
+				m_BlockMap.Insert(Key, Slot);
+
+				AReplayArenaState& Arena = m_Arenas[Event.ArenaId];
+				Arena.LiveBytes += Event.Size;
+				Arena.LiveBlocksCount++;
+
+				// GMalloc has neither 'FreeAll' nor 'Rewind', so it doesn't need the list.
+				if (Event.ArenaId != 0)
+				{
+					if (Arena.Slots.Size() > 2 * Arena.LiveBlocksCount + 1024)
+					{
+						CompactArenaSlots(Arena);
+					}
+					Arena.Slots.PushBack(((uint64)SlotState.Generation << 32) | Slot);
+				}
+
+				m_Trace.Operations.PushBack({ Event.Size, Slot, Event.AlignmentLog2, EReplayOperationType::Allocate });
+				m_Trace.AllocationsCount++;
+
+				m_LiveBytes += Event.Size;
+				if (m_LiveBytes > m_Trace.PeakLiveBytes)
+				{
+					m_Trace.PeakLiveBytes = m_LiveBytes;
+				}
+				if (m_Slots.Size() > m_Trace.SlotsCount)
+				{
+					m_Trace.SlotsCount = m_Slots.Size();
+				}
+			}
+
+			void Free(uint32 Slot, uint16 ArenaId)
+			{
+				AReplaySlot& SlotState = m_Slots[Slot];
+				SlotState.bIsLive = false;
+				m_FreeSlots.PushBack(Slot);
+
+				AReplayArenaState& Arena = m_Arenas[ArenaId];
+				Arena.LiveBytes -= SlotState.Size;
+				Arena.LiveBlocksCount--;
+				m_LiveBytes -= SlotState.Size;
+
+				m_Trace.Operations.PushBack({ SlotState.Size, Slot, SlotState.AlignmentLog2, EReplayOperationType::Free });
+			}
+
+			/**
+			* Frees the newest live blocks of the arena, until its live bytes are at most 'LiveBytes'.
+			*/
+			void RewindArena(uint16 ArenaId, uint64 LiveBytes)
+			{
+				AReplayArenaState& Arena = m_Arenas[ArenaId];
+				while (Arena.LiveBytes > LiveBytes && !Arena.Slots.IsEmpty())
+				{
+					uint64 Entry = Arena.Slots.Back();
+					Arena.Slots.SetSize(Arena.Slots.Size() - 1);
+
+					uint32 Slot = (uint32)Entry;
+					if (!IsEntryLive(Entry))
+					{
+						continue;
+					}
+
+					m_BlockMap.Remove(m_Slots[Slot].Key);
+					Free(Slot, ArenaId);
+				}
+			}
+
+			void FreeArena(uint16 ArenaId)
+			{
+				AReplayArenaState& Arena = m_Arenas[ArenaId];
+				for (uint64 Index = Arena.Slots.Size(); Index > 0; Index--)
+				{
+					uint64 Entry = Arena.Slots[Index - 1];
+					if (IsEntryLive(Entry))
+					{
+						m_BlockMap.Remove(m_Slots[(uint32)Entry].Key);
+						Free((uint32)Entry, ArenaId);
+					}
+				}
+				Arena.Slots.Clear();
+			}
+
+			FORCEINLINE bool8 IsEntryLive(uint64 Entry) const
+			{
+				const AReplaySlot& SlotState = m_Slots[(uint32)Entry];
+				return SlotState.bIsLive && SlotState.Generation == (uint32)(Entry >> 32);
+			}
+
+			void CompactArenaSlots(AReplayArenaState& Arena)
+			{
+				uint64 LiveCount = 0;
+				for (uint64 Index = 0; Index < Arena.Slots.Size(); Index++)
+				{
+					if (IsEntryLive(Arena.Slots[Index]))
+					{
+						Arena.Slots[LiveCount++] = Arena.Slots[Index];
+					}
+				}
+				Arena.Slots.SetSize(LiveCount);
+			}
+
+		private:
+			AReplayTrace& m_Trace;
+
+			AReplayBlockMap m_BlockMap;
+			TVector<AReplaySlot> m_Slots;
+			TVector<uint32> m_FreeSlots;
+			TVector<AReplayArenaState> m_Arenas;
+
+			uint64 m_LiveBytes = 0;
+		};
+
+
+		static bool8 ReadTrace(const char8* TracePath, TVector<AAllocationTraceEvent>& OutEvents)
+		{
+		#ifdef AE_PLATFORM_WINDOWS
+			FILE* File = nullptr;
+			fopen_s(&File, TracePath, "rb");
+		#else
+			FILE* File = fopen(TracePath, "rb");
+		#endif
+			if (File == nullptr)
+			{
+				printf("Failed to open the trace '%s'!\n", TracePath);
+				return false;
+			}
+
+			AAllocationTraceHeader Header;
+			bool8 bIsTrace = fread(&Header, sizeof(Header), 1, File) == 1 && Header.Magic == AAllocationTraceHeader::TraceMagic;
+			if (!bIsTrace || Header.Version != AAllocationTraceHeader::TraceVersion || Header.EventSize != sizeof(AAllocationTraceEvent))
+			{
+				printf("'%s' isn't an allocation trace, or it was written by another version of the recorder!\n", TracePath);
+				fclose(File);
+				return false;
+			}
+
+			// The events fill the rest of the file.
+			uint64 EventsCount = 0;
+			while (true)
+			{
+				if (EventsCount + ReadChunkEventsCount > OutEvents.Size())
+				{
+					OutEvents.SetSize(2 * OutEvents.Size() + ReadChunkEventsCount);
+				}
+
+				uint64 ReadCount = fread(OutEvents.Data() + EventsCount, sizeof(AAllocationTraceEvent), ReadChunkEventsCount, File);
+				EventsCount += ReadCount;
+				if (ReadCount < ReadChunkEventsCount)
+				{
+					break;
+				}
+			}
+			OutEvents.SetSize(EventsCount);
+
+			fclose(File);
+			return true;
+		}
+
+		static bool8 BuildReplayTrace(const char8* TracePath, AReplayTrace& OutTrace)
+		{
+			TVector<AAllocationTraceEvent> Events;
+			if (!ReadTrace(TracePath, Events))
+			{
+				return false;
+			}
+
+			// The threads write their events in batches. The sort is stable, so the events of a thread that have the same
+			//	timestamp (a reallocation is a free and an allocation) keep their order.
+			std::stable_sort(Events.Data(), Events.Data() + Events.Size(),
+				[](const AAllocationTraceEvent& A, const AAllocationTraceEvent& B) { return A.Timestamp < B.Timestamp; });
+
+			AReplayTraceBuilder Builder(OutTrace);
+			for (uint64 Index = 0; Index < Events.Size(); Index++)
+			{
+				if (Events[Index].Type < EAllocationEventType::MaxEnumValue)
+				{
+					Builder.Submit(Events[Index]);
+				}
+			}
+
+			printf("Trace '%s': %llu events, %llu allocations, %llu operations, %llu peak live blocks, %.2f MiB peak live bytes",
+				TracePath, (unsigned long long)Events.Size(), (unsigned long long)OutTrace.AllocationsCount,
+				(unsigned long long)OutTrace.Operations.Size(), (unsigned long long)OutTrace.SlotsCount,
+				(float64)OutTrace.PeakLiveBytes / (1024.0 * 1024.0));
+			if (OutTrace.UnmatchedEventsCount > 0)
+			{
+				printf(", %llu unmatched events", (unsigned long long)OutTrace.UnmatchedEventsCount);
+			}
+			printf("\n");
+
+			return true;
+		}
+
+		/**
+		* The allocator policies of the replay. The arenas start empty and grow on their own, the same as an arena that
+		*	wasn't sized for the workload. 'GetArena' returns nullptr for the allocators that aren't arenas.
+		*/
+
+		struct AGMallocReplayPolicy
+		{
+			static constexpr const char8* Name = "GMalloc";
+
+			void Init() {}
+			void Shutdown() {}
+
+			FORCEINLINE void* Alloc(uint64 Size, uint64 Alignment) { return GMalloc->Alloc(Size, Alignment); }
+			FORCEINLINE void Free(void* Block, uint64 Size, uint64 Alignment) { GMalloc->Free(Block, Size); }
+
+			const AMemoryArena* GetArena() const { return nullptr; }
+		};
+
+		struct ASystemMallocReplayPolicy
+		{
+			static constexpr const char8* Name = "malloc";
+
+			/**
+			* malloc only guarantees the alignment of the fundamental types.
+			*/
+			static constexpr uint64 MallocAlignment = 16;
+
+			void Init() {}
+			void Shutdown() {}
+
+			FORCEINLINE void* Alloc(uint64 Size, uint64 Alignment)
+			{
+				if (Alignment <= MallocAlignment)
+				{
+					return malloc(Size);
+				}
+
+			#ifdef AE_PLATFORM_WINDOWS
+				return _aligned_malloc(Size, Alignment);
+			#else
+				// The size must be a multiple of the alignment.
+				return aligned_alloc(Alignment, (Size + Alignment - 1) & ~(Alignment - 1));
+			#endif
+			}
+
+			FORCEINLINE void Free(void* Block, uint64 Size, uint64 Alignment)
+			{
+			#ifdef AE_PLATFORM_WINDOWS
+				if (Alignment > MallocAlignment)
+				{
+					_aligned_free(Block);
+					return;
+				}
+			#endif
+				free(Block);
+			}
+
+			const AMemoryArena* GetArena() const { return nullptr; }
+		};
+
+		struct AFreelistReplayPolicy
+		{
+			static constexpr const char8* Name = "Freelist";
+
+			void Init() { Arena = AFreelistArena::Create(AFreelistArenaSpecification()); }
+			void Shutdown() { Arena = NULL_SHARED; }
+
+			FORCEINLINE void* Alloc(uint64 Size, uint64 Alignment) { return Arena->AllocUnsafe(Size, Alignment); }
+			FORCEINLINE void Free(void* Block, uint64 Size, uint64 Alignment) { Arena->FreeUnsafe(Block, Size); }
+
+			const AMemoryArena* GetArena() const { return Arena.Get(); }
+
+			TSharedPtr<AFreelistArena> Arena;
+		};
+
+		struct APoolReplayPolicy
+		{
+			static constexpr const char8* Name = "Pool";
+
+			/**
+			* A pool page holds many chunks of the same size, so the pool is only used for the small blocks, as it would be
+			*	in the engine. The bigger blocks go to GMalloc.
+			*/
+			static constexpr uint64 MaxPoolBlockSize = 64 * 1024;
+
+			void Init() { Arena = APoolArena::Create(APoolArenaSpecification()); }
+			void Shutdown() { Arena = NULL_SHARED; }
+
+			FORCEINLINE void* Alloc(uint64 Size, uint64 Alignment)
+			{
+				if (Size + Alignment - 1 > MaxPoolBlockSize)
+				{
+					return GMalloc->Alloc(Size, Alignment);
+				}
+				return Arena->AllocUnsafe(Size, Alignment);
+			}
+
+			FORCEINLINE void Free(void* Block, uint64 Size, uint64 Alignment)
+			{
+				if (Size + Alignment - 1 > MaxPoolBlockSize)
+				{
+					GMalloc->Free(Block, Size);
+					return;
+				}
+				Arena->FreeUnsafe(Block, Size);
+			}
+
+			const AMemoryArena* GetArena() const { return Arena.Get(); }
+
+			TSharedPtr<APoolArena> Arena;
+		};
+
+		FORCEINLINE static uint64 GetResidentBytes()
+		{
+			APlatform::AProcessMemoryUsage Usage;
+			return APlatform::GetProcessMemoryUsage(Usage) ? Usage.ResidentBytes : 0;
+		}
+
+		FORCEINLINE static float64 ToMiB(uint64 Bytes)
+		{
+			return (float64)Bytes / (1024.0 * 1024.0);
+		}
+
+		/**
+		* Runs all the operations of the trace against the allocator. Every block has one byte written per 4 KiB, so that its
+		*	pages count in the resident memory, as they would if the block was used.
+		*/
+		template<typename PolicyType>
+		static void ReplayTrace(const AReplayTrace& Trace)
+		{
+			PolicyType Allocator;
+			Allocator.Init();
+
+			TVector<void*> Blocks;
+			Blocks.SetSize(Trace.SlotsCount);
+
+			uint64 BaselineResidentBytes = GetResidentBytes();
+			uint64 PeakResidentBytes = BaselineResidentBytes;
+			uint64 PeakArenaBytes = 0;
+			uint64 FailedAllocationsCount = 0;
+			uint64 ElapsedNanoseconds = 0;
+
+			const AReplayOperation* Operations = Trace.Operations.Data();
+			uint64 OperationsCount = Trace.Operations.Size();
+			for (uint64 BatchBegin = 0; BatchBegin < OperationsCount; BatchBegin += ReplayBatchSize)
+			{
+				uint64 BatchEnd = BatchBegin + ReplayBatchSize < OperationsCount ? BatchBegin + ReplayBatchSize : OperationsCount;
+
+				uint64 StartNanoseconds = APlatform::GetSystemPerformanceTime();
+				for (uint64 Index = BatchBegin; Index < BatchEnd; Index++)
+				{
+					const AReplayOperation& Operation = Operations[Index];
+					uint64 Alignment = 1ull << Operation.AlignmentLog2;
+
+					if (Operation.Type == EReplayOperationType::Allocate)
+					{
+						uint8* Block = (uint8*)Allocator.Alloc(Operation.Size, Alignment);
+						if (Block)
+						{
+							for (uint64 Offset = 0; Offset < Operation.Size; Offset += 4096)
+							{
+								Block[Offset] = (uint8)Index;
+							}
+						}
+						else if (Operation.Size > 0)
+						{
+							FailedAllocationsCount++;
+						}
+						Blocks[Operation.Slot] = Block;
+					}
+					else if (Blocks[Operation.Slot])
+					{
+						Allocator.Free(Blocks[Operation.Slot], Operation.Size, Alignment);
+						Blocks[Operation.Slot] = nullptr;
+					}
+				}
+				uint64 EndNanoseconds = APlatform::GetSystemPerformanceTime();
+				ElapsedNanoseconds += EndNanoseconds - StartNanoseconds;
+
+				uint64 ResidentBytes = GetResidentBytes();
+				PeakResidentBytes = ResidentBytes > PeakResidentBytes ? ResidentBytes : PeakResidentBytes;
+				if (const AMemoryArena* Arena = Allocator.GetArena())
+				{
+					uint64 ArenaBytes = Arena->GetTotalSize();
+					PeakArenaBytes = ArenaBytes > PeakArenaBytes ? ArenaBytes : PeakArenaBytes;
+				}
+			}
+
+			uint64 PeakResidentGrowth = PeakResidentBytes - BaselineResidentBytes;
+			printf("%-10s | %10.3f ms | %8.2f ns/op | peak RSS +%9.2f MiB (%6.2fx live)",
+				PolicyType::Name, (float64)ElapsedNanoseconds / 1000000.0,
+				OperationsCount > 0 ? (float64)ElapsedNanoseconds / (float64)OperationsCount : 0.0,
+				ToMiB(PeakResidentGrowth), Trace.PeakLiveBytes > 0 ? (float64)PeakResidentGrowth / (float64)Trace.PeakLiveBytes : 0.0);
+
+			if (const AMemoryArena* Arena = Allocator.GetArena())
+			{
+				// The report is taken before the remaining blocks are freed, so it describes the end of the trace.
+				AArenaFragmentationReport Report;
+				Arena->TakeFragmentationReport(Report);
+				printf(" | peak arena %9.2f MiB | final occupancy %5.1f%%, padding %.2f MiB, tail waste %.2f MiB, %llu pages",
+					ToMiB(PeakArenaBytes), Report.GetOccupancy() * 100.0f, ToMiB(Report.PaddingBytes), ToMiB(Report.TailWasteBytes),
+					(unsigned long long)Report.PagesCount);
+			}
+			if (FailedAllocationsCount > 0)
+			{
+				printf(" | %llu failed allocations", (unsigned long long)FailedAllocationsCount);
+			}
+			printf("\n");
+
+			// The last operation of a slot is met first, so a block that is still allocated is freed with its own size.
+			for (uint64 Index = OperationsCount; Index > 0; Index--)
+			{
+				const AReplayOperation& Operation = Operations[Index - 1];
+				if (Operation.Type == EReplayOperationType::Allocate && Blocks[Operation.Slot])
+				{
+					Allocator.Free(Blocks[Operation.Slot], Operation.Size, 1ull << Operation.AlignmentLog2);
+					Blocks[Operation.Slot] = nullptr;
+				}
+			}
+
+			Allocator.Shutdown();
+		}
+
+	}
+
+	bool8 RunTraceReplay(const char8* TracePath, const char8* Allocator)
+	{
+		Utils::AReplayTrace Trace;
+		if (!Utils::BuildReplayTrace(TracePath, Trace))
+		{
+			return false;
+		}
+
+		bool8 bReplayAll = Allocator == nullptr;
+		bool8 bIsKnownAllocator = bReplayAll;
+
+		if (bReplayAll || strcmp(Allocator, Utils::AGMallocReplayPolicy::Name) == 0)
+		{
+			Utils::ReplayTrace<Utils::AGMallocReplayPolicy>(Trace);
+			bIsKnownAllocator = true;
+		}
+		if (bReplayAll || strcmp(Allocator, Utils::AFreelistReplayPolicy::Name) == 0)
+		{
+			Utils::ReplayTrace<Utils::AFreelistReplayPolicy>(Trace);
+			bIsKnownAllocator = true;
+		}
+		if (bReplayAll || strcmp(Allocator, Utils::APoolReplayPolicy::Name) == 0)
+		{
+			Utils::ReplayTrace<Utils::APoolReplayPolicy>(Trace);
+			bIsKnownAllocator = true;
+		}
+		if (bReplayAll || strcmp(Allocator, Utils::ASystemMallocReplayPolicy::Name) == 0)
+		{
+			Utils::ReplayTrace<Utils::ASystemMallocReplayPolicy>(Trace);
+			bIsKnownAllocator = true;
+		}
+
+		if (!bIsKnownAllocator)
+		{
+			printf("Unknown allocator '%s'! Expected GMalloc, Freelist, Pool or malloc.\n", Allocator);
+		}
+		return bIsKnownAllocator;
+	}
+
+}
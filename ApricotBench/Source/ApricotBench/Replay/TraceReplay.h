@@ -0,0 +1,23 @@
+// Part of Apricot Engine. 2022-2022.
+// Module: Bench
+
+#pragma once
+
+#include <Apricot/Core/Base.h>
+
+namespace Apricot {
+
+	/**
+	* Replays an allocation trace, written by AAllocationRecorder, against an allocator: "GMalloc", "Freelist" (AFreelistArena),
+	*	"Pool" (APoolArena) or "malloc". If 'Allocator' is nullptr, the trace is replayed against all of them.
+	* The events of all the threads and arenas are replayed in the order of their timestamps, on a single thread and a single
+	*	allocator. For every allocator, it prints the time per operation, the peak resident memory compared to the peak of
+	*	the live bytes and, for the arenas, their fragmentation.
+	* The resident memory of a process never shrinks much, so only the first allocator of a run measures it exactly. Replay
+	*	one allocator per run to compare them.
+	*
+	* @returns False if the trace couldn't be read, or if the allocator is unknown.
+	*/
+	bool8 RunTraceReplay(const char8* TracePath, const char8* Allocator);
+
+}
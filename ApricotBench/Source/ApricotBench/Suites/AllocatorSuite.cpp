@@ -0,0 +1,686 @@
+// Part of Apricot Engine. 2022-2022.
+// Module: Bench
+
+#include "abpch.h"
+#include "AllocatorSuite.h"
+
+#include <Apricot/Core/Memory/ApricotMemory.h>
+#include <Apricot/Core/Memory/ConcurrentPoolArena.h>
+#include <Apricot/Core/Memory/LinearArena.h>
+#include <Apricot/Core/Memory/PoolArena.h>
+#include <Apricot/Core/Memory/StackArena.h>
+
+#include <stdlib.h>
+
+#include <mutex>
+
+namespace Apricot {
+
+	namespace Utils {
+
+		/**
+		* Size of the live set of the churn scenarios. Every churn operation picks a random slot: an empty slot gets a new
+		*	allocation and a full one is freed, so the live set settles around half of the slots.
+		*/
+		static constexpr uint64 ChurnSlotsCount = 1024;
+
+		/**
+		* Chunk sizes of the pool arenas are powers of two, starting at this size.
+		*/
+		static constexpr uint64 MinPoolChunkSizeLog2 = 4;
+		static constexpr uint64 PoolSizeClassesCount = 14;
+
+		/**
+		* Worst case bookkeeping of an allocation in the linear and stack arenas: the alignment padding and the stack
+		*	arena's alignment info.
+		*/
+		static constexpr uint64 ArenaAllocationOverhead = 32;
+
+		enum class ESizeDistribution : uint8
+		{
+			/**
+			* Every allocation is 64 bytes.
+			*/
+			Fixed64,
+
+			/**
+			* Every allocation is 48 bytes. It isn't a power of two, so it doesn't fill its pool arena size class exactly.
+			*/
+			Fixed48,
+
+			/**
+			* Mostly small allocations, with a long tail: 60% are 8-64 bytes, 25% are 65-256 bytes, 12% are 257-1024 bytes
+			*	and 3% are 1025-8192 bytes.
+			*/
+			Mixed,
+		};
+
+		/**
+		* Xorshift64. Deterministic, so every allocator sees the exact same sizes and slots.
+		*/
+		FORCEINLINE static uint64 NextRandom(uint64& State)
+		{
+			State ^= State << 13;
+			State ^= State >> 7;
+			State ^= State << 17;
+			return State;
+		}
+
+		FORCEINLINE static uint64 GetThreadSeed(uint64 ThreadIndex)
+		{
+			return 0x2545F4914F6CDD1Dull + ThreadIndex * 0x9E3779B97F4A7C15ull;
+		}
+
+		static uint32 GetRandomSize(uint64& State, ESizeDistribution Distribution)
+		{
+			if (Distribution == ESizeDistribution::Fixed64)
+			{
+				return 64;
+			}
+			if (Distribution == ESizeDistribution::Fixed48)
+			{
+				return 48;
+			}
+
+			uint64 Bucket = NextRandom(State) % 100;
+			uint64 Random = NextRandom(State);
+			if (Bucket < 60)
+			{
+				return (uint32)(8 + Random % 57);
+			}
+			if (Bucket < 85)
+			{
+				return (uint32)(65 + Random % 192);
+			}
+			if (Bucket < 97)
+			{
+				return (uint32)(257 + Random % 768);
+			}
+			return (uint32)(1025 + Random % 7168);
+		}
+
+		static void FillSizes(TVector<uint32>& OutSizes, uint64 Count, ESizeDistribution Distribution, uint64 Seed)
+		{
+			OutSizes.SetSize(Count);
+			for (uint64 Index = 0; Index < Count; Index++)
+			{
+				OutSizes[Index] = GetRandomSize(Seed, Distribution);
+			}
+		}
+
+		static uint64 GetPoolSizeClass(uint64 Size)
+		{
+			uint64 SizeClass = 0;
+			while ((1ull << (SizeClass + MinPoolChunkSizeLog2)) < Size)
+			{
+				SizeClass++;
+			}
+			return SizeClass;
+		}
+
+		/**
+		* Creates a pool arena with one page per power-of-two size class that is used. A class never has more live blocks than
+		*	its count of operations, nor than the maximum count of live blocks.
+		*/
+		template<typename ArenaType>
+		static TSharedPtr<ArenaType> CreateSizeClassPool(const TVector<uint32>& Sizes, uint64 MaxLiveBlocks)
+		{
+			uint64 ClassCounts[PoolSizeClassesCount] = {};
+			for (uint64 Index = 0; Index < Sizes.Size(); Index++)
+			{
+				ClassCounts[GetPoolSizeClass(Sizes[Index])]++;
+			}
+
+			uint64 PageChunkCounts[PoolSizeClassesCount];
+			uint64 PageChunkSizes[PoolSizeClassesCount];
+			uint64 PagesCount = 0;
+			for (uint64 SizeClass = 0; SizeClass < PoolSizeClassesCount; SizeClass++)
+			{
+				if (ClassCounts[SizeClass] > 0)
+				{
+					PageChunkCounts[PagesCount] = ClassCounts[SizeClass] < MaxLiveBlocks ? ClassCounts[SizeClass] : MaxLiveBlocks;
+					PageChunkSizes[PagesCount] = 1ull << (SizeClass + MinPoolChunkSizeLog2);
+					PagesCount++;
+				}
+			}
+
+			APoolArenaSpecification Specification;
+			Specification.PagesCount = PagesCount;
+			Specification.PageChunkCounts = PageChunkCounts;
+			Specification.PageChunkSizes = PageChunkSizes;
+			return ArenaType::Create(Specification);
+		}
+
+		/**
+		* The allocator policies. 'Init' receives the sizes of a thread's operations and the maximum count of blocks that
+		*	are alive at once, so the arenas are created with enough memory to never grow while measured. 'Init' and 'Shutdown'
+		*	run on the thread that uses the allocator, which then owns its arena.
+		* 'Reset' runs at the end of every burst, inside the measurement, as it is how the linear arena frees its blocks.
+		*/
+
+		struct ALinearArenaPolicy
+		{
+			static constexpr const char8* Name = "ALinearArena";
+
+			void Init(const TVector<uint32>& Sizes, uint64 MaxLiveBlocks)
+			{
+				uint64 PageSize = 0;
+				for (uint64 Index = 0; Index < Sizes.Size(); Index++)
+				{
+					PageSize += Sizes[Index] + ArenaAllocationOverhead;
+				}
+
+				ALinearArenaSpecification Specification;
+				Specification.PagesCount = 1;
+				Specification.PageSizes = &PageSize;
+				Arena = ALinearArena::Create(Specification);
+			}
+
+			void Shutdown() { Arena = NULL_SHARED; }
+
+			FORCEINLINE void* Alloc(uint64 Size) { return Arena->AllocUnsafe(Size); }
+			FORCEINLINE void Free(void* Block, uint64 Size) {}
+			FORCEINLINE void Reset() { Arena->FreeAllUnsafe(); }
+
+			TSharedPtr<ALinearArena> Arena;
+		};
+
+		struct AStackArenaPolicy
+		{
+			static constexpr const char8* Name = "AStackArena";
+
+			void Init(const TVector<uint32>& Sizes, uint64 MaxLiveBlocks)
+			{
+				uint64 PageSize = 0;
+				for (uint64 Index = 0; Index < Sizes.Size(); Index++)
+				{
+					PageSize += Sizes[Index] + ArenaAllocationOverhead;
+				}
+
+				AStackArenaSpecification Specification;
+				Specification.PagesCount = 1;
+				Specification.PageSizes = &PageSize;
+				Arena = AStackArena::Create(Specification);
+			}
+
+			void Shutdown() { Arena = NULL_SHARED; }
+
+			FORCEINLINE void* Alloc(uint64 Size) { return Arena->AllocUnsafe(Size); }
+			FORCEINLINE void Free(void* Block, uint64 Size) { Arena->FreeUnsafe(Block, Size); }
+			FORCEINLINE void Reset() {}
+
+			TSharedPtr<AStackArena> Arena;
+		};
+
+		struct APoolArenaPolicy
+		{
+			static constexpr const char8* Name = "APoolArena";
+
+			void Init(const TVector<uint32>& Sizes, uint64 MaxLiveBlocks)
+			{
+				Arena = CreateSizeClassPool<APoolArena>(Sizes, MaxLiveBlocks);
+			}
+
+			void Shutdown() { Arena = NULL_SHARED; }
+
+			// The blocks are only byte aligned, so a block of a power-of-two size fits its class exactly.
+			FORCEINLINE void* Alloc(uint64 Size) { return Arena->AllocUnsafe(Size, 1); }
+			FORCEINLINE void Free(void* Block, uint64 Size) { Arena->FreeUnsafe(Block, Size); }
+			FORCEINLINE void Reset() {}
+
+			TSharedPtr<APoolArena> Arena;
+		};
+
+		/**
+		* A pool arena whose chunks all have the size of the biggest block, split evenly in 'PagesCount' pages. It allocates with
+		*	the first fit strategy, which should take the same time whatever the count of pages is.
+		*/
+		template<uint64 PagesCount>
+		struct TPoolArenaFirstFitPolicy
+		{
+			static constexpr const char8* Name = "APoolArena/FirstFit";
+
+			void Init(const TVector<uint32>& Sizes, uint64 MaxLiveBlocks)
+			{
+				uint64 ChunkSize = 1;
+				for (uint64 Index = 0; Index < Sizes.Size(); Index++)
+				{
+					ChunkSize = Sizes[Index] > ChunkSize ? Sizes[Index] : ChunkSize;
+				}
+
+				uint64 PageChunkCounts[PagesCount];
+				uint64 PageChunkSizes[PagesCount];
+				for (uint64 Page = 0; Page < PagesCount; Page++)
+				{
+					PageChunkCounts[Page] = (MaxLiveBlocks + PagesCount - 1) / PagesCount;
+					PageChunkSizes[Page] = ChunkSize;
+				}
+
+				APoolArenaSpecification Specification;
+				Specification.PagesCount = PagesCount;
+				Specification.PageChunkCounts = PageChunkCounts;
+				Specification.PageChunkSizes = PageChunkSizes;
+				Arena = APoolArena::Create(Specification);
+			}
+
+			void Shutdown() { Arena = NULL_SHARED; }
+
+			FORCEINLINE void* Alloc(uint64 Size) { return Arena->AllocUnsafe(Size, 1, EAllocStrategy::FirstFit); }
+			FORCEINLINE void Free(void* Block, uint64 Size) { Arena->FreeUnsafe(Block, Size); }
+			FORCEINLINE void Reset() {}
+
+			TSharedPtr<APoolArena> Arena;
+		};
+
+		/**
+		* Used by all the threads at once, in the shared scenarios. 'Init' receives the sizes of every thread's operations.
+		*/
+		struct AConcurrentPoolArenaPolicy
+		{
+			static constexpr const char8* Name = "AConcurrentPoolArena";
+
+			void Init(const TVector<uint32>& Sizes, uint64 MaxLiveBlocks)
+			{
+				Arena = CreateSizeClassPool<AConcurrentPoolArena>(Sizes, MaxLiveBlocks);
+			}
+
+			void Shutdown() { Arena = NULL_SHARED; }
+
+			FORCEINLINE void* Alloc(uint64 Size) { return Arena->AllocUnsafe(Size, 1); }
+			FORCEINLINE void Free(void* Block, uint64 Size) { Arena->FreeUnsafe(Block, Size); }
+			FORCEINLINE void Reset() {}
+
+			TSharedPtr<AConcurrentPoolArena> Arena;
+		};
+
+		/**
+		* The baseline of AConcurrentPoolArena: a single pool arena behind a mutex. The thread that holds the lock claims the
+		*	arena, so its frees are applied directly instead of being deferred to another thread.
+		*/
+		struct AMutexPoolArenaPolicy
+		{
+			static constexpr const char8* Name = "APoolArena/Mutex";
+
+			void Init(const TVector<uint32>& Sizes, uint64 MaxLiveBlocks)
+			{
+				Arena = CreateSizeClassPool<APoolArena>(Sizes, MaxLiveBlocks);
+			}
+
+			void Shutdown() { Arena = NULL_SHARED; }
+
+			FORCEINLINE void* Alloc(uint64 Size)
+			{
+				std::lock_guard<std::mutex> Lock(Mutex);
+				Arena->ClaimOwnership();
+				return Arena->AllocUnsafe(Size, 1);
+			}
+
+			FORCEINLINE void Free(void* Block, uint64 Size)
+			{
+				std::lock_guard<std::mutex> Lock(Mutex);
+				Arena->ClaimOwnership();
+				Arena->FreeUnsafe(Block, Size);
+			}
+
+			FORCEINLINE void Reset() {}
+
+			TSharedPtr<APoolArena> Arena;
+			std::mutex Mutex;
+		};
+
+		struct AGMallocPolicy
+		{
+			static constexpr const char8* Name = "GMalloc";
+
+			void Init(const TVector<uint32>& Sizes, uint64 MaxLiveBlocks) {}
+			void Shutdown() {}
+
+			FORCEINLINE void* Alloc(uint64 Size) { return GMalloc->Alloc(Size); }
+			FORCEINLINE void Free(void* Block, uint64 Size) { GMalloc->Free(Block, Size); }
+			FORCEINLINE void Reset() {}
+		};
+
+		struct ASystemMallocPolicy
+		{
+			static constexpr const char8* Name = "malloc";
+
+			void Init(const TVector<uint32>& Sizes, uint64 MaxLiveBlocks) {}
+			void Shutdown() {}
+
+			FORCEINLINE void* Alloc(uint64 Size) { return malloc(Size); }
+			FORCEINLINE void Free(void* Block, uint64 Size) { free(Block); }
+			FORCEINLINE void Reset() {}
+		};
+
+		/**
+		* Every thread allocates 'OperationsCount' blocks, then frees them in reverse order. An operation is an allocation
+		*	and its free.
+		*/
+		template<typename PolicyType>
+		class TBurstBenchmark : public ABenchmark
+		{
+		public:
+			TBurstBenchmark(const char8* Scenario, ESizeDistribution Distribution)
+				: ABenchmark(Scenario, PolicyType::Name), m_Distribution(Distribution)
+			{
+			}
+
+			virtual void Setup(const ABenchmarkSpecification& Specification) override
+			{
+				m_Threads.SetSize(Specification.ThreadsCount);
+				for (uint64 ThreadIndex = 0; ThreadIndex < m_Threads.Size(); ThreadIndex++)
+				{
+					AThreadState& State = m_Threads[ThreadIndex];
+					FillSizes(State.Sizes, Specification.OperationsCount, m_Distribution, GetThreadSeed(ThreadIndex));
+					State.Blocks.SetSize(Specification.OperationsCount);
+				}
+			}
+
+			virtual void Teardown() override
+			{
+				m_Threads.Clear();
+			}
+
+			virtual void SetupThread(uint64 ThreadIndex) override
+			{
+				AThreadState& State = m_Threads[ThreadIndex];
+				State.Allocator.Init(State.Sizes, State.Sizes.Size());
+			}
+
+			virtual void TeardownThread(uint64 ThreadIndex) override
+			{
+				m_Threads[ThreadIndex].Allocator.Shutdown();
+			}
+
+			virtual void Run(uint64 ThreadIndex, uint64 OperationsCount) override
+			{
+				AThreadState& State = m_Threads[ThreadIndex];
+
+				for (uint64 Index = 0; Index < OperationsCount; Index++)
+				{
+					// Writing to the block keeps the compiler from eliding the allocation.
+					uint8* Block = (uint8*)State.Allocator.Alloc(State.Sizes[Index]);
+					*Block = (uint8)Index;
+					State.Blocks[Index] = Block;
+				}
+
+				for (uint64 Index = OperationsCount; Index > 0; Index--)
+				{
+					State.Allocator.Free(State.Blocks[Index - 1], State.Sizes[Index - 1]);
+				}
+
+				State.Allocator.Reset();
+			}
+
+		private:
+			struct AThreadState
+			{
+				PolicyType Allocator;
+				TVector<uint32> Sizes;
+				TVector<void*> Blocks;
+			};
+
+			ESizeDistribution m_Distribution;
+			TVector<AThreadState> m_Threads;
+		};
+
+		/**
+		* The live set of a churn thread, and the sizes and slots of its operations.
+		*/
+		struct AChurnState
+		{
+		public:
+			void Init(uint64 OperationsCount, ESizeDistribution Distribution, uint64 Seed)
+			{
+				FillSizes(Sizes, OperationsCount, Distribution, Seed);
+				SlotSequence.SetSize(OperationsCount);
+				for (uint64 Index = 0; Index < OperationsCount; Index++)
+				{
+					SlotSequence[Index] = (uint32)(NextRandom(Seed) % ChurnSlotsCount);
+				}
+
+				Slots.SetSize(ChurnSlotsCount);
+				SlotSizes.SetSize(ChurnSlotsCount);
+				for (uint64 Slot = 0; Slot < ChurnSlotsCount; Slot++)
+				{
+					Slots[Slot] = nullptr;
+				}
+			}
+
+			template<typename AllocatorType>
+			FORCEINLINE void Run(AllocatorType& Allocator, uint64 OperationsCount)
+			{
+				for (uint64 Index = 0; Index < OperationsCount; Index++)
+				{
+					uint32 Slot = SlotSequence[Index];
+					if (Slots[Slot])
+					{
+						Allocator.Free(Slots[Slot], SlotSizes[Slot]);
+						Slots[Slot] = nullptr;
+					}
+					else
+					{
+						uint8* Block = (uint8*)Allocator.Alloc(Sizes[Index]);
+						*Block = (uint8)Index;
+						Slots[Slot] = Block;
+						SlotSizes[Slot] = Sizes[Index];
+					}
+				}
+			}
+
+			template<typename AllocatorType>
+			void FreeLiveSet(AllocatorType& Allocator)
+			{
+				for (uint64 Slot = 0; Slot < ChurnSlotsCount; Slot++)
+				{
+					if (Slots[Slot])
+					{
+						Allocator.Free(Slots[Slot], SlotSizes[Slot]);
+						Slots[Slot] = nullptr;
+					}
+				}
+			}
+
+		public:
+			TVector<uint32> Sizes;
+			TVector<uint32> SlotSequence;
+			TVector<void*> Slots;
+			TVector<uint32> SlotSizes;
+		};
+
+		/**
+		* Every thread frees and allocates blocks of its own live set, in random order. An operation is either an
+		*	allocation or a free. The live set is kept between the repetitions, so the warmup brings it to a steady state.
+		*/
+		template<typename PolicyType>
+		class TChurnBenchmark : public ABenchmark
+		{
+		public:
+			TChurnBenchmark(const char8* Scenario, ESizeDistribution Distribution)
+				: ABenchmark(Scenario, PolicyType::Name), m_Distribution(Distribution)
+			{
+			}
+
+			virtual void Setup(const ABenchmarkSpecification& Specification) override
+			{
+				m_Threads.SetSize(Specification.ThreadsCount);
+				for (uint64 ThreadIndex = 0; ThreadIndex < m_Threads.Size(); ThreadIndex++)
+				{
+					m_Threads[ThreadIndex].Churn.Init(Specification.OperationsCount, m_Distribution, GetThreadSeed(ThreadIndex));
+				}
+			}
+
+			virtual void Teardown() override
+			{
+				m_Threads.Clear();
+			}
+
+			virtual void SetupThread(uint64 ThreadIndex) override
+			{
+				AThreadState& State = m_Threads[ThreadIndex];
+				State.Allocator.Init(State.Churn.Sizes, ChurnSlotsCount);
+			}
+
+			/**
+			* The live set is freed by the thread that allocated it, so the pool arenas never take the remote free path.
+			*/
+			virtual void TeardownThread(uint64 ThreadIndex) override
+			{
+				AThreadState& State = m_Threads[ThreadIndex];
+				State.Churn.FreeLiveSet(State.Allocator);
+				State.Allocator.Shutdown();
+			}
+
+			virtual void Run(uint64 ThreadIndex, uint64 OperationsCount) override
+			{
+				AThreadState& State = m_Threads[ThreadIndex];
+				State.Churn.Run(State.Allocator, OperationsCount);
+			}
+
+		private:
+			struct AThreadState
+			{
+				PolicyType Allocator;
+				AChurnState Churn;
+			};
+
+			ESizeDistribution m_Distribution;
+			TVector<AThreadState> m_Threads;
+		};
+
+		/**
+		* Same as TChurnBenchmark, but all the threads allocate from and free to a single allocator.
+		*/
+		template<typename PolicyType>
+		class TSharedChurnBenchmark : public ABenchmark
+		{
+		public:
+			TSharedChurnBenchmark(const char8* Scenario, ESizeDistribution Distribution)
+				: ABenchmark(Scenario, PolicyType::Name), m_Distribution(Distribution)
+			{
+			}
+
+			virtual void Setup(const ABenchmarkSpecification& Specification) override
+			{
+				TVector<uint32> AllSizes;
+				m_Threads.SetSize(Specification.ThreadsCount);
+				for (uint64 ThreadIndex = 0; ThreadIndex < m_Threads.Size(); ThreadIndex++)
+				{
+					AChurnState& State = m_Threads[ThreadIndex];
+					State.Init(Specification.OperationsCount, m_Distribution, GetThreadSeed(ThreadIndex));
+					for (uint64 Index = 0; Index < State.Sizes.Size(); Index++)
+					{
+						AllSizes.PushBack(State.Sizes[Index]);
+					}
+				}
+
+				m_Allocator.Init(AllSizes, ChurnSlotsCount * Specification.ThreadsCount);
+			}
+
+			virtual void Teardown() override
+			{
+				m_Allocator.Shutdown();
+				m_Threads.Clear();
+			}
+
+			virtual void TeardownThread(uint64 ThreadIndex) override
+			{
+				m_Threads[ThreadIndex].FreeLiveSet(m_Allocator);
+			}
+
+			virtual void Run(uint64 ThreadIndex, uint64 OperationsCount) override
+			{
+				m_Threads[ThreadIndex].Run(m_Allocator, OperationsCount);
+			}
+
+		private:
+			ESizeDistribution m_Distribution;
+			PolicyType m_Allocator;
+			TVector<AChurnState> m_Threads;
+		};
+
+		template<template<typename> class BenchmarkType, typename PolicyType>
+		static void RunBenchmark(ABenchmarkRunner& Runner, const ABenchmarkSpecification& Specification, const char8* Scenario,
+			ESizeDistribution Distribution)
+		{
+			BenchmarkType<PolicyType> Benchmark(Scenario, Distribution);
+			Runner.Run(Benchmark, Specification);
+		}
+
+		static void RunBurstScenario(ABenchmarkRunner& Runner, const ABenchmarkSpecification& Specification, const char8* Scenario,
+			ESizeDistribution Distribution)
+		{
+			RunBenchmark<TBurstBenchmark, ALinearArenaPolicy>(Runner, Specification, Scenario, Distribution);
+			RunBenchmark<TBurstBenchmark, AStackArenaPolicy>(Runner, Specification, Scenario, Distribution);
+			RunBenchmark<TBurstBenchmark, APoolArenaPolicy>(Runner, Specification, Scenario, Distribution);
+			RunBenchmark<TBurstBenchmark, AGMallocPolicy>(Runner, Specification, Scenario, Distribution);
+			RunBenchmark<TBurstBenchmark, ASystemMallocPolicy>(Runner, Specification, Scenario, Distribution);
+		}
+
+		/**
+		* The linear and stack arenas can't free blocks in random order, so they don't take part in the churn scenarios.
+		*/
+		static void RunChurnScenario(ABenchmarkRunner& Runner, const ABenchmarkSpecification& Specification, const char8* Scenario,
+			ESizeDistribution Distribution)
+		{
+			RunBenchmark<TChurnBenchmark, APoolArenaPolicy>(Runner, Specification, Scenario, Distribution);
+			RunBenchmark<TChurnBenchmark, AGMallocPolicy>(Runner, Specification, Scenario, Distribution);
+			RunBenchmark<TChurnBenchmark, ASystemMallocPolicy>(Runner, Specification, Scenario, Distribution);
+		}
+
+
+		/**
+		* The pool arena's first fit allocations, with the same live set spread over more and more pages.
+		*/
+		static void RunPoolPagesScenario(ABenchmarkRunner& Runner, const ABenchmarkSpecification& Specification)
+		{
+			RunBenchmark<TChurnBenchmark, TPoolArenaFirstFitPolicy<1>>(Runner, Specification, "Churn/Fixed48/1Page", ESizeDistribution::Fixed48);
+			RunBenchmark<TChurnBenchmark, TPoolArenaFirstFitPolicy<16>>(Runner, Specification, "Churn/Fixed48/16Pages", ESizeDistribution::Fixed48);
+			RunBenchmark<TChurnBenchmark, TPoolArenaFirstFitPolicy<256>>(Runner, Specification, "Churn/Fixed48/256Pages", ESizeDistribution::Fixed48);
+		}
+
+		/**
+		* A single allocator shared by 1, 2, 4... threads, up to 'ThreadsCount', to measure how AConcurrentPoolArena scales
+		*	against a pool arena behind a mutex.
+		*/
+		static void RunSharedScalingScenario(ABenchmarkRunner& Runner, const ABenchmarkSpecification& Specification, uint64 ThreadsCount)
+		{
+			ABenchmarkSpecification Scaled = Specification;
+			Scaled.ThreadsCount = 1;
+			while (true)
+			{
+				RunBenchmark<TSharedChurnBenchmark, AConcurrentPoolArenaPolicy>(Runner, Scaled, "Churn/Mixed/Shared", ESizeDistribution::Mixed);
+				RunBenchmark<TSharedChurnBenchmark, AMutexPoolArenaPolicy>(Runner, Scaled, "Churn/Mixed/Shared", ESizeDistribution::Mixed);
+
+				if (Scaled.ThreadsCount >= ThreadsCount)
+				{
+					break;
+				}
+				Scaled.ThreadsCount = Scaled.ThreadsCount * 2 < ThreadsCount ? Scaled.ThreadsCount * 2 : ThreadsCount;
+			}
+		}
+
+	}
+
+	void RunAllocatorSuite(ABenchmarkRunner& Runner, const ABenchmarkSpecification& Specification, uint64 ThreadsCount)
+	{
+		ABenchmarkSpecification SingleThreaded = Specification;
+		SingleThreaded.ThreadsCount = 1;
+
+		Utils::RunBurstScenario(Runner, SingleThreaded, "Burst/Fixed64", Utils::ESizeDistribution::Fixed64);
+		Utils::RunBurstScenario(Runner, SingleThreaded, "Burst/Mixed", Utils::ESizeDistribution::Mixed);
+		Utils::RunChurnScenario(Runner, SingleThreaded, "Churn/Mixed", Utils::ESizeDistribution::Mixed);
+		Utils::RunPoolPagesScenario(Runner, SingleThreaded);
+
+		if (ThreadsCount > 1)
+		{
+			// Every thread creates and owns its pool arena, while GMalloc and malloc are shared by all of them.
+			ABenchmarkSpecification MultiThreaded = Specification;
+			MultiThreaded.ThreadsCount = ThreadsCount;
+			Utils::RunChurnScenario(Runner, MultiThreaded, "Churn/Mixed/Threads", Utils::ESizeDistribution::Mixed);
+		}
+
+		Utils::RunSharedScalingScenario(Runner, Specification, ThreadsCount);
+	}
+
+}
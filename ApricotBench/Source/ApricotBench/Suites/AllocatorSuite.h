@@ -0,0 +1,20 @@
+// Part of Apricot Engine. 2022-2022.
+// Module: Bench
+
+#pragma once
+
+#include "ApricotBench/Core/Benchmark.h"
+
+namespace Apricot {
+
+	/**
+	* Runs the allocator benchmarks: ALinearArena, AStackArena, APoolArena, GMalloc and the system's malloc, in burst
+	*	and churn scenarios, with fixed and mixed allocation sizes. APoolArena's first fit strategy is also measured with
+	*	a growing count of pages.
+	* The multi-threaded churn runs with 'ThreadsCount' threads and is skipped if it is 1 or less.
+	* AConcurrentPoolArena and a mutex-guarded APoolArena are shared by 1, 2, 4... threads, up to 'ThreadsCount', to measure
+	*	how they scale.
+	*/
+	void RunAllocatorSuite(ABenchmarkRunner& Runner, const ABenchmarkSpecification& Specification, uint64 ThreadsCount);
+
+}
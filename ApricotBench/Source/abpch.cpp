@@ -0,0 +1,3 @@
+// Part of Apricot Engine. 2022-2022.
+
+#include "abpch.h"
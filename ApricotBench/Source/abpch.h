@@ -0,0 +1,14 @@
+// Part of Apricot Engine. 2022-2022.
+
+#pragma once
+
+#include <Apricot/Core/Config.h>
+#include <Apricot/Core/Base.h>
+#include <Apricot/Core/Assert.h>
+
+#include <Apricot/Containers/SharedPtr.h>
+#include <Apricot/Containers/SharedRef.h>
+#include <Apricot/Containers/WeakPtr.h>
+#include <Apricot/Containers/UniquePtr.h>
+#include <Apricot/Containers/PtrConversions.h>
+#include <Apricot/Containers/Vector.h>
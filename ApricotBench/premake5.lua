@@ -0,0 +1,111 @@
+project "ApricotBench"
+	kind "ConsoleApp"
+	language "C++"
+	cppdialect "C++20"
+	staticruntime "off"
+
+	pchheader "abpch.h"
+	pchsource "Source/abpch.cpp"
+
+	files {
+		"Source/**.h",
+		"Source/**.cpp"
+	}
+
+	includedirs {
+		"Source",
+
+		"%{IncludeDirs.AE}",
+		"%{IncludeDirs.Optick}"
+	}
+
+	links {
+		"AE"
+	}
+
+	defines {
+		"AE_IMPORT_DLL"
+	}
+
+	filter { "system:windows" }
+		systemversion "latest"
+		characterset "Unicode"
+		defines {
+			"AE_PLATFORM_WINDOWS",
+			"AE_UNICODE"
+		}
+
+	filter { "configurations:Debug_Editor" }
+		defines {
+			"AE_CONFIG_DEBUG_EDITOR"
+		}
+
+		symbols "on"
+		optimize "off"
+
+		filter { "configurations:Debug_Editor", "system:windows" }
+			targetdir "%{wks.location}/Binaries/Win64-DebugEd"
+			objdir "%{wks.location}/Binaries-Int/Win64/%{prj.name}"
+			
+	filter { "configurations:Debug_Game" }
+		defines {
+			"AE_CONFIG_DEBUG_GAME"
+		}
+
+		symbols "on"
+		optimize "off"
+
+		filter { "configurations:Debug_Game", "system:windows" }
+			targetdir "%{wks.location}/Binaries/Win64-Debug"
+			objdir "%{wks.location}/Binaries-Int/Win64/%{prj.name}"
+			
+	filter { "configurations:Release_Editor" }
+		defines {
+			"AE_CONFIG_RELEASE_EDITOR"
+		}
+
+		symbols "off"
+		optimize "full"
+
+		filter { "configurations:Release_Editor", "system:windows" }
+			targetdir "%{wks.location}/Binaries/Win64-ReleaseEd"
+			objdir "%{wks.location}/Binaries-Int/Win64/%{prj.name}"
+			
+	filter { "configurations:Release_Game" }
+		defines {
+			"AE_CONFIG_RELEASE_GAME"
+		}
+
+		symbols "off"
+		optimize "full"
+
+		filter { "configurations:Release_Game", "system:windows" }
+			targetdir "%{wks.location}/Binaries/Win64-Release"
+			objdir "%{wks.location}/Binaries-Int/Win64/%{prj.name}"
+			
+	filter { "configurations:Shipping_Game" }
+		defines {
+			"AE_CONFIG_SHIPPING_GAME"
+		}
+
+		symbols "off"
+		optimize "speed"
+
+		filter { "configurations:Shipping_Game", "system:windows" }
+			targetdir "%{wks.location}/Binaries/Win64-Shipping"
+			objdir "%{wks.location}/Binaries-Int/Win64/%{prj.name}"
+
+	filter { "system:linux" }
+		defines {
+			"AE_PLATFORM_LINUX",
+			"AE_ANSII"
+		}
+
+		targetdir "%{wks.location}/Binaries/Linux-%{cfg.buildcfg}"
+		objdir "%{wks.location}/Binaries-Int/Linux/%{prj.name}"
+
+		links {
+			"pthread"
+		}
+			
+	filter {}
@@ -98,5 +98,20 @@ project "ApricotJam"
 		filter { "configurations:Shipping_Game", "system:windows" }
 			targetdir "%{wks.location}/Binaries/Win64-Shipping"
 			objdir "%{wks.location}/Binaries-Int/Win64/%{prj.name}"
+
+	filter { "system:linux" }
+		kind "ConsoleApp"
+		defines {
+			"AE_PLATFORM_LINUX",
+			"AE_ANSII"
+		}
+
+		removefiles {
+			"ApricotJam.rc",
+			"ApricotJam.aps"
+		}
+
+		targetdir "%{wks.location}/Binaries/Linux-%{cfg.buildcfg}"
+		objdir "%{wks.location}/Binaries-Int/Linux/%{prj.name}"
 			
 	filter {}
\ No newline at end of file
@@ -31,6 +31,7 @@ group "Core"
     include "Apricot"
 group "Tools"
     include "ApricotJam"
+    include "ApricotBench"
 group "ThirdParty"
     
 group ""
\ No newline at end of file